@@ -0,0 +1,131 @@
+#ifndef IRODS_HTTP_API_ALLOCATION_ACCOUNTING_HPP
+#define IRODS_HTTP_API_ALLOCATION_ACCOUNTING_HPP
+
+/// \file
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/// Defines the types and free functions used to attribute memory allocations to requests.
+///
+/// The server replaces the global allocation functions (i.e. operator new). Each allocation made
+/// by a thread which is working on a request is added to the record of that request. When the
+/// request ends, its totals are added to the totals of its endpoint and operation.
+///
+/// Only allocations made via operator new are counted. Allocations made via malloc (e.g. by
+/// the iRODS C API) are not. Bytes are counted when they are allocated, therefore, the totals
+/// describe allocation pressure rather than the amount of memory held.
+///
+/// The record of the request being processed by the current thread is held in a thread-local
+/// variable. It is carried into background threads by irods::http::globals::background_task.
+/// Threads without a record pay for one thread-local load per allocation.
+///
+/// Accounting is configured via /http_server/allocation_accounting.
+namespace irods::http::allocation_accounting
+{
+	/// The allocations of a single request.
+	///
+	/// Instances are shared by all threads working on the request.
+	class request_record : public std::enable_shared_from_this<request_record>
+	{
+	  public:
+		explicit request_record(std::string_view _endpoint);
+
+		request_record(const request_record&) = delete;
+		auto operator=(const request_record&) -> request_record& = delete;
+
+		request_record(request_record&&) = delete;
+		auto operator=(request_record&&) -> request_record& = delete;
+
+		~request_record() = default;
+
+		/// This function is thread-safe and does not allocate.
+		auto add(std::size_t _bytes) noexcept -> void
+		{
+			bytes_.fetch_add(_bytes, std::memory_order_relaxed);
+			allocations_.fetch_add(1, std::memory_order_relaxed);
+		} // add
+
+		/// This function is thread-safe.
+		auto set_operation(std::string_view _operation) -> void;
+
+		auto bytes() const noexcept -> std::uint64_t
+		{
+			return bytes_.load(std::memory_order_relaxed);
+		} // bytes
+
+		auto allocations() const noexcept -> std::uint64_t
+		{
+			return allocations_.load(std::memory_order_relaxed);
+		} // allocations
+
+		/// Ends the request and adds its allocations to the totals of its endpoint and operation.
+		auto finish() -> void;
+
+	  private:
+		const std::string endpoint_;
+
+		std::mutex mtx_;
+		std::string operation_;
+
+		std::atomic<std::uint64_t> bytes_{};
+		std::atomic<std::uint64_t> allocations_{};
+	}; // class request_record
+
+	/// The allocations of all finished requests for an endpoint and operation.
+	struct totals
+	{
+		std::uint64_t number_of_requests;
+		std::uint64_t bytes;
+		std::uint64_t allocations;
+		std::uint64_t max_bytes_per_request;
+	}; // struct totals
+
+	/// Returns whether allocations are attributed to requests.
+	auto enabled() -> bool;
+
+	/// Returns a new record for a request to \p _endpoint, or a null pointer if accounting is
+	/// disabled.
+	auto start(std::string_view _endpoint) -> std::shared_ptr<request_record>;
+
+	/// Returns the record of the request being processed by the current thread, if any.
+	auto current() noexcept -> request_record*;
+
+	/// Makes \p _record the record of the current thread for the lifetime of the object.
+	class scope
+	{
+	  public:
+		explicit scope(std::shared_ptr<request_record> _record);
+
+		scope(const scope&) = delete;
+		auto operator=(const scope&) -> scope& = delete;
+
+		scope(scope&&) = delete;
+		auto operator=(scope&&) -> scope& = delete;
+
+		~scope();
+
+	  private:
+		std::shared_ptr<request_record> record_;
+		request_record* previous_;
+	}; // class scope
+
+	/// Returns a function which runs \p _task with the record of the current thread. Returns
+	/// \p _task unchanged if the current thread has no record.
+	auto wrap(std::function<void()> _task) -> std::function<void()>;
+
+	/// Returns the totals of all finished requests, keyed by endpoint and then by operation.
+	/// Requests without an operation are keyed by an empty string.
+	///
+	/// This function is thread-safe.
+	auto totals_by_endpoint() -> std::map<std::string, std::map<std::string, totals>>;
+} // namespace irods::http::allocation_accounting
+
+#endif // IRODS_HTTP_API_ALLOCATION_ACCOUNTING_HPP
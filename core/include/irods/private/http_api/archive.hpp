@@ -0,0 +1,161 @@
+#ifndef IRODS_HTTP_API_ARCHIVE_HPP
+#define IRODS_HTTP_API_ARCHIVE_HPP
+
+/// \file
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace irods::http::archive
+{
+	/// The archive formats supported by the HTTP API.
+	enum class format
+	{
+		tar,
+		zip
+	}; // enum class format
+
+	enum class entry_type
+	{
+		file,
+		directory,
+		other // Symbolic links, hard links, devices, etc.
+	}; // enum class entry_type
+
+	/// Describes a single member of an archive.
+	///
+	/// Entries produced by read_entries() reference memory owned by the archive they were read from.
+	struct entry
+	{
+		/// The path of the entry as recorded in the archive.
+		std::string path;
+
+		entry_type type = entry_type::file;
+
+		/// The bytes of the entry as stored in the archive (i.e. possibly compressed).
+		std::string_view data;
+
+		/// The size of the entry after decompression.
+		std::uint64_t size = 0;
+
+		/// The zip compression method. Always 0 (stored) for tar archives.
+		std::uint16_t compression_method = 0;
+
+		/// The CRC-32 of the uncompressed bytes. Only available for zip archives.
+		std::optional<std::uint32_t> crc32;
+	}; // struct entry
+
+	/// Returns the archive format associated with \p _content_type.
+	///
+	/// Recognizes application/x-tar, application/tar, application/zip, and
+	/// application/x-zip-compressed.
+	auto to_format(std::string_view _content_type) -> std::optional<format>;
+
+	/// Returns the MIME type of \p _format.
+	auto to_content_type(format _format) -> const char*;
+
+	/// Returns the entries contained in \p _archive.
+	///
+	/// Tar archives may use the ustar, GNU (long names), or pax (path and size records)
+	/// extensions. Zip archives may use the Zip64 extensions.
+	///
+	/// \throws irods::exception If the archive is malformed or uses an unsupported feature.
+	auto read_entries(format _format, std::string_view _archive) -> std::vector<entry>;
+
+	/// Passes the uncompressed bytes of \p _entry to \p _sink, in order.
+	///
+	/// Stored entries are passed in a single call without copying. Compressed entries are
+	/// decompressed in chunks of at most \p _chunk_size bytes, so memory usage does not depend on
+	/// the size of the entry. If the entry has a CRC-32, it is verified once all bytes have been
+	/// passed to \p _sink.
+	///
+	/// \throws irods::exception If the entry cannot be decompressed, does not match its declared
+	/// size, or fails verification. Bytes may have been passed to \p _sink already.
+	auto read_contents(
+		const entry& _entry,
+		std::size_t _chunk_size,
+		const std::function<void(std::string_view)>& _sink) -> void;
+
+	/// Normalizes the path of an archive entry so that it is safe to join with a parent path.
+	///
+	/// Leading slashes and "." components are removed.
+	///
+	/// \returns An empty optional if the path is empty or contains ".." components.
+	auto normalize_entry_path(std::string_view _path) -> std::optional<std::string>;
+
+	/// Incrementally produces an archive.
+	///
+	/// Each member function returns bytes which the caller must append to the archive. The
+	/// contents of an entry are appended by the caller between the calls to begin_entry() and
+	/// end_entry() and must also be passed to update(). Memory usage does not depend on the size
+	/// of the entries.
+	///
+	/// Zip entries are stored without compression. Their sizes and CRC-32 values are recorded in
+	/// data descriptors. The central directory is kept in memory until finish() is called.
+	class writer
+	{
+	  public:
+		explicit writer(format _format);
+
+		/// Returns the header of a new entry.
+		///
+		/// \param[in] _path  The path of the entry within the archive.
+		/// \param[in] _type  The type of the entry. Must be file or directory.
+		/// \param[in] _size  The number of bytes the entry will contain. Ignored for directories.
+		/// \param[in] _mtime The modification time of the entry, in seconds since the epoch.
+		auto begin_entry(std::string_view _path, entry_type _type, std::uint64_t _size, std::int64_t _mtime)
+			-> std::string;
+
+		/// Records that \p _data was appended to the current entry.
+		///
+		/// \throws irods::exception If the entry would exceed the size passed to begin_entry().
+		auto update(std::string_view _data) -> void;
+
+		/// Returns the bytes which complete the current entry.
+		///
+		/// If fewer bytes than announced were appended to a tar entry, the remainder is filled
+		/// with zeros so that the archive remains well-formed.
+		auto end_entry() -> std::string;
+
+		/// Returns the bytes which complete the archive.
+		auto finish() -> std::string;
+
+	  private:
+		struct zip_record
+		{
+			std::string path;
+			bool is_directory;
+			std::uint16_t dos_time;
+			std::uint16_t dos_date;
+			std::uint32_t crc32;
+			std::uint64_t size;
+			std::uint64_t offset;
+		}; // struct zip_record
+
+		auto begin_tar_entry(std::string_view _path, entry_type _type, std::uint64_t _size, std::int64_t _mtime)
+			-> std::string;
+
+		auto begin_zip_entry(std::string_view _path, entry_type _type, std::int64_t _mtime) -> std::string;
+
+		format format_;
+
+		// The number of bytes produced so far. Only tracked for zip archives.
+		std::uint64_t offset_{};
+
+		// Information about the entry being written.
+		std::uint64_t size_{};
+		std::uint64_t bytes_written_{};
+		std::uint32_t crc32_{};
+		bool zip64_{};
+		zip_record record_{};
+
+		std::vector<zip_record> records_;
+	}; // class writer
+} // namespace irods::http::archive
+
+#endif // IRODS_HTTP_API_ARCHIVE_HPP
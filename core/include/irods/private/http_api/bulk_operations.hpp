@@ -0,0 +1,65 @@
+#ifndef IRODS_HTTP_API_BULK_OPERATIONS_HPP
+#define IRODS_HTTP_API_BULK_OPERATIONS_HPP
+
+/// \file
+
+#include "irods/private/http_api/common.hpp"
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+struct RcComm;
+
+namespace irods::http
+{
+	/// Represents a single non-empty line of an NDJSON document.
+	struct ndjson_entry
+	{
+		/// The line number of the entry. Line numbers start at 1.
+		std::size_t line_number;
+
+		/// The text of the line, excluding the line terminator.
+		std::string_view text;
+	}; // struct ndjson_entry
+
+	/// The type of function used to process a single entry of a bulk request.
+	///
+	/// The function MUST return exactly one line of JSON, including the trailing newline.
+	/// Exceptions thrown by the function are converted into an error result for the entry.
+	using bulk_entry_handler_type = std::function<std::string(RcComm&, const ndjson_entry&)>;
+
+	/// Splits \p _body into NDJSON entries. Empty lines are skipped.
+	///
+	/// The entries reference memory owned by \p _body.
+	auto split_ndjson_entries(std::string_view _body) -> std::vector<ndjson_entry>;
+
+	/// Returns a line of JSON describing a failure to process an entry of a bulk request.
+	auto make_bulk_error_result(std::size_t _line_number, int _error_code, std::string_view _message) -> std::string;
+
+	/// Returns whether the body of \p _req is of type application/x-ndjson.
+	auto is_ndjson_request(const request_type& _req) -> bool;
+
+	/// Processes every entry in the NDJSON body of \p _req and streams the results to the client.
+	///
+	/// Entries are processed in batches by multiple background tasks. Each task holds a single
+	/// iRODS connection for its lifetime. The results of a batch are sent to the client as a
+	/// single chunk as soon as the batch completes, therefore, results are not guaranteed to be
+	/// returned in the same order as the entries.
+	///
+	/// This function MUST be invoked from a background task.
+	///
+	/// \param[in] _sess_ptr The session the request belongs to.
+	/// \param[in] _req      The request. Ownership is taken so that entries remain valid.
+	/// \param[in] _username The iRODS user the entries are processed as.
+	/// \param[in] _handler  The function used to process each entry.
+	auto process_ndjson_entries(
+		session_pointer_type _sess_ptr,
+		request_type&& _req,
+		std::string _username,
+		bulk_entry_handler_type _handler) -> void;
+} // namespace irods::http
+
+#endif // IRODS_HTTP_API_BULK_OPERATIONS_HPP
@@ -0,0 +1,54 @@
+#ifndef IRODS_HTTP_API_CHECKSUM_CACHE_HPP
+#define IRODS_HTTP_API_CHECKSUM_CACHE_HPP
+
+/// \file
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// Defines the set of free functions used to manage the checksum cache.
+///
+/// The checksum cache remembers which replicas were successfully verified against the checksum
+/// recorded in the catalog. A replica is identified by its logical path, replica number, size,
+/// and modification time. If any of those change, previous results no longer apply.
+///
+/// Entries expire after the number of seconds defined by
+/// /irods_client/checksum_cache/timeout_in_seconds. A timeout of 0 disables the cache.
+namespace irods::http::checksum_cache
+{
+	/// The properties of a replica which identify its contents.
+	struct replica_identity
+	{
+		std::string logical_path;
+		int replica_number;
+		std::int64_t size;
+		std::string modify_time;
+	}; // struct replica_identity
+
+	/// Returns whether the cache is enabled.
+	auto enabled() -> bool;
+
+	/// Records that the replica identified by \p _id matches \p _checksum.
+	///
+	/// This function is thread-safe.
+	auto insert(const replica_identity& _id, std::string _checksum) -> void;
+
+	/// Returns the checksum the replica identified by \p _id was verified against.
+	///
+	/// This function is thread-safe.
+	///
+	/// \returns An empty optional if the replica has not been verified or the entry expired.
+	auto find(const replica_identity& _id) -> std::optional<std::string>;
+
+	/// Removes all entries for the data object at \p _logical_path.
+	///
+	/// Must be called after modifying a data object. The modification time of a replica has a
+	/// resolution of one second, so a replica may be modified without changing its identity.
+	///
+	/// This function is thread-safe.
+	auto invalidate(std::string_view _logical_path) -> void;
+} // namespace irods::http::checksum_cache
+
+#endif // IRODS_HTTP_API_CHECKSUM_CACHE_HPP
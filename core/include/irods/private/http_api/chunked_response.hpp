@@ -0,0 +1,115 @@
+#ifndef IRODS_HTTP_API_CHUNKED_RESPONSE_HPP
+#define IRODS_HTTP_API_CHUNKED_RESPONSE_HPP
+
+/// \file
+
+#include "irods/private/http_api/common.hpp"
+#include "irods/private/http_api/memory_budget.hpp"
+
+#include <boost/beast/http/empty_body.hpp>
+#include <boost/beast/http/serializer.hpp>
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+namespace irods::http
+{
+	/// Streams a response body to the client using chunked transfer encoding.
+	///
+	/// Instances are designed to be fed by one or more background tasks. Each call to write()
+	/// produces a single chunk. Writes are queued and transmitted in order on the session's
+	/// executor. Once the number of queued bytes exceeds the configured limit, write() blocks
+	/// until the socket drains. This keeps memory usage bounded regardless of the total size
+	/// of the response.
+	///
+	/// write() and finish() MUST NOT be invoked from the threads servicing HTTP requests.
+	class chunked_response : public std::enable_shared_from_this<chunked_response>
+	{
+	  public:
+		/// The default number of bytes allowed to sit in the queue before write() blocks.
+		static constexpr std::size_t default_max_buffered_bytes = 8 * 1024 * 1024;
+
+		chunked_response(
+			session_pointer_type _sess_ptr,
+			unsigned int _http_version,
+			bool _keep_alive,
+			std::string_view _content_type,
+			std::size_t _max_buffered_bytes = default_max_buffered_bytes);
+
+		chunked_response(const chunked_response&) = delete;
+		auto operator=(const chunked_response&) -> chunked_response& = delete;
+
+		chunked_response(chunked_response&&) = delete;
+		auto operator=(chunked_response&&) -> chunked_response& = delete;
+
+		~chunked_response() = default;
+
+		/// Adds a header field to the response. Must be called before start().
+		auto set(field_type _field, std::string_view _value) -> void;
+
+		/// Asynchronously writes the response headers.
+		auto start() -> void;
+
+		/// Queues \p _data for transmission as a single chunk.
+		///
+		/// Empty strings are ignored.
+		///
+		/// \returns A boolean indicating whether the data was queued. \p false is returned if the
+		/// client's connection is no longer usable, the request was cancelled, or finish() has
+		/// already been called.
+		auto write(std::string _data) -> bool;
+
+		/// Queues the final chunk. The session resumes reading requests once it is sent.
+		///
+		/// If the request was cancelled, this behaves like abort().
+		auto finish() -> void;
+
+		/// Closes the connection once the queued chunks are sent, without sending the final chunk.
+		///
+		/// This allows the client to detect that the response is incomplete. Used when an error
+		/// occurs after the response headers have been sent.
+		auto abort() -> void;
+
+		/// Returns whether the response can no longer be delivered to the client or the request
+		/// was cancelled.
+		auto is_closed() const -> bool;
+
+	  private:
+		auto write_next_chunk() -> void;
+
+		auto on_chunk_written(boost::beast::error_code _ec, std::size_t _bytes_transferred) -> void;
+
+		auto close_on_error(boost::beast::error_code _ec) -> void;
+
+		struct chunk
+		{
+			std::string data;
+
+			// Accounts the chunk against the memory budget while it is queued.
+			memory_budget::reservation reservation;
+		}; // struct chunk
+
+		session_pointer_type sess_ptr_;
+		boost::beast::http::response<boost::beast::http::empty_body> res_;
+		boost::beast::http::response_serializer<boost::beast::http::empty_body> serializer_;
+
+		mutable std::mutex mtx_;
+		std::condition_variable cv_;
+		std::deque<chunk> chunks_;
+		std::size_t buffered_bytes_{};
+		const std::size_t max_buffered_bytes_;
+
+		// Indicates whether an asynchronous write is in progress. The header write counts.
+		bool writing_{true};
+		bool finished_{};
+		bool aborted_{};
+		bool closed_{};
+	}; // class chunked_response
+} // namespace irods::http
+
+#endif // IRODS_HTTP_API_CHUNKED_RESPONSE_HPP
@@ -0,0 +1,79 @@
+#ifndef IRODS_HTTP_API_CIRCUIT_BREAKER_HPP
+#define IRODS_HTTP_API_CIRCUIT_BREAKER_HPP
+
+/// \file
+
+#include <chrono>
+#include <cstddef>
+#include <string_view>
+
+/// Defines the set of free functions used to manage the circuit breaker.
+///
+/// The circuit breaker protects the server from an unhealthy iRODS server. It tracks the
+/// outcome and latency of iRODS calls over a sliding window. Once the proportion of failed or
+/// slow calls exceeds the threshold, the breaker opens and requests fail immediately with an
+/// HTTP status code of 503 instead of blocking background threads. After a cool-down period,
+/// a limited number of trial requests are let through. The breaker closes if they succeed and
+/// opens again if any of them fail.
+///
+/// Only the calls made while obtaining an iRODS connection for a request are recorded, i.e.
+/// the connection pool checkout and rc_switch_user. The calls made by operations are not.
+///
+/// The breaker is configured via /irods_client/circuit_breaker.
+namespace irods::http::circuit_breaker
+{
+	/// The states of the circuit breaker.
+	enum class breaker_state
+	{
+		/// Requests are allowed.
+		closed,
+
+		/// Requests are rejected.
+		open,
+
+		/// A limited number of trial requests are allowed.
+		half_open
+	}; // enum class breaker_state
+
+	/// Returns the name of \p _state.
+	auto to_string(breaker_state _state) -> std::string_view;
+
+	/// The information reported by the circuit breaker.
+	struct statistics
+	{
+		breaker_state state;
+
+		/// The number of calls recorded within the sliding window.
+		std::size_t number_of_calls;
+
+		/// The number of failed or slow calls recorded within the sliding window.
+		std::size_t number_of_failed_calls;
+	}; // struct statistics
+
+	/// Returns whether the circuit breaker is enabled.
+	auto enabled() -> bool;
+
+	/// Returns whether a request is allowed to perform work against iRODS.
+	///
+	/// This function is thread-safe.
+	auto allow_request() -> bool;
+
+	/// Records an iRODS call which completed. The call counts as a failure if it took longer
+	/// than the configured threshold.
+	///
+	/// This function is thread-safe.
+	auto record_success(std::chrono::steady_clock::duration _latency) -> void;
+
+	/// Records an iRODS call which failed because the iRODS server could not be reached or did
+	/// not respond.
+	///
+	/// This function is thread-safe.
+	auto record_failure() -> void;
+
+	/// Returns the current state of the circuit breaker.
+	///
+	/// This function is thread-safe.
+	auto stats() -> statistics;
+} // namespace irods::http::circuit_breaker
+
+#endif // IRODS_HTTP_API_CIRCUIT_BREAKER_HPP
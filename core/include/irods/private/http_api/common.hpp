@@ -18,7 +18,11 @@
 
 #include <nlohmann/json.hpp>
 
+#include <atomic>
 #include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
 #include <memory>
 #include <optional>
 #include <string>
@@ -89,6 +93,13 @@ namespace irods::http
 		{
 		} // constructor
 
+		// Decrements \p _in_use when the connection is returned to the pool.
+		connection_facade(irods::connection_pool::connection_proxy&& _conn, std::atomic<std::size_t>& _in_use)
+			: in_use_{&_in_use}
+			, conn_{std::move(_conn)}
+		{
+		} // constructor
+
 		explicit connection_facade(irods::experimental::client_connection&& _conn)
 			: conn_{std::move(_conn)}
 		{
@@ -133,6 +144,17 @@ namespace irods::http
 		} // get_ref
 
 	  private:
+		struct decrement
+		{
+			auto operator()(std::atomic<std::size_t>* _counter) const noexcept -> void
+			{
+				--*_counter;
+			}
+		}; // struct decrement
+
+		// Declared before conn_ so that the counter is decremented after the connection is released.
+		std::unique_ptr<std::atomic<std::size_t>, decrement> in_use_;
+
 		std::variant<std::monostate, irods::experimental::client_connection, irods::connection_pool::connection_proxy>
 			conn_;
 	}; // class connection_facade
@@ -166,13 +188,80 @@ namespace irods::http
 
 	auto map_json_to_user(const nlohmann::json& _json) -> std::optional<std::string>;
 
+	// Reuses the result held by the innermost client_identity_scope of the calling thread, if any.
 	auto resolve_client_identity(const request_type& _req) -> client_identity_resolution_result;
 
+	// Makes resolve_client_identity() return \p _result for the lifetime of the object, instead
+	// of authenticating the request again. Used by the session to reuse the identity resolved
+	// before the body of the request was read. Passing a null pointer has no effect.
+	class client_identity_scope
+	{
+	  public:
+		explicit client_identity_scope(const client_identity_resolution_result* _result);
+
+		client_identity_scope(const client_identity_scope&) = delete;
+		auto operator=(const client_identity_scope&) -> client_identity_scope& = delete;
+
+		client_identity_scope(client_identity_scope&&) = delete;
+		auto operator=(client_identity_scope&&) -> client_identity_scope& = delete;
+
+		~client_identity_scope();
+
+	  private:
+		const client_identity_resolution_result* previous_;
+	}; // class client_identity_scope
+
+	// Returns the maximum size of the body of a POST request for an operation, or nothing if
+	// /http_server/requests/max_size_of_request_body_in_bytes applies.
+	using body_limit_function_type = std::function<std::optional<std::uint64_t>(std::string_view _op)>;
+
+	// Records the operations supported by an endpoint so that requests for unknown operations
+	// can be rejected before their body is read. Endpoints which dispatch via execute_operation()
+	// define one instance at namespace scope.
+	//
+	// Operations which accept larger bodies than other requests (e.g. archives) can be given a
+	// limit of their own via \p _max_size_of_request_body. The function is only invoked for
+	// requests which pass the operation via the query string.
+	struct operation_registration
+	{
+		operation_registration(
+			request_handler_type _endpoint,
+			const std::unordered_map<std::string, handler_type>& _op_table_get,
+			const std::unordered_map<std::string, handler_type>& _op_table_post,
+			body_limit_function_type _max_size_of_request_body = {});
+	}; // struct operation_registration
+
+	// Returns whether \p _endpoint supports \p _op for requests using \p _method. Returns true if
+	// the endpoint did not register its operations.
+	//
+	// This function is thread-safe.
+	auto is_supported_operation(request_handler_type _endpoint, verb_type _method, std::string_view _op) -> bool;
+
+	// Returns the maximum size of the body of a POST request to \p _endpoint for \p _op, or
+	// nothing if the server-wide limit applies.
+	//
+	// This function is thread-safe.
+	auto max_size_of_request_body(request_handler_type _endpoint, std::string_view _op) -> std::optional<std::uint64_t>;
+
+	// Controls whether execute_operation() may reject a request to protect the iRODS server.
+	enum class admission_control
+	{
+		// The request is subject to the concurrency limiter and the circuit breaker.
+		enabled = 0,
+
+		// For operations which do not talk to iRODS (e.g. /admin). They must stay available
+		// while the server is overloaded, which is when they are needed most.
+		disabled
+	}; // enum class admission_control
+
+	// Dispatches the request to the handler of its operation. If rate limits are enabled, the
+	// request is authenticated and charged against the limits of the client first.
 	auto execute_operation(
 		session_pointer_type _sess_ptr,
 		request_type& _req,
 		const std::unordered_map<std::string, handler_type>& _op_table_get,
-		const std::unordered_map<std::string, handler_type>& _op_table_post) -> void;
+		const std::unordered_map<std::string, handler_type>& _op_table_post,
+		admission_control _admission_control = admission_control::enabled) -> void;
 
 	auto get_port_from_url(boost::urls::url_view _url) -> std::optional<std::string>;
 } // namespace irods::http
@@ -203,6 +292,16 @@ namespace irods
 
 	auto get_connection(const std::string& _username) -> irods::http::connection_facade;
 
+	// A snapshot of the iRODS connection pool. All values are zero when 4.2 compatibility is enabled.
+	struct connection_pool_statistics
+	{
+		std::size_t size;
+		std::size_t number_of_connections_in_use;
+		std::size_t number_of_waiters;
+	}; // struct connection_pool_statistics
+
+	auto connection_pool_stats() -> connection_pool_statistics;
+
 	auto fail(boost::beast::error_code ec, char const* what) -> void;
 
 	auto enable_ticket(RcComm& _comm, const std::string& _ticket) -> int;
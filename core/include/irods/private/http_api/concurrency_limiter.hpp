@@ -0,0 +1,63 @@
+#ifndef IRODS_HTTP_API_CONCURRENCY_LIMITER_HPP
+#define IRODS_HTTP_API_CONCURRENCY_LIMITER_HPP
+
+/// \file
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+
+/// Defines the set of free functions used to manage the adaptive concurrency limiter.
+///
+/// The limiter bounds the number of background tasks which perform work against iRODS on
+/// behalf of requests. The limit is adjusted continuously using the latency of iRODS calls.
+/// It grows while the latency stays near the lowest latency observed recently, and shrinks
+/// once latency rises, which indicates requests are queueing inside the iRODS server. This
+/// is the approach used by TCP Vegas.
+///
+/// Tasks which exceed the limit are queued. Requests are rejected with an HTTP status code of
+/// 503 once the queue is full.
+///
+/// The limiter is configured via /irods_client/concurrency_limiter.
+namespace irods::http::concurrency_limiter
+{
+	/// The information reported by the limiter.
+	struct statistics
+	{
+		std::size_t limit;
+		std::size_t number_of_tasks_in_flight;
+		std::size_t number_of_queued_tasks;
+
+		/// The lowest latency observed recently. Used as the baseline.
+		std::chrono::microseconds min_latency;
+
+		/// A moving average of the latency.
+		std::chrono::microseconds latency;
+	}; // struct statistics
+
+	/// Returns whether the limiter is enabled.
+	auto enabled() -> bool;
+
+	/// Runs \p _task on the background thread pool once the number of tasks in flight is below
+	/// the limit.
+	///
+	/// This function is thread-safe.
+	auto submit(std::function<void()> _task) -> void;
+
+	/// Returns whether the queue is full. New requests must be rejected if this is true.
+	///
+	/// This function is thread-safe.
+	auto is_saturated() -> bool;
+
+	/// Records the latency of a single iRODS call and adjusts the limit.
+	///
+	/// This function is thread-safe.
+	auto record_latency(std::chrono::steady_clock::duration _latency) -> void;
+
+	/// Returns the current state of the limiter.
+	///
+	/// This function is thread-safe.
+	auto stats() -> statistics;
+} // namespace irods::http::concurrency_limiter
+
+#endif // IRODS_HTTP_API_CONCURRENCY_LIMITER_HPP
@@ -0,0 +1,82 @@
+#ifndef IRODS_HTTP_API_DELTA_HPP
+#define IRODS_HTTP_API_DELTA_HPP
+
+/// \file
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+namespace irods::http::delta
+{
+	/// The smallest block size accepted for block signatures.
+	inline constexpr std::uint64_t min_block_size = 512;
+
+	/// Computes the weak checksum of \p _block.
+	///
+	/// The checksum is the rolling checksum used by rsync, computed over unsigned bytes. Given a
+	/// block x of length n:
+	///
+	///     a = (x[0] + x[1] + ... + x[n-1]) mod 2^16
+	///     b = (n * x[0] + (n-1) * x[1] + ... + 1 * x[n-1]) mod 2^16
+	///     checksum = a + (b * 2^16)
+	///
+	/// Clients can roll the checksum one byte at a time, which makes searching a file for matching
+	/// blocks linear in the size of the file.
+	auto weak_checksum(std::string_view _block) -> std::uint32_t;
+
+	/// Returns the block size used when the client does not specify one.
+	///
+	/// The size grows with the square root of \p _data_object_size and is clamped between
+	/// min_block_size and \p _max_block_size.
+	auto default_block_size(std::uint64_t _data_object_size, std::uint64_t _max_block_size) -> std::uint64_t;
+
+	/// A single step in the reconstruction of a data object.
+	struct instruction
+	{
+		enum class kind
+		{
+			/// Copies bytes from the data object as it existed before the delta was applied.
+			copy,
+
+			/// Writes bytes supplied by the client.
+			literal
+		}; // enum class kind
+
+		kind type;
+
+		/// The offset of the bytes in the data object (copy) or the literal bytes (literal).
+		std::uint64_t source_offset;
+
+		/// The offset in the data object that the bytes are written to.
+		std::uint64_t target_offset;
+
+		std::uint64_t length;
+	}; // struct instruction
+
+	/// Parses the JSON array of instructions which make up a delta.
+	///
+	/// Each element is one of the following:
+	///
+	///     {"op": "copy", "block": <integer>, "count": <integer>}
+	///     {"op": "literal", "offset": <integer>, "length": <integer>}
+	///
+	/// Copy instructions reference whole blocks of the data object. The final block of the data
+	/// object may be shorter than \p _block_size. Literal instructions reference a range of
+	/// \p _literals. The data object is rebuilt by concatenating the bytes described by each
+	/// instruction, in order. Copy instructions may reference blocks in any order.
+	///
+	/// \param[in] _json        The instructions.
+	/// \param[in] _block_size  The block size used to compute the signatures.
+	/// \param[in] _source_size The size of the data object before the delta is applied.
+	/// \param[in] _literals    The literal bytes supplied by the client.
+	///
+	/// \throws irods::exception If the instructions are malformed or reference missing bytes.
+	auto parse_instructions(
+		std::string_view _json,
+		std::uint64_t _block_size,
+		std::uint64_t _source_size,
+		std::string_view _literals) -> std::vector<instruction>;
+} // namespace irods::http::delta
+
+#endif // IRODS_HTTP_API_DELTA_HPP
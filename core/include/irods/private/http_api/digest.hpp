@@ -0,0 +1,95 @@
+#ifndef IRODS_HTTP_API_DIGEST_HPP
+#define IRODS_HTTP_API_DIGEST_HPP
+
+/// \file
+
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace irods::http
+{
+	/// The hashing algorithms supported by the digest class.
+	enum class digest_algorithm
+	{
+		md5,
+		sha256
+	}; // enum class digest_algorithm
+
+	/// Incrementally computes a message digest.
+	///
+	/// The implementation is backed by OpenSSL's EVP interface, which selects hardware-accelerated
+	/// implementations (e.g. SHA extensions) when they are available.
+	class digest
+	{
+	  public:
+		explicit digest(digest_algorithm _algorithm);
+
+		digest(const digest&) = delete;
+		auto operator=(const digest&) -> digest& = delete;
+
+		digest(digest&&) noexcept;
+		auto operator=(digest&&) noexcept -> digest&;
+
+		~digest();
+
+		/// Returns the algorithm used by this instance.
+		auto algorithm() const noexcept -> digest_algorithm;
+
+		/// Feeds \p _data into the digest.
+		auto update(std::string_view _data) -> void;
+
+		/// Completes the computation and returns the raw bytes of the digest.
+		///
+		/// The instance cannot be updated afterwards.
+		auto finish() -> std::string;
+
+	  private:
+		struct impl;
+
+		digest_algorithm algorithm_;
+		std::unique_ptr<impl> impl_;
+	}; // class digest
+
+	/// Converts the raw bytes of a digest into the representation used by the iRODS catalog.
+	///
+	/// SHA-256 digests are represented as "sha2:<base64>". MD5 digests are represented as
+	/// lowercase hexadecimal.
+	auto to_irods_checksum(digest_algorithm _algorithm, std::string_view _raw_digest) -> std::string;
+
+	/// Returns the algorithm used to produce \p _checksum, an iRODS checksum string.
+	///
+	/// \returns An empty optional if the algorithm is not supported.
+	auto algorithm_of_irods_checksum(std::string_view _checksum) -> std::optional<digest_algorithm>;
+
+	/// A digest supplied by a client for the content of a request.
+	struct expected_digest
+	{
+		digest_algorithm algorithm;
+
+		/// The base64 encoding of the raw digest, without padding.
+		std::string base64;
+	}; // struct expected_digest
+
+	/// Parses the value of a Content-Digest header (RFC 9530).
+	///
+	/// e.g. sha-256=:X48E9qOokqqrvdts8nOJRJN3OWDUoyWxBf7kbu9DBPE=:
+	///
+	/// \returns An empty optional if the value does not contain a supported algorithm. SHA-256 is
+	/// preferred over MD5 when both are present.
+	auto parse_content_digest_header(std::string_view _value) -> std::optional<expected_digest>;
+
+	/// Parses the value of a Digest header (RFC 3230).
+	///
+	/// e.g. SHA-256=X48E9qOokqqrvdts8nOJRJN3OWDUoyWxBf7kbu9DBPE=
+	///
+	/// \returns An empty optional if the value does not contain a supported algorithm. SHA-256 is
+	/// preferred over MD5 when both are present.
+	auto parse_digest_header(std::string_view _value) -> std::optional<expected_digest>;
+
+	/// Returns whether \p _raw_digest matches the digest supplied by the client.
+	auto matches(const expected_digest& _expected, std::string_view _raw_digest) -> bool;
+} // namespace irods::http
+
+#endif // IRODS_HTTP_API_DIGEST_HPP
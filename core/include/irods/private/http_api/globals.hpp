@@ -8,10 +8,23 @@
 #include <boost/dll.hpp>
 #include <nlohmann/json.hpp>
 
+#include <cstddef>
 #include <functional>
 
 namespace irods::http::globals
 {
+	// A snapshot of the work submitted via background_task().
+	struct background_task_statistics
+	{
+		std::size_t number_of_threads;
+
+		// Tasks which have been submitted but have not started. Includes tasks held back by the
+		// concurrency limiter.
+		std::size_t number_of_queued_tasks;
+
+		std::size_t number_of_running_tasks;
+	}; // struct background_task_statistics
+
 	auto set_configuration(const nlohmann::json& _config) -> void;
 	auto configuration() -> const nlohmann::json&;
 
@@ -21,6 +34,7 @@ namespace irods::http::globals
 	auto set_background_thread_pool(boost::asio::thread_pool& _tp) -> void;
 	auto background_thread_pool() -> boost::asio::thread_pool&;
 	auto background_task(std::function<void()> _task) -> void;
+	auto background_task_stats() -> background_task_statistics;
 
 	auto set_connection_pool(irods::connection_pool& _cp) -> void;
 	auto connection_pool() -> irods::connection_pool&;
@@ -0,0 +1,265 @@
+#ifndef IRODS_HTTP_API_INSTRUMENTED_MUTEX_HPP
+#define IRODS_HTTP_API_INSTRUMENTED_MUTEX_HPP
+
+/// \file
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+/// Defines the types used to measure lock contention.
+///
+/// Locks which sit on hot paths are wrapped in an instrumented_mutex. Each instrumented mutex
+/// reports to a lock_statistics object, which records the number of acquisitions, how many of
+/// them had to wait, and histograms of the time spent waiting for and holding the lock.
+/// Multiple mutexes may report to the same object (e.g. one mutex per parallel write context).
+///
+/// When the statistics are disabled, locking costs one relaxed atomic load on top of the
+/// wrapped mutex.
+///
+/// This header has no dependencies on the rest of the server so that plugins can use it.
+namespace irods::http
+{
+	class lock_statistics
+	{
+	  public:
+		using clock_type = std::chrono::steady_clock;
+
+		/// The upper bounds (inclusive) of the histogram buckets in microseconds. The last
+		/// bucket holds everything above the last bound.
+		static constexpr std::array<std::uint64_t, 11> bucket_bounds_in_microseconds{
+			1, 4, 16, 64, 256, 1'024, 4'096, 16'384, 65'536, 262'144, 1'048'576};
+
+		explicit lock_statistics(std::string _name, bool _enabled = false)
+			: name_{std::move(_name)}
+			, enabled_{_enabled}
+		{
+		} // constructor
+
+		lock_statistics(const lock_statistics&) = delete;
+		auto operator=(const lock_statistics&) -> lock_statistics& = delete;
+
+		lock_statistics(lock_statistics&&) = delete;
+		auto operator=(lock_statistics&&) -> lock_statistics& = delete;
+
+		~lock_statistics() = default;
+
+		auto name() const noexcept -> const std::string&
+		{
+			return name_;
+		} // name
+
+		auto enabled() const noexcept -> bool
+		{
+			return enabled_.load(std::memory_order_relaxed);
+		} // enabled
+
+		auto set_enabled(bool _value) noexcept -> void
+		{
+			enabled_.store(_value, std::memory_order_relaxed);
+		} // set_enabled
+
+		/// Records an acquisition of the lock. \p _contended indicates whether the lock was
+		/// held by another thread when the acquisition started. Uncontended acquisitions are
+		/// counted in the first bucket of the wait time histogram.
+		auto record_acquisition(clock_type::duration _wait, bool _contended) noexcept -> void
+		{
+			acquisitions_.fetch_add(1, std::memory_order_relaxed);
+
+			if (_contended) {
+				contended_acquisitions_.fetch_add(1, std::memory_order_relaxed);
+				record(wait_, _wait);
+			}
+			else {
+				wait_.histogram[0].fetch_add(1, std::memory_order_relaxed);
+			}
+		} // record_acquisition
+
+		auto record_hold(clock_type::duration _hold) noexcept -> void
+		{
+			record(hold_, _hold);
+		} // record_hold
+
+		auto to_json() const -> nlohmann::json
+		{
+			// clang-format off
+			return {
+				{"acquisitions", acquisitions_.load(std::memory_order_relaxed)},
+				{"contended_acquisitions", contended_acquisitions_.load(std::memory_order_relaxed)},
+				{"wait_time", to_json(wait_)},
+				{"hold_time", to_json(hold_)}
+			};
+			// clang-format on
+		} // to_json
+
+	  private:
+		struct distribution
+		{
+			std::atomic<std::uint64_t> total_in_microseconds{};
+			std::atomic<std::uint64_t> max_in_microseconds{};
+			std::array<std::atomic<std::uint64_t>, bucket_bounds_in_microseconds.size() + 1> histogram{};
+		}; // struct distribution
+
+		static auto record(distribution& _d, clock_type::duration _duration) noexcept -> void
+		{
+			const auto us = static_cast<std::uint64_t>(
+				std::max(std::chrono::duration_cast<std::chrono::microseconds>(_duration).count(), std::int64_t{0}));
+
+			_d.total_in_microseconds.fetch_add(us, std::memory_order_relaxed);
+
+			auto max = _d.max_in_microseconds.load(std::memory_order_relaxed);
+			while (us > max && !_d.max_in_microseconds.compare_exchange_weak(max, us, std::memory_order_relaxed)) {
+			}
+
+			const auto iter = std::lower_bound(
+				std::begin(bucket_bounds_in_microseconds), std::end(bucket_bounds_in_microseconds), us);
+			const auto bucket = static_cast<std::size_t>(iter - std::begin(bucket_bounds_in_microseconds));
+
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-constant-array-index)
+			_d.histogram[bucket].fetch_add(1, std::memory_order_relaxed);
+		} // record
+
+		static auto to_json(const distribution& _d) -> nlohmann::json
+		{
+			// The counts line up with bucket_bounds_in_microseconds. The last count is for the
+			// observations above the last bound.
+			auto histogram = nlohmann::json::array();
+
+			for (auto&& count : _d.histogram) {
+				histogram.push_back(count.load(std::memory_order_relaxed));
+			}
+
+			// clang-format off
+			return {
+				{"total_in_microseconds", _d.total_in_microseconds.load(std::memory_order_relaxed)},
+				{"max_in_microseconds", _d.max_in_microseconds.load(std::memory_order_relaxed)},
+				{"histogram", histogram}
+			};
+			// clang-format on
+		} // to_json
+
+		const std::string name_;
+		std::atomic<bool> enabled_;
+		std::atomic<std::uint64_t> acquisitions_{};
+		std::atomic<std::uint64_t> contended_acquisitions_{};
+		distribution wait_;
+		distribution hold_;
+	}; // class lock_statistics
+
+	/// A mutex which reports to a lock_statistics object.
+	///
+	/// Satisfies the Lockable requirements, and the SharedLockable requirements if \p Mutex does.
+	/// Hold times are only measured for exclusive ownership because shared ownership may be held
+	/// by many threads at once.
+	template <typename Mutex>
+	class instrumented_mutex
+	{
+	  public:
+		explicit instrumented_mutex(lock_statistics& _stats)
+			: stats_{&_stats}
+		{
+		} // constructor
+
+		instrumented_mutex(const instrumented_mutex&) = delete;
+		auto operator=(const instrumented_mutex&) -> instrumented_mutex& = delete;
+
+		instrumented_mutex(instrumented_mutex&&) = delete;
+		auto operator=(instrumented_mutex&&) -> instrumented_mutex& = delete;
+
+		~instrumented_mutex() = default;
+
+		auto lock() -> void
+		{
+			if (!stats_->enabled()) {
+				mtx_.lock();
+				return;
+			}
+
+			if (mtx_.try_lock()) {
+				stats_->record_acquisition({}, false);
+			}
+			else {
+				const auto start = lock_statistics::clock_type::now();
+				mtx_.lock();
+				stats_->record_acquisition(lock_statistics::clock_type::now() - start, true);
+			}
+
+			locked_at_ = lock_statistics::clock_type::now();
+		} // lock
+
+		auto try_lock() -> bool
+		{
+			if (!mtx_.try_lock()) {
+				return false;
+			}
+
+			if (stats_->enabled()) {
+				stats_->record_acquisition({}, false);
+				locked_at_ = lock_statistics::clock_type::now();
+			}
+
+			return true;
+		} // try_lock
+
+		auto unlock() -> void
+		{
+			// The statistics may have been enabled while the lock was held.
+			if (locked_at_ != lock_statistics::clock_type::time_point{}) {
+				stats_->record_hold(lock_statistics::clock_type::now() - locked_at_);
+				locked_at_ = {};
+			}
+
+			mtx_.unlock();
+		} // unlock
+
+		auto lock_shared() -> void
+		{
+			if (!stats_->enabled()) {
+				mtx_.lock_shared();
+				return;
+			}
+
+			if (mtx_.try_lock_shared()) {
+				stats_->record_acquisition({}, false);
+				return;
+			}
+
+			const auto start = lock_statistics::clock_type::now();
+			mtx_.lock_shared();
+			stats_->record_acquisition(lock_statistics::clock_type::now() - start, true);
+		} // lock_shared
+
+		auto try_lock_shared() -> bool
+		{
+			if (!mtx_.try_lock_shared()) {
+				return false;
+			}
+
+			if (stats_->enabled()) {
+				stats_->record_acquisition({}, false);
+			}
+
+			return true;
+		} // try_lock_shared
+
+		auto unlock_shared() -> void
+		{
+			mtx_.unlock_shared();
+		} // unlock_shared
+
+	  private:
+		lock_statistics* stats_;
+		Mutex mtx_;
+
+		// The time at which exclusive ownership was acquired. Only accessed by the owner.
+		lock_statistics::clock_type::time_point locked_at_{};
+	}; // class instrumented_mutex
+} // namespace irods::http
+
+#endif // IRODS_HTTP_API_INSTRUMENTED_MUTEX_HPP
@@ -0,0 +1,40 @@
+#ifndef IRODS_HTTP_API_LOCK_INSTRUMENTATION_HPP
+#define IRODS_HTTP_API_LOCK_INSTRUMENTATION_HPP
+
+/// \file
+
+#include "irods/private/http_api/instrumented_mutex.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <string_view>
+
+/// Defines the set of free functions used to manage the statistics of instrumented locks.
+///
+/// Instrumentation is configured via /http_server/lock_instrumentation.
+namespace irods::http::lock_instrumentation
+{
+	/// Returns the statistics identified by \p _name, creating them if necessary.
+	///
+	/// The returned reference is valid for the lifetime of the process. This function may be
+	/// used to initialize objects with static storage duration.
+	///
+	/// This function is thread-safe.
+	auto statistics(std::string_view _name) -> lock_statistics&;
+
+	/// Enables or disables all statistics, including those created afterwards.
+	///
+	/// This function is thread-safe.
+	auto set_enabled(bool _value) -> void;
+
+	/// This function is thread-safe.
+	auto enabled() -> bool;
+
+	/// Returns the statistics of all instrumented locks, keyed by name. Includes the locks of
+	/// the user mapping plugin if it reports them.
+	///
+	/// This function is thread-safe.
+	auto to_json() -> nlohmann::json;
+} // namespace irods::http::lock_instrumentation
+
+#endif // IRODS_HTTP_API_LOCK_INSTRUMENTATION_HPP
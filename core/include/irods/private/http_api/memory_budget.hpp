@@ -0,0 +1,89 @@
+#ifndef IRODS_HTTP_API_MEMORY_BUDGET_HPP
+#define IRODS_HTTP_API_MEMORY_BUDGET_HPP
+
+/// \file
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+
+/// Defines the set of free functions used to manage the memory budget.
+///
+/// The memory budget bounds the number of bytes held by buffered request bodies and response
+/// buffers across all sessions. Sessions reserve the size of a request body before reading it.
+/// If the budget is exhausted, the session stops reading from the socket until enough bytes
+/// are released. This applies TCP backpressure to clients instead of allocating memory.
+///
+/// The budget is defined by /http_server/requests/max_size_of_buffered_data_in_bytes. A value
+/// of 0 disables the budget.
+namespace irods::http::memory_budget
+{
+	/// Represents bytes accounted against the budget. The bytes are released when the
+	/// reservation is destroyed.
+	class reservation
+	{
+	  public:
+		reservation() = default;
+
+		reservation(const reservation&) = delete;
+		auto operator=(const reservation&) -> reservation& = delete;
+
+		reservation(reservation&& _other) noexcept;
+		auto operator=(reservation&& _other) noexcept -> reservation&;
+
+		~reservation();
+
+		/// Returns the number of bytes held by the reservation.
+		auto size() const noexcept -> std::uint64_t
+		{
+			return size_;
+		} // size
+
+		/// Returns the bytes to the budget.
+		auto release() noexcept -> void;
+
+	  private:
+		friend auto acquire(std::uint64_t _size) -> reservation;
+		friend auto async_reserve(std::uint64_t _size, std::function<void(reservation)> _handler) -> void;
+
+		explicit reservation(std::uint64_t _size) noexcept
+			: size_{_size}
+		{
+		} // reservation (constructor)
+
+		std::uint64_t size_{};
+	}; // class reservation
+
+	/// Returns the maximum number of bytes which can be reserved. 0 means unlimited.
+	auto limit() -> std::uint64_t;
+
+	/// Returns the number of bytes currently reserved.
+	///
+	/// This function is thread-safe.
+	auto usage() -> std::uint64_t;
+
+	/// Returns the number of reservations waiting for bytes to be released.
+	///
+	/// This function is thread-safe.
+	auto number_of_waiters() -> std::size_t;
+
+	/// Reserves \p _size bytes without waiting, even if doing so exceeds the budget.
+	///
+	/// Used for buffers which cannot wait, such as the chunks of a response which is already
+	/// being streamed. The bytes still delay reservations made via async_reserve().
+	///
+	/// This function is thread-safe.
+	auto acquire(std::uint64_t _size) -> reservation;
+
+	/// Reserves \p _size bytes and passes the reservation to \p _handler.
+	///
+	/// If the bytes are available, \p _handler is invoked before this function returns.
+	/// Otherwise, \p _handler is invoked by the thread which releases enough bytes. Waiting
+	/// reservations are granted in the order they were made. A reservation which is larger than
+	/// the budget is granted once no other bytes are reserved.
+	///
+	/// This function is thread-safe.
+	auto async_reserve(std::uint64_t _size, std::function<void(reservation)> _handler) -> void;
+} // namespace irods::http::memory_budget
+
+#endif // IRODS_HTTP_API_MEMORY_BUDGET_HPP
@@ -9,6 +9,8 @@
 #include <boost/beast/http/string_body.hpp>
 #include <boost/url/url_view.hpp>
 
+#include <chrono>
+#include <cstddef>
 #include <optional>
 #include <string>
 
@@ -47,6 +49,24 @@ namespace irods::http::openid
 	/// is returned
 	auto validate_using_local_validation(token_type _type, const jwt::decoded_jwt<jwt::traits::nlohmann_json>& _jwt)
 		-> std::optional<nlohmann::json>;
+
+	/// Describes the JWKs cached for local validation.
+	struct jwks_cache_statistics
+	{
+		/// Whether the JWKs have been fetched from the OpenID Provider. They are fetched when the
+		/// first token is validated locally.
+		bool loaded;
+
+		std::size_t number_of_keys;
+
+		/// The time since the JWKs were fetched.
+		std::chrono::steady_clock::duration age;
+	}; // struct jwks_cache_statistics
+
+	/// Returns the state of the JWKs cache.
+	///
+	/// This function is thread-safe.
+	auto jwks_cache_stats() -> jwks_cache_statistics;
 } //namespace irods::http::openid
 
 #endif // IRODS_HTTP_API_OPENID_HPP
@@ -7,7 +7,9 @@
 // because it produces the correct results when used across shared library boundaries.
 #include <boost/any.hpp>
 
+#include <cstddef>
 #include <functional>
+#include <map>
 #include <optional>
 #include <string>
 #include <vector>
@@ -84,6 +86,13 @@ namespace irods::http::process_stash
 	///
 	/// \since 4.2.12
 	auto handles() -> std::vector<std::string>;
+
+	/// Returns the number of objects in the process stash, grouped by type.
+	///
+	/// The keys are the demangled names of the stored types.
+	///
+	/// This function is thread-safe.
+	auto count_by_type() -> std::map<std::string, std::size_t>;
 } // namespace irods::http::process_stash
 
 #endif // IRODS_HTTP_PROCESS_STASH_HPP
@@ -0,0 +1,86 @@
+#ifndef IRODS_HTTP_API_PROFILER_HPP
+#define IRODS_HTTP_API_PROFILER_HPP
+
+/// \file
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+
+/// Defines the set of free functions used to profile the running server.
+///
+/// CPU profiles are captured by sampling. While a profile is being captured, a timer measuring
+/// the CPU time consumed by the process delivers SIGPROF at the requested frequency. The signal
+/// handler records the call stack of the interrupted thread into a buffer which is allocated up
+/// front. Once the profile ends, the stacks are symbolized in-process and aggregated into the
+/// folded-stack format understood by flame graph tools (one line per unique stack, frames
+/// separated by semicolons from the root to the leaf, followed by the number of samples).
+///
+/// Frames which cannot be symbolized are reported as the name of the containing module and
+/// the offset of the frame within it so that they can be resolved offline (e.g. via addr2line).
+///
+/// Only one profile can be captured at a time. No cost is incurred while no profile is being
+/// captured.
+namespace irods::http::profiler
+{
+	/// The result of a CPU profile.
+	struct cpu_profile
+	{
+		std::chrono::milliseconds duration;
+
+		std::uint64_t number_of_samples;
+
+		/// The number of samples which did not fit in the buffer.
+		std::uint64_t number_of_dropped_samples;
+
+		/// The samples aggregated by call stack in folded-stack format.
+		std::string folded_stacks;
+	}; // struct cpu_profile
+
+	/// The state of the heap as reported by the memory allocator.
+	struct heap_statistics
+	{
+		/// The number of bytes obtained from the system via sbrk.
+		std::uint64_t arena_bytes;
+
+		/// The number of bytes obtained from the system via mmap.
+		std::uint64_t mmapped_bytes;
+
+		/// The number of bytes allocated by the application.
+		std::uint64_t in_use_bytes;
+
+		/// The number of bytes held by the allocator which are not in use.
+		std::uint64_t free_bytes;
+
+		/// The number of free bytes at the top of the heap which could be returned to the system.
+		std::uint64_t releasable_bytes;
+
+		/// The resident set size of the process.
+		std::uint64_t resident_bytes;
+	}; // struct heap_statistics
+
+	/// Captures a CPU profile of all threads of the process.
+	///
+	/// Blocks the calling thread for the duration of the profile.
+	///
+	/// This function is thread-safe.
+	///
+	/// \param[in] _duration  The amount of time to sample for.
+	/// \param[in] _frequency The number of samples to take per second of CPU time.
+	///
+	/// \returns The profile, or an empty optional if another profile is being captured.
+	///
+	/// \throws std::runtime_error If the profiling timer cannot be armed.
+	auto profile_cpu(std::chrono::seconds _duration, int _frequency) -> std::optional<cpu_profile>;
+
+	/// Returns the state of the heap.
+	///
+	/// The allocator statistics are only available when built against glibc 2.33 or later.
+	/// Otherwise, they are reported as 0.
+	///
+	/// This function is thread-safe.
+	auto heap_stats() -> heap_statistics;
+} // namespace irods::http::profiler
+
+#endif // IRODS_HTTP_API_PROFILER_HPP
@@ -0,0 +1,49 @@
+#ifndef IRODS_HTTP_API_RATE_LIMITER_HPP
+#define IRODS_HTTP_API_RATE_LIMITER_HPP
+
+/// \file
+
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// Defines the set of free functions used to enforce rate limits.
+///
+/// Requests and request body bytes are limited per authenticated user and per bearer token.
+/// Each limit is a token bucket which allows bursts of up to the configured number of seconds
+/// worth of traffic. Buckets are implemented using the generic cell rate algorithm. A request is
+/// only charged if every bucket of its user and bearer token allows it, so rejected requests do
+/// not use up any quota. Buckets are stored in sharded maps to keep contention between requests
+/// of different clients low.
+///
+/// The limits are configured via /http_server/rate_limits. A rate of 0 disables the limit.
+namespace irods::http::rate_limiter
+{
+	/// Returns whether any rate limit is enabled.
+	auto enabled() -> bool;
+
+	/// Charges a request carrying \p _bytes bytes against the limits of \p _username and
+	/// \p _bearer_token.
+	///
+	/// This function is thread-safe.
+	///
+	/// \returns An empty optional if the request is allowed. Otherwise, the amount of time the
+	/// client should wait before trying again.
+	auto check(std::string_view _username, std::string_view _bearer_token, std::uint64_t _bytes)
+		-> std::optional<std::chrono::seconds>;
+
+	/// Returns the number of requests rejected by the rate limits.
+	///
+	/// This function is thread-safe.
+	auto number_of_rejected_requests() -> std::uint64_t;
+
+	/// Returns the number of requests rejected by the rate limits, per user.
+	///
+	/// This function is thread-safe.
+	auto number_of_rejected_requests_per_user() -> std::map<std::string, std::uint64_t, std::less<>>;
+} // namespace irods::http::rate_limiter
+
+#endif // IRODS_HTTP_API_RATE_LIMITER_HPP
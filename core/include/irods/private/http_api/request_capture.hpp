@@ -0,0 +1,45 @@
+#ifndef IRODS_HTTP_API_REQUEST_CAPTURE_HPP
+#define IRODS_HTTP_API_REQUEST_CAPTURE_HPP
+
+/// \file
+
+#include "irods/private/http_api/common.hpp"
+
+#include <chrono>
+
+/// Defines the set of free functions used to capture requests so that they can be replayed.
+///
+/// Each captured request is written to the capture file as a single line of JSON holding the
+/// time at which its header arrived, its method, path, query parameters, headers and body.
+/// Form data is recorded field by field. Credentials are never written. The values of the
+/// Authorization, Cookie and Proxy-Authorization headers, and of parameters which carry
+/// secrets (e.g. password, ticket), are replaced with "<redacted>". The contents of data
+/// objects (i.e. the bytes parameter of a write) are always replaced by their size, as are
+/// values which are larger than the configured limit or which are not valid UTF-8. The capture
+/// file is created with mode 0600 and its mode is reset to 0600 if it already exists.
+///
+/// The first line written after the file is opened describes the capture. Times are relative
+/// to the start of the capture, therefore, a file which is appended to by several runs of the
+/// server holds one segment per run. See test/replay_requests.py for a tool which re-issues a
+/// capture against a server.
+///
+/// Requests are serialized and written by a dedicated thread. Requests are dropped from the
+/// capture rather than delayed when the number of requests or the number of bytes waiting for
+/// the thread exceeds its limit.
+///
+/// Capturing is configured via /http_server/request_capture.
+namespace irods::http::request_capture
+{
+	/// Returns whether requests are captured.
+	auto enabled() -> bool;
+
+	/// Captures \p _req if capturing is enabled and the request is sampled.
+	///
+	/// This function is thread-safe.
+	///
+	/// \param[in] _req         The request. Its body must have been read.
+	/// \param[in] _received_at The time at which the header of the request arrived.
+	auto capture(const request_type& _req, std::chrono::steady_clock::time_point _received_at) -> void;
+} // namespace irods::http::request_capture
+
+#endif // IRODS_HTTP_API_REQUEST_CAPTURE_HPP
@@ -1,16 +1,59 @@
 #ifndef IRODS_HTTP_API_SESSION_HPP
 #define IRODS_HTTP_API_SESSION_HPP
 
+#include "irods/private/http_api/allocation_accounting.hpp"
 #include "irods/private/http_api/common.hpp"
+#include "irods/private/http_api/memory_budget.hpp"
+#include "irods/private/http_api/slow_requests.hpp"
+#include "irods/private/http_api/timing_wheel.hpp"
+#include "irods/private/http_api/tracing.hpp"
 
 #include <boost/beast/core.hpp>
 #include <boost/beast/http.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
 #include <optional>
+#include <string>
+#include <vector>
 
 namespace irods::http
 {
+	// The stages a session moves through while serving requests.
+	enum class session_state : std::uint8_t
+	{
+		reading_header,
+		waiting_for_memory,
+		reading_body,
+		processing,
+		writing,
+		closed,
+
+		// Must be last.
+		count
+	}; // enum class session_state
+
+	auto to_string(session_state _state) -> const char*;
+
+	struct session_info
+	{
+		std::string ip;
+		session_state state;
+		std::chrono::steady_clock::duration time_in_state;
+	}; // struct session_info
+
+	struct sessions_snapshot
+	{
+		std::array<std::size_t, static_cast<std::size_t>(session_state::count)> number_of_sessions_by_state;
+
+		// Holds at most the number of sessions requested by the caller.
+		std::vector<session_info> sessions;
+	}; // struct sessions_snapshot
+
 	class session : public std::enable_shared_from_this<session>
 	{
 	  public:
@@ -18,20 +61,52 @@ namespace irods::http
 			boost::asio::ip::tcp::socket&& socket,
 			const request_handler_map_type& _request_handler_map,
 			int _max_body_size,
-			int _timeout_in_seconds);
+			std::shared_ptr<timing_wheel> _timing_wheel,
+			std::chrono::seconds _header_timeout,
+			std::chrono::seconds _body_timeout);
+
+		session(const session&) = delete;
+		auto operator=(const session&) -> session& = delete;
+
+		session(session&&) = delete;
+		auto operator=(session&&) -> session& = delete;
+
+		~session();
 
 		auto ip() const -> std::string;
 
+		// Returns the state of all live sessions. At most \p _max_sessions are listed.
+		//
+		// This function is thread-safe.
+		static auto snapshot(std::size_t _max_sessions) -> sessions_snapshot;
+
 		auto run() -> void;
 
 		auto do_read() -> void;
 
+		auto on_read_header(boost::beast::error_code ec, std::size_t bytes_transferred) -> void;
+
+		auto do_read_body() -> void;
+
 		auto on_read(boost::beast::error_code ec, std::size_t bytes_transferred) -> void;
 
 		auto on_write(bool close, boost::beast::error_code ec, std::size_t bytes_transferred) -> void;
 
 		auto do_close() -> void;
 
+		// Closes the connection. Invoked by the timing wheel when a timeout expires or the
+		// session is evicted from the set of idle sessions.
+		//
+		// This function is thread-safe.
+		auto on_timeout() -> void;
+
+		// Returns whether the work for the current request should stop. This is the case when
+		// the client disconnected or the deadline supplied via the X-Request-Timeout header
+		// passed. Long running operations should check this between iRODS calls.
+		//
+		// This function is thread-safe.
+		auto is_cancelled() const -> bool;
+
 		auto stream() -> boost::beast::tcp_stream&
 		{
 			return stream_;
@@ -50,6 +125,25 @@ namespace irods::http
 			// Store a type-erased version of the shared
 			// pointer in the class to keep it alive.
 			res_ = sp;
+			set_state(session_state::writing);
+			response_reservation_ = memory_budget::acquire(sp->payload_size().value_or(0));
+
+			if (trace_) {
+				if constexpr (!isRequest) {
+					trace_->set_attribute("http.response.status_code", static_cast<std::int64_t>(sp->result_int()));
+				}
+			}
+
+			if (timings_) {
+				timings_->add_bytes_sent(sp->payload_size().value_or(0));
+			}
+
+			if (trace_ || timings_) {
+				write_started_at_ = tracing::now();
+			}
+
+			// A client which stops reading must not hold on to the session forever.
+			timing_wheel_->schedule(timeout_, body_timeout_);
 
 			// Write the response.
 			http::async_write(
@@ -57,14 +151,67 @@ namespace irods::http
 		} // send
 
 	  private:
+		auto set_state(session_state _state) -> void;
+
+		// Returns a response if the request must be rejected before its body is read.
+		auto check_request_header() -> std::optional<response_type>;
+
+		// Reserves memory for the body of the request, then reads it. Reading is paused until
+		// the memory budget allows the body to be buffered.
+		auto reserve_body() -> void;
+
+		auto on_body_reserved(memory_budget::reservation _reservation) -> void;
+
+		// Sends a response and closes the connection. Used when the body of the request was
+		// not read.
+		auto reject(response_type&& _response) -> void;
+
+		// Records the time spent writing the response, exports the trace of the current request,
+		// adds its allocations to the totals and reports the request if it was slow.
+		auto finish_instrumentation() -> void;
+
+		// Marks the request as cancelled if the client closes the connection while the
+		// request is being processed. Bytes of pipelined requests which arrive in the meantime
+		// are moved into the read buffer. Must be called from the executor of the session.
+		auto watch_for_disconnect() -> void;
+
+		// Stops watching for the client to close the connection. Must be called from the
+		// executor of the session before reading the next request.
+		auto stop_watching_for_disconnect() -> void;
+
 		boost::beast::tcp_stream stream_;
 		boost::beast::flat_buffer buffer_;
 		std::optional<boost::beast::http::request_parser<boost::beast::http::string_body>> parser_;
 		std::shared_ptr<void> res_; // TODO Probably doesn't need to be a shared_ptr anymore. The session owns it and is
 		                            // available for the lifetime of the request.
+		memory_budget::reservation body_reservation_;
+		memory_budget::reservation response_reservation_;
+		std::shared_ptr<tracing::trace> trace_;
+		std::shared_ptr<slow_requests::request_record> timings_;
+		std::shared_ptr<allocation_accounting::request_record> allocations_;
+
+		// The identity of the client, if the request was authenticated before its body was read.
+		std::optional<client_identity_resolution_result> client_identity_;
+
+		std::chrono::steady_clock::time_point header_received_at_;
+		std::int64_t body_read_started_at_{};
+		std::int64_t write_started_at_{};
+		std::string ip_;
+		std::atomic<session_state> state_{session_state::reading_header};
+		std::atomic<std::chrono::steady_clock::time_point> state_changed_at_{std::chrono::steady_clock::now()};
+		std::atomic<bool> cancelled_{};
+		bool watching_for_disconnect_{};
+		std::atomic<std::chrono::steady_clock::time_point> deadline_{std::chrono::steady_clock::time_point::max()};
 		const request_handler_map_type* req_handlers_;
 		const int max_body_size_;
-		const int timeout_in_secs_;
+
+		// The maximum size of the body of the current request.
+		std::uint64_t body_limit_{};
+
+		const std::shared_ptr<timing_wheel> timing_wheel_;
+		timing_wheel::entry timeout_;
+		const std::chrono::seconds header_timeout_;
+		const std::chrono::seconds body_timeout_;
 	}; // class session
 } // namespace irods::http
 
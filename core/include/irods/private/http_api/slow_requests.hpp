@@ -0,0 +1,214 @@
+#ifndef IRODS_HTTP_API_SLOW_REQUESTS_HPP
+#define IRODS_HTTP_API_SLOW_REQUESTS_HPP
+
+/// \file
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/// Defines the types and free functions used to detect slow requests.
+///
+/// Unlike tracing, the detector is always on. Every request records the time spent in a small
+/// set of phases using a few clock reads and atomic additions. Requests which take longer than
+/// the configured threshold are logged along with the breakdown, and the slowest of them are
+/// kept in memory so that they can be retrieved via the admin endpoint.
+///
+/// The record of the request being processed by the current thread is held in a thread-local
+/// variable. It is carried into background threads by irods::http::globals::background_task.
+///
+/// The detector is configured via /http_server/slow_requests.
+namespace irods::http::slow_requests
+{
+	/// The phases measured for each request.
+	enum class phase : std::size_t
+	{
+		/// The time spent waiting for a background thread.
+		queue_wait,
+
+		/// The time spent waiting for an iRODS connection from the connection pool.
+		connection_checkout,
+
+		/// The time spent changing the identity associated with an iRODS connection.
+		switch_user,
+
+		/// The time spent running background tasks. Includes the time spent checking out
+		/// connections and switching users.
+		background_task,
+
+		/// The time spent writing the response.
+		write,
+
+		// Must be last.
+		count
+	}; // enum class phase
+
+	/// A request which exceeded the threshold.
+	struct entry
+	{
+		std::chrono::system_clock::time_point finished_at;
+		std::string endpoint;
+		std::string operation;
+		std::string username;
+		std::uint64_t bytes_received;
+		std::uint64_t bytes_sent;
+
+		/// The bytes allocated via operator new while processing the request. Only recorded
+		/// when allocation accounting is enabled.
+		std::uint64_t bytes_allocated;
+
+		/// The number of allocations made via operator new while processing the request. Only
+		/// recorded when allocation accounting is enabled.
+		std::uint64_t number_of_allocations;
+
+		std::chrono::microseconds duration;
+		std::chrono::microseconds queue_wait;
+		std::chrono::microseconds connection_checkout;
+		std::chrono::microseconds switch_user;
+
+		/// The time spent in background tasks which was not spent checking out connections
+		/// or switching users. This is dominated by iRODS calls.
+		std::chrono::microseconds irods;
+
+		std::chrono::microseconds write;
+	}; // struct entry
+
+	/// The timings of a single request.
+	///
+	/// Instances are shared by all threads working on the request.
+	class request_record
+	{
+	  public:
+		explicit request_record(std::string_view _endpoint);
+
+		request_record(const request_record&) = delete;
+		auto operator=(const request_record&) -> request_record& = delete;
+
+		request_record(request_record&&) = delete;
+		auto operator=(request_record&&) -> request_record& = delete;
+
+		~request_record() = default;
+
+		/// Adds \p _duration to the time spent in \p _phase.
+		///
+		/// This function is thread-safe.
+		auto add(phase _phase, std::chrono::steady_clock::duration _duration) -> void
+		{
+			durations_[static_cast<std::size_t>(_phase)].fetch_add(_duration.count(), std::memory_order_relaxed);
+		} // add
+
+		/// This function is thread-safe.
+		auto set_operation(std::string_view _operation) -> void;
+
+		/// This function is thread-safe.
+		auto set_username(std::string_view _username) -> void;
+
+		/// This function is thread-safe.
+		auto add_bytes_received(std::uint64_t _bytes) -> void
+		{
+			bytes_received_.fetch_add(_bytes, std::memory_order_relaxed);
+		} // add_bytes_received
+
+		/// This function is thread-safe.
+		auto add_bytes_sent(std::uint64_t _bytes) -> void
+		{
+			bytes_sent_.fetch_add(_bytes, std::memory_order_relaxed);
+		} // add_bytes_sent
+
+		/// Sets the allocations made while processing the request.
+		///
+		/// This function is thread-safe.
+		auto set_allocations(std::uint64_t _bytes, std::uint64_t _count) -> void
+		{
+			bytes_allocated_.store(_bytes, std::memory_order_relaxed);
+			number_of_allocations_.store(_count, std::memory_order_relaxed);
+		} // set_allocations
+
+		/// Ends the request. If it exceeded the threshold, it is logged and considered for the
+		/// list of slowest requests.
+		auto finish() -> void;
+
+	  private:
+		const std::chrono::steady_clock::time_point start_;
+		const std::string endpoint_;
+
+		std::mutex mtx_;
+		std::string operation_;
+		std::string username_;
+
+		std::atomic<std::uint64_t> bytes_received_{};
+		std::atomic<std::uint64_t> bytes_sent_{};
+		std::atomic<std::uint64_t> bytes_allocated_{};
+		std::atomic<std::uint64_t> number_of_allocations_{};
+		std::array<std::atomic<std::chrono::steady_clock::rep>, static_cast<std::size_t>(phase::count)> durations_{};
+	}; // class request_record
+
+	/// Returns whether slow requests are detected.
+	auto enabled() -> bool;
+
+	/// Returns a new record for a request to \p _endpoint, or a null pointer if the detector is
+	/// disabled.
+	auto start(std::string_view _endpoint) -> std::shared_ptr<request_record>;
+
+	/// Returns the record of the request being processed by the current thread, if any.
+	auto current() -> request_record*;
+
+	/// Makes \p _record the record of the current thread for the lifetime of the object.
+	class scope
+	{
+	  public:
+		explicit scope(std::shared_ptr<request_record> _record);
+
+		scope(const scope&) = delete;
+		auto operator=(const scope&) -> scope& = delete;
+
+		scope(scope&&) = delete;
+		auto operator=(scope&&) -> scope& = delete;
+
+		~scope();
+
+	  private:
+		std::shared_ptr<request_record> previous_;
+	}; // class scope
+
+	/// Adds the lifetime of the object to a phase of the request being processed by the current
+	/// thread. Does nothing if the current thread has no record.
+	class timer
+	{
+	  public:
+		explicit timer(phase _phase);
+
+		timer(const timer&) = delete;
+		auto operator=(const timer&) -> timer& = delete;
+
+		timer(timer&&) = delete;
+		auto operator=(timer&&) -> timer& = delete;
+
+		~timer();
+
+	  private:
+		request_record* record_;
+		phase phase_;
+		std::chrono::steady_clock::time_point start_;
+	}; // class timer
+
+	/// Returns a function which runs \p _task with the record of the current thread. The time
+	/// spent waiting for the task to start and running it is recorded. Returns \p _task
+	/// unchanged if the current thread has no record.
+	auto wrap(std::function<void()> _task) -> std::function<void()>;
+
+	/// Returns the slowest recent requests which exceeded the threshold, slowest first.
+	///
+	/// This function is thread-safe.
+	auto slowest() -> std::vector<entry>;
+} // namespace irods::http::slow_requests
+
+#endif // IRODS_HTTP_API_SLOW_REQUESTS_HPP
@@ -0,0 +1,146 @@
+#ifndef IRODS_HTTP_API_TIMING_WHEEL_HPP
+#define IRODS_HTTP_API_TIMING_WHEEL_HPP
+
+/// \file
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/steady_timer.hpp>
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace irods::http
+{
+	class session;
+
+	/// Manages the read timeouts and idle state of every session served by an io_context.
+	///
+	/// Sessions do not arm a timer of their own. Instead, the wheel advances one slot per tick
+	/// using a single timer and closes the sessions whose timeout expired. Scheduling, cancelling,
+	/// and expiring a timeout are O(1) and do not allocate memory.
+	///
+	/// The wheel has two levels with the same number of slots. A slot of the lower level spans
+	/// one tick and a slot of the upper level spans one revolution of the lower level. Timeouts
+	/// which do not fit in the lower level are placed in the upper level and moved down when the
+	/// lower level reaches their revolution, so a tick only visits the timeouts which expire.
+	/// Timeouts which do not fit in the upper level either stay in it for further revolutions.
+	///
+	/// The wheel also tracks the sessions waiting for their next request. If the number of idle
+	/// sessions exceeds the configured limit, or the memory budget has waiters or is nearly
+	/// exhausted, the sessions which have been idle the longest are closed.
+	///
+	/// All member functions are thread-safe.
+	class timing_wheel : public std::enable_shared_from_this<timing_wheel>
+	{
+	  public:
+		/// The timeout state of a session. The entry is owned by the session and linked into the
+		/// wheel while a timeout is scheduled or the session is idle.
+		class entry
+		{
+		  public:
+			explicit entry(session& _session) noexcept
+				: session_{&_session}
+			{
+			} // entry (constructor)
+
+			entry(const entry&) = delete;
+			auto operator=(const entry&) -> entry& = delete;
+
+			entry(entry&&) = delete;
+			auto operator=(entry&&) -> entry& = delete;
+
+			~entry() = default;
+
+		  private:
+			friend class timing_wheel;
+
+			session* session_;
+
+			// Links into a slot of the wheel.
+			entry* prev_{};
+			entry* next_{};
+			std::size_t level_{};
+			std::size_t slot_{};
+			std::uint64_t expires_at_{};
+			bool scheduled_{};
+
+			// Links into the list of idle sessions.
+			entry* idle_prev_{};
+			entry* idle_next_{};
+			bool idle_{};
+		}; // class entry
+
+		/// \param[in] _io                   The io_context which drives the wheel.
+		/// \param[in] _tick_interval        The amount of time represented by a single slot.
+		/// \param[in] _number_of_slots      The number of slots in each level of the wheel.
+		/// \param[in] _max_number_of_idle   The maximum number of idle sessions. 0 means unlimited.
+		timing_wheel(
+			boost::asio::io_context& _io,
+			std::chrono::milliseconds _tick_interval,
+			std::size_t _number_of_slots,
+			std::size_t _max_number_of_idle);
+
+		timing_wheel(const timing_wheel&) = delete;
+		auto operator=(const timing_wheel&) -> timing_wheel& = delete;
+
+		timing_wheel(timing_wheel&&) = delete;
+		auto operator=(timing_wheel&&) -> timing_wheel& = delete;
+
+		~timing_wheel() = default;
+
+		/// Starts advancing the wheel.
+		auto start() -> void;
+
+		/// Schedules the timeout of \p _entry. Replaces the timeout previously scheduled, if any.
+		///
+		/// The timeout expires up to two ticks late.
+		auto schedule(entry& _entry, std::chrono::steady_clock::duration _timeout) -> void;
+
+		/// Cancels the timeout of \p _entry and removes it from the list of idle sessions.
+		///
+		/// Must be called before \p _entry is destroyed.
+		auto cancel(entry& _entry) -> void;
+
+		/// Marks the session owning \p _entry as waiting for its next request.
+		///
+		/// If this causes the number of idle sessions to exceed the limit, the session which has
+		/// been idle the longest is closed. The same happens if reservations are waiting for the
+		/// memory budget or less than a tenth of it is left, unless \p _entry is the only idle
+		/// session.
+		auto mark_idle(entry& _entry) -> void;
+
+		/// Marks the session owning \p _entry as servicing a request.
+		auto mark_busy(entry& _entry) -> void;
+
+	  private:
+		// The following functions require the caller to hold mtx_.
+		auto link(entry& _entry) -> void;
+		auto unlink(entry& _entry) -> void;
+		auto unlink_idle(entry& _entry) -> void;
+
+		auto tick() -> void;
+
+		boost::asio::steady_timer timer_;
+		const std::chrono::milliseconds tick_interval_;
+		const std::size_t max_number_of_idle_;
+
+		std::mutex mtx_;
+		const std::size_t number_of_slots_;
+		std::array<std::vector<entry*>, 2> levels_;
+
+		// The number of ticks since the wheel was started.
+		std::uint64_t now_{};
+
+		// The idle sessions, ordered from the least recently idle to the most recently idle.
+		entry* idle_head_{};
+		entry* idle_tail_{};
+		std::size_t number_of_idle_{};
+	}; // class timing_wheel
+} // namespace irods::http
+
+#endif // IRODS_HTTP_API_TIMING_WHEEL_HPP
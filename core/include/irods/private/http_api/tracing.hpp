@@ -0,0 +1,185 @@
+#ifndef IRODS_HTTP_API_TRACING_HPP
+#define IRODS_HTTP_API_TRACING_HPP
+
+/// \file
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <variant>
+#include <vector>
+
+/// Defines the types and free functions used to trace the phases of a request.
+///
+/// A trace is started for each sampled request. Its root span covers the request from the
+/// arrival of the header until the response is written. Child spans cover individual phases
+/// such as authentication, waiting for a background thread, checking out an iRODS connection
+/// and serializing the response.
+///
+/// The trace of the request being processed by the current thread is held in a thread-local
+/// variable. It is carried into background threads by irods::http::globals::background_task.
+/// Spans created on a thread without a trace do nothing, so requests which are not sampled
+/// pay for little more than a thread-local lookup.
+///
+/// Finished traces are exported as OTLP/JSON by a dedicated thread, either as lines appended
+/// to a file or as UDP datagrams. Tracing is configured via /http_server/tracing.
+namespace irods::http::tracing
+{
+	/// The value of an attribute attached to a span.
+	using attribute_value = std::variant<std::string, std::int64_t>;
+
+	/// A key-value pair attached to a span.
+	using attribute = std::pair<std::string, attribute_value>;
+
+	/// Returns the current time as the number of nanoseconds since the Unix epoch.
+	auto now() -> std::int64_t;
+
+	/// The spans of a single request.
+	///
+	/// Instances are created via start() and are shared by all threads working on the request.
+	class trace
+	{
+	  public:
+		/// Starts a trace if the request is sampled.
+		///
+		/// \param[in] _traceparent The value of the W3C traceparent header of the request. May be
+		/// empty. If it is valid, the trace continues the trace of the client and the sampling
+		/// decision of the client is honored.
+		///
+		/// \returns A null pointer if tracing is disabled or the request is not sampled.
+		static auto start(std::string_view _traceparent) -> std::shared_ptr<trace>;
+
+		trace(const trace&) = delete;
+		auto operator=(const trace&) -> trace& = delete;
+
+		trace(trace&&) = delete;
+		auto operator=(trace&&) -> trace& = delete;
+
+		~trace() = default;
+
+		/// Returns the identifier of the root span.
+		auto root_span_id() const noexcept -> std::uint64_t
+		{
+			return root_span_id_;
+		} // root_span_id
+
+		/// Records a finished span.
+		///
+		/// This function is thread-safe.
+		auto add_span(
+			std::string _name,
+			std::uint64_t _span_id,
+			std::uint64_t _parent_span_id,
+			std::int64_t _start,
+			std::int64_t _end,
+			std::vector<attribute> _attributes = {}) -> void;
+
+		/// Attaches an attribute to the root span.
+		///
+		/// This function is thread-safe.
+		auto set_attribute(std::string _key, attribute_value _value) -> void;
+
+		/// Ends the root span and hands the trace to the exporter. Spans added afterwards are
+		/// discarded.
+		///
+		/// This function is thread-safe.
+		auto finish() -> void;
+
+		// Public so that the trace can be constructed via std::make_shared. Use start() instead.
+		struct private_tag
+		{
+		};
+
+		trace(private_tag, std::uint64_t _trace_id_high, std::uint64_t _trace_id_low, std::uint64_t _remote_parent_id);
+
+		/// The data describing a finished span.
+		struct span_data
+		{
+			std::string name;
+			std::uint64_t span_id;
+			std::uint64_t parent_span_id;
+			std::int64_t start;
+			std::int64_t end;
+			std::vector<attribute> attributes;
+		}; // struct span_data
+
+	  private:
+		const std::uint64_t trace_id_high_;
+		const std::uint64_t trace_id_low_;
+		const std::uint64_t root_span_id_;
+		const std::uint64_t remote_parent_id_;
+		const std::int64_t start_;
+
+		std::mutex mtx_;
+		bool finished_{};
+		std::vector<attribute> root_attributes_;
+		std::vector<span_data> spans_;
+	}; // class trace
+
+	/// Returns a new random span identifier.
+	auto new_span_id() -> std::uint64_t;
+
+	/// Returns the trace of the request being processed by the current thread, if any.
+	auto current() -> const std::shared_ptr<trace>&;
+
+	/// Returns the identifier of the innermost span active on the current thread.
+	auto current_span_id() -> std::uint64_t;
+
+	/// Makes \p _trace the trace of the current thread for the lifetime of the object. New
+	/// spans become children of \p _parent_span_id, or of the root span if it is 0.
+	class scope
+	{
+	  public:
+		explicit scope(std::shared_ptr<trace> _trace, std::uint64_t _parent_span_id = 0);
+
+		scope(const scope&) = delete;
+		auto operator=(const scope&) -> scope& = delete;
+
+		scope(scope&&) = delete;
+		auto operator=(scope&&) -> scope& = delete;
+
+		~scope();
+
+	  private:
+		std::shared_ptr<trace> previous_trace_;
+		std::uint64_t previous_span_id_;
+	}; // class scope
+
+	/// A span which covers the lifetime of the object. The span is a child of the innermost
+	/// span active on the current thread. Does nothing if the current thread has no trace.
+	class span
+	{
+	  public:
+		explicit span(std::string_view _name);
+
+		span(const span&) = delete;
+		auto operator=(const span&) -> span& = delete;
+
+		span(span&&) = delete;
+		auto operator=(span&&) -> span& = delete;
+
+		~span();
+
+		/// Attaches an attribute to the span.
+		auto set_attribute(std::string _key, attribute_value _value) -> void;
+
+	  private:
+		trace* trace_;
+		std::string_view name_;
+		std::uint64_t span_id_{};
+		std::uint64_t parent_span_id_{};
+		std::int64_t start_{};
+		std::vector<attribute> attributes_;
+	}; // class span
+
+	/// Returns a function which runs \p _task within the trace of the current thread. The time
+	/// spent between this call and the start of the task is recorded as a span. Returns
+	/// \p _task unchanged if the current thread has no trace.
+	auto wrap(std::function<void()> _task) -> std::function<void()>;
+} // namespace irods::http::tracing
+
+#endif // IRODS_HTTP_API_TRACING_HPP
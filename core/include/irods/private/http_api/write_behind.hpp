@@ -0,0 +1,118 @@
+#ifndef IRODS_HTTP_API_WRITE_BEHIND_HPP
+#define IRODS_HTTP_API_WRITE_BEHIND_HPP
+
+/// \file
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+/// Defines the set of free functions used to manage the write-behind spool.
+///
+/// Writes which are spooled are stored in a local directory and acknowledged before they reach
+/// iRODS. Spooled writes are uploaded in the background, in the order they were received. Bytes
+/// and state are flushed to disk before a write is acknowledged, therefore, spooled writes
+/// survive a restart of the server.
+///
+/// The spool is configured via /irods_client/write_behind. It is disabled unless a directory
+/// is defined.
+namespace irods::http::write_behind
+{
+	/// The states of a spooled write.
+	enum class upload_state
+	{
+		/// The write is waiting to be uploaded. This includes writes waiting for a retry.
+		pending,
+
+		/// The write is being uploaded.
+		uploading,
+
+		/// The write was uploaded and removed from the spool.
+		completed,
+
+		/// Every attempt to upload the write failed. The write is not attempted again. Its bytes
+		/// remain in the spool, without counting against its size, until the status expires or
+		/// the write is discarded.
+		failed
+	}; // enum class upload_state
+
+	/// The results of discarding a spooled write.
+	enum class discard_result
+	{
+		/// The write and its bytes were removed from the spool.
+		discarded,
+
+		/// The handle does not exist or is not owned by the user.
+		not_found,
+
+		/// The write has not failed. Only failed writes can be discarded.
+		not_failed
+	}; // enum class discard_result
+
+	/// Returns the name of \p _state.
+	auto to_string(upload_state _state) -> std::string_view;
+
+	/// The information reported for a spooled write.
+	struct upload_status
+	{
+		upload_state state;
+		std::string logical_path;
+		std::uint64_t size;
+
+		/// The number of failed attempts.
+		int attempts;
+
+		/// The error produced by the most recent failed attempt.
+		int error_code;
+		std::string error_message;
+	}; // struct upload_status
+
+	/// Returns whether the write-behind spool is enabled.
+	auto enabled() -> bool;
+
+	/// Loads the writes left in the spool by a previous run of the server and schedules them.
+	///
+	/// Must be called once, after the background thread pool is initialized.
+	auto recover() -> void;
+
+	/// Stores a write in the spool and schedules it for upload.
+	///
+	/// This function is thread-safe.
+	///
+	/// \param[in] _username     The user which owns the write. The upload is performed as this user.
+	/// \param[in] _logical_path The data object to write. It is truncated before the bytes are written.
+	/// \param[in] _resource     The root resource to write to. May be empty.
+	/// \param[in] _bytes        The new contents of the data object.
+	///
+	/// \throws std::system_error If the write could not be stored.
+	///
+	/// \returns The handle of the spooled write, or an empty optional if the spool is full.
+	auto enqueue(
+		std::string_view _username,
+		std::string_view _logical_path,
+		std::string_view _resource,
+		std::string_view _bytes) -> std::optional<std::string>;
+
+	/// Returns the status of the spooled write identified by \p _handle.
+	///
+	/// This function is thread-safe.
+	///
+	/// \returns An empty optional if the handle does not exist or is not owned by \p _username.
+	auto status(std::string_view _handle, std::string_view _username) -> std::optional<upload_status>;
+
+	/// Removes a failed write owned by \p _username from the spool, along with its bytes.
+	///
+	/// This function is thread-safe.
+	auto discard(std::string_view _handle, std::string_view _username) -> discard_result;
+
+	/// Launches uploads of spooled writes which are ready, and forgets completed and failed
+	/// writes whose status is no longer retained. The bytes of failed writes are removed then.
+	///
+	/// Must be called periodically so that failed uploads are retried.
+	///
+	/// This function is thread-safe.
+	auto process() -> void;
+} // namespace irods::http::write_behind
+
+#endif // IRODS_HTTP_API_WRITE_BEHIND_HPP
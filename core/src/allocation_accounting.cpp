@@ -0,0 +1,215 @@
+#include "irods/private/http_api/allocation_accounting.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+namespace
+{
+	using irods::http::allocation_accounting::request_record;
+	using irods::http::allocation_accounting::totals;
+
+	// The record of the request being processed by the current thread. This is a plain pointer
+	// with constant initialization so that reading it from operator new neither allocates nor
+	// runs thread-local initialization code. The record is kept alive by a scope object.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	constinit thread_local request_record* t_record = nullptr;
+
+	// The totals of all finished requests, keyed by endpoint and then by operation.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	std::map<std::string, std::map<std::string, totals>> g_totals;
+
+	// A mutex which protects the totals from data corruption.
+	std::mutex g_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+
+	auto allocate(std::size_t _size) -> void*
+	{
+		if (0 == _size) {
+			_size = 1;
+		}
+
+		if (auto* record = t_record; record) {
+			record->add(_size);
+		}
+
+		while (true) {
+			// NOLINTNEXTLINE(cppcoreguidelines-no-malloc, cppcoreguidelines-owning-memory)
+			if (auto* p = std::malloc(_size); p) {
+				return p;
+			}
+
+			auto handler = std::get_new_handler();
+			if (!handler) {
+				throw std::bad_alloc{};
+			}
+
+			handler();
+		}
+	} // allocate
+
+	auto allocate(std::size_t _size, std::align_val_t _alignment) -> void*
+	{
+		const auto alignment = std::max(static_cast<std::size_t>(_alignment), sizeof(void*));
+
+		// std::aligned_alloc requires the size to be a multiple of the alignment.
+		_size = std::max((_size + alignment - 1) / alignment * alignment, alignment);
+
+		if (auto* record = t_record; record) {
+			record->add(_size);
+		}
+
+		while (true) {
+			// NOLINTNEXTLINE(cppcoreguidelines-no-malloc, cppcoreguidelines-owning-memory)
+			if (auto* p = std::aligned_alloc(alignment, _size); p) {
+				return p;
+			}
+
+			auto handler = std::get_new_handler();
+			if (!handler) {
+				throw std::bad_alloc{};
+			}
+
+			handler();
+		}
+	} // allocate
+
+	auto deallocate(void* _p) noexcept -> void
+	{
+		std::free(_p); // NOLINT(cppcoreguidelines-no-malloc, cppcoreguidelines-owning-memory)
+	} // deallocate
+} // anonymous namespace
+
+//
+// Replacements for the global allocation functions.
+//
+
+// clang-format off
+auto operator new(std::size_t _size) -> void* { return allocate(_size); }
+auto operator new[](std::size_t _size) -> void* { return allocate(_size); }
+auto operator new(std::size_t _size, std::align_val_t _al) -> void* { return allocate(_size, _al); }
+auto operator new[](std::size_t _size, std::align_val_t _al) -> void* { return allocate(_size, _al); }
+
+auto operator new(std::size_t _size, const std::nothrow_t&) noexcept -> void*
+{
+	try { return allocate(_size); } catch (...) { return nullptr; }
+}
+
+auto operator new[](std::size_t _size, const std::nothrow_t&) noexcept -> void*
+{
+	try { return allocate(_size); } catch (...) { return nullptr; }
+}
+
+auto operator new(std::size_t _size, std::align_val_t _al, const std::nothrow_t&) noexcept -> void*
+{
+	try { return allocate(_size, _al); } catch (...) { return nullptr; }
+}
+
+auto operator new[](std::size_t _size, std::align_val_t _al, const std::nothrow_t&) noexcept -> void*
+{
+	try { return allocate(_size, _al); } catch (...) { return nullptr; }
+}
+
+auto operator delete(void* _p) noexcept -> void { deallocate(_p); }
+auto operator delete[](void* _p) noexcept -> void { deallocate(_p); }
+auto operator delete(void* _p, std::size_t) noexcept -> void { deallocate(_p); }
+auto operator delete[](void* _p, std::size_t) noexcept -> void { deallocate(_p); }
+auto operator delete(void* _p, std::align_val_t) noexcept -> void { deallocate(_p); }
+auto operator delete[](void* _p, std::align_val_t) noexcept -> void { deallocate(_p); }
+auto operator delete(void* _p, std::size_t, std::align_val_t) noexcept -> void { deallocate(_p); }
+auto operator delete[](void* _p, std::size_t, std::align_val_t) noexcept -> void { deallocate(_p); }
+auto operator delete(void* _p, const std::nothrow_t&) noexcept -> void { deallocate(_p); }
+auto operator delete[](void* _p, const std::nothrow_t&) noexcept -> void { deallocate(_p); }
+auto operator delete(void* _p, std::align_val_t, const std::nothrow_t&) noexcept -> void { deallocate(_p); }
+auto operator delete[](void* _p, std::align_val_t, const std::nothrow_t&) noexcept -> void { deallocate(_p); }
+// clang-format on
+
+namespace irods::http::allocation_accounting
+{
+	request_record::request_record(std::string_view _endpoint)
+		: endpoint_{_endpoint}
+	{
+	} // request_record (constructor)
+
+	auto request_record::set_operation(std::string_view _operation) -> void
+	{
+		std::scoped_lock lk{mtx_};
+		operation_ = _operation;
+	} // set_operation
+
+	auto request_record::finish() -> void
+	{
+		const auto b = bytes();
+		const auto n = allocations();
+
+		std::string operation;
+
+		{
+			std::scoped_lock lk{mtx_};
+			operation = operation_;
+		}
+
+		std::scoped_lock lk{g_mtx};
+
+		auto& t = g_totals[endpoint_][operation];
+		++t.number_of_requests;
+		t.bytes += b;
+		t.allocations += n;
+		t.max_bytes_per_request = std::max(t.max_bytes_per_request, b);
+	} // finish
+
+	auto enabled() -> bool
+	{
+		static const auto enabled = irods::http::globals::configuration().value(
+			nlohmann::json::json_pointer{"/http_server/allocation_accounting/enabled"}, false);
+
+		return enabled;
+	} // enabled
+
+	auto start(std::string_view _endpoint) -> std::shared_ptr<request_record>
+	{
+		if (!enabled()) {
+			return nullptr;
+		}
+
+		return std::make_shared<request_record>(_endpoint);
+	} // start
+
+	auto current() noexcept -> request_record*
+	{
+		return t_record;
+	} // current
+
+	scope::scope(std::shared_ptr<request_record> _record)
+		: record_{std::move(_record)}
+		, previous_{std::exchange(t_record, record_.get())}
+	{
+	} // scope (constructor)
+
+	scope::~scope()
+	{
+		t_record = previous_;
+	} // scope (destructor)
+
+	auto wrap(std::function<void()> _task) -> std::function<void()>
+	{
+		if (!t_record) {
+			return _task;
+		}
+
+		return [record = t_record->shared_from_this(), task = std::move(_task)] {
+			scope s{record};
+			task();
+		};
+	} // wrap
+
+	auto totals_by_endpoint() -> std::map<std::string, std::map<std::string, totals>>
+	{
+		std::scoped_lock lk{g_mtx};
+		return g_totals;
+	} // totals_by_endpoint
+} // namespace irods::http::allocation_accounting
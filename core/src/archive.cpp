@@ -0,0 +1,970 @@
+#include "irods/private/http_api/archive.hpp"
+
+#include <irods/irods_at_scope_exit.hpp>
+#include <irods/irods_exception.hpp>
+#include <irods/rodsErrorTable.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <fmt/format.h>
+
+#include <zlib.h>
+
+#include <algorithm>
+#include <charconv>
+#include <cstddef>
+#include <ctime>
+#include <limits>
+
+namespace
+{
+	namespace archive = irods::http::archive;
+
+	using namespace std::string_view_literals;
+
+	// clang-format off
+	constexpr std::size_t tar_block_size = 512;
+
+	constexpr std::uint32_t zip_local_file_header_signature     = 0x04034b50;
+	constexpr std::uint32_t zip_data_descriptor_signature       = 0x08074b50;
+	constexpr std::uint32_t zip_central_directory_signature     = 0x02014b50;
+	constexpr std::uint32_t zip_end_of_central_directory_sig    = 0x06054b50;
+	constexpr std::uint32_t zip64_end_of_central_directory_sig  = 0x06064b50;
+	constexpr std::uint32_t zip64_end_of_central_directory_locator_sig = 0x07064b50;
+
+	constexpr std::size_t zip_end_of_central_directory_size     = 22;
+	constexpr std::size_t zip64_end_of_central_directory_locator_size = 20;
+
+	// Zip flags: sizes and CRC-32 follow the data, file names are encoded using UTF-8.
+	constexpr std::uint16_t zip_writer_flags                    = 0x0808;
+
+	// The version of the specification required to extract entries (2.0 and 4.5 for Zip64).
+	constexpr std::uint16_t zip_version_needed                  = 20;
+	constexpr std::uint16_t zip64_version_needed                = 45;
+
+	// Upper byte identifies the host system as UNIX so that permissions are honored.
+	constexpr std::uint16_t zip_version_made_by                 = (3 << 8) | zip64_version_needed;
+
+	constexpr std::uint32_t zip_saturated_32                    = std::numeric_limits<std::uint32_t>::max();
+	constexpr std::uint16_t zip_saturated_16                    = std::numeric_limits<std::uint16_t>::max();
+
+	// The largest value which fits in the 12 byte octal size field of a tar header.
+	constexpr std::uint64_t tar_max_octal_size                  = 077777777777;
+	// clang-format on
+
+	//
+	// Function prototypes
+	//
+
+	auto require(std::string_view _archive, std::size_t _offset, std::size_t _size) -> void;
+
+	template <typename T>
+	auto read_le(std::string_view _archive, std::size_t _offset) -> T;
+
+	auto c_string(std::string_view _field) -> std::string_view;
+
+	auto parse_tar_number(std::string_view _field) -> std::uint64_t;
+
+	auto parse_pax_records(std::string_view _records, std::string& _path, std::optional<std::uint64_t>& _size)
+		-> void;
+
+	auto read_tar_entries(std::string_view _archive) -> std::vector<archive::entry>;
+
+	auto read_zip_entries(std::string_view _archive) -> std::vector<archive::entry>;
+
+	template <typename T>
+	auto append_le(std::string& _out, T _value) -> void;
+
+	auto write_tar_field(char* _field, std::size_t _size, std::uint64_t _value) -> void;
+
+	auto make_tar_header(
+		std::string_view _name,
+		std::string_view _prefix,
+		char _type_flag,
+		std::uint64_t _size,
+		std::int64_t _mtime) -> std::string;
+
+	auto make_pax_record(std::string_view _key, std::string_view _value) -> std::string;
+
+	auto split_tar_path(std::string_view _path) -> std::optional<std::pair<std::string_view, std::string_view>>;
+
+	auto to_dos_date_time(std::int64_t _mtime) -> std::pair<std::uint16_t, std::uint16_t>;
+
+	//
+	// Function implementations
+	//
+
+	auto require(std::string_view _archive, std::size_t _offset, std::size_t _size) -> void
+	{
+		if (_offset > _archive.size() || _size > _archive.size() - _offset) {
+			THROW(SYS_INVALID_INPUT_PARAM, "Archive is truncated or malformed.");
+		}
+	} // require
+
+	template <typename T>
+	auto read_le(std::string_view _archive, std::size_t _offset) -> T
+	{
+		require(_archive, _offset, sizeof(T));
+
+		T value{};
+
+		for (std::size_t i = 0; i < sizeof(T); ++i) {
+			value |= static_cast<T>(static_cast<unsigned char>(_archive[_offset + i])) << (8 * i);
+		}
+
+		return value;
+	} // read_le
+
+	auto c_string(std::string_view _field) -> std::string_view
+	{
+		return _field.substr(0, _field.find('\0'));
+	} // c_string
+
+	auto parse_tar_number(std::string_view _field) -> std::uint64_t
+	{
+		// GNU tar uses base-256 encoding for values which do not fit in the octal field.
+		if (!_field.empty() && (static_cast<unsigned char>(_field[0]) & 0x80) != 0) {
+			std::uint64_t value = static_cast<unsigned char>(_field[0]) & 0x7f;
+
+			for (std::size_t i = 1; i < _field.size(); ++i) {
+				if (value > (std::numeric_limits<std::uint64_t>::max() >> 8)) {
+					THROW(SYS_INVALID_INPUT_PARAM, "Numeric field in tar header is too large.");
+				}
+
+				value = (value << 8) | static_cast<unsigned char>(_field[i]);
+			}
+
+			return value;
+		}
+
+		const auto begin = _field.find_first_not_of(" \0"sv);
+		if (begin == std::string_view::npos) {
+			return 0;
+		}
+
+		const auto end = _field.find_first_of(" \0"sv, begin);
+		const auto digits = _field.substr(begin, end - begin);
+
+		std::uint64_t value{};
+		const auto [ptr, ec] = std::from_chars(digits.data(), digits.data() + digits.size(), value, 8);
+
+		if (ec != std::errc{} || ptr != digits.data() + digits.size()) {
+			THROW(SYS_INVALID_INPUT_PARAM, "Invalid numeric field in tar header.");
+		}
+
+		return value;
+	} // parse_tar_number
+
+	auto parse_pax_records(std::string_view _records, std::string& _path, std::optional<std::uint64_t>& _size)
+		-> void
+	{
+		// Each record has the form "<length> <key>=<value>\n" where <length> includes itself.
+		while (!_records.empty()) {
+			std::size_t length{};
+			const auto [ptr, ec] = std::from_chars(_records.data(), _records.data() + _records.size(), length);
+
+			if (ec != std::errc{} || length == 0 || length > _records.size()) {
+				THROW(SYS_INVALID_INPUT_PARAM, "Invalid pax extended header.");
+			}
+
+			auto record = _records.substr(0, length);
+			_records.remove_prefix(length);
+
+			record.remove_prefix(static_cast<std::size_t>(ptr - record.data()) + 1);
+			if (record.ends_with('\n')) {
+				record.remove_suffix(1);
+			}
+
+			const auto equals = record.find('=');
+			if (equals == std::string_view::npos) {
+				continue;
+			}
+
+			const auto key = record.substr(0, equals);
+			const auto value = record.substr(equals + 1);
+
+			if (key == "path") {
+				_path = value;
+			}
+			else if (key == "size") {
+				std::uint64_t size{};
+				if (std::from_chars(value.data(), value.data() + value.size(), size).ec == std::errc{}) {
+					_size = size;
+				}
+			}
+		}
+	} // parse_pax_records
+
+	auto read_tar_entries(std::string_view _archive) -> std::vector<archive::entry>
+	{
+		std::vector<archive::entry> entries;
+
+		// Information carried over from GNU long name and pax headers.
+		std::string next_path;
+		std::optional<std::uint64_t> next_size;
+
+		std::size_t offset = 0;
+
+		while (offset + tar_block_size <= _archive.size()) {
+			const auto header = _archive.substr(offset, tar_block_size);
+
+			// The archive ends with (at least) two blocks of zeros.
+			if (std::all_of(std::begin(header), std::end(header), [](char _c) { return _c == '\0'; })) {
+				break;
+			}
+
+			// Verify the header checksum. The checksum field is treated as if it contained spaces.
+			std::uint64_t checksum = 0;
+			for (std::size_t i = 0; i < tar_block_size; ++i) {
+				checksum += (i >= 148 && i < 156) ? ' ' : static_cast<unsigned char>(header[i]);
+			}
+
+			if (checksum != parse_tar_number(header.substr(148, 8))) {
+				THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Invalid tar header checksum at offset [{}].", offset));
+			}
+
+			auto size = parse_tar_number(header.substr(124, 12));
+			const auto type_flag = header[156];
+
+			offset += tar_block_size;
+
+			// pax headers may override the size of the next entry.
+			if (next_size && type_flag != 'x' && type_flag != 'L') {
+				size = *next_size;
+			}
+
+			require(_archive, offset, size);
+			const auto data = _archive.substr(offset, size);
+
+			// Advance to the next header. Data is padded to a multiple of the block size.
+			offset += ((size + tar_block_size - 1) / tar_block_size) * tar_block_size;
+
+			if (type_flag == 'L') {
+				next_path = c_string(data);
+				continue;
+			}
+
+			if (type_flag == 'x') {
+				parse_pax_records(data, next_path, next_size);
+				continue;
+			}
+
+			// Global pax headers do not describe an entry.
+			if (type_flag == 'g') {
+				continue;
+			}
+
+			archive::entry e;
+
+			if (!next_path.empty()) {
+				e.path = std::move(next_path);
+				next_path.clear();
+			}
+			else {
+				// ustar archives store the leading part of long paths in the prefix field.
+				const auto prefix = c_string(header.substr(345, 155));
+				const auto name = c_string(header.substr(0, 100));
+
+				if (header.substr(257, 5) == "ustar" && !prefix.empty()) {
+					e.path = fmt::format("{}/{}", prefix, name);
+				}
+				else {
+					e.path = name;
+				}
+			}
+
+			next_size.reset();
+
+			switch (type_flag) {
+				case '0':
+				case '\0':
+				case '7':
+					e.type = (e.path.ends_with('/')) ? archive::entry_type::directory : archive::entry_type::file;
+					break;
+
+				case '5':
+					e.type = archive::entry_type::directory;
+					break;
+
+				default:
+					e.type = archive::entry_type::other;
+					break;
+			}
+
+			if (archive::entry_type::file == e.type) {
+				e.data = data;
+				e.size = size;
+			}
+
+			entries.push_back(std::move(e));
+		}
+
+		return entries;
+	} // read_tar_entries
+
+	auto read_zip_entries(std::string_view _archive) -> std::vector<archive::entry>
+	{
+		// Locate the end of central directory record. It is followed by a variable length
+		// comment, so the record must be searched for starting at the end of the archive.
+		if (_archive.size() < zip_end_of_central_directory_size) {
+			THROW(SYS_INVALID_INPUT_PARAM, "Archive is too small to be a zip file.");
+		}
+
+		std::optional<std::size_t> eocd_offset;
+		const auto search_limit = std::min<std::size_t>(
+			_archive.size() - zip_end_of_central_directory_size, std::numeric_limits<std::uint16_t>::max());
+
+		for (std::size_t i = 0; i <= search_limit; ++i) {
+			const auto pos = _archive.size() - zip_end_of_central_directory_size - i;
+			if (read_le<std::uint32_t>(_archive, pos) == zip_end_of_central_directory_sig) {
+				eocd_offset = pos;
+				break;
+			}
+		}
+
+		if (!eocd_offset) {
+			THROW(SYS_INVALID_INPUT_PARAM, "Could not locate the zip end of central directory record.");
+		}
+
+		std::uint64_t number_of_entries = read_le<std::uint16_t>(_archive, *eocd_offset + 10);
+		std::uint64_t cd_offset = read_le<std::uint32_t>(_archive, *eocd_offset + 16);
+
+		// Zip64 archives have a locator immediately before the end of central directory record.
+		if (*eocd_offset >= zip64_end_of_central_directory_locator_size) {
+			const auto locator_offset = *eocd_offset - zip64_end_of_central_directory_locator_size;
+
+			if (read_le<std::uint32_t>(_archive, locator_offset) == zip64_end_of_central_directory_locator_sig) {
+				const auto zip64_eocd_offset = read_le<std::uint64_t>(_archive, locator_offset + 8);
+
+				if (read_le<std::uint32_t>(_archive, zip64_eocd_offset) != zip64_end_of_central_directory_sig) {
+					THROW(SYS_INVALID_INPUT_PARAM, "Invalid zip64 end of central directory record.");
+				}
+
+				number_of_entries = read_le<std::uint64_t>(_archive, zip64_eocd_offset + 32);
+				cd_offset = read_le<std::uint64_t>(_archive, zip64_eocd_offset + 48);
+			}
+		}
+
+		std::vector<archive::entry> entries;
+		entries.reserve(std::min<std::uint64_t>(number_of_entries, _archive.size() / 46));
+
+		auto offset = static_cast<std::size_t>(cd_offset);
+
+		for (std::uint64_t n = 0; n < number_of_entries; ++n) {
+			if (read_le<std::uint32_t>(_archive, offset) != zip_central_directory_signature) {
+				THROW(SYS_INVALID_INPUT_PARAM, "Invalid zip central directory entry.");
+			}
+
+			const auto flags = read_le<std::uint16_t>(_archive, offset + 8);
+			const auto method = read_le<std::uint16_t>(_archive, offset + 10);
+			const auto crc = read_le<std::uint32_t>(_archive, offset + 16);
+			std::uint64_t compressed_size = read_le<std::uint32_t>(_archive, offset + 20);
+			std::uint64_t uncompressed_size = read_le<std::uint32_t>(_archive, offset + 24);
+			const auto name_length = read_le<std::uint16_t>(_archive, offset + 28);
+			const auto extra_length = read_le<std::uint16_t>(_archive, offset + 30);
+			const auto comment_length = read_le<std::uint16_t>(_archive, offset + 32);
+			std::uint64_t local_header_offset = read_le<std::uint32_t>(_archive, offset + 42);
+
+			require(_archive, offset + 46, name_length + extra_length);
+			const auto name = _archive.substr(offset + 46, name_length);
+			auto extra = _archive.substr(offset + 46 + name_length, extra_length);
+
+			// Values which do not fit in 32 bits are stored in the Zip64 extended information
+			// extra field, in a fixed order, only when the corresponding field is saturated.
+			constexpr auto saturated = std::numeric_limits<std::uint32_t>::max();
+
+			while (extra.size() >= 4) {
+				const auto id = read_le<std::uint16_t>(extra, 0);
+				const auto size = read_le<std::uint16_t>(extra, 2);
+				require(extra, 4, size);
+
+				if (id == 0x0001) {
+					const auto field = extra.substr(4, size);
+					std::size_t pos = 0;
+
+					if (uncompressed_size == saturated) {
+						uncompressed_size = read_le<std::uint64_t>(field, pos);
+						pos += 8;
+					}
+
+					if (compressed_size == saturated) {
+						compressed_size = read_le<std::uint64_t>(field, pos);
+						pos += 8;
+					}
+
+					if (local_header_offset == saturated) {
+						local_header_offset = read_le<std::uint64_t>(field, pos);
+					}
+				}
+
+				extra.remove_prefix(4 + size);
+			}
+
+			offset += 46 + name_length + extra_length + comment_length;
+
+			if ((flags & 0x1) != 0) {
+				THROW(SYS_NOT_SUPPORTED, fmt::format("Encrypted zip entries are not supported [{}].", name));
+			}
+
+			archive::entry e;
+			e.path = name;
+			e.type = e.path.ends_with('/') ? archive::entry_type::directory : archive::entry_type::file;
+
+			if (archive::entry_type::file == e.type) {
+				// The local file header may have extra fields which differ from the ones in the
+				// central directory. Its lengths must be used to locate the data.
+				const auto lh = static_cast<std::size_t>(local_header_offset);
+
+				if (read_le<std::uint32_t>(_archive, lh) != zip_local_file_header_signature) {
+					THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Invalid zip local file header [{}].", name));
+				}
+
+				const auto data_offset = lh + 30 + read_le<std::uint16_t>(_archive, lh + 26) +
+				                         read_le<std::uint16_t>(_archive, lh + 28);
+
+				require(_archive, data_offset, compressed_size);
+
+				e.data = _archive.substr(data_offset, compressed_size);
+				e.size = uncompressed_size;
+				e.compression_method = method;
+				e.crc32 = crc;
+			}
+
+			entries.push_back(std::move(e));
+		}
+
+		return entries;
+	} // read_zip_entries
+
+	template <typename T>
+	auto append_le(std::string& _out, T _value) -> void
+	{
+		for (std::size_t i = 0; i < sizeof(T); ++i) {
+			_out += static_cast<char>((_value >> (8 * i)) & 0xff);
+		}
+	} // append_le
+
+	auto write_tar_field(char* _field, std::size_t _size, std::uint64_t _value) -> void
+	{
+		// Numeric fields hold zero-padded octal digits followed by a NUL terminator.
+		auto* const last = _field + _size - 1; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		std::fill(_field, last, '0');
+		*last = '\0';
+
+		char digits[24]{};
+		const auto [ptr, ec] = std::to_chars(std::begin(digits), std::end(digits), _value, 8);
+		const auto length = static_cast<std::size_t>(ptr - std::begin(digits));
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		std::copy(std::begin(digits), ptr, last - std::min(length, _size - 1));
+	} // write_tar_field
+
+	auto make_tar_header(
+		std::string_view _name,
+		std::string_view _prefix,
+		char _type_flag,
+		std::uint64_t _size,
+		std::int64_t _mtime) -> std::string
+	{
+		std::string header(tar_block_size, '\0');
+		auto* const h = header.data();
+
+		// NOLINTBEGIN(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+		std::copy_n(_name.data(), std::min<std::size_t>(_name.size(), 100), h);
+		write_tar_field(h + 100, 8, ('5' == _type_flag) ? 0755 : 0644);
+		write_tar_field(h + 108, 8, 0);
+		write_tar_field(h + 116, 8, 0);
+		write_tar_field(h + 124, 12, std::min(_size, tar_max_octal_size));
+		write_tar_field(h + 136, 12, static_cast<std::uint64_t>(std::max<std::int64_t>(_mtime, 0)));
+		h[156] = _type_flag;
+		std::copy_n("ustar\0" "00", 8, h + 257);
+		std::copy_n(_prefix.data(), std::min<std::size_t>(_prefix.size(), 155), h + 345);
+
+		// The checksum is computed as if the checksum field contained spaces. It is stored as six
+		// octal digits followed by a NUL and a space.
+		std::fill_n(h + 148, 8, ' ');
+
+		std::uint64_t checksum = 0;
+		for (auto c : header) {
+			checksum += static_cast<unsigned char>(c);
+		}
+
+		write_tar_field(h + 148, 7, checksum);
+		// NOLINTEND(cppcoreguidelines-pro-bounds-pointer-arithmetic)
+
+		return header;
+	} // make_tar_header
+
+	auto make_pax_record(std::string_view _key, std::string_view _value) -> std::string
+	{
+		// Each record has the form "<length> <key>=<value>\n" where <length> includes itself.
+		const auto payload_size = _key.size() + _value.size() + 3;
+		auto length = payload_size + 1;
+
+		while (std::to_string(length).size() + payload_size != length) {
+			length = std::to_string(length).size() + payload_size;
+		}
+
+		return fmt::format("{} {}={}\n", length, _key, _value);
+	} // make_pax_record
+
+	auto split_tar_path(std::string_view _path) -> std::optional<std::pair<std::string_view, std::string_view>>
+	{
+		if (_path.size() <= 100) {
+			return std::pair{_path, std::string_view{}};
+		}
+
+		// ustar archives can store paths of up to 256 bytes by splitting them at a slash. The
+		// part before the slash is stored in the prefix field.
+		for (auto pos = _path.find('/'); pos != std::string_view::npos; pos = _path.find('/', pos + 1)) {
+			if (pos > 155) {
+				break;
+			}
+
+			if (_path.size() - pos - 1 <= 100) {
+				return std::pair{_path.substr(pos + 1), _path.substr(0, pos)};
+			}
+		}
+
+		return std::nullopt;
+	} // split_tar_path
+
+	auto to_dos_date_time(std::int64_t _mtime) -> std::pair<std::uint16_t, std::uint16_t>
+	{
+		// DOS timestamps cannot represent dates before 1980.
+		constexpr std::int64_t dos_epoch = 315532800;
+		const auto t = static_cast<std::time_t>(std::max(_mtime, dos_epoch));
+
+		std::tm tm{};
+		gmtime_r(&t, &tm);
+
+		const auto time = (tm.tm_hour << 11) | (tm.tm_min << 5) | (tm.tm_sec / 2);
+		const auto date = (std::min(tm.tm_year - 80, 127) << 9) | ((tm.tm_mon + 1) << 5) | tm.tm_mday;
+
+		return {static_cast<std::uint16_t>(time), static_cast<std::uint16_t>(date)};
+	} // to_dos_date_time
+} // anonymous namespace
+
+namespace irods::http::archive
+{
+	auto to_format(std::string_view _content_type) -> std::optional<format>
+	{
+		if (boost::istarts_with(_content_type, "application/x-tar") ||
+		    boost::istarts_with(_content_type, "application/tar"))
+		{
+			return format::tar;
+		}
+
+		if (boost::istarts_with(_content_type, "application/zip") ||
+		    boost::istarts_with(_content_type, "application/x-zip-compressed"))
+		{
+			return format::zip;
+		}
+
+		return std::nullopt;
+	} // to_format
+
+	auto to_content_type(format _format) -> const char*
+	{
+		return (format::zip == _format) ? "application/zip" : "application/x-tar";
+	} // to_content_type
+
+	auto read_entries(format _format, std::string_view _archive) -> std::vector<entry>
+	{
+		return (format::zip == _format) ? read_zip_entries(_archive) : read_tar_entries(_archive);
+	} // read_entries
+
+	auto read_contents(
+		const entry& _entry,
+		std::size_t _chunk_size,
+		const std::function<void(std::string_view)>& _sink) -> void
+	{
+		auto crc = ::crc32(0L, Z_NULL, 0);
+
+		// zlib's crc32() accepts at most 4GB per call.
+		const auto update_crc = [&crc](std::string_view _data) {
+			while (!_data.empty()) {
+				const auto n = std::min<std::size_t>(_data.size(), std::numeric_limits<uInt>::max());
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+				crc = ::crc32(crc, reinterpret_cast<const Bytef*>(_data.data()), static_cast<uInt>(n));
+				_data.remove_prefix(n);
+			}
+		};
+
+		switch (_entry.compression_method) {
+			case 0:
+				if (_entry.data.size() != _entry.size) {
+					THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Size mismatch for zip entry [{}].", _entry.path));
+				}
+
+				if (_entry.crc32) {
+					update_crc(_entry.data);
+				}
+
+				_sink(_entry.data);
+				break;
+
+			case Z_DEFLATED: {
+				z_stream zs{};
+
+				// Zip entries use raw deflate streams (i.e. no zlib header).
+				if (inflateInit2(&zs, -MAX_WBITS) != Z_OK) {
+					THROW(SYS_LIBRARY_ERROR, "Could not initialize zlib inflate stream.");
+				}
+
+				irods::at_scope_exit end_inflate{[&zs] { inflateEnd(&zs); }};
+
+				std::string chunk(std::clamp<std::size_t>(_chunk_size, 1, std::numeric_limits<uInt>::max()), '\0');
+				auto input = _entry.data;
+				std::uint64_t total_out = 0;
+				int ec = Z_OK;
+
+				while (ec != Z_STREAM_END) {
+					// zlib counts the input in 32-bit units, so large entries are fed in parts.
+					if (0 == zs.avail_in && !input.empty()) {
+						const auto n = std::min<std::size_t>(input.size(), std::numeric_limits<uInt>::max());
+						// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast, cppcoreguidelines-pro-type-const-cast)
+						zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(input.data()));
+						zs.avail_in = static_cast<uInt>(n);
+						input.remove_prefix(n);
+					}
+
+					// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+					zs.next_out = reinterpret_cast<Bytef*>(chunk.data());
+					zs.avail_out = static_cast<uInt>(chunk.size());
+
+					ec = inflate(&zs, Z_NO_FLUSH);
+
+					if (ec != Z_OK && ec != Z_STREAM_END) {
+						THROW(
+							SYS_INVALID_INPUT_PARAM, fmt::format("Could not decompress zip entry [{}].", _entry.path));
+					}
+
+					const auto produced = chunk.size() - zs.avail_out;
+					total_out += produced;
+
+					// Stop as soon as the entry exceeds its declared size. The declared size is
+					// what the caller checked against its limits.
+					if (total_out > _entry.size) {
+						THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Size mismatch for zip entry [{}].", _entry.path));
+					}
+
+					// No progress is possible once the input is exhausted.
+					if (Z_OK == ec && 0 == produced && 0 == zs.avail_in && input.empty()) {
+						THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Zip entry [{}] is truncated.", _entry.path));
+					}
+
+					if (produced > 0) {
+						const std::string_view data{chunk.data(), produced};
+
+						if (_entry.crc32) {
+							update_crc(data);
+						}
+
+						_sink(data);
+					}
+				}
+
+				if (total_out != _entry.size) {
+					THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Size mismatch for zip entry [{}].", _entry.path));
+				}
+
+				break;
+			}
+
+			default: {
+				const auto msg = fmt::format(
+					"Compression method [{}] is not supported for zip entry [{}].",
+					_entry.compression_method,
+					_entry.path);
+				THROW(SYS_NOT_SUPPORTED, msg);
+			}
+		}
+
+		if (_entry.crc32 && crc != *_entry.crc32) {
+			THROW(SYS_INVALID_INPUT_PARAM, fmt::format("CRC-32 mismatch for zip entry [{}].", _entry.path));
+		}
+	} // read_contents
+
+	auto normalize_entry_path(std::string_view _path) -> std::optional<std::string>
+	{
+		std::string normalized;
+		normalized.reserve(_path.size());
+
+		while (!_path.empty()) {
+			const auto slash = _path.find('/');
+			const auto c = _path.substr(0, slash);
+			_path.remove_prefix((slash == std::string_view::npos) ? _path.size() : slash + 1);
+
+			if (c.empty() || c == ".") {
+				continue;
+			}
+
+			if (c == "..") {
+				return std::nullopt;
+			}
+
+			if (!normalized.empty()) {
+				normalized += '/';
+			}
+
+			normalized += c;
+		}
+
+		if (normalized.empty()) {
+			return std::nullopt;
+		}
+
+		return normalized;
+	} // normalize_entry_path
+
+	writer::writer(format _format)
+		: format_{_format}
+	{
+	} // writer (constructor)
+
+	auto writer::begin_entry(std::string_view _path, entry_type _type, std::uint64_t _size, std::int64_t _mtime)
+		-> std::string
+	{
+		if (entry_type::other == _type) {
+			THROW(SYS_NOT_SUPPORTED, "Archive entries must be files or directories.");
+		}
+
+		size_ = (entry_type::directory == _type) ? 0 : _size;
+		bytes_written_ = 0;
+		crc32_ = ::crc32(0L, Z_NULL, 0);
+
+		return (format::zip == format_) ? begin_zip_entry(_path, _type, _mtime)
+		                                : begin_tar_entry(_path, _type, size_, _mtime);
+	} // writer::begin_entry
+
+	auto writer::update(std::string_view _data) -> void
+	{
+		if (_data.size() > size_ - bytes_written_) {
+			THROW(SYS_INVALID_INPUT_PARAM, "Archive entry exceeds its announced size.");
+		}
+
+		bytes_written_ += _data.size();
+
+		if (format::zip == format_) {
+			offset_ += _data.size();
+
+			// zlib's crc32() accepts at most 4GB per call.
+			while (!_data.empty()) {
+				const auto n = std::min<std::size_t>(_data.size(), std::numeric_limits<uInt>::max());
+				// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+				crc32_ = ::crc32(crc32_, reinterpret_cast<const Bytef*>(_data.data()), static_cast<uInt>(n));
+				_data.remove_prefix(n);
+			}
+		}
+	} // writer::update
+
+	auto writer::end_entry() -> std::string
+	{
+		if (format::tar == format_) {
+			// Fill in any missing bytes and pad the data to a multiple of the block size.
+			const auto padded_size = ((size_ + tar_block_size - 1) / tar_block_size) * tar_block_size;
+			return std::string(padded_size - bytes_written_, '\0');
+		}
+
+		std::string descriptor;
+		append_le(descriptor, zip_data_descriptor_signature);
+		append_le(descriptor, crc32_);
+
+		if (zip64_) {
+			append_le(descriptor, bytes_written_);
+			append_le(descriptor, bytes_written_);
+		}
+		else {
+			append_le(descriptor, static_cast<std::uint32_t>(bytes_written_));
+			append_le(descriptor, static_cast<std::uint32_t>(bytes_written_));
+		}
+
+		offset_ += descriptor.size();
+
+		record_.crc32 = crc32_;
+		record_.size = bytes_written_;
+		records_.push_back(std::move(record_));
+
+		return descriptor;
+	} // writer::end_entry
+
+	auto writer::finish() -> std::string
+	{
+		if (format::tar == format_) {
+			// Tar archives end with two blocks of zeros.
+			return std::string(2 * tar_block_size, '\0');
+		}
+
+		std::string out;
+		const auto cd_offset = offset_;
+
+		for (const auto& r : records_) {
+			// Values which do not fit in 32 bits are moved into the Zip64 extended information
+			// extra field, in a fixed order, and the corresponding field is saturated.
+			std::string extra;
+
+			if (r.size >= zip_saturated_32) {
+				append_le(extra, r.size);
+				append_le(extra, r.size);
+			}
+
+			if (r.offset >= zip_saturated_32) {
+				append_le(extra, r.offset);
+			}
+
+			if (!extra.empty()) {
+				std::string header;
+				append_le(header, std::uint16_t{0x0001});
+				append_le(header, static_cast<std::uint16_t>(extra.size()));
+				extra.insert(0, header);
+			}
+
+			const auto needs_zip64 = r.size >= zip_saturated_32 || r.offset >= zip_saturated_32;
+			const auto size = static_cast<std::uint32_t>(std::min<std::uint64_t>(r.size, zip_saturated_32));
+			const std::uint32_t external_attributes = r.is_directory ? ((040755U << 16) | 0x10U) : (0100644U << 16);
+
+			append_le(out, zip_central_directory_signature);
+			append_le(out, zip_version_made_by);
+			append_le(out, needs_zip64 ? zip64_version_needed : zip_version_needed);
+			append_le(out, zip_writer_flags);
+			append_le(out, std::uint16_t{0}); // Compression method (stored).
+			append_le(out, r.dos_time);
+			append_le(out, r.dos_date);
+			append_le(out, r.crc32);
+			append_le(out, size); // Compressed size.
+			append_le(out, size); // Uncompressed size.
+			append_le(out, static_cast<std::uint16_t>(r.path.size()));
+			append_le(out, static_cast<std::uint16_t>(extra.size()));
+			append_le(out, std::uint16_t{0}); // Comment length.
+			append_le(out, std::uint16_t{0}); // Disk number.
+			append_le(out, std::uint16_t{0}); // Internal attributes.
+			append_le(out, external_attributes);
+			append_le(out, static_cast<std::uint32_t>(std::min<std::uint64_t>(r.offset, zip_saturated_32)));
+			out += r.path;
+			out += extra;
+		}
+
+		const std::uint64_t cd_size = out.size();
+		const std::uint64_t number_of_entries = records_.size();
+
+		if (number_of_entries >= zip_saturated_16 || cd_offset >= zip_saturated_32 || cd_size >= zip_saturated_32) {
+			const auto zip64_eocd_offset = cd_offset + cd_size;
+
+			append_le(out, zip64_end_of_central_directory_sig);
+			append_le(out, std::uint64_t{44}); // Size of the remaining record.
+			append_le(out, zip_version_made_by);
+			append_le(out, zip64_version_needed);
+			append_le(out, std::uint32_t{0}); // Disk number.
+			append_le(out, std::uint32_t{0}); // Disk containing the central directory.
+			append_le(out, number_of_entries);
+			append_le(out, number_of_entries);
+			append_le(out, cd_size);
+			append_le(out, cd_offset);
+
+			append_le(out, zip64_end_of_central_directory_locator_sig);
+			append_le(out, std::uint32_t{0}); // Disk containing the Zip64 end of central directory record.
+			append_le(out, zip64_eocd_offset);
+			append_le(out, std::uint32_t{1}); // Total number of disks.
+		}
+
+		const auto saturated_entries =
+			static_cast<std::uint16_t>(std::min<std::uint64_t>(number_of_entries, zip_saturated_16));
+
+		append_le(out, zip_end_of_central_directory_sig);
+		append_le(out, std::uint16_t{0}); // Disk number.
+		append_le(out, std::uint16_t{0}); // Disk containing the central directory.
+		append_le(out, saturated_entries);
+		append_le(out, saturated_entries);
+		append_le(out, static_cast<std::uint32_t>(std::min<std::uint64_t>(cd_size, zip_saturated_32)));
+		append_le(out, static_cast<std::uint32_t>(std::min<std::uint64_t>(cd_offset, zip_saturated_32)));
+		append_le(out, std::uint16_t{0}); // Comment length.
+
+		records_.clear();
+
+		return out;
+	} // writer::finish
+
+	auto writer::begin_tar_entry(std::string_view _path, entry_type _type, std::uint64_t _size, std::int64_t _mtime)
+		-> std::string
+	{
+		const auto is_directory = (entry_type::directory == _type);
+		const auto path = is_directory ? fmt::format("{}/", _path) : std::string{_path};
+		const auto type_flag = is_directory ? '5' : '0';
+
+		std::string pax_records;
+		auto name_and_prefix = split_tar_path(path);
+
+		if (!name_and_prefix) {
+			pax_records += make_pax_record("path", path);
+		}
+
+		if (_size > tar_max_octal_size) {
+			pax_records += make_pax_record("size", std::to_string(_size));
+		}
+
+		std::string out;
+
+		if (!pax_records.empty()) {
+			// The pax header describes the entry which follows it. The name of the pax header is
+			// only used by readers which do not understand pax headers.
+			if (!name_and_prefix) {
+				name_and_prefix = std::pair{std::string_view{path}.substr(0, 100), std::string_view{}};
+			}
+
+			out += make_tar_header("././@PaxHeader", {}, 'x', pax_records.size(), _mtime);
+			out += pax_records;
+			out.append((tar_block_size - pax_records.size() % tar_block_size) % tar_block_size, '\0');
+		}
+
+		out += make_tar_header(name_and_prefix->first, name_and_prefix->second, type_flag, _size, _mtime);
+
+		return out;
+	} // writer::begin_tar_entry
+
+	auto writer::begin_zip_entry(std::string_view _path, entry_type _type, std::int64_t _mtime) -> std::string
+	{
+		const auto is_directory = (entry_type::directory == _type);
+		const auto [dos_time, dos_date] = to_dos_date_time(_mtime);
+
+		record_ = {};
+		record_.path = is_directory ? fmt::format("{}/", _path) : std::string{_path};
+		record_.is_directory = is_directory;
+		record_.dos_time = dos_time;
+		record_.dos_date = dos_date;
+		record_.offset = offset_;
+
+		if (record_.path.size() >= zip_saturated_16) {
+			THROW(SYS_INVALID_INPUT_PARAM, "Path is too long for a zip archive entry.");
+		}
+
+		// The Zip64 extra field in the local header signals readers that the data descriptor
+		// holds 64-bit sizes.
+		zip64_ = size_ >= zip_saturated_32;
+
+		std::string out;
+		append_le(out, zip_local_file_header_signature);
+		append_le(out, zip64_ ? zip64_version_needed : zip_version_needed);
+		append_le(out, zip_writer_flags);
+		append_le(out, std::uint16_t{0}); // Compression method (stored).
+		append_le(out, dos_time);
+		append_le(out, dos_date);
+		append_le(out, std::uint32_t{0}); // CRC-32 (in data descriptor).
+		append_le(out, zip64_ ? zip_saturated_32 : 0U); // Compressed size (in data descriptor).
+		append_le(out, zip64_ ? zip_saturated_32 : 0U); // Uncompressed size (in data descriptor).
+		append_le(out, static_cast<std::uint16_t>(record_.path.size()));
+		append_le(out, static_cast<std::uint16_t>(zip64_ ? 20 : 0));
+		out += record_.path;
+
+		if (zip64_) {
+			append_le(out, std::uint16_t{0x0001});
+			append_le(out, std::uint16_t{16});
+			append_le(out, std::uint64_t{0});
+			append_le(out, std::uint64_t{0});
+		}
+
+		offset_ += out.size();
+
+		return out;
+	} // writer::begin_zip_entry
+} // namespace irods::http::archive
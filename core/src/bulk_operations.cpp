@@ -0,0 +1,192 @@
+#include "irods/private/http_api/bulk_operations.hpp"
+
+#include "irods/private/http_api/chunked_response.hpp"
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+#include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/tracing.hpp"
+
+#include <irods/irods_exception.hpp>
+#include <irods/rodsErrorTable.h>
+
+#include <boost/algorithm/string.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <memory>
+#include <optional>
+#include <utility>
+
+namespace
+{
+	using json = nlohmann::json;
+
+	struct bulk_request_state
+	{
+		irods::http::session_pointer_type sess_ptr;
+		irods::http::request_type req;
+		std::string username;
+		irods::http::bulk_entry_handler_type handler;
+
+		// The entries reference memory owned by the request object.
+		std::vector<irods::http::ndjson_entry> entries;
+		std::size_t entries_per_task{};
+
+		std::atomic<std::size_t> next_entry{};
+		std::atomic<std::size_t> active_tasks{};
+		std::shared_ptr<irods::http::chunked_response> response;
+	}; // struct bulk_request_state
+
+	auto run_bulk_task(std::shared_ptr<bulk_request_state> _state) -> void
+	{
+		namespace logging = irods::http::log;
+
+		const auto& entries = _state->entries;
+		std::optional<irods::http::connection_facade> conn;
+
+		while (!_state->response->is_closed()) {
+			const auto begin = _state->next_entry.fetch_add(_state->entries_per_task);
+			if (begin >= entries.size()) {
+				break;
+			}
+
+			const auto end = std::min(begin + _state->entries_per_task, entries.size());
+			std::string results;
+
+			for (auto i = begin; i < end; ++i) {
+				const auto& entry = entries[i];
+
+				try {
+					if (!conn) {
+						conn.emplace(irods::get_connection(_state->username));
+					}
+
+					irods::http::tracing::span span{"irods_bulk_entry"};
+					results += _state->handler(*conn, entry);
+				}
+				catch (const irods::exception& e) {
+					logging::error(*_state->sess_ptr, "{}: {}", __func__, e.client_display_what());
+					results += irods::http::make_bulk_error_result(
+						entry.line_number, static_cast<int>(e.code()), e.client_display_what());
+					// The connection may no longer be usable. Acquire a new one for the next entry.
+					conn.reset();
+				}
+				catch (const std::exception& e) {
+					logging::error(*_state->sess_ptr, "{}: {}", __func__, e.what());
+					results += irods::http::make_bulk_error_result(entry.line_number, SYS_INTERNAL_ERR, e.what());
+					conn.reset();
+				}
+			}
+
+			// All results for a batch are sent as a single chunk.
+			if (!_state->response->write(std::move(results))) {
+				logging::error(*_state->sess_ptr, "{}: Client is no longer receiving results.", __func__);
+				break;
+			}
+		}
+
+		// Return the connection to the pool before completing the response.
+		conn.reset();
+
+		if (_state->active_tasks.fetch_sub(1) == 1) {
+			_state->response->finish();
+		}
+	} // run_bulk_task
+} // anonymous namespace
+
+namespace irods::http
+{
+	auto split_ndjson_entries(std::string_view _body) -> std::vector<ndjson_entry>
+	{
+		std::vector<ndjson_entry> entries;
+		std::size_t line_number = 0;
+
+		while (!_body.empty()) {
+			++line_number;
+
+			const auto newline = _body.find('\n');
+			auto line = _body.substr(0, newline);
+			_body.remove_prefix((newline == std::string_view::npos) ? _body.size() : newline + 1);
+
+			if (!line.empty() && line.back() == '\r') {
+				line.remove_suffix(1);
+			}
+
+			if (line.find_first_not_of(" \t") != std::string_view::npos) {
+				entries.push_back({line_number, line});
+			}
+		}
+
+		return entries;
+	} // split_ndjson_entries
+
+	auto make_bulk_error_result(std::size_t _line_number, int _error_code, std::string_view _message) -> std::string
+	{
+		// clang-format off
+		auto result = json{
+			{"line", _line_number},
+			{"irods_response", {
+				{"status_code", _error_code},
+				{"status_message", _message}
+			}}
+		}.dump();
+		// clang-format on
+
+		result += '\n';
+
+		return result;
+	} // make_bulk_error_result
+
+	auto is_ndjson_request(const request_type& _req) -> bool
+	{
+		return boost::istarts_with(_req.base()["content-type"], "application/x-ndjson");
+	} // is_ndjson_request
+
+	auto process_ndjson_entries(
+		session_pointer_type _sess_ptr,
+		request_type&& _req,
+		std::string _username,
+		bulk_entry_handler_type _handler) -> void
+	{
+		namespace logging = irods::http::log;
+
+		static const auto& config = irods::http::globals::configuration();
+		static const auto max_number_of_tasks = std::max(
+			config.value(json::json_pointer{"/irods_client/bulk_operations/max_number_of_concurrent_tasks"}, 4), 1);
+		static const auto max_number_of_entries_per_task = std::max(
+			config.value(json::json_pointer{"/irods_client/bulk_operations/max_number_of_entries_per_task"}, 32), 1);
+
+		auto state = std::make_shared<bulk_request_state>();
+		state->sess_ptr = std::move(_sess_ptr);
+		state->req = std::move(_req);
+		state->username = std::move(_username);
+		state->handler = std::move(_handler);
+		state->entries = split_ndjson_entries(state->req.body());
+		state->entries_per_task = static_cast<std::size_t>(max_number_of_entries_per_task);
+
+		const auto batches = (state->entries.size() + state->entries_per_task - 1) / state->entries_per_task;
+		const auto tasks = std::min(static_cast<std::size_t>(max_number_of_tasks), batches);
+		logging::debug(
+			*state->sess_ptr, "{}: Processing [{}] entries using [{}] tasks.", __func__, state->entries.size(), tasks);
+
+		state->response = std::make_shared<chunked_response>(
+			state->sess_ptr, state->req.version(), state->req.keep_alive(), "application/x-ndjson");
+		state->response->start();
+
+		if (0 == tasks) {
+			state->response->finish();
+			return;
+		}
+
+		state->active_tasks = tasks;
+
+		// The current thread acts as one of the tasks.
+		for (std::size_t i = 1; i < tasks; ++i) {
+			irods::http::globals::background_task([state] { run_bulk_task(state); });
+		}
+
+		run_bulk_task(std::move(state));
+	} // process_ndjson_entries
+} // namespace irods::http
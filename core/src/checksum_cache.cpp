@@ -0,0 +1,152 @@
+#include "irods/private/http_api/checksum_cache.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	using clock_type = std::chrono::steady_clock;
+
+	struct cache_entry
+	{
+		int replica_number;
+		std::int64_t size;
+		std::string modify_time;
+		std::string checksum;
+		clock_type::time_point expires_at;
+	}; // struct cache_entry
+
+	// Maps a logical path to the verified replicas of the data object. Keying the map by
+	// logical path allows all entries of a data object to be invalidated at once.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::map<std::string, std::vector<cache_entry>, std::less<>> g_entries;
+
+	// The total number of entries across all data objects.
+	std::size_t g_size{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// A mutex which protects the map from data corruption.
+	std::mutex g_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+
+	auto timeout() -> std::chrono::seconds
+	{
+		static const auto timeout = std::chrono::seconds{std::max(
+			irods::http::globals::configuration().value(
+				nlohmann::json::json_pointer{"/irods_client/checksum_cache/timeout_in_seconds"}, 0),
+			0)};
+
+		return timeout;
+	} // timeout
+
+	auto max_number_of_entries() -> std::size_t
+	{
+		static const auto max = static_cast<std::size_t>(std::max(
+			irods::http::globals::configuration().value(
+				nlohmann::json::json_pointer{"/irods_client/checksum_cache/max_number_of_entries"}, 100000),
+			1));
+
+		return max;
+	} // max_number_of_entries
+
+	auto matches(const cache_entry& _entry, const irods::http::checksum_cache::replica_identity& _id) -> bool
+	{
+		return _entry.replica_number == _id.replica_number && _entry.size == _id.size &&
+		       _entry.modify_time == _id.modify_time;
+	} // matches
+
+	// Removes expired entries. Requires the caller to hold g_mtx.
+	auto erase_expired_entries(clock_type::time_point _now) -> void
+	{
+		for (auto iter = std::begin(g_entries); iter != std::end(g_entries);) {
+			auto& entries = iter->second;
+			const auto n = std::erase_if(entries, [_now](const auto& _e) { return _e.expires_at <= _now; });
+			g_size -= n;
+			iter = entries.empty() ? g_entries.erase(iter) : std::next(iter);
+		}
+	} // erase_expired_entries
+} // anonymous namespace
+
+namespace irods::http::checksum_cache
+{
+	auto enabled() -> bool
+	{
+		return timeout().count() > 0;
+	} // enabled
+
+	auto insert(const replica_identity& _id, std::string _checksum) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		const auto now = clock_type::now();
+
+		std::scoped_lock lk{g_mtx};
+
+		if (g_size >= max_number_of_entries()) {
+			erase_expired_entries(now);
+
+			// Every entry is still valid. Make room by forgetting the results of an arbitrary data
+			// object. This only causes the data object to be verified again.
+			if (g_size >= max_number_of_entries()) {
+				g_size -= std::begin(g_entries)->second.size();
+				g_entries.erase(std::begin(g_entries));
+			}
+		}
+
+		auto& entries = g_entries[_id.logical_path];
+		const auto replaced =
+			std::erase_if(entries, [&_id](const auto& _e) { return _e.replica_number == _id.replica_number; });
+
+		if (replaced == 0) {
+			++g_size;
+		}
+
+		entries.push_back({_id.replica_number, _id.size, _id.modify_time, std::move(_checksum), now + timeout()});
+	} // insert
+
+	auto find(const replica_identity& _id) -> std::optional<std::string>
+	{
+		if (!enabled()) {
+			return std::nullopt;
+		}
+
+		std::scoped_lock lk{g_mtx};
+
+		const auto iter = g_entries.find(_id.logical_path);
+		if (iter == std::end(g_entries)) {
+			return std::nullopt;
+		}
+
+		const auto& entries = iter->second;
+		const auto e = std::find_if(
+			std::begin(entries), std::end(entries), [&_id](const auto& _e) { return matches(_e, _id); });
+
+		if (e == std::end(entries) || e->expires_at <= clock_type::now()) {
+			return std::nullopt;
+		}
+
+		return e->checksum;
+	} // find
+
+	auto invalidate(std::string_view _logical_path) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		std::scoped_lock lk{g_mtx};
+
+		if (const auto iter = g_entries.find(_logical_path); iter != std::end(g_entries)) {
+			g_size -= iter->second.size();
+			g_entries.erase(iter);
+		}
+	} // invalidate
+} // namespace irods::http::checksum_cache
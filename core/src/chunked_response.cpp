@@ -0,0 +1,232 @@
+#include "irods/private/http_api/chunked_response.hpp"
+
+#include "irods/private/http_api/log.hpp"
+#include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/version.hpp"
+
+#include <boost/asio/post.hpp>
+#include <boost/asio/write.hpp>
+#include <boost/beast/http/chunk_encode.hpp>
+#include <boost/beast/http/write.hpp>
+
+#include <utility>
+
+// clang-format off
+namespace beast = boost::beast; // from <boost/beast.hpp>
+namespace http  = beast::http;  // from <boost/beast/http.hpp>
+namespace net   = boost::asio;  // from <boost/asio.hpp>
+// clang-format on
+
+namespace irods::http
+{
+	chunked_response::chunked_response(
+		session_pointer_type _sess_ptr,
+		unsigned int _http_version,
+		bool _keep_alive,
+		std::string_view _content_type,
+		std::size_t _max_buffered_bytes)
+		: sess_ptr_{std::move(_sess_ptr)}
+		, res_{::http::status::ok, _http_version}
+		, serializer_{res_}
+		, max_buffered_bytes_{_max_buffered_bytes}
+	{
+		res_.set(::http::field::server, irods::http::version::server_name);
+		res_.set(::http::field::content_type, beast::string_view{_content_type.data(), _content_type.size()});
+		res_.keep_alive(_keep_alive);
+		res_.chunked(true);
+	} // chunked_response (constructor)
+
+	auto chunked_response::set(field_type _field, std::string_view _value) -> void
+	{
+		res_.set(_field, beast::string_view{_value.data(), _value.size()});
+	} // set
+
+	auto chunked_response::start() -> void
+	{
+		namespace logging = irods::http::log;
+
+		// Streamed responses can take an arbitrary amount of time to produce, therefore, they are
+		// not subject to the timeouts managed by the session's timing wheel.
+		::http::async_write_header(
+			sess_ptr_->stream(),
+			serializer_,
+			[self = shared_from_this(), fn = __func__](const auto& _ec, std::size_t _bytes_transferred) {
+				logging::trace(*self->sess_ptr_, "{}: Wrote [{}] bytes representing headers.", fn, _bytes_transferred);
+
+				if (_ec) {
+					return self->close_on_error(_ec);
+				}
+
+				{
+					std::scoped_lock lk{self->mtx_};
+					self->writing_ = false;
+				}
+
+				self->write_next_chunk();
+			});
+	} // start
+
+	auto chunked_response::write(std::string _data) -> bool
+	{
+		// Producers stop as soon as the client disconnects or the deadline of the request passes.
+		if (sess_ptr_->is_cancelled()) {
+			abort();
+			return false;
+		}
+
+		if (_data.empty()) {
+			return !is_closed();
+		}
+
+		{
+			std::unique_lock lk{mtx_};
+
+			cv_.wait(lk, [this] { return closed_ || buffered_bytes_ < max_buffered_bytes_; });
+
+			if (closed_ || finished_) {
+				return false;
+			}
+
+			buffered_bytes_ += _data.size();
+			auto reservation = memory_budget::acquire(_data.size());
+			chunks_.push_back({std::move(_data), std::move(reservation)});
+		}
+
+		net::post(sess_ptr_->stream().get_executor(), [self = shared_from_this()] { self->write_next_chunk(); });
+
+		return true;
+	} // write
+
+	auto chunked_response::finish() -> void
+	{
+		// Producers may have stopped early. The response must not appear complete.
+		if (sess_ptr_->is_cancelled()) {
+			return abort();
+		}
+
+		{
+			std::scoped_lock lk{mtx_};
+
+			if (closed_ || finished_) {
+				return;
+			}
+
+			finished_ = true;
+		}
+
+		net::post(sess_ptr_->stream().get_executor(), [self = shared_from_this()] { self->write_next_chunk(); });
+	} // finish
+
+	auto chunked_response::abort() -> void
+	{
+		{
+			std::scoped_lock lk{mtx_};
+
+			if (closed_ || finished_) {
+				return;
+			}
+
+			finished_ = true;
+			aborted_ = true;
+		}
+
+		net::post(sess_ptr_->stream().get_executor(), [self = shared_from_this()] { self->write_next_chunk(); });
+	} // abort
+
+	auto chunked_response::is_closed() const -> bool
+	{
+		{
+			std::scoped_lock lk{mtx_};
+
+			if (closed_) {
+				return true;
+			}
+		}
+
+		return sess_ptr_->is_cancelled();
+	} // is_closed
+
+	auto chunked_response::write_next_chunk() -> void
+	{
+		// This function only runs on the session's executor. The front of the queue is the
+		// chunk being written. It is not removed until the write completes.
+
+		std::unique_lock lk{mtx_};
+
+		if (writing_ || closed_) {
+			return;
+		}
+
+		if (!chunks_.empty()) {
+			writing_ = true;
+			const auto& data = chunks_.front().data;
+			lk.unlock();
+
+			net::async_write(
+				sess_ptr_->stream(),
+				::http::make_chunk(net::buffer(data)),
+				beast::bind_front_handler(&chunked_response::on_chunk_written, shared_from_this()));
+
+			return;
+		}
+
+		if (!finished_) {
+			return;
+		}
+
+		writing_ = true;
+		closed_ = true;
+		lk.unlock();
+		cv_.notify_all();
+
+		if (aborted_) {
+			// Closing the connection without the final chunk signals an incomplete response.
+			return sess_ptr_->on_write(true, {}, 0);
+		}
+
+		net::async_write(
+			sess_ptr_->stream(),
+			::http::make_chunk_last(),
+			[self = shared_from_this()](const auto& _ec, std::size_t _bytes_transferred) {
+				// Hand control back to the session so that it can read the next request.
+				self->sess_ptr_->on_write(!self->res_.keep_alive(), _ec, _bytes_transferred);
+			});
+	} // write_next_chunk
+
+	auto chunked_response::on_chunk_written(beast::error_code _ec, std::size_t _bytes_transferred) -> void
+	{
+		namespace logging = irods::http::log;
+
+		if (_ec) {
+			return close_on_error(_ec);
+		}
+
+		logging::trace(*sess_ptr_, "{}: Wrote [{}] bytes to socket.", __func__, _bytes_transferred);
+
+		{
+			std::scoped_lock lk{mtx_};
+			buffered_bytes_ -= chunks_.front().data.size();
+			chunks_.pop_front();
+			writing_ = false;
+		}
+
+		cv_.notify_all();
+		write_next_chunk();
+	} // on_chunk_written
+
+	auto chunked_response::close_on_error(beast::error_code _ec) -> void
+	{
+		namespace logging = irods::http::log;
+
+		logging::error(*sess_ptr_, "{}: Error writing bytes to socket: {}", __func__, _ec.message());
+
+		{
+			std::scoped_lock lk{mtx_};
+			closed_ = true;
+			chunks_.clear();
+			buffered_bytes_ = 0;
+		}
+
+		cv_.notify_all();
+	} // close_on_error
+} // namespace irods::http
@@ -0,0 +1,249 @@
+#include "irods/private/http_api/circuit_breaker.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <mutex>
+#include <vector>
+
+namespace
+{
+	using clock_type = std::chrono::steady_clock;
+
+	using irods::http::circuit_breaker::breaker_state;
+
+	struct breaker_config
+	{
+		bool enabled;
+		int failure_rate_threshold_in_percent;
+		clock_type::duration slow_call_threshold;
+		std::size_t minimum_number_of_calls;
+		std::size_t window_in_seconds;
+		clock_type::duration open_duration;
+		std::size_t number_of_trial_requests;
+	}; // struct breaker_config
+
+	// The calls recorded during one second of the sliding window.
+	struct bucket
+	{
+		std::int64_t second{-1};
+		std::size_t calls{};
+		std::size_t failures{};
+	}; // struct bucket
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	breaker_state g_state{breaker_state::closed};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::vector<bucket> g_buckets;
+
+	// The time at which the breaker last changed state to open or half-open.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	clock_type::time_point g_state_changed_at;
+
+	// The number of trial requests let through and the number which succeeded while the
+	// breaker is half-open.
+	std::size_t g_trials_started{};   // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+	std::size_t g_trials_succeeded{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// A mutex which protects the state above from data corruption.
+	std::mutex g_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+
+	auto config() -> const breaker_config&
+	{
+		static const auto cfg = [] {
+			using json_pointer = nlohmann::json::json_pointer;
+
+			const auto& config = irods::http::globals::configuration();
+
+			const auto get = [&config](const char* _name, int _default, int _min) {
+				return std::max(config.value(json_pointer{_name}, _default), _min);
+			};
+
+			return breaker_config{
+				config.value(json_pointer{"/irods_client/circuit_breaker/enabled"}, false),
+				std::min(get("/irods_client/circuit_breaker/failure_rate_threshold_in_percent", 50, 1), 100),
+				std::chrono::milliseconds{
+					get("/irods_client/circuit_breaker/slow_call_threshold_in_milliseconds", 5000, 1)},
+				static_cast<std::size_t>(get("/irods_client/circuit_breaker/minimum_number_of_calls", 20, 1)),
+				static_cast<std::size_t>(get("/irods_client/circuit_breaker/window_in_seconds", 10, 1)),
+				std::chrono::seconds{get("/irods_client/circuit_breaker/open_duration_in_seconds", 30, 1)},
+				static_cast<std::size_t>(get("/irods_client/circuit_breaker/number_of_trial_requests", 3, 1))};
+		}();
+
+		return cfg;
+	} // config
+
+	// Returns the totals of the sliding window. Requires the caller to hold g_mtx.
+	auto totals(clock_type::time_point _now) -> bucket
+	{
+		const auto now = std::chrono::duration_cast<std::chrono::seconds>(_now.time_since_epoch()).count();
+		const auto window = static_cast<std::int64_t>(config().window_in_seconds);
+
+		bucket total;
+
+		for (const auto& b : g_buckets) {
+			if (b.second > now - window) {
+				total.calls += b.calls;
+				total.failures += b.failures;
+			}
+		}
+
+		return total;
+	} // totals
+
+	// Requires the caller to hold g_mtx.
+	auto change_state(breaker_state _state, clock_type::time_point _now) -> void
+	{
+		irods::http::log::warn(
+			"Circuit breaker changed state from [{}] to [{}].",
+			irods::http::circuit_breaker::to_string(g_state),
+			irods::http::circuit_breaker::to_string(_state));
+
+		g_state = _state;
+		g_state_changed_at = _now;
+		g_trials_started = 0;
+		g_trials_succeeded = 0;
+
+		// Outcomes recorded before the breaker closed describe an iRODS server which was not
+		// healthy. They must not cause the breaker to open again.
+		if (breaker_state::closed == _state) {
+			std::fill(std::begin(g_buckets), std::end(g_buckets), bucket{});
+		}
+	} // change_state
+
+	auto record(bool _failed) -> void
+	{
+		const auto& cfg = config();
+		const auto now = clock_type::now();
+
+		std::scoped_lock lk{g_mtx};
+
+		switch (g_state) {
+			case breaker_state::open:
+				// Calls which started before the breaker opened carry no new information.
+				return;
+
+			case breaker_state::half_open:
+				if (_failed) {
+					change_state(breaker_state::open, now);
+				}
+				else if (++g_trials_succeeded >= cfg.number_of_trial_requests) {
+					change_state(breaker_state::closed, now);
+				}
+				return;
+
+			case breaker_state::closed:
+				break;
+		}
+
+		if (g_buckets.empty()) {
+			g_buckets.resize(cfg.window_in_seconds);
+		}
+
+		const auto second = std::chrono::duration_cast<std::chrono::seconds>(now.time_since_epoch()).count();
+		auto& b = g_buckets[static_cast<std::size_t>(second) % g_buckets.size()];
+
+		if (b.second != second) {
+			b = bucket{second};
+		}
+
+		++b.calls;
+		b.failures += _failed ? 1 : 0;
+
+		const auto total = totals(now);
+
+		if (total.calls >= cfg.minimum_number_of_calls &&
+		    total.failures * 100 >= total.calls * static_cast<std::size_t>(cfg.failure_rate_threshold_in_percent))
+		{
+			change_state(breaker_state::open, now);
+		}
+	} // record
+} // anonymous namespace
+
+namespace irods::http::circuit_breaker
+{
+	auto to_string(breaker_state _state) -> std::string_view
+	{
+		switch (_state) {
+			case breaker_state::closed:
+				return "closed";
+			case breaker_state::open:
+				return "open";
+			case breaker_state::half_open:
+				return "half_open";
+		}
+
+		return "unknown";
+	} // to_string
+
+	auto enabled() -> bool
+	{
+		return config().enabled;
+	} // enabled
+
+	auto allow_request() -> bool
+	{
+		if (!enabled()) {
+			return true;
+		}
+
+		const auto& cfg = config();
+		const auto now = clock_type::now();
+
+		std::scoped_lock lk{g_mtx};
+
+		switch (g_state) {
+			case breaker_state::closed:
+				return true;
+
+			case breaker_state::open:
+				if (now - g_state_changed_at < cfg.open_duration) {
+					return false;
+				}
+
+				change_state(breaker_state::half_open, now);
+				break;
+
+			case breaker_state::half_open:
+				// Trial requests may end without calling iRODS (e.g. invalid parameters). Let
+				// another set of trial requests through if no verdict was reached in time.
+				if (now - g_state_changed_at >= cfg.open_duration) {
+					g_state_changed_at = now;
+					g_trials_started = 0;
+				}
+				break;
+		}
+
+		if (g_trials_started >= cfg.number_of_trial_requests) {
+			return false;
+		}
+
+		++g_trials_started;
+		return true;
+	} // allow_request
+
+	auto record_success(std::chrono::steady_clock::duration _latency) -> void
+	{
+		if (enabled()) {
+			record(_latency >= config().slow_call_threshold);
+		}
+	} // record_success
+
+	auto record_failure() -> void
+	{
+		if (enabled()) {
+			record(true);
+		}
+	} // record_failure
+
+	auto stats() -> statistics
+	{
+		std::scoped_lock lk{g_mtx};
+		const auto total = totals(clock_type::now());
+		return {g_state, total.calls, total.failures};
+	} // stats
+} // namespace irods::http::circuit_breaker
@@ -1,11 +1,19 @@
 #include "irods/private/http_api/common.hpp"
 
+#include "irods/private/http_api/allocation_accounting.hpp"
+#include "irods/private/http_api/archive.hpp"
+#include "irods/private/http_api/circuit_breaker.hpp"
+#include "irods/private/http_api/concurrency_limiter.hpp"
 #include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/lock_instrumentation.hpp"
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/multipart_form_data.hpp"
 #include "irods/private/http_api/openid.hpp"
 #include "irods/private/http_api/process_stash.hpp"
+#include "irods/private/http_api/rate_limiter.hpp"
 #include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/slow_requests.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/transport.hpp"
 #include "irods/private/http_api/version.hpp"
 
@@ -31,14 +39,93 @@
 #include <nlohmann/json.hpp>
 #include <spdlog/spdlog.h>
 
+#include <atomic>
+#include <chrono>
 #include <string>
 #include <string_view>
+#include <utility>
 
 // clang-format off
 namespace beast = boost::beast; // from <boost/beast.hpp>
 namespace net   = boost::asio;  // from <boost/asio.hpp>
 // clang-format on
 
+namespace
+{
+	// Returns whether \p _ec indicates the iRODS server could not be reached or did not respond.
+	auto is_connection_error(int _ec) -> bool
+	{
+		switch (_ec) {
+			case SYS_SOCK_OPEN_ERR:
+			case SYS_SOCK_CONNECT_ERR:
+			case SYS_SOCK_READ_TIMEDOUT:
+			case SYS_SOCK_READ_ERR:
+			case SYS_HEADER_READ_LEN_ERR:
+			case SYS_HEADER_WRITE_LEN_ERR:
+				return true;
+
+			default:
+				return false;
+		}
+	} // is_connection_error
+
+	// Charges the request against the rate limits of the authenticated client. Returns a response
+	// if the request must be rejected.
+	auto enforce_rate_limits(const irods::http::request_type& _req, const std::string& _username)
+		-> std::optional<irods::http::response_type>
+	{
+		// The request has been authenticated, therefore, it carries a bearer token.
+		std::string bearer_token;
+
+		if (const auto iter = _req.find(irods::http::field_type::authorization); iter != std::end(_req)) {
+			const std::string_view value{iter->value().data(), iter->value().size()};
+
+			if (const auto pos = value.find("Bearer "); pos != std::string_view::npos) {
+				bearer_token = value.substr(pos + 7);
+				boost::trim(bearer_token);
+			}
+		}
+
+		const auto retry_after = irods::http::rate_limiter::check(_username, bearer_token, _req.body().size());
+
+		if (!retry_after) {
+			return std::nullopt;
+		}
+
+		irods::http::log::warn("Rate limit exceeded for user [{}]. Rejecting request.", _username);
+
+		auto res = irods::http::fail(irods::http::status_type::too_many_requests);
+		res.set(irods::http::field_type::retry_after, std::to_string(retry_after->count()));
+		return res;
+	} // enforce_rate_limits
+
+	// The identity reused by resolve_client_identity(). See client_identity_scope.
+	constinit thread_local const irods::http::client_identity_resolution_result* t_client_identity{};
+
+	struct operation_tables
+	{
+		const std::unordered_map<std::string, irods::http::handler_type>* get;
+		const std::unordered_map<std::string, irods::http::handler_type>* post;
+		irods::http::body_limit_function_type max_size_of_request_body;
+	}; // struct operation_tables
+
+	// The operations of each endpoint. Populated during static initialization and read-only
+	// afterwards, therefore, it is not protected by a mutex.
+	auto operation_registry() -> std::unordered_map<irods::http::request_handler_type, operation_tables>&
+	{
+		static std::unordered_map<irods::http::request_handler_type, operation_tables> registry;
+		return registry;
+	} // operation_registry
+
+	// The number of pooled connections checked out by get_connection().
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::atomic<std::size_t> g_connections_in_use{};
+
+	// The number of threads waiting for a pooled connection.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::atomic<std::size_t> g_connection_waiters{};
+} // anonymous namespace
+
 namespace irods::http
 {
 	auto fail(response_type& _response, status_type _status, const std::string_view _error_msg) -> response_type
@@ -298,6 +385,8 @@ namespace irods::http
 	{
 		namespace logging = irods::http::log;
 
+		tracing::span span{"authenticate"};
+
 		//
 		// Extract the Bearer token from the Authorization header.
 		//
@@ -321,6 +410,11 @@ namespace irods::http
 		boost::trim(bearer_token);
 		logging::debug("{}: Bearer token: [{}]", __func__, bearer_token);
 
+		// The request was authenticated before its body was read.
+		if (t_client_identity) {
+			return *t_client_identity;
+		}
+
 		// Verify the bearer token is known to the server. If not, return an error.
 		auto mapped_value{irods::http::process_stash::find(bearer_token)};
 		if (!mapped_value.has_value()) {
@@ -374,7 +468,13 @@ namespace irods::http
 				// Do mapping of user to irods user
 				auto user{map_json_to_user(json_res)};
 				if (user) {
-					return {.client_info = {.username = *std::move(user)}};
+					client_identity_resolution_result result{.client_info = {.username = *std::move(user)}};
+
+					if (auto* timings = slow_requests::current(); timings) {
+						timings->set_username(result.client_info.username);
+					}
+
+					return result;
 				}
 
 				logging::warn("{}: Could not find a matching user.", __func__);
@@ -397,17 +497,111 @@ namespace irods::http
 		}
 
 		logging::trace("{}: Client is authenticated.", __func__);
+
+		if (auto* timings = slow_requests::current(); timings) {
+			timings->set_username(client_info->username);
+		}
+
 		return {.client_info = std::move(*client_info)};
 	} // resolve_client_identity
 
+	client_identity_scope::client_identity_scope(const client_identity_resolution_result* _result)
+		: previous_{t_client_identity}
+	{
+		if (_result) {
+			t_client_identity = _result;
+		}
+	} // client_identity_scope (constructor)
+
+	client_identity_scope::~client_identity_scope()
+	{
+		t_client_identity = previous_;
+	} // client_identity_scope (destructor)
+
+	operation_registration::operation_registration(
+		request_handler_type _endpoint,
+		const std::unordered_map<std::string, handler_type>& _op_table_get,
+		const std::unordered_map<std::string, handler_type>& _op_table_post,
+		body_limit_function_type _max_size_of_request_body)
+	{
+		operation_registry().insert_or_assign(
+			_endpoint, operation_tables{&_op_table_get, &_op_table_post, std::move(_max_size_of_request_body)});
+	} // operation_registration (constructor)
+
+	auto is_supported_operation(request_handler_type _endpoint, verb_type _method, std::string_view _op) -> bool
+	{
+		const auto& registry = operation_registry();
+
+		// Other methods are rejected by execute_operation().
+		const auto iter = registry.find(_endpoint);
+		if (iter == std::end(registry) || (verb_type::get != _method && verb_type::post != _method)) {
+			return true;
+		}
+
+		const auto& ops = (verb_type::get == _method) ? *iter->second.get : *iter->second.post;
+		return ops.contains(std::string{_op});
+	} // is_supported_operation
+
+	auto max_size_of_request_body(request_handler_type _endpoint, std::string_view _op) -> std::optional<std::uint64_t>
+	{
+		const auto& registry = operation_registry();
+
+		const auto iter = registry.find(_endpoint);
+		if (iter == std::end(registry) || !iter->second.max_size_of_request_body) {
+			return std::nullopt;
+		}
+
+		return iter->second.max_size_of_request_body(_op);
+	} // max_size_of_request_body
+
 	auto execute_operation(
 		session_pointer_type _sess_ptr,
 		request_type& _req,
 		const std::unordered_map<std::string, handler_type>& _op_table_get,
-		const std::unordered_map<std::string, handler_type>& _op_table_post) -> void
+		const std::unordered_map<std::string, handler_type>& _op_table_post,
+		admission_control _admission_control) -> void
 	{
 		namespace logging = irods::http::log;
 
+		if (admission_control::enabled == _admission_control) {
+			// Shed load once the backlog of work waiting for iRODS is full. Queueing more work
+			// would only increase the latency of every request.
+			if (concurrency_limiter::is_saturated()) {
+				logging::warn("{}: Too many requests waiting for iRODS. Rejecting request.", __func__);
+				auto res = irods::http::fail(status_type::service_unavailable);
+				res.set(field_type::retry_after, "1");
+				return _sess_ptr->send(std::move(res));
+			}
+
+			// Fail fast while the iRODS server is unhealthy instead of tying up a background thread.
+			if (!circuit_breaker::allow_request()) {
+				logging::warn("{}: Circuit breaker is open. Rejecting request.", __func__);
+				auto res = irods::http::fail(status_type::service_unavailable);
+				res.set(field_type::retry_after, "1");
+				return _sess_ptr->send(std::move(res));
+			}
+		}
+
+		// Charges the request against the rate limits of the client before running the operation.
+		// The operation reuses the identity resolved here.
+		const auto invoke = [&_sess_ptr, &_req](handler_type _handler, query_arguments_type& _args) {
+			if (!rate_limiter::enabled()) {
+				return _handler(_sess_ptr, _req, _args);
+			}
+
+			auto result = resolve_client_identity(_req);
+			if (result.response) {
+				return _sess_ptr->send(std::move(*result.response));
+			}
+
+			if (auto res = enforce_rate_limits(_req, result.client_info.username); res) {
+				return _sess_ptr->send(std::move(*res));
+			}
+
+			client_identity_scope identity_scope{&result};
+			return _handler(_sess_ptr, _req, _args);
+		};
+
 		if (_req.method() == verb_type::get) {
 			if (_op_table_get.empty()) {
 				logging::error("{}: HTTP method not supported.", __func__);
@@ -422,8 +616,17 @@ namespace irods::http
 				return _sess_ptr->send(irods::http::fail(status_type::bad_request));
 			}
 
+			if (auto* timings = slow_requests::current(); timings) {
+				timings->set_operation(op_iter->second);
+			}
+
 			if (const auto iter = _op_table_get.find(op_iter->second); iter != std::end(_op_table_get)) {
-				return (iter->second)(_sess_ptr, _req, url.query);
+				// Only known operations are accounted for so that the totals cannot grow without bound.
+				if (auto* allocations = allocation_accounting::current(); allocations) {
+					allocations->set_operation(iter->first);
+				}
+
+				return invoke(iter->second, url.query);
 			}
 
 			logging::error("{}: Operation [{}] not supported.", __func__, op_iter->second);
@@ -452,6 +655,13 @@ namespace irods::http
 			else if (boost::istarts_with(content_type, "application/x-www-form-urlencoded")) {
 				args = irods::http::to_argument_list(_req.body());
 			}
+			else if (boost::istarts_with(content_type, "application/x-ndjson") ||
+			         irods::http::archive::to_format({content_type.data(), content_type.size()}))
+			{
+				// The request body is a payload that is interpreted by the operation, therefore
+				// the arguments must be passed via the URL's query string.
+				args = irods::http::parse_url(_req).query;
+			}
 			else {
 				logging::error("{}: Content type [{}] not supported.", __func__, content_type);
 				return _sess_ptr->send(irods::http::fail(status_type::bad_request));
@@ -463,8 +673,17 @@ namespace irods::http
 				return _sess_ptr->send(irods::http::fail(status_type::bad_request));
 			}
 
+			if (auto* timings = slow_requests::current(); timings) {
+				timings->set_operation(op_iter->second);
+			}
+
 			if (const auto iter = _op_table_post.find(op_iter->second); iter != std::end(_op_table_post)) {
-				return (iter->second)(_sess_ptr, _req, args);
+				// Only known operations are accounted for so that the totals cannot grow without bound.
+				if (auto* allocations = allocation_accounting::current(); allocations) {
+					allocations->set_operation(iter->first);
+				}
+
+				return invoke(iter->second, args);
 			}
 
 			logging::error("{}: Operation [{}] not supported.", __func__, op_iter->second);
@@ -610,7 +829,36 @@ namespace irods
 			return irods::http::connection_facade{std::move(conn)};
 		}
 
-		auto conn = irods::http::globals::connection_pool().get_connection();
+		auto conn = [] {
+			irods::http::tracing::span span{"connection_checkout"};
+			irods::http::slow_requests::timer timer{irods::http::slow_requests::phase::connection_checkout};
+
+			// The connection pool is treated like a lock. Only the time spent waiting for a
+			// connection is recorded.
+			static auto& pool_stats = irods::http::lock_instrumentation::statistics("irods_connection_pool");
+			const auto start = std::chrono::steady_clock::now();
+
+			// The checkout is contended if other threads are waiting or all connections are in use.
+			const auto all_in_use =
+				pool_stats.enabled() && g_connections_in_use >= irods::connection_pool_stats().size;
+			const auto contended = g_connection_waiters++ > 0 || all_in_use;
+			irods::at_scope_exit decrement_waiters{[] { --g_connection_waiters; }};
+
+			try {
+				auto proxy = irods::http::globals::connection_pool().get_connection();
+				++g_connections_in_use;
+
+				if (pool_stats.enabled()) {
+					pool_stats.record_acquisition(std::chrono::steady_clock::now() - start, contended);
+				}
+
+				return irods::http::connection_facade{std::move(proxy), g_connections_in_use};
+			}
+			catch (...) {
+				irods::http::circuit_breaker::record_failure();
+				throw;
+			}
+		}();
 
 		logging::trace("{}: Changing identity associated with connection to [{}].", __func__, _username);
 
@@ -622,16 +870,48 @@ namespace irods
 		irods::strncpy_null_terminated(input.zone, zone.c_str());
 		addKeyVal(&input.options, KW_CLOSE_OPEN_REPLICAS, "");
 
+		// The latency of this call is used to detect overload of the iRODS server. Unlike the
+		// duration of a request, it does not depend on the amount of data transferred.
+		const auto start = std::chrono::steady_clock::now();
+
+		irods::http::tracing::span switch_user_span{"switch_user"};
+		irods::http::slow_requests::timer switch_user_timer{irods::http::slow_requests::phase::switch_user};
+
 		if (const auto ec = rc_switch_user(static_cast<RcComm*>(conn), &input); ec < 0) {
 			logging::error("{}: rc_switch_user error: {}", __func__, ec);
+
+			if (is_connection_error(ec)) {
+				irods::http::circuit_breaker::record_failure();
+			}
+
 			THROW(ec, "rc_switch_user error.");
 		}
 
+		const auto latency = std::chrono::steady_clock::now() - start;
+		irods::http::concurrency_limiter::record_latency(latency);
+		irods::http::circuit_breaker::record_success(latency);
+
 		logging::trace("{}: Successfully changed identity associated with connection to [{}].", __func__, _username);
 
-		return irods::http::connection_facade{std::move(conn)};
+		return conn;
 	} // get_connection
 
+	auto connection_pool_stats() -> connection_pool_statistics
+	{
+		using json_pointer = nlohmann::json::json_pointer;
+
+		static const auto& config = irods::http::globals::configuration();
+
+		if (config.at(json_pointer{"/irods_client/enable_4_2_compatibility"}).get<bool>()) {
+			return {};
+		}
+
+		static const auto size =
+			static_cast<std::size_t>(config.at(json_pointer{"/irods_client/connection_pool/size"}).get<int>());
+
+		return {size, g_connections_in_use.load(), g_connection_waiters.load()};
+	} // connection_pool_stats
+
 	auto fail(boost::beast::error_code ec, char const* what) -> void
 	{
 		irods::http::log::error("{}: {}: {}", __func__, what, ec.message());
@@ -0,0 +1,253 @@
+#include "irods/private/http_api/concurrency_limiter.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+
+#include <boost/asio/post.hpp>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	using clock_type = std::chrono::steady_clock;
+
+	// The amount of time the lowest latency of a window is used as the baseline. Replacing the
+	// baseline periodically allows the limiter to adapt to permanent changes in latency, such
+	// as the iRODS server moving to different hardware.
+	constexpr auto min_latency_window = std::chrono::seconds{60};
+
+	// The weight given to a new sample by the moving average of the latency.
+	constexpr auto latency_smoothing = 0.1;
+
+	struct limiter_config
+	{
+		bool enabled;
+		std::size_t min_limit;
+		std::size_t max_limit;
+		std::size_t max_number_of_queued_tasks;
+	}; // struct limiter_config
+
+	// The current limit. It is a floating point value because the limit grows and shrinks in
+	// steps which are not whole numbers.
+	double g_limit{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	std::size_t g_in_flight{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::deque<std::function<void()>> g_queue;
+
+	// The lowest latency of the previous and current windows.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	clock_type::duration g_previous_min_latency{clock_type::duration::max()};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	clock_type::duration g_current_min_latency{clock_type::duration::max()};
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	clock_type::time_point g_window_start{clock_type::now()};
+
+	double g_average_latency{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// A mutex which protects the state above from data corruption.
+	std::mutex g_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+
+	auto config() -> const limiter_config&
+	{
+		static const auto cfg = [] {
+			using json_pointer = nlohmann::json::json_pointer;
+
+			const auto& config = irods::http::globals::configuration();
+
+			const auto threads = std::max(config.at(json_pointer{"/http_server/background_io/threads"}).get<int>(), 1);
+			const auto min_limit = std::max(
+				config.value(json_pointer{"/irods_client/concurrency_limiter/min_number_of_concurrent_tasks"}, 1), 1);
+			const auto max_limit = std::max(
+				config.value(json_pointer{"/irods_client/concurrency_limiter/max_number_of_concurrent_tasks"}, threads),
+				min_limit);
+
+			return limiter_config{
+				config.value(json_pointer{"/irods_client/concurrency_limiter/enabled"}, false),
+				static_cast<std::size_t>(min_limit),
+				static_cast<std::size_t>(max_limit),
+				static_cast<std::size_t>(std::max(
+					config.value(json_pointer{"/irods_client/concurrency_limiter/max_number_of_queued_tasks"}, 1000),
+					0))};
+		}();
+
+		return cfg;
+	} // config
+
+	// Returns the limit as a number of tasks. Requires the caller to hold g_mtx.
+	auto current_limit() -> std::size_t
+	{
+		// The limit starts at the maximum. It only shrinks once latency indicates overload.
+		if (g_limit == 0) {
+			g_limit = static_cast<double>(config().max_limit);
+		}
+
+		return static_cast<std::size_t>(g_limit);
+	} // current_limit
+
+	// Starts queued tasks until the limit is reached. Requires the caller to hold g_mtx.
+	auto take_ready_tasks() -> std::vector<std::function<void()>>
+	{
+		std::vector<std::function<void()>> ready;
+
+		while (!g_queue.empty() && g_in_flight < current_limit()) {
+			++g_in_flight;
+			ready.push_back(std::move(g_queue.front()));
+			g_queue.pop_front();
+		}
+
+		return ready;
+	} // take_ready_tasks
+
+	auto run(std::function<void()> _task) -> void
+	{
+		boost::asio::post(irods::http::globals::background_thread_pool(), [t = std::move(_task)] {
+			// The slot must be released no matter how the task exits.
+			try {
+				t();
+			}
+			catch (const std::exception& e) {
+				irods::http::log::error("Background task exited with an exception: {}", e.what());
+			}
+			catch (...) {
+				irods::http::log::error("Background task exited with an unknown exception.");
+			}
+
+			std::vector<std::function<void()>> ready;
+
+			{
+				std::scoped_lock lk{g_mtx};
+				--g_in_flight;
+				ready = take_ready_tasks();
+			}
+
+			for (auto&& r : ready) {
+				run(std::move(r));
+			}
+		});
+	} // run
+} // anonymous namespace
+
+namespace irods::http::concurrency_limiter
+{
+	auto enabled() -> bool
+	{
+		return config().enabled;
+	} // enabled
+
+	auto submit(std::function<void()> _task) -> void
+	{
+		{
+			std::scoped_lock lk{g_mtx};
+
+			if (!g_queue.empty() || g_in_flight >= current_limit()) {
+				g_queue.push_back(std::move(_task));
+				return;
+			}
+
+			++g_in_flight;
+		}
+
+		run(std::move(_task));
+	} // submit
+
+	auto is_saturated() -> bool
+	{
+		if (!enabled()) {
+			return false;
+		}
+
+		std::scoped_lock lk{g_mtx};
+		return g_queue.size() >= config().max_number_of_queued_tasks;
+	} // is_saturated
+
+	auto record_latency(std::chrono::steady_clock::duration _latency) -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		const auto now = clock_type::now();
+		const auto& cfg = config();
+
+		std::vector<std::function<void()>> ready;
+
+		{
+			std::scoped_lock lk{g_mtx};
+
+			if (now - g_window_start >= min_latency_window) {
+				g_previous_min_latency = std::exchange(g_current_min_latency, clock_type::duration::max());
+				g_window_start = now;
+			}
+
+			g_current_min_latency = std::min(g_current_min_latency, _latency);
+
+			const auto sample = static_cast<double>(std::max(_latency.count(), clock_type::duration::rep{1}));
+			g_average_latency = (g_average_latency == 0)
+			                        ? sample
+			                        : (latency_smoothing * sample) + ((1 - latency_smoothing) * g_average_latency);
+
+			const auto min_latency =
+				static_cast<double>(std::max(std::min(g_previous_min_latency, g_current_min_latency).count(),
+			                                 clock_type::duration::rep{1}));
+
+			current_limit();
+			const auto limit = g_limit;
+
+			// Growing the limit is pointless while the application is not using it.
+			if (static_cast<double>(g_in_flight) * 2 < limit) {
+				return;
+			}
+
+			// The estimated number of requests queued inside the iRODS server.
+			const auto queue_size = std::ceil(limit * (1 - (min_latency / sample)));
+
+			const auto step = std::max(std::log10(limit), 1.0);
+			const auto alpha = 3 * step;
+			const auto beta = 6 * step;
+
+			if (queue_size <= step) {
+				g_limit = limit + beta;
+			}
+			else if (queue_size < alpha) {
+				g_limit = limit + step;
+			}
+			else if (queue_size > beta) {
+				g_limit = limit - step;
+			}
+
+			g_limit = std::clamp(g_limit, static_cast<double>(cfg.min_limit), static_cast<double>(cfg.max_limit));
+
+			ready = take_ready_tasks();
+		}
+
+		for (auto&& r : ready) {
+			run(std::move(r));
+		}
+	} // record_latency
+
+	auto stats() -> statistics
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::microseconds;
+
+		std::scoped_lock lk{g_mtx};
+
+		const auto min_latency = std::min(g_previous_min_latency, g_current_min_latency);
+		const auto average_latency = clock_type::duration{static_cast<clock_type::duration::rep>(g_average_latency)};
+
+		return {
+			current_limit(),
+			g_in_flight,
+			g_queue.size(),
+			(min_latency == clock_type::duration::max()) ? microseconds{} : duration_cast<microseconds>(min_latency),
+			duration_cast<microseconds>(average_latency)};
+	} // stats
+} // namespace irods::http::concurrency_limiter
@@ -0,0 +1,98 @@
+#include "irods/private/http_api/delta.hpp"
+
+#include <irods/irods_exception.hpp>
+#include <irods/rodsErrorTable.h>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <cmath>
+
+namespace irods::http::delta
+{
+	auto weak_checksum(std::string_view _block) -> std::uint32_t
+	{
+		std::uint32_t a = 0;
+		std::uint32_t b = 0;
+		auto n = static_cast<std::uint32_t>(_block.size());
+
+		for (auto c : _block) {
+			const auto x = static_cast<unsigned char>(c);
+			a += x;
+			b += n-- * x;
+		}
+
+		return (a & 0xffff) | ((b & 0xffff) << 16);
+	} // weak_checksum
+
+	auto default_block_size(std::uint64_t _data_object_size, std::uint64_t _max_block_size) -> std::uint64_t
+	{
+		// Round to a multiple of 8 like rsync does.
+		auto size = static_cast<std::uint64_t>(std::sqrt(static_cast<double>(_data_object_size)));
+		size = (size + 7) & ~std::uint64_t{7};
+
+		return std::clamp(size, min_block_size, std::max(min_block_size, _max_block_size));
+	} // default_block_size
+
+	auto parse_instructions(
+		std::string_view _json,
+		std::uint64_t _block_size,
+		std::uint64_t _source_size,
+		std::string_view _literals) -> std::vector<instruction>
+	{
+		using json = nlohmann::json;
+
+		if (_block_size < min_block_size) {
+			THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Block size must be at least [{}] bytes.", min_block_size));
+		}
+
+		const auto instructions = json::parse(_json);
+		if (!instructions.is_array()) {
+			THROW(SYS_INVALID_INPUT_PARAM, "Instructions must be a JSON array.");
+		}
+
+		std::vector<instruction> result;
+		result.reserve(instructions.size());
+
+		const auto number_of_blocks = (_source_size + _block_size - 1) / _block_size;
+		std::uint64_t target_offset = 0;
+
+		for (std::size_t i = 0; i < instructions.size(); ++i) {
+			const auto& in = instructions[i];
+			const auto& op = in.at("op").get_ref<const std::string&>();
+
+			if (op == "copy") {
+				const auto block = in.at("block").get<std::uint64_t>();
+				const auto count = in.at("count").get<std::uint64_t>();
+
+				if (count == 0 || block >= number_of_blocks || count > number_of_blocks - block) {
+					THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Instruction [{}] references a missing block.", i));
+				}
+
+				const auto source_offset = block * _block_size;
+				const auto length = std::min(count * _block_size, _source_size - source_offset);
+
+				result.push_back({instruction::kind::copy, source_offset, target_offset, length});
+				target_offset += length;
+			}
+			else if (op == "literal") {
+				const auto offset = in.at("offset").get<std::uint64_t>();
+				const auto length = in.at("length").get<std::uint64_t>();
+
+				if (offset > _literals.size() || length > _literals.size() - offset) {
+					const auto msg = fmt::format("Instruction [{}] references missing literal bytes.", i);
+					THROW(SYS_INVALID_INPUT_PARAM, msg);
+				}
+
+				result.push_back({instruction::kind::literal, offset, target_offset, length});
+				target_offset += length;
+			}
+			else {
+				THROW(SYS_INVALID_INPUT_PARAM, fmt::format("Instruction [{}] has an unsupported op [{}].", i, op));
+			}
+		}
+
+		return result;
+	} // parse_instructions
+} // namespace irods::http::delta
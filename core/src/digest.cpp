@@ -0,0 +1,226 @@
+#include "irods/private/http_api/digest.hpp"
+
+#include "irods/private/http_api/common.hpp"
+
+#include <irods/irods_exception.hpp>
+#include <irods/rodsErrorTable.h>
+
+#include <fmt/format.h>
+
+#include <openssl/evp.h>
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <utility>
+
+namespace irods::http
+{
+	struct digest::impl
+	{
+		EVP_MD_CTX* ctx{};
+
+		impl() = default;
+		impl(const impl&) = delete;
+		auto operator=(const impl&) -> impl& = delete;
+
+		~impl()
+		{
+			if (ctx) {
+				EVP_MD_CTX_free(ctx);
+			}
+		}
+	}; // struct digest::impl
+
+	digest::digest(digest_algorithm _algorithm)
+		: algorithm_{_algorithm}
+		, impl_{std::make_unique<impl>()}
+	{
+		impl_->ctx = EVP_MD_CTX_new();
+		if (!impl_->ctx) {
+			THROW(SYS_LIBRARY_ERROR, "Could not allocate message digest context.");
+		}
+
+		const auto* md = (digest_algorithm::sha256 == _algorithm) ? EVP_sha256() : EVP_md5();
+
+		if (EVP_DigestInit_ex(impl_->ctx, md, nullptr) != 1) {
+			THROW(SYS_LIBRARY_ERROR, "Could not initialize message digest context.");
+		}
+	} // digest (constructor)
+
+	digest::digest(digest&&) noexcept = default;
+
+	auto digest::operator=(digest&&) noexcept -> digest& = default;
+
+	digest::~digest() = default;
+
+	auto digest::algorithm() const noexcept -> digest_algorithm
+	{
+		return algorithm_;
+	} // algorithm
+
+	auto digest::update(std::string_view _data) -> void
+	{
+		if (EVP_DigestUpdate(impl_->ctx, _data.data(), _data.size()) != 1) {
+			THROW(SYS_LIBRARY_ERROR, "Could not update message digest.");
+		}
+	} // update
+
+	auto digest::finish() -> std::string
+	{
+		std::string md(EVP_MAX_MD_SIZE, '\0');
+		unsigned int size = 0;
+
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-reinterpret-cast)
+		if (EVP_DigestFinal_ex(impl_->ctx, reinterpret_cast<unsigned char*>(md.data()), &size) != 1) {
+			THROW(SYS_LIBRARY_ERROR, "Could not finalize message digest.");
+		}
+
+		md.resize(size);
+
+		return md;
+	} // finish
+
+	auto to_irods_checksum(digest_algorithm _algorithm, std::string_view _raw_digest) -> std::string
+	{
+		if (digest_algorithm::sha256 == _algorithm) {
+			return "sha2:" + safe_base64_encode(_raw_digest);
+		}
+
+		std::string hex;
+		hex.reserve(_raw_digest.size() * 2);
+
+		for (auto c : _raw_digest) {
+			fmt::format_to(std::back_inserter(hex), "{:02x}", static_cast<unsigned char>(c));
+		}
+
+		return hex;
+	} // to_irods_checksum
+
+	auto algorithm_of_irods_checksum(std::string_view _checksum) -> std::optional<digest_algorithm>
+	{
+		if (_checksum.starts_with("sha2:")) {
+			return digest_algorithm::sha256;
+		}
+
+		// MD5 checksums are not prefixed. They are always 32 hexadecimal characters.
+		if (_checksum.size() == 32 && _checksum.find(':') == std::string_view::npos) {
+			return digest_algorithm::md5;
+		}
+
+		return std::nullopt;
+	} // algorithm_of_irods_checksum
+
+	namespace
+	{
+		auto trim(std::string_view _s) -> std::string_view
+		{
+			const auto is_space = [](char c) { return c == ' ' || c == '\t'; };
+
+			while (!_s.empty() && is_space(_s.front())) {
+				_s.remove_prefix(1);
+			}
+
+			while (!_s.empty() && is_space(_s.back())) {
+				_s.remove_suffix(1);
+			}
+
+			return _s;
+		} // trim
+
+		auto to_digest_algorithm(std::string_view _name) -> std::optional<digest_algorithm>
+		{
+			std::string name{_name};
+			std::transform(std::begin(name), std::end(name), std::begin(name), [](unsigned char c) {
+				return static_cast<char>(std::tolower(c));
+			});
+
+			if (name == "sha-256") {
+				return digest_algorithm::sha256;
+			}
+
+			if (name == "md5") {
+				return digest_algorithm::md5;
+			}
+
+			return std::nullopt;
+		} // to_digest_algorithm
+
+		auto strip_base64_padding(std::string_view _s) -> std::string_view
+		{
+			while (!_s.empty() && _s.back() == '=') {
+				_s.remove_suffix(1);
+			}
+
+			return _s;
+		} // strip_base64_padding
+
+		// Both headers hold a comma-separated list of <algorithm>=<value> pairs. The only difference
+		// is how the value is encoded. Content-Digest wraps the value in colons (a structured field
+		// byte sequence) and may attach parameters to it.
+		auto parse_digest_list(std::string_view _value, bool _is_structured_field) -> std::optional<expected_digest>
+		{
+			std::optional<expected_digest> result;
+
+			while (!_value.empty()) {
+				const auto comma = _value.find(',');
+				const auto member = trim(_value.substr(0, comma));
+				_value = (comma == std::string_view::npos) ? std::string_view{} : _value.substr(comma + 1);
+
+				const auto equals = member.find('=');
+				if (equals == std::string_view::npos) {
+					continue;
+				}
+
+				const auto algorithm = to_digest_algorithm(trim(member.substr(0, equals)));
+				if (!algorithm) {
+					continue;
+				}
+
+				auto encoded = trim(member.substr(equals + 1));
+
+				if (_is_structured_field) {
+					if (encoded.size() < 2 || encoded.front() != ':') {
+						continue;
+					}
+
+					encoded.remove_prefix(1);
+
+					const auto end = encoded.find(':');
+					if (end == std::string_view::npos) {
+						continue;
+					}
+
+					encoded = encoded.substr(0, end);
+				}
+
+				encoded = strip_base64_padding(encoded);
+				if (encoded.empty()) {
+					continue;
+				}
+
+				if (!result || digest_algorithm::sha256 == *algorithm) {
+					result = expected_digest{*algorithm, std::string{encoded}};
+				}
+			}
+
+			return result;
+		} // parse_digest_list
+	} // anonymous namespace
+
+	auto parse_content_digest_header(std::string_view _value) -> std::optional<expected_digest>
+	{
+		return parse_digest_list(_value, true);
+	} // parse_content_digest_header
+
+	auto parse_digest_header(std::string_view _value) -> std::optional<expected_digest>
+	{
+		return parse_digest_list(_value, false);
+	} // parse_digest_header
+
+	auto matches(const expected_digest& _expected, std::string_view _raw_digest) -> bool
+	{
+		const auto encoded = safe_base64_encode(_raw_digest);
+		return strip_base64_padding(encoded) == _expected.base64;
+	} // matches
+} // namespace irods::http
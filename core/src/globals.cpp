@@ -1,7 +1,17 @@
 #include "irods/private/http_api/globals.hpp"
 
+#include "irods/private/http_api/allocation_accounting.hpp"
+#include "irods/private/http_api/concurrency_limiter.hpp"
+#include "irods/private/http_api/slow_requests.hpp"
+#include "irods/private/http_api/tracing.hpp"
+
+#include <irods/irods_at_scope_exit.hpp>
+
 #include <boost/asio.hpp>
 
+#include <algorithm>
+#include <atomic>
+
 namespace
 {
 	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
@@ -24,6 +34,12 @@ namespace
 
 	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 	boost::dll::shared_library g_user_map_lib;
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::atomic<std::size_t> g_queued_background_tasks{};
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::atomic<std::size_t> g_running_background_tasks{};
 } // anonymous namespace
 
 namespace irods::http::globals
@@ -60,6 +76,24 @@ namespace irods::http::globals
 
 	auto background_task(std::function<void()> _task) -> void
 	{
+		// Carry the trace, timings and allocation record of the request into the background thread.
+		_task = allocation_accounting::wrap(slow_requests::wrap(tracing::wrap(std::move(_task))));
+
+		++g_queued_background_tasks;
+
+		_task = [t = std::move(_task)] {
+			--g_queued_background_tasks;
+			++g_running_background_tasks;
+			irods::at_scope_exit decrement{[] { --g_running_background_tasks; }};
+			t();
+		};
+
+		// Tasks launched by other background tasks belong to work which was already admitted.
+		// Making them wait for the limiter could deadlock tasks which wait for their children.
+		if (concurrency_limiter::enabled() && !background_thread_pool().get_executor().running_in_this_thread()) {
+			return concurrency_limiter::submit(std::move(_task));
+		}
+
 		boost::asio::post(background_thread_pool(), [t = std::move(_task)] {
 			try {
 				t();
@@ -69,6 +103,14 @@ namespace irods::http::globals
 		});
 	} // background_task
 
+	auto background_task_stats() -> background_task_statistics
+	{
+		static const auto number_of_threads = static_cast<std::size_t>(std::max(
+			configuration().value(nlohmann::json::json_pointer{"/http_server/background_io/threads"}, 1), 1));
+
+		return {number_of_threads, g_queued_background_tasks.load(), g_running_background_tasks.load()};
+	} // background_task_stats
+
 	auto set_connection_pool(irods::connection_pool& _cp) -> void
 	{
 		g_conn_pool = &_cp;
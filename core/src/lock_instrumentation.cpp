@@ -0,0 +1,116 @@
+#include "irods/private/http_api/lock_instrumentation.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+
+#include <boost/dll.hpp>
+
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
+namespace
+{
+	struct registry
+	{
+		std::mutex mtx;
+		bool enabled = false;
+		std::map<std::string, std::unique_ptr<irods::http::lock_statistics>, std::less<>> statistics;
+	}; // struct registry
+
+	// The registry is created on first use because statistics are requested during the
+	// initialization of objects with static storage duration in other translation units.
+	auto get_registry() -> registry&
+	{
+		static registry r;
+		return r;
+	} // get_registry
+
+	// Adds the statistics reported by the user mapping plugin to \p _locks. Supporting this is
+	// optional for plugins.
+	auto add_user_mapping_plugin_statistics(nlohmann::json& _locks) -> void
+	{
+		auto& lib = irods::http::globals::user_mapping_lib();
+
+		if (!lib.is_loaded() || !lib.has("user_mapper_lock_statistics")) {
+			return;
+		}
+
+		const auto stats_func = lib.get<int(char**)>("user_mapper_lock_statistics");
+		const auto free_func = lib.get<void(char*)>("user_mapper_free");
+
+		char* stats{};
+		if (const auto rc = stats_func(&stats); rc != 0 || nullptr == stats) {
+			irods::http::log::error("{}: Could not retrieve lock statistics from user mapping plugin.", __func__);
+			return;
+		}
+
+		try {
+			_locks.update(nlohmann::json::parse(stats));
+		}
+		catch (const std::exception& e) {
+			irods::http::log::error("{}: {}", __func__, e.what());
+		}
+
+		free_func(stats);
+	} // add_user_mapping_plugin_statistics
+} // anonymous namespace
+
+namespace irods::http::lock_instrumentation
+{
+	auto statistics(std::string_view _name) -> lock_statistics&
+	{
+		auto& r = get_registry();
+
+		std::scoped_lock lk{r.mtx};
+
+		auto iter = r.statistics.find(_name);
+
+		if (iter == std::end(r.statistics)) {
+			auto stats = std::make_unique<lock_statistics>(std::string{_name}, r.enabled);
+			iter = r.statistics.emplace(std::string{_name}, std::move(stats)).first;
+		}
+
+		return *iter->second;
+	} // statistics
+
+	auto set_enabled(bool _value) -> void
+	{
+		auto& r = get_registry();
+
+		std::scoped_lock lk{r.mtx};
+
+		r.enabled = _value;
+
+		for (auto&& [name, stats] : r.statistics) {
+			stats->set_enabled(_value);
+		}
+	} // set_enabled
+
+	auto enabled() -> bool
+	{
+		auto& r = get_registry();
+		std::scoped_lock lk{r.mtx};
+		return r.enabled;
+	} // enabled
+
+	auto to_json() -> nlohmann::json
+	{
+		auto& r = get_registry();
+
+		auto locks = nlohmann::json::object();
+
+		{
+			std::scoped_lock lk{r.mtx};
+
+			for (auto&& [name, stats] : r.statistics) {
+				locks[name] = stats->to_json();
+			}
+		}
+
+		add_user_mapping_plugin_statistics(locks);
+
+		return locks;
+	} // to_json
+} // namespace irods::http::lock_instrumentation
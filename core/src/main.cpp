@@ -1,11 +1,14 @@
 #include "irods/private/http_api/common.hpp"
 #include "irods/private/http_api/globals.hpp"
 #include "irods/private/http_api/handlers.hpp"
+#include "irods/private/http_api/lock_instrumentation.hpp"
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/timing_wheel.hpp"
 #include "irods/private/http_api/transport.hpp"
 #include "irods/private/http_api/process_stash.hpp"
 #include "irods/private/http_api/version.hpp"
+#include "irods/private/http_api/write_behind.hpp"
 
 #include <irods/connection_pool.hpp>
 #include <irods/fully_qualified_username.hpp>
@@ -46,6 +49,7 @@
 #include <iostream>
 #include <iterator>
 #include <memory>
+#include <optional>
 #include <stdexcept>
 #include <string_view>
 #include <system_error>
@@ -83,11 +87,13 @@ using tcp  = boost::asio::ip::tcp; // from <boost/asio/ip/tcp.hpp>
 
 // IRODS_HTTP_API_BASE_URL is a macro defined by the CMakeLists.txt.
 const irods::http::request_handler_map_type req_handlers{
+	{IRODS_HTTP_API_BASE_URL "/admin",        irods::http::handler::administration},
 	{IRODS_HTTP_API_BASE_URL "/authenticate", irods::http::handler::authentication},
 	{IRODS_HTTP_API_BASE_URL "/collections",  irods::http::handler::collections},
 	//{IRODS_HTTP_API_BASE_URL "/config",       irods::http::handler::configuration},
 	{IRODS_HTTP_API_BASE_URL "/data-objects", irods::http::handler::data_objects},
 	{IRODS_HTTP_API_BASE_URL "/info",         irods::http::handler::information},
+	{IRODS_HTTP_API_BASE_URL "/metrics",      irods::http::handler::metrics},
 	{IRODS_HTTP_API_BASE_URL "/query",        irods::http::handler::query},
 	{IRODS_HTTP_API_BASE_URL "/resources",    irods::http::handler::resources},
 	{IRODS_HTTP_API_BASE_URL "/rules",        irods::http::handler::rules},
@@ -101,13 +107,23 @@ const irods::http::request_handler_map_type req_handlers{
 class listener : public std::enable_shared_from_this<listener>
 {
   public:
-	listener(net::io_context& ioc, const tcp::endpoint& endpoint, const json& _config)
+	listener(
+		net::io_context& ioc,
+		const tcp::endpoint& endpoint,
+		const json& _config,
+		std::shared_ptr<irods::http::timing_wheel> _timing_wheel)
 		: ioc_{ioc}
 		, acceptor_{net::make_strand(ioc)}
 		, max_body_size_{_config.at(json::json_pointer{"/http_server/requests/max_size_of_request_body_in_bytes"})
 	                         .get<int>()}
-		, timeout_in_secs_{_config.at(json::json_pointer{"/http_server/requests/timeout_in_seconds"}).get<int>()}
+		, timing_wheel_{std::move(_timing_wheel)}
 	{
+		const auto timeout = _config.at(json::json_pointer{"/http_server/requests/timeout_in_seconds"}).get<int>();
+		header_timeout_ = std::chrono::seconds{
+			_config.value(json::json_pointer{"/http_server/requests/header_timeout_in_seconds"}, timeout)};
+		body_timeout_ = std::chrono::seconds{
+			_config.value(json::json_pointer{"/http_server/requests/body_timeout_in_seconds"}, timeout)};
+
 		acceptor_.open(endpoint.protocol());
 		acceptor_.set_option(net::socket_base::reuse_address(true));
 		acceptor_.bind(endpoint);
@@ -136,7 +152,8 @@ class listener : public std::enable_shared_from_this<listener>
 		}
 		else {
 			// Create the session and run it
-			std::make_shared<irods::http::session>(std::move(socket), req_handlers, max_body_size_, timeout_in_secs_)
+			std::make_shared<irods::http::session>(
+				std::move(socket), req_handlers, max_body_size_, timing_wheel_, header_timeout_, body_timeout_)
 				->run();
 		}
 
@@ -147,7 +164,9 @@ class listener : public std::enable_shared_from_this<listener>
 	net::io_context& ioc_;
 	tcp::acceptor acceptor_;
 	const int max_body_size_;
-	const int timeout_in_secs_;
+	const std::shared_ptr<irods::http::timing_wheel> timing_wheel_;
+	std::chrono::seconds header_timeout_{};
+	std::chrono::seconds body_timeout_{};
 }; // class listener
 
 auto print_version_info() -> void
@@ -315,6 +334,22 @@ constexpr auto default_jsonschema() -> std::string_view
                         "timeout_in_seconds": {{
                             "type": "integer",
                             "minimum": 1
+                        }},
+                        "header_timeout_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "body_timeout_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "max_number_of_idle_connections": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }},
+                        "max_size_of_buffered_data_in_bytes": {{
+                            "type": "integer",
+                            "minimum": 0
                         }}
                     }},
                     "required": [
@@ -323,6 +358,132 @@ constexpr auto default_jsonschema() -> std::string_view
                         "timeout_in_seconds"
                     ]
                 }},
+                "rate_limits": {{
+                    "type": "object",
+                    "properties": {{
+                        "burst_size_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "per_user": {{
+                            "type": "object",
+                            "properties": {{
+                                "requests_per_second": {{
+                                    "type": "integer",
+                                    "minimum": 0
+                                }},
+                                "bytes_per_second": {{
+                                    "type": "integer",
+                                    "minimum": 0
+                                }}
+                            }}
+                        }},
+                        "per_bearer_token": {{
+                            "type": "object",
+                            "properties": {{
+                                "requests_per_second": {{
+                                    "type": "integer",
+                                    "minimum": 0
+                                }},
+                                "bytes_per_second": {{
+                                    "type": "integer",
+                                    "minimum": 0
+                                }}
+                            }}
+                        }}
+                    }}
+                }},
+                "lock_instrumentation": {{
+                    "type": "object",
+                    "properties": {{
+                        "enabled": {{
+                            "type": "boolean"
+                        }}
+                    }}
+                }},
+                "allocation_accounting": {{
+                    "type": "object",
+                    "properties": {{
+                        "enabled": {{
+                            "type": "boolean"
+                        }}
+                    }}
+                }},
+                "slow_requests": {{
+                    "type": "object",
+                    "properties": {{
+                        "threshold_in_milliseconds": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }},
+                        "max_number_of_entries": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }},
+                        "retention_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }}
+                    }}
+                }},
+                "request_capture": {{
+                    "type": "object",
+                    "properties": {{
+                        "enabled": {{
+                            "type": "boolean"
+                        }},
+                        "sampling_ratio": {{
+                            "type": "number",
+                            "minimum": 0,
+                            "maximum": 1
+                        }},
+                        "path": {{
+                            "type": "string"
+                        }},
+                        "max_size_of_value_in_bytes": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }}
+                    }}
+                }},
+                "tracing": {{
+                    "type": "object",
+                    "properties": {{
+                        "enabled": {{
+                            "type": "boolean"
+                        }},
+                        "sampling_ratio": {{
+                            "type": "number",
+                            "minimum": 0,
+                            "maximum": 1
+                        }},
+                        "service_name": {{
+                            "type": "string"
+                        }},
+                        "exporter": {{
+                            "type": "object",
+                            "properties": {{
+                                "type": {{
+                                    "enum": [
+                                        "file",
+                                        "udp"
+                                    ]
+                                }},
+                                "path": {{
+                                    "type": "string"
+                                }},
+                                "host": {{
+                                    "type": "string"
+                                }},
+                                "port": {{
+                                    "type": "integer",
+                                    "minimum": 1,
+                                    "maximum": 65535
+                                }}
+                            }}
+                        }}
+                    }}
+                }},
                 "background_io": {{
                     "type": "object",
                     "properties": {{
@@ -459,6 +620,137 @@ constexpr auto default_jsonschema() -> std::string_view
                 "max_number_of_rows_per_catalog_query": {{
                     "type": "integer",
                     "minimum": 1
+                }},
+                "bulk_operations": {{
+                    "type": "object",
+                    "properties": {{
+                        "max_number_of_concurrent_tasks": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "max_number_of_entries_per_task": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "max_size_of_archive_in_bytes": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }},
+                        "max_size_of_decompressed_archive_entry_in_bytes": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }}
+                    }}
+                }},
+                "checksum_cache": {{
+                    "type": "object",
+                    "properties": {{
+                        "timeout_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }},
+                        "max_number_of_entries": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }}
+                    }}
+                }},
+                "circuit_breaker": {{
+                    "type": "object",
+                    "properties": {{
+                        "enabled": {{
+                            "type": "boolean"
+                        }},
+                        "failure_rate_threshold_in_percent": {{
+                            "type": "integer",
+                            "minimum": 1,
+                            "maximum": 100
+                        }},
+                        "slow_call_threshold_in_milliseconds": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "minimum_number_of_calls": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "window_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "open_duration_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "number_of_trial_requests": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }}
+                    }}
+                }},
+                "concurrency_limiter": {{
+                    "type": "object",
+                    "properties": {{
+                        "enabled": {{
+                            "type": "boolean"
+                        }},
+                        "min_number_of_concurrent_tasks": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "max_number_of_concurrent_tasks": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "max_number_of_queued_tasks": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }}
+                    }}
+                }},
+                "checksum_verification": {{
+                    "type": "object",
+                    "properties": {{
+                        "max_number_of_concurrent_tasks_per_resource": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "max_number_of_bytes_per_second": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }}
+                    }}
+                }},
+                "write_behind": {{
+                    "type": "object",
+                    "properties": {{
+                        "directory": {{
+                            "type": "string"
+                        }},
+                        "max_size_in_bytes": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }},
+                        "max_number_of_concurrent_uploads": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "max_number_of_retries": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }},
+                        "retry_delay_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 1
+                        }},
+                        "status_retention_in_seconds": {{
+                            "type": "integer",
+                            "minimum": 0
+                        }}
+                    }},
+                    "required": [
+                        "directory"
+                    ]
                 }}
             }},
             "required": [
@@ -521,7 +813,56 @@ auto print_configuration_template() -> void
         "requests": {{
             "threads": 3,
             "max_size_of_request_body_in_bytes": 8388608,
-            "timeout_in_seconds": 30
+            "max_size_of_buffered_data_in_bytes": 1073741824,
+            "timeout_in_seconds": 30,
+            "header_timeout_in_seconds": 30,
+            "body_timeout_in_seconds": 30,
+            "max_number_of_idle_connections": 0
+        }},
+
+        "rate_limits": {{
+            "burst_size_in_seconds": 1,
+            "per_user": {{
+                "requests_per_second": 0,
+                "bytes_per_second": 0
+            }},
+            "per_bearer_token": {{
+                "requests_per_second": 0,
+                "bytes_per_second": 0
+            }}
+        }},
+
+        "lock_instrumentation": {{
+            "enabled": false
+        }},
+
+        "allocation_accounting": {{
+            "enabled": false
+        }},
+
+        "slow_requests": {{
+            "threshold_in_milliseconds": 5000,
+            "max_number_of_entries": 20,
+            "retention_in_seconds": 3600
+        }},
+
+        "request_capture": {{
+            "enabled": false,
+            "sampling_ratio": 1.0,
+            "path": "/tmp/irods_http_api_requests.jsonl",
+            "max_size_of_value_in_bytes": 4096
+        }},
+
+        "tracing": {{
+            "enabled": false,
+            "sampling_ratio": 0.01,
+            "service_name": "irods_http_api",
+            "exporter": {{
+                "type": "file",
+                "path": "/tmp/irods_http_api_traces.jsonl",
+                "host": "localhost",
+                "port": 4319
+            }}
         }},
 
         "background_io": {{
@@ -564,7 +905,50 @@ auto print_configuration_template() -> void
         "max_number_of_bytes_per_read_operation": 8192,
         "max_number_of_bytes_per_write_operation": 8192,
 
-        "max_number_of_rows_per_catalog_query": 15
+        "max_number_of_rows_per_catalog_query": 15,
+
+        "bulk_operations": {{
+            "max_number_of_concurrent_tasks": 4,
+            "max_number_of_entries_per_task": 32,
+            "max_size_of_archive_in_bytes": 1073741824,
+            "max_size_of_decompressed_archive_entry_in_bytes": 1073741824
+        }},
+
+        "checksum_cache": {{
+            "timeout_in_seconds": 0,
+            "max_number_of_entries": 100000
+        }},
+
+        "checksum_verification": {{
+            "max_number_of_concurrent_tasks_per_resource": 1,
+            "max_number_of_bytes_per_second": 0
+        }},
+
+        "circuit_breaker": {{
+            "enabled": false,
+            "failure_rate_threshold_in_percent": 50,
+            "slow_call_threshold_in_milliseconds": 5000,
+            "minimum_number_of_calls": 20,
+            "window_in_seconds": 10,
+            "open_duration_in_seconds": 30,
+            "number_of_trial_requests": 3
+        }},
+
+        "concurrency_limiter": {{
+            "enabled": false,
+            "min_number_of_concurrent_tasks": 1,
+            "max_number_of_concurrent_tasks": 6,
+            "max_number_of_queued_tasks": 1000
+        }},
+
+        "write_behind": {{
+            "directory": "",
+            "max_size_in_bytes": 1073741824,
+            "max_number_of_concurrent_uploads": 4,
+            "max_number_of_retries": 5,
+            "retry_delay_in_seconds": 5,
+            "status_retention_in_seconds": 3600
+        }}
     }}
 }}
 )");
@@ -927,6 +1311,37 @@ class process_stash_eviction_manager
 	} // evict
 }; // class process_stash_eviction_manager
 
+class write_behind_manager
+{
+	net::steady_timer timer_;
+	std::chrono::seconds interval_;
+
+  public:
+	write_behind_manager(net::io_context& _io, std::chrono::seconds _check_interval)
+		: timer_{_io}
+		, interval_{_check_interval}
+	{
+		irods::http::write_behind::recover();
+		process();
+	} // constructor
+
+  private:
+	auto process() -> void
+	{
+		timer_.expires_after(interval_);
+		timer_.async_wait([this](const auto& _ec) {
+			if (_ec) {
+				return;
+			}
+
+			// Launches spooled writes which are waiting for a retry.
+			irods::http::write_behind::process();
+
+			process();
+		});
+	} // process
+}; // class write_behind_manager
+
 auto main(int _argc, char* _argv[]) -> int
 {
 	po::options_description opts_desc{""};
@@ -1006,6 +1421,9 @@ auto main(int _argc, char* _argv[]) -> int
 
 		logging::info("Initializing server.");
 
+		irods::http::lock_instrumentation::set_enabled(
+			http_server_config.value(json::json_pointer{"/lock_instrumentation/enabled"}, false));
+
 		// Confirm OIDC endpoint is valid (Assume all provide endpoint)
 		logging::trace("Verifying OIDC endpoint configuration");
 
@@ -1064,9 +1482,23 @@ auto main(int _argc, char* _argv[]) -> int
 		net::io_context ioc{request_thread_count};
 		irods::http::globals::set_request_handler_io_context(ioc);
 
+		// The timing wheel manages the read timeouts and idle state of all sessions.
+		// A tick of 100 milliseconds and 1024 slots per level allows timeouts of up to ~100 seconds
+		// to be placed directly in the lower level and timeouts of up to ~29 hours in the upper
+		// level.
+		logging::trace("Initializing timing wheel.");
+		const auto max_number_of_idle_connections = std::max(
+			http_server_config.value(json::json_pointer{"/requests/max_number_of_idle_connections"}, 0), 0);
+		auto timing_wheel = std::make_shared<irods::http::timing_wheel>(
+			ioc,
+			std::chrono::milliseconds{100},
+			1024,
+			static_cast<std::size_t>(max_number_of_idle_connections));
+		timing_wheel->start();
+
 		// Create and launch a listening port.
 		logging::trace("Initializing listening socket (host=[{}], port=[{}]).", address.to_string(), port);
-		std::make_shared<listener>(ioc, tcp::endpoint{address, port}, config)->run();
+		std::make_shared<listener>(ioc, tcp::endpoint{address, port}, config, timing_wheel)->run();
 
 		// SIGINT and SIGTERM instruct the server to shut down.
 		logging::trace("Initializing signal handlers.");
@@ -1099,6 +1531,13 @@ auto main(int _argc, char* _argv[]) -> int
 			http_server_config.at(json::json_pointer{"/authentication/eviction_check_interval_in_seconds"}).get<int>();
 		process_stash_eviction_manager eviction_mgr{ioc, std::chrono::seconds{eviction_check_interval}};
 
+		// Launch uploads of spooled writes, including those left behind by a previous run.
+		std::optional<write_behind_manager> write_behind_mgr;
+		if (irods::http::write_behind::enabled()) {
+			logging::trace("Initializing write-behind spool.");
+			write_behind_mgr.emplace(ioc, std::chrono::seconds{1});
+		}
+
 		logging::info("Server is ready.");
 		ioc.run();
 
@@ -0,0 +1,131 @@
+#include "irods/private/http_api/memory_budget.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct waiter
+	{
+		std::uint64_t size;
+		std::function<void(irods::http::memory_budget::reservation)> handler;
+	}; // struct waiter
+
+	// The number of bytes currently reserved.
+	std::uint64_t g_usage{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// The reservations waiting for bytes to be released, in the order they were made.
+	std::deque<waiter> g_waiters; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// A mutex which protects the usage and the waiters from data corruption.
+	std::mutex g_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+
+	// Returns whether \p _size bytes can be reserved. Requires the caller to hold g_mtx.
+	auto fits(std::uint64_t _size) -> bool
+	{
+		const auto max = irods::http::memory_budget::limit();
+		return max == 0 || g_usage == 0 || (g_usage <= max && _size <= max - g_usage);
+	} // fits
+} // anonymous namespace
+
+namespace irods::http::memory_budget
+{
+	reservation::reservation(reservation&& _other) noexcept
+		: size_{std::exchange(_other.size_, 0)}
+	{
+	} // reservation (move constructor)
+
+	auto reservation::operator=(reservation&& _other) noexcept -> reservation&
+	{
+		if (this != &_other) {
+			release();
+			size_ = std::exchange(_other.size_, 0);
+		}
+
+		return *this;
+	} // reservation (move assignment)
+
+	reservation::~reservation()
+	{
+		release();
+	} // reservation (destructor)
+
+	auto reservation::release() noexcept -> void
+	{
+		if (size_ == 0) {
+			return;
+		}
+
+		std::vector<waiter> granted;
+
+		{
+			std::scoped_lock lk{g_mtx};
+
+			g_usage -= std::min(g_usage, std::exchange(size_, 0));
+
+			// Waiters are granted in order. Skipping a large reservation would starve it.
+			while (!g_waiters.empty() && fits(g_waiters.front().size)) {
+				g_usage += g_waiters.front().size;
+				granted.push_back(std::move(g_waiters.front()));
+				g_waiters.pop_front();
+			}
+		}
+
+		for (auto&& w : granted) {
+			w.handler(reservation{w.size});
+		}
+	} // release
+
+	auto limit() -> std::uint64_t
+	{
+		static const auto max = static_cast<std::uint64_t>(std::max<std::int64_t>(
+			irods::http::globals::configuration().value(
+				nlohmann::json::json_pointer{"/http_server/requests/max_size_of_buffered_data_in_bytes"},
+				std::int64_t{1073741824}),
+			0));
+
+		return max;
+	} // limit
+
+	auto usage() -> std::uint64_t
+	{
+		std::scoped_lock lk{g_mtx};
+		return g_usage;
+	} // usage
+
+	auto number_of_waiters() -> std::size_t
+	{
+		std::scoped_lock lk{g_mtx};
+		return g_waiters.size();
+	} // number_of_waiters
+
+	auto acquire(std::uint64_t _size) -> reservation
+	{
+		std::scoped_lock lk{g_mtx};
+		g_usage += _size;
+		return reservation{_size};
+	} // acquire
+
+	auto async_reserve(std::uint64_t _size, std::function<void(reservation)> _handler) -> void
+	{
+		{
+			std::scoped_lock lk{g_mtx};
+
+			if (!g_waiters.empty() || !fits(_size)) {
+				g_waiters.push_back({_size, std::move(_handler)});
+				return;
+			}
+
+			g_usage += _size;
+		}
+
+		_handler(reservation{_size});
+	} // async_reserve
+} // namespace irods::http::memory_budget
@@ -8,11 +8,25 @@
 
 #include <boost/algorithm/string.hpp>
 
+#include <atomic>
+#include <iterator>
+
 // clang-format off
 namespace beast = boost::beast; // from <boost/beast.hpp>
 namespace net   = boost::asio;  // from <boost/asio.hpp>
 // clang-format on
 
+namespace
+{
+	// The number of JWKs fetched from the OpenID Provider.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::atomic<std::size_t> g_number_of_jwks{};
+
+	// The time at which the JWKs were fetched. Holds the epoch until then.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::atomic<std::chrono::steady_clock::time_point> g_jwks_loaded_at{};
+} // anonymous namespace
+
 namespace irods::http::openid
 {
 	using jwt_verifier = jwt::verifier<jwt::default_clock, jwt::traits::nlohmann_json>;
@@ -517,7 +531,12 @@ namespace irods::http::openid
 
 		try {
 			// Parse the JWKs discovered from the OpenID Provider
-			static auto jwks{jwt::parse_jwks<jwt::traits::nlohmann_json>(fetch_jwks_from_openid_provider())};
+			static auto jwks{[] {
+				auto keys{jwt::parse_jwks<jwt::traits::nlohmann_json>(fetch_jwks_from_openid_provider())};
+				g_number_of_jwks = static_cast<std::size_t>(std::distance(std::cbegin(keys), std::cend(keys)));
+				g_jwks_loaded_at = std::chrono::steady_clock::now();
+				return keys;
+			}()};
 
 			// Handling missing 'typ'
 			if (!_jwt.has_type()) {
@@ -641,4 +660,15 @@ namespace irods::http::openid
 			return std::nullopt;
 		}
 	} // validate_using_local_validation
+
+	auto jwks_cache_stats() -> jwks_cache_statistics
+	{
+		const auto loaded_at = g_jwks_loaded_at.load();
+
+		if (loaded_at == std::chrono::steady_clock::time_point{}) {
+			return {};
+		}
+
+		return {true, g_number_of_jwks.load(), std::chrono::steady_clock::now() - loaded_at};
+	} // jwks_cache_stats
 } //namespace irods::http::openid
@@ -1,5 +1,8 @@
 #include "irods/private/http_api/process_stash.hpp"
 
+#include "irods/private/http_api/lock_instrumentation.hpp"
+
+#include <boost/core/demangle.hpp>
 #include <boost/uuid/uuid.hpp>
 #include <boost/uuid/uuid_generators.hpp>
 #include <boost/uuid/uuid_io.hpp>
@@ -15,7 +18,9 @@ namespace
 	std::unordered_map<std::string, boost::any> g_stash; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
 
 	// A mutex which protects the map from data corruption.
-	std::shared_mutex g_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	irods::http::instrumented_mutex<std::shared_mutex> g_mtx{
+		irods::http::lock_instrumentation::statistics("process_stash")};
 
 	auto generate_unique_key() -> std::string
 	{
@@ -81,4 +86,17 @@ namespace irods::http::process_stash
 
 		return handles;
 	} // handles
+
+	auto count_by_type() -> std::map<std::string, std::size_t>
+	{
+		std::map<std::string, std::size_t> counts;
+
+		std::shared_lock lock{g_mtx};
+
+		for (const auto& [k, v] : g_stash) {
+			++counts[boost::core::demangle(v.type().name())];
+		}
+
+		return counts;
+	} // count_by_type
 } // namespace irods::http::process_stash
@@ -0,0 +1,282 @@
+#include "irods/private/http_api/profiler.hpp"
+
+#include "irods/private/http_api/log.hpp"
+
+#include <boost/core/demangle.hpp>
+
+#include <fmt/format.h>
+
+#include <dlfcn.h>
+#include <execinfo.h>
+#include <malloc.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <fstream>
+#include <map>
+#include <stdexcept>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// The maximum number of frames recorded per sample. Deeper stacks are truncated at the root.
+	constexpr int max_stack_depth = 48;
+
+	// The frames belonging to the signal handler and the signal trampoline.
+	constexpr int number_of_frames_to_skip = 2;
+
+	// Bounds the memory used by a profile to roughly 12 MiB.
+	constexpr std::size_t max_number_of_samples = 32768;
+
+	struct sample
+	{
+		int depth;
+		std::array<void*, max_stack_depth> frames;
+	}; // struct sample
+
+	// Whether a profile is being captured. Only one profile is captured at a time.
+	std::atomic<bool> g_profiling{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// Whether the signal handler records samples.
+	std::atomic<bool> g_sampling{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// The number of signal handlers which are running.
+	std::atomic<int> g_active_handlers{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// The buffer holding the samples. Only accessed while g_profiling is true.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::vector<sample> g_samples;
+
+	// The index of the next free slot in g_samples.
+	std::atomic<std::size_t> g_next_sample{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::atomic<std::uint64_t> g_number_of_dropped_samples{};
+
+	// The handler for SIGPROF. Only async-signal-safe operations are allowed here. backtrace()
+	// qualifies once it has been called outside of a signal handler, which loads the unwinder.
+	auto on_sigprof(int, siginfo_t*, void*) -> void
+	{
+		const auto saved_errno = errno;
+
+		++g_active_handlers;
+
+		if (g_sampling) {
+			if (const auto i = g_next_sample.fetch_add(1); i < g_samples.size()) {
+				auto& s = g_samples[i];
+				s.depth = backtrace(s.frames.data(), max_stack_depth);
+			}
+			else {
+				++g_number_of_dropped_samples;
+			}
+		}
+
+		--g_active_handlers;
+
+		errno = saved_errno;
+	} // on_sigprof
+
+	auto set_profiling_timer(int _frequency) -> bool
+	{
+		itimerval timer{};
+
+		if (_frequency > 0) {
+			constexpr auto microseconds_per_second = 1'000'000;
+			const auto interval = std::max(microseconds_per_second / _frequency, 1);
+			timer.it_interval.tv_sec = interval / microseconds_per_second;
+			timer.it_interval.tv_usec = interval % microseconds_per_second;
+			timer.it_value = timer.it_interval;
+		}
+
+		return setitimer(ITIMER_PROF, &timer, nullptr) == 0;
+	} // set_profiling_timer
+
+	auto symbolize(void* _address) -> std::string
+	{
+		Dl_info info{};
+
+		if (dladdr(_address, &info) == 0) {
+			return fmt::format("{}", _address);
+		}
+
+		if (info.dli_sname) {
+			return boost::core::demangle(info.dli_sname);
+		}
+
+		if (info.dli_fname) {
+			std::string_view module = info.dli_fname;
+
+			if (const auto pos = module.rfind('/'); pos != std::string_view::npos) {
+				module.remove_prefix(pos + 1);
+			}
+
+			const auto offset = static_cast<char*>(_address) - static_cast<char*>(info.dli_fbase);
+			return fmt::format("{}+{:#x}", module, offset);
+		}
+
+		return fmt::format("{}", _address);
+	} // symbolize
+
+	// Aggregates the first \p _count samples by call stack.
+	auto fold(std::size_t _count) -> std::string
+	{
+		std::unordered_map<void*, std::string> symbols;
+		std::map<std::string, std::uint64_t> stacks;
+
+		const auto lookup = [&symbols](void* _address) -> const std::string& {
+			auto iter = symbols.find(_address);
+
+			if (iter == std::end(symbols)) {
+				iter = symbols.emplace(_address, symbolize(_address)).first;
+			}
+
+			return iter->second;
+		};
+
+		std::string stack;
+
+		for (std::size_t i = 0; i < _count; ++i) {
+			const auto& s = g_samples[i];
+
+			stack.clear();
+
+			// Walk from the root to the leaf. Return addresses point at the instruction following
+			// the call, therefore, the address is adjusted to land inside the calling function.
+			for (auto j = s.depth - 1; j >= number_of_frames_to_skip; --j) {
+				auto* address = s.frames[j]; // NOLINT(cppcoreguidelines-pro-bounds-constant-array-index)
+
+				if (j > number_of_frames_to_skip) {
+					address = static_cast<char*>(address) - 1;
+				}
+
+				if (!stack.empty()) {
+					stack += ';';
+				}
+
+				stack += lookup(address);
+			}
+
+			if (!stack.empty()) {
+				++stacks[stack];
+			}
+		}
+
+		std::string folded;
+
+		for (auto&& [frames, count] : stacks) {
+			fmt::format_to(std::back_inserter(folded), "{} {}\n", frames, count);
+		}
+
+		return folded;
+	} // fold
+} // anonymous namespace
+
+namespace irods::http::profiler
+{
+	auto profile_cpu(std::chrono::seconds _duration, int _frequency) -> std::optional<cpu_profile>
+	{
+		if (g_profiling.exchange(true)) {
+			return std::nullopt;
+		}
+
+		struct reset_profiling_flag
+		{
+			~reset_profiling_flag()
+			{
+				g_samples = {};
+				g_profiling = false;
+			}
+		} reset;
+
+		// Load the unwinder before the signal handler needs it.
+		{
+			std::array<void*, 1> frames{};
+			backtrace(frames.data(), static_cast<int>(frames.size()));
+		}
+
+		const auto capacity = static_cast<std::size_t>(_frequency) * static_cast<std::size_t>(_duration.count()) *
+		                      std::max(std::thread::hardware_concurrency(), 1U);
+
+		g_samples.assign(std::min(capacity, max_number_of_samples), sample{});
+		g_next_sample = 0;
+		g_number_of_dropped_samples = 0;
+
+		// The handler is left installed once the profile ends. A signal generated before the
+		// timer was disarmed may still be pending, and the default action for SIGPROF terminates
+		// the process.
+		struct sigaction action{};
+		action.sa_sigaction = on_sigprof;
+		action.sa_flags = SA_RESTART | SA_SIGINFO;
+		sigemptyset(&action.sa_mask);
+
+		if (sigaction(SIGPROF, &action, nullptr) != 0) {
+			throw std::runtime_error{"Could not install SIGPROF handler."};
+		}
+
+		g_sampling = true;
+
+		const auto start = std::chrono::steady_clock::now();
+
+		if (!set_profiling_timer(_frequency)) {
+			g_sampling = false;
+			throw std::runtime_error{"Could not arm profiling timer."};
+		}
+
+		irods::http::log::info(
+			"{}: Capturing CPU profile for [{}] seconds at [{}] Hz.", __func__, _duration.count(), _frequency);
+
+		std::this_thread::sleep_for(_duration);
+
+		set_profiling_timer(0);
+		g_sampling = false;
+
+		const auto elapsed = std::chrono::steady_clock::now() - start;
+
+		// Handlers which started before sampling was turned off may still be writing samples.
+		while (g_active_handlers > 0) {
+			std::this_thread::yield();
+		}
+
+		const auto number_of_samples = std::min(g_next_sample.load(), g_samples.size());
+
+		return cpu_profile{
+			.duration = std::chrono::duration_cast<std::chrono::milliseconds>(elapsed),
+			.number_of_samples = number_of_samples,
+			.number_of_dropped_samples = g_number_of_dropped_samples.load(),
+			.folded_stacks = fold(number_of_samples)};
+	} // profile_cpu
+
+	auto heap_stats() -> heap_statistics
+	{
+		heap_statistics stats{};
+
+#if defined(__GLIBC__) && (__GLIBC__ > 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ >= 33))
+		const auto info = mallinfo2();
+		stats.arena_bytes = info.arena;
+		stats.mmapped_bytes = info.hblkhd;
+		stats.in_use_bytes = info.uordblks;
+		stats.free_bytes = info.fordblks;
+		stats.releasable_bytes = info.keepcost;
+#endif
+
+		// The second field of /proc/self/statm holds the number of resident pages.
+		if (std::ifstream in{"/proc/self/statm"}; in) {
+			std::uint64_t size{};
+			std::uint64_t resident{};
+
+			if (in >> size >> resident) {
+				stats.resident_bytes = resident * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+			}
+		}
+
+		return stats;
+	} // heap_stats
+} // namespace irods::http::profiler
@@ -0,0 +1,303 @@
+#include "irods/private/http_api/rate_limiter.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+
+namespace
+{
+	using clock_type = std::chrono::steady_clock;
+
+	// The number of shards per map. Requests of different clients rarely contend for the lock
+	// of a shard, and the lock is only held exclusively when a new client is added.
+	constexpr std::size_t number_of_shards = 16;
+
+	// The number of entries a shard may hold before idle entries are removed.
+	constexpr std::size_t max_number_of_entries_per_shard = 1024;
+
+	struct rate
+	{
+		// The amount of time represented by a single unit (request or byte). 0 means unlimited.
+		std::int64_t nanoseconds_per_unit;
+		std::int64_t units_per_second;
+	}; // struct rate
+
+	struct limiter_config
+	{
+		rate user_requests;
+		rate user_bytes;
+		rate token_requests;
+		rate token_bytes;
+
+		// The amount of traffic allowed in a burst, in nanoseconds. Bursts are measured in time
+		// so that the same setting applies to every rate.
+		std::int64_t burst;
+	}; // struct limiter_config
+
+	// A token bucket implemented via the generic cell rate algorithm. The bucket stores the
+	// theoretical arrival time (TAT), which is the time at which the bucket will be full again.
+	// The TAT is only updated while holding the mutex of the entry. It is atomic so that idle
+	// entries can be found without locking them.
+	struct bucket
+	{
+		std::atomic<std::int64_t> tat{};
+	}; // struct bucket
+
+	struct entry
+	{
+		std::mutex mtx;
+		bucket requests;
+		bucket bytes;
+	}; // struct entry
+
+	// A bucket which allows the request being checked, and the TAT it is set to if every other
+	// bucket allows the request as well.
+	struct charge
+	{
+		bucket* target;
+		std::int64_t new_tat;
+	}; // struct charge
+
+	struct shard
+	{
+		std::shared_mutex mtx;
+		std::unordered_map<std::string, std::shared_ptr<entry>> entries;
+	}; // struct shard
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	std::array<shard, number_of_shards> g_user_shards;
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	std::array<shard, number_of_shards> g_token_shards;
+
+	// The number of rejected requests.
+	std::atomic<std::uint64_t> g_number_of_rejections{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// The number of rejected requests per user. Only updated when a request is rejected.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::map<std::string, std::uint64_t, std::less<>> g_rejections;
+
+	// A mutex which protects the rejection counts from data corruption.
+	std::mutex g_rejections_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+
+	auto to_rate(std::int64_t _units_per_second) -> rate
+	{
+		constexpr std::int64_t nanoseconds_per_second = 1'000'000'000;
+
+		if (_units_per_second <= 0) {
+			return {0, 0};
+		}
+
+		return {std::max<std::int64_t>(nanoseconds_per_second / _units_per_second, 1), _units_per_second};
+	} // to_rate
+
+	auto config() -> const limiter_config&
+	{
+		static const auto cfg = [] {
+			using json_pointer = nlohmann::json::json_pointer;
+
+			const auto& config = irods::http::globals::configuration();
+
+			const auto get = [&config](const char* _name) {
+				return config.value(json_pointer{_name}, std::int64_t{0});
+			};
+
+			const auto burst =
+				std::max(config.value(json_pointer{"/http_server/rate_limits/burst_size_in_seconds"}, 1), 1);
+
+			return limiter_config{
+				to_rate(get("/http_server/rate_limits/per_user/requests_per_second")),
+				to_rate(get("/http_server/rate_limits/per_user/bytes_per_second")),
+				to_rate(get("/http_server/rate_limits/per_bearer_token/requests_per_second")),
+				to_rate(get("/http_server/rate_limits/per_bearer_token/bytes_per_second")),
+				std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::seconds{burst}).count()};
+		}();
+
+		return cfg;
+	} // config
+
+	auto now_in_nanoseconds() -> std::int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(clock_type::now().time_since_epoch()).count();
+	} // now_in_nanoseconds
+
+	// Returns the entry for \p _key, creating it if necessary.
+	auto find_entry(std::array<shard, number_of_shards>& _shards, std::string_view _key) -> std::shared_ptr<entry>
+	{
+		auto& s = _shards[std::hash<std::string_view>{}(_key) % number_of_shards];
+
+		{
+			std::shared_lock lk{s.mtx};
+			if (const auto iter = s.entries.find(std::string{_key}); iter != std::end(s.entries)) {
+				return iter->second;
+			}
+		}
+
+		std::scoped_lock lk{s.mtx};
+
+		// Entries whose buckets are full carry no state, so they can be recreated at any time.
+		if (s.entries.size() >= max_number_of_entries_per_shard) {
+			const auto now = now_in_nanoseconds();
+			std::erase_if(s.entries, [now](const auto& _kv) {
+				return _kv.second->requests.tat.load() <= now && _kv.second->bytes.tat.load() <= now;
+			});
+		}
+
+		auto& e = s.entries[std::string{_key}];
+		if (!e) {
+			e = std::make_shared<entry>();
+		}
+
+		return e;
+	} // find_entry
+
+	// Computes the charge of taking \p _units from \p _bucket at time \p _now. The bucket is not
+	// modified. The mutex of the entry holding the bucket must be locked.
+	//
+	// \returns 0 if the bucket allows the units. Otherwise, the number of nanoseconds to wait.
+	auto plan(
+		bucket& _bucket,
+		const rate& _rate,
+		std::int64_t _units,
+		std::int64_t _burst,
+		std::int64_t _now,
+		charge& _charge) -> std::int64_t
+	{
+		_charge = {nullptr, 0};
+
+		if (0 == _rate.nanoseconds_per_unit || 0 == _units) {
+			return 0;
+		}
+
+		// Computed in floating point to avoid overflow for large byte counts.
+		const auto increment = static_cast<std::int64_t>(
+			static_cast<double>(_units) * 1e9 / static_cast<double>(_rate.units_per_second));
+
+		// A single request larger than the burst is allowed once the bucket is full.
+		const auto tolerance = std::max(_burst, increment);
+
+		const auto new_tat = std::max(_bucket.tat.load(std::memory_order_relaxed), _now) + increment;
+
+		if (new_tat - _now > tolerance) {
+			return new_tat - _now - tolerance;
+		}
+
+		_charge = {&_bucket, new_tat};
+
+		return 0;
+	} // plan
+
+	auto reject(std::string_view _username) -> void
+	{
+		g_number_of_rejections.fetch_add(1, std::memory_order_relaxed);
+
+		std::scoped_lock lk{g_rejections_mtx};
+
+		if (auto iter = g_rejections.find(_username); iter != std::end(g_rejections)) {
+			++iter->second;
+		}
+		else {
+			g_rejections.emplace(_username, 1);
+		}
+	} // reject
+} // anonymous namespace
+
+namespace irods::http::rate_limiter
+{
+	auto enabled() -> bool
+	{
+		const auto& cfg = config();
+		return cfg.user_requests.units_per_second > 0 || cfg.user_bytes.units_per_second > 0 ||
+		       cfg.token_requests.units_per_second > 0 || cfg.token_bytes.units_per_second > 0;
+	} // enabled
+
+	auto check(std::string_view _username, std::string_view _bearer_token, std::uint64_t _bytes)
+		-> std::optional<std::chrono::seconds>
+	{
+		if (!enabled()) {
+			return std::nullopt;
+		}
+
+		const auto& cfg = config();
+		const auto bytes = static_cast<std::int64_t>(std::min<std::uint64_t>(_bytes, INT64_MAX / 2));
+
+		std::shared_ptr<entry> user;
+		if (cfg.user_requests.units_per_second > 0 || cfg.user_bytes.units_per_second > 0) {
+			user = find_entry(g_user_shards, _username);
+		}
+
+		std::shared_ptr<entry> token;
+		if (cfg.token_requests.units_per_second > 0 || cfg.token_bytes.units_per_second > 0) {
+			token = find_entry(g_token_shards, _bearer_token);
+		}
+
+		// The buckets of the user and the token are updated together, so that a request which is
+		// rejected by one bucket does not use up the quota of the others. std::lock keeps requests
+		// which lock the same entries from deadlocking.
+		std::unique_lock<std::mutex> user_lk;
+		std::unique_lock<std::mutex> token_lk;
+
+		if (user && token) {
+			user_lk = std::unique_lock{user->mtx, std::defer_lock};
+			token_lk = std::unique_lock{token->mtx, std::defer_lock};
+			std::lock(user_lk, token_lk);
+		}
+		else if (user) {
+			user_lk = std::unique_lock{user->mtx};
+		}
+		else if (token) {
+			token_lk = std::unique_lock{token->mtx};
+		}
+
+		const auto now = now_in_nanoseconds();
+
+		std::array<charge, 4> charges{};
+		std::int64_t wait = 0;
+
+		if (user) {
+			wait = std::max(wait, plan(user->requests, cfg.user_requests, 1, cfg.burst, now, charges[0]));
+			wait = std::max(wait, plan(user->bytes, cfg.user_bytes, bytes, cfg.burst, now, charges[1]));
+		}
+
+		if (token) {
+			wait = std::max(wait, plan(token->requests, cfg.token_requests, 1, cfg.burst, now, charges[2]));
+			wait = std::max(wait, plan(token->bytes, cfg.token_bytes, bytes, cfg.burst, now, charges[3]));
+		}
+
+		if (0 == wait) {
+			for (auto&& c : charges) {
+				if (c.target) {
+					c.target->tat.store(c.new_tat, std::memory_order_relaxed);
+				}
+			}
+
+			return std::nullopt;
+		}
+
+		reject(_username);
+
+		// Round up so that clients which honor the delay are not rejected again.
+		const auto seconds = std::chrono::ceil<std::chrono::seconds>(std::chrono::nanoseconds{wait});
+		return std::max(seconds, std::chrono::seconds{1});
+	} // check
+
+	auto number_of_rejected_requests() -> std::uint64_t
+	{
+		return g_number_of_rejections.load(std::memory_order_relaxed);
+	} // number_of_rejected_requests
+
+	auto number_of_rejected_requests_per_user() -> std::map<std::string, std::uint64_t, std::less<>>
+	{
+		std::scoped_lock lk{g_rejections_mtx};
+		return g_rejections;
+	} // number_of_rejected_requests_per_user
+} // namespace irods::http::rate_limiter
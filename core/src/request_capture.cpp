@@ -0,0 +1,444 @@
+#include "irods/private/http_api/request_capture.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+#include "irods/private/http_api/multipart_form_data.hpp"
+
+#include <irods/irods_at_scope_exit.hpp>
+
+#include <boost/algorithm/string.hpp>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <condition_variable>
+#include <deque>
+#include <random>
+#include <stop_token>
+#include <thread>
+
+namespace
+{
+	using json = nlohmann::json;
+
+	// The number of captured requests, and the number of bytes of their bodies, allowed to wait
+	// for the writer. Requests are dropped when the writer cannot keep up, so that capturing
+	// never slows down requests.
+	constexpr std::size_t max_number_of_queued_requests = 4096;
+	constexpr std::size_t max_number_of_queued_bytes = 64 * 1024 * 1024;
+
+	// The version of the format of the capture file.
+	constexpr int capture_format_version = 1;
+
+	constexpr const char* redacted = "<redacted>";
+
+	// Headers whose values are never written.
+	constexpr std::array<std::string_view, 3> sensitive_headers{"authorization", "cookie", "proxy-authorization"};
+
+	// Headers which describe the connection or the encoding of the body. The replay tool
+	// recomputes them.
+	constexpr std::array<std::string_view, 4> ignored_headers{
+		"connection", "content-length", "host", "transfer-encoding"};
+
+	// Query parameters and form fields which carry the contents of data objects. Only their
+	// size is written.
+	constexpr std::array<std::string_view, 1> content_parameters{"bytes"};
+
+	// Query parameters and form fields whose values are never written.
+	constexpr std::array<std::string_view, 9> sensitive_parameters{
+		"access_token",
+		"client_secret",
+		"code",
+		"id_token",
+		"new-password",
+		"password",
+		"refresh_token",
+		"state",
+		"ticket"};
+
+	// A request waiting to be written.
+	struct captured_request
+	{
+		// Holds the body only if it is written field by field or is small enough to be written
+		// in full.
+		irods::http::request_type request;
+		std::size_t body_size;
+		std::chrono::steady_clock::time_point received_at;
+	}; // struct captured_request
+
+	struct capture_config
+	{
+		bool enabled;
+		double sampling_ratio;
+		std::string path;
+		std::size_t max_value_size;
+	}; // struct capture_config
+
+	auto config() -> const capture_config&
+	{
+		static const auto cfg = [] {
+			using json_pointer = json::json_pointer;
+
+			const auto& config = irods::http::globals::configuration();
+
+			return capture_config{
+				config.value(json_pointer{"/http_server/request_capture/enabled"}, false),
+				std::clamp(config.value(json_pointer{"/http_server/request_capture/sampling_ratio"}, 1.0), 0.0, 1.0),
+				config.value(
+					json_pointer{"/http_server/request_capture/path"},
+					std::string{"/tmp/irods_http_api_requests.jsonl"}),
+				static_cast<std::size_t>(std::max(
+					config.value(json_pointer{"/http_server/request_capture/max_size_of_value_in_bytes"}, 4096),
+					0))};
+		}();
+
+		return cfg;
+	} // config
+
+	// The time all captured requests are relative to.
+	auto capture_started_at() -> std::chrono::steady_clock::time_point
+	{
+		static const auto t = std::chrono::steady_clock::now();
+		return t;
+	} // capture_started_at
+
+	auto contains(const auto& _names, std::string_view _name) -> bool
+	{
+		return std::any_of(std::begin(_names), std::end(_names), [_name](std::string_view _n) {
+			return boost::iequals(_n, _name);
+		});
+	} // contains
+
+	// Returns \p _value as a JSON string, or an object holding its size if it is too large or
+	// is not valid UTF-8.
+	auto to_value(std::string_view _value) -> json
+	{
+		if (_value.size() <= config().max_value_size) {
+			json value = std::string{_value};
+
+			try {
+				// Throws if the string is not valid UTF-8.
+				static_cast<void>(value.dump());
+				return value;
+			}
+			catch (const json::type_error&) {
+			}
+		}
+
+		return {{"size", _value.size()}};
+	} // to_value
+
+	auto to_parameters(const irods::http::query_arguments_type& _args) -> json
+	{
+		auto params = json::object();
+
+		for (auto&& [k, v] : _args) {
+			if (contains(sensitive_parameters, k)) {
+				params[k] = redacted;
+			}
+			else if (contains(content_parameters, k)) {
+				params[k] = {{"size", v.size()}};
+			}
+			else {
+				params[k] = to_value(v);
+			}
+		}
+
+		return params;
+	} // to_parameters
+
+	// Returns whether the body of a request with \p _content_type is written field by field.
+	auto is_form(std::string_view _content_type) -> bool
+	{
+		return boost::istarts_with(_content_type, "application/x-www-form-urlencoded") ||
+		       boost::istarts_with(_content_type, "multipart/form-data");
+	} // is_form
+
+	auto to_json(const captured_request& _captured) -> json
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::microseconds;
+
+		const auto& req = _captured.request;
+		const auto url = irods::http::parse_url(req);
+
+		auto headers = json::object();
+
+		for (auto&& h : req.base()) {
+			const std::string_view name{h.name_string().data(), h.name_string().size()};
+
+			if (contains(ignored_headers, name)) {
+				continue;
+			}
+
+			if (contains(sensitive_headers, name)) {
+				// Keep the scheme (e.g. Bearer, Basic) so that the replay tool knows which
+				// credentials to substitute.
+				const std::string_view value{h.value().data(), h.value().size()};
+				const auto scheme = value.substr(0, value.find(' '));
+				headers[std::string{name}] = (scheme.size() < value.size())
+				                                 ? fmt::format("{} {}", scheme, redacted)
+				                                 : std::string{redacted};
+				continue;
+			}
+
+			headers[std::string{name}] = std::string{h.value()};
+		}
+
+		// Requests whose header arrived before the first request was captured are placed at the
+		// start of the capture.
+		const auto t =
+			std::max(duration_cast<microseconds>(_captured.received_at - capture_started_at()), microseconds{});
+
+		// clang-format off
+		json record{
+			{"t", t.count()},
+			{"method", std::string{req.method_string()}},
+			{"path", url.path},
+			{"query", to_parameters(url.query)},
+			{"headers", headers}
+		};
+		// clang-format on
+
+		if (0 == _captured.body_size) {
+			return record;
+		}
+
+		const auto& body = req.body();
+
+		const auto content_type_header = req.base()["content-type"];
+		const std::string_view content_type{content_type_header.data(), content_type_header.size()};
+
+		if (!is_form(content_type) && body.size() != _captured.body_size) {
+			// The body was too large to be kept.
+			record["body"] = {{"size", _captured.body_size}};
+		}
+		else if (boost::istarts_with(content_type, "application/x-www-form-urlencoded")) {
+			record["form"] = to_parameters(irods::http::to_argument_list(body));
+		}
+		else if (boost::istarts_with(content_type, "multipart/form-data")) {
+			if (const auto boundary = irods::http::get_multipart_form_data_boundary(content_type); boundary) {
+				record["form"] = to_parameters(irods::http::parse_multipart_form_data(*boundary, body));
+			}
+			else {
+				record["body"] = {{"size", body.size()}};
+			}
+		}
+		else {
+			record["body"] = to_value(body);
+		}
+
+		return record;
+	} // to_json
+
+	// Writes all of \p _data to \p _fd.
+	auto write_all(int _fd, std::string_view _data) -> bool
+	{
+		while (!_data.empty()) {
+			const auto n = ::write(_fd, _data.data(), _data.size());
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+
+				return false;
+			}
+
+			_data.remove_prefix(static_cast<std::size_t>(n));
+		}
+
+		return true;
+	} // write_all
+
+	// Appends captured requests to the capture file on a dedicated thread so that requests
+	// never wait for I/O.
+	class writer
+	{
+	  public:
+		writer()
+			: thread_{[this](std::stop_token _stoken) { run(std::move(_stoken)); }}
+		{
+		} // writer (constructor)
+
+		writer(const writer&) = delete;
+		auto operator=(const writer&) -> writer& = delete;
+
+		writer(writer&&) = delete;
+		auto operator=(writer&&) -> writer& = delete;
+
+		~writer() = default;
+
+		auto enqueue(captured_request&& _request) -> void
+		{
+			{
+				std::scoped_lock lk{mtx_};
+
+				const auto size = _request.request.body().size();
+
+				if (queue_.size() >= max_number_of_queued_requests ||
+				    size > max_number_of_queued_bytes - std::min(queued_bytes_, max_number_of_queued_bytes))
+				{
+					++dropped_;
+					return;
+				}
+
+				queued_bytes_ += size;
+				queue_.push_back(std::move(_request));
+			}
+
+			cv_.notify_one();
+		} // enqueue
+
+	  private:
+		auto run(std::stop_token _stoken) -> void
+		{
+			using std::chrono::duration_cast;
+			using std::chrono::seconds;
+
+			const auto& cfg = config();
+
+			// The capture holds the paths, parameters and bodies of requests. Only the user running
+			// the server may read it, even if the file already existed.
+			// NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+			auto fd = ::open(cfg.path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, S_IRUSR | S_IWUSR);
+			irods::at_scope_exit close_fd{[&fd] {
+				if (fd >= 0) {
+					::close(fd);
+				}
+			}};
+
+			if (fd >= 0 && ::fchmod(fd, S_IRUSR | S_IWUSR) != 0) {
+				::close(fd);
+				fd = -1;
+			}
+
+			if (fd < 0) {
+				irods::http::log::error(
+					"Could not open request capture file [{}]. Requests will not be captured.", cfg.path);
+			}
+			else {
+				// The system time at which the capture started, so that the times of requests
+				// can be mapped to other logs.
+				const auto started_at = std::chrono::system_clock::now() -
+				                        duration_cast<std::chrono::system_clock::duration>(
+											std::chrono::steady_clock::now() - capture_started_at());
+
+				// clang-format off
+				write_all(fd, json{{"capture", {
+					{"version", capture_format_version},
+					{"started_at", duration_cast<seconds>(started_at.time_since_epoch()).count()}
+				}}}.dump() + '\n');
+				// clang-format on
+
+				irods::http::log::info("Capturing requests to [{}].", cfg.path);
+			}
+
+			std::deque<captured_request> requests;
+			std::string lines;
+
+			while (true) {
+				std::size_t dropped{};
+
+				{
+					std::unique_lock lk{mtx_};
+
+					// Returns false if a stop was requested and nothing is left to write.
+					if (!cv_.wait(lk, _stoken, [this] { return !queue_.empty(); })) {
+						return;
+					}
+
+					requests.swap(queue_);
+					std::swap(dropped, dropped_);
+					queued_bytes_ = 0;
+				}
+
+				if (dropped > 0) {
+					irods::http::log::warn("Request capture dropped [{}] requests.", dropped);
+				}
+
+				// Requests are serialized here rather than by the threads serving them.
+				if (fd >= 0) {
+					for (const auto& r : requests) {
+						try {
+							lines += to_json(r).dump();
+							lines += '\n';
+						}
+						catch (const std::exception& e) {
+							irods::http::log::error("Could not capture request: {}", e.what());
+						}
+					}
+
+					if (!write_all(fd, lines)) {
+						irods::http::log::error(
+							"Could not write to request capture file [{}]. Requests will not be captured.", cfg.path);
+						::close(fd);
+						fd = -1;
+					}
+				}
+
+				requests.clear();
+				lines.clear();
+			}
+		} // run
+
+		std::mutex mtx_;
+		std::condition_variable_any cv_;
+		std::deque<captured_request> queue_;
+		std::size_t queued_bytes_{};
+		std::size_t dropped_{};
+
+		// Declared last so that the thread is stopped before the members it uses are destroyed.
+		std::jthread thread_;
+	}; // class writer
+
+	auto get_writer() -> writer&
+	{
+		static writer w;
+		return w;
+	} // get_writer
+} // anonymous namespace
+
+namespace irods::http::request_capture
+{
+	auto enabled() -> bool
+	{
+		return config().enabled;
+	} // enabled
+
+	auto capture(const request_type& _req, std::chrono::steady_clock::time_point _received_at) -> void
+	{
+		const auto& cfg = config();
+
+		if (!cfg.enabled) {
+			return;
+		}
+
+		if (cfg.sampling_ratio < 1.0) {
+			thread_local std::mt19937_64 engine{std::random_device{}()};
+
+			if (std::uniform_real_distribution<double>{0.0, 1.0}(engine) >= cfg.sampling_ratio) {
+				return;
+			}
+		}
+
+		// Only the parts of the request which are written are copied. Serializing them is left to
+		// the writer.
+		try {
+			const auto content_type = _req.base()["content-type"];
+			const auto keep_body =
+				is_form({content_type.data(), content_type.size()}) || _req.body().size() <= cfg.max_value_size;
+
+			get_writer().enqueue({keep_body ? _req : request_type{_req.base()}, _req.body().size(), _received_at});
+		}
+		catch (const std::exception& e) {
+			irods::http::log::error("{}: Could not capture request: {}", __func__, e.what());
+		}
+	} // capture
+} // namespace irods::http::request_capture
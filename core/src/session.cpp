@@ -3,9 +3,12 @@
 //#include "irods/private/http_api/common.hpp"
 #include "irods/private/http_api/globals.hpp"
 #include "irods/private/http_api/log.hpp"
+#include "irods/private/http_api/request_capture.hpp"
 
+#include <boost/algorithm/string.hpp>
 #include <boost/beast/version.hpp>
 #include <boost/asio/dispatch.hpp>
+#include <boost/asio/post.hpp>
 #include <boost/asio/strand.hpp>
 #include <boost/asio/signal_set.hpp>
 #include <boost/asio/thread_pool.hpp>
@@ -13,13 +16,34 @@
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
+#include <array>
+#include <cstdint>
 #include <chrono>
 #include <iterator>
+#include <limits>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <unordered_set>
 #include <utility>
 
-#ifdef IRODS_WRITE_REQUEST_TO_TEMP_FILE
-#  include <fstream>
-#endif
+namespace
+{
+	// Endpoints which do not require a bearer token. Requests for all other endpoints are
+	// authenticated before the body is read.
+	// IRODS_HTTP_API_BASE_URL is a macro defined by the CMakeLists.txt.
+	constexpr std::array<std::string_view, 3> endpoints_without_bearer_token{
+		IRODS_HTTP_API_BASE_URL "/authenticate", IRODS_HTTP_API_BASE_URL "/info", IRODS_HTTP_API_BASE_URL "/metrics"};
+
+	// All live sessions. Used for introspection only.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	std::unordered_set<const irods::http::session*> g_sessions;
+
+	// A mutex which protects the set of live sessions from data corruption.
+	std::mutex g_sessions_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+} // anonymous namespace
 
 namespace irods::http
 {
@@ -27,19 +51,87 @@ namespace irods::http
 		boost::asio::ip::tcp::socket&& socket,
 		const request_handler_map_type& _request_handler_map,
 		int _max_body_size,
-		int _timeout_in_seconds)
+		std::shared_ptr<timing_wheel> _timing_wheel,
+		std::chrono::seconds _header_timeout,
+		std::chrono::seconds _body_timeout)
 		: stream_(std::move(socket))
 		, req_handlers_{&_request_handler_map}
 		, max_body_size_{_max_body_size}
-		, timeout_in_secs_{_timeout_in_seconds}
+		, timing_wheel_{std::move(_timing_wheel)}
+		, timeout_{*this}
+		, header_timeout_{_header_timeout}
+		, body_timeout_{_body_timeout}
 	{
+		// The address is captured up front so that it remains available after the client
+		// disconnects.
+		boost::system::error_code ec;
+		if (const auto ep = stream_.socket().remote_endpoint(ec); !ec) {
+			ip_ = ep.address().to_string();
+		}
+
+		std::scoped_lock lk{g_sessions_mtx};
+		g_sessions.insert(this);
 	} // session (constructor)
 
+	session::~session()
+	{
+		{
+			std::scoped_lock lk{g_sessions_mtx};
+			g_sessions.erase(this);
+		}
+
+		timing_wheel_->cancel(timeout_);
+		finish_instrumentation();
+	} // session (destructor)
+
+	auto to_string(session_state _state) -> const char*
+	{
+		// clang-format off
+		switch (_state) {
+			case session_state::reading_header:     return "reading_header";
+			case session_state::waiting_for_memory: return "waiting_for_memory";
+			case session_state::reading_body:       return "reading_body";
+			case session_state::processing:         return "processing";
+			case session_state::writing:            return "writing";
+			case session_state::closed:             return "closed";
+			default:                                return "unknown";
+		}
+		// clang-format on
+	} // to_string
+
 	auto session::ip() const -> std::string
 	{
-		return stream_.socket().remote_endpoint().address().to_string();
+		return ip_;
 	} // ip
 
+	auto session::snapshot(std::size_t _max_sessions) -> sessions_snapshot
+	{
+		const auto now = std::chrono::steady_clock::now();
+
+		sessions_snapshot snapshot{};
+
+		std::scoped_lock lk{g_sessions_mtx};
+
+		snapshot.sessions.reserve(std::min(_max_sessions, g_sessions.size()));
+
+		for (const auto* s : g_sessions) {
+			const auto state = s->state_.load();
+			++snapshot.number_of_sessions_by_state.at(static_cast<std::size_t>(state));
+
+			if (snapshot.sessions.size() < _max_sessions) {
+				snapshot.sessions.push_back({s->ip_, state, now - s->state_changed_at_.load()});
+			}
+		}
+
+		return snapshot;
+	} // snapshot
+
+	auto session::set_state(session_state _state) -> void
+	{
+		state_ = _state;
+		state_changed_at_ = std::chrono::steady_clock::now();
+	} // set_state
+
 	// Start the asynchronous operation
 	auto session::run() -> void
 	{
@@ -53,19 +145,220 @@ namespace irods::http
 
 	auto session::do_read() -> void
 	{
+		stop_watching_for_disconnect();
+		set_state(session_state::reading_header);
+		client_identity_.reset();
+
 		// Construct a new parser for each message.
 		parser_.emplace();
 
-		// Apply the limit defined in the configuration file.
-		parser_->body_limit(max_body_size_);
+		// The limit depends on the operation, which is not known until the header has been read.
+		// It is applied by on_read_header().
+		parser_->body_limit(std::numeric_limits<std::uint64_t>::max());
+		body_limit_ = static_cast<std::uint64_t>(max_body_size_);
+
+		// The session is idle until the header of the next request arrives. The timeout is
+		// managed by the timing wheel rather than by a timer owned by the stream, because arming
+		// a timer per read does not scale to large numbers of keep-alive connections.
+		timing_wheel_->schedule(timeout_, header_timeout_);
+		timing_wheel_->mark_idle(timeout_);
+
+		// Read the header of the request. The body is read once the header has been validated.
+		// This keeps clients from transferring bodies which would be rejected anyway.
+		boost::beast::http::async_read_header(
+			stream_, buffer_, *parser_, boost::beast::bind_front_handler(&session::on_read_header, shared_from_this()));
+	} // do_read
+
+	auto session::on_read_header(boost::beast::error_code ec, std::size_t bytes_transferred) -> void
+	{
+		namespace logging = irods::http::log;
+		namespace http = boost::beast::http;
+
+		boost::ignore_unused(bytes_transferred);
+
+		timing_wheel_->mark_busy(timeout_);
+		timing_wheel_->schedule(timeout_, body_timeout_);
+
+		// This means they closed the connection
+		if (ec == http::error::end_of_stream) {
+			return do_close();
+		}
+
+		if (ec) {
+			return irods::fail(ec, "read");
+		}
+
+		header_received_at_ = std::chrono::steady_clock::now();
+
+		// The trace and timings cover the request from the arrival of its header.
+		const auto traceparent = parser_->get()["traceparent"];
+		trace_ = tracing::trace::start({traceparent.data(), traceparent.size()});
+
+		const auto target = parser_->get().target();
+		const auto endpoint = std::string_view{target.data(), target.size()}.substr(0, target.find('?'));
+		timings_ = slow_requests::start(endpoint);
+
+		// Only known endpoints are accounted for so that the totals cannot grow without bound.
+		if (req_handlers_->contains(endpoint)) {
+			allocations_ = allocation_accounting::start(endpoint);
+		}
+
+		try {
+			tracing::scope trace_scope{trace_};
+			slow_requests::scope timings_scope{timings_};
+			allocation_accounting::scope allocations_scope{allocations_};
+
+			if (auto res = check_request_header(); res) {
+				return reject(std::move(*res));
+			}
+		}
+		catch (const std::exception& e) {
+			logging::error(*this, "{}: {}", __func__, e.what());
+			return reject(irods::http::fail(http::status::internal_server_error));
+		}
+
+		// The request does not have a body.
+		if (parser_->is_done()) {
+			return on_read({}, 0);
+		}
+
+		// The Content-Length exceeds the limit. The limit applied by the parser only covers
+		// chunked requests once the header has been read.
+		if (const auto size = parser_->content_length(); size && *size > body_limit_) {
+			logging::error(*this, "{}: Request constraint error: Content-Length exceeds [{}].", __func__, body_limit_);
+			return reject(irods::http::fail(http::status::payload_too_large));
+		}
+
+		parser_->body_limit(body_limit_);
+
+		reserve_body();
+	} // on_read_header
 
-		// Set the timeout.
-		stream_.expires_after(std::chrono::seconds(timeout_in_secs_));
+	auto session::reserve_body() -> void
+	{
+		set_state(session_state::waiting_for_memory);
+
+		if (trace_) {
+			body_read_started_at_ = tracing::now();
+		}
+
+		// Chunked requests do not declare the size of the body, so the limit is reserved instead.
+		const auto size = parser_->content_length().value_or(body_limit_);
+
+		memory_budget::async_reserve(size, [self = shared_from_this()](memory_budget::reservation _reservation) {
+			// The reservation may be granted by another thread.
+			boost::asio::dispatch(
+				self->stream_.get_executor(), [self, r = std::move(_reservation)]() mutable {
+					self->on_body_reserved(std::move(r));
+				});
+		});
+	} // reserve_body
+
+	auto session::on_body_reserved(memory_budget::reservation _reservation) -> void
+	{
+		namespace http = boost::beast::http;
+
+		body_reservation_ = std::move(_reservation);
+
+		// Clients which sent "Expect: 100-continue" wait for permission before sending the body.
+		if (boost::iequals(parser_->get()[http::field::expect], "100-continue")) {
+			auto res = std::make_shared<http::response<http::empty_body>>(
+				http::status::continue_, parser_->get().version());
+
+			return http::async_write(
+				stream_, *res, [self = shared_from_this(), res](boost::beast::error_code _ec, std::size_t) {
+					if (_ec) {
+						return irods::fail(_ec, "write");
+					}
+
+					self->do_read_body();
+				});
+		}
+
+		do_read_body();
+	} // on_body_reserved
+
+	auto session::do_read_body() -> void
+	{
+		set_state(session_state::reading_body);
 
-		// Read a request.
 		boost::beast::http::async_read(
 			stream_, buffer_, *parser_, boost::beast::bind_front_handler(&session::on_read, shared_from_this()));
-	} // do_read
+	} // do_read_body
+
+	auto session::check_request_header() -> std::optional<response_type>
+	{
+		namespace logging = irods::http::log;
+		namespace http = boost::beast::http;
+
+		const auto& req = parser_->get();
+
+		// "host" is a placeholder that's used so that get_url_path() can parse the URL correctly.
+		const auto path = irods::http::get_url_path(fmt::format("http://host{}", req.target()));
+		if (!path) {
+			return irods::http::fail(http::status::bad_request);
+		}
+
+		const auto handler_iter = req_handlers_->find(*path);
+		if (handler_iter == std::end(*req_handlers_)) {
+			return irods::http::fail(http::status::not_found);
+		}
+
+		// Requests without a body are authenticated by the endpoint. Authenticating them here
+		// would not save anything.
+		if (parser_->is_done()) {
+			return std::nullopt;
+		}
+
+		// Form data carries the operation in the body. All other requests pass it via the query
+		// string, so requests for unknown operations can be rejected without reading the body.
+		const auto content_type = req[http::field::content_type];
+		if (!boost::istarts_with(content_type, "multipart/form-data") &&
+		    !boost::istarts_with(content_type, "application/x-www-form-urlencoded"))
+		{
+			const auto url = irods::http::parse_url(req);
+
+			if (const auto op = url.query.find("op"); op != std::end(url.query)) {
+				if (!irods::http::is_supported_operation(handler_iter->second, req.method(), op->second)) {
+					logging::error(*this, "{}: Operation [{}] not supported.", __func__, op->second);
+					return irods::http::fail(http::status::bad_request);
+				}
+
+				if (http::verb::post == req.method()) {
+					if (const auto limit = irods::http::max_size_of_request_body(handler_iter->second, op->second);
+					    limit)
+					{
+						body_limit_ = *limit;
+					}
+				}
+			}
+		}
+
+		const auto iter = std::find(
+			std::begin(endpoints_without_bearer_token), std::end(endpoints_without_bearer_token), *path);
+
+		if (iter != std::end(endpoints_without_bearer_token)) {
+			return std::nullopt;
+		}
+
+		// Rate limits are applied by execute_operation() once the size of the body is known. The
+		// identity is kept so that the request is not authenticated again once the body has been read.
+		auto result = irods::http::resolve_client_identity(req);
+		if (result.response) {
+			return std::move(result.response);
+		}
+
+		client_identity_ = std::move(result);
+
+		return std::nullopt;
+	} // check_request_header
+
+	auto session::reject(response_type&& _response) -> void
+	{
+		// The body of the request is still in flight, therefore, the connection cannot be reused.
+		_response.keep_alive(false);
+		send(std::move(_response));
+	} // reject
 
 	auto session::on_read(boost::beast::error_code ec, std::size_t bytes_transferred) -> void
 	{
@@ -73,14 +366,19 @@ namespace irods::http
 
 		boost::ignore_unused(bytes_transferred);
 
+		// The time needed to process the request is not limited. Responses which are sent via
+		// send() schedule a timeout of their own.
+		timing_wheel_->cancel(timeout_);
+
 		// This means they closed the connection
 		if (ec == boost::beast::http::error::end_of_stream) {
 			return do_close();
 		}
 
+		// The body of a chunked request exceeds the limit.
 		if (ec == boost::beast::http::error::body_limit) {
 			logging::error(*this, "{}: Request constraint error: {}", __func__, ec.message());
-			return;
+			return reject(irods::http::fail(boost::beast::http::status::payload_too_large));
 		}
 
 		if (ec) {
@@ -93,6 +391,23 @@ namespace irods::http
 
 		auto req_ = parser_->release();
 
+		set_state(session_state::processing);
+
+		if (timings_) {
+			timings_->add_bytes_received(req_.body().size());
+		}
+
+		if (trace_) {
+			// Includes the time spent waiting for the memory budget.
+			if (body_read_started_at_ > 0) {
+				trace_->add_span(
+					"read_body", tracing::new_span_id(), trace_->root_span_id(), body_read_started_at_, tracing::now());
+			}
+
+			trace_->set_attribute("http.request.method", std::string{req_.method_string()});
+			trace_->set_attribute("http.request.body.size", static_cast<std::int64_t>(req_.body().size()));
+		}
+
 		// Print the headers.
 		for (auto&& h : req_.base()) {
 			logging::debug(*this, "{}: Header: ({}, {})", __func__, h.name_string(), h.value());
@@ -110,10 +425,6 @@ namespace irods::http
 		namespace http = boost::beast::http;
 
 		try {
-#ifdef IRODS_WRITE_REQUEST_TO_TEMP_FILE
-			std::ofstream{"/tmp/http_request.txt"}.write(req_.body().c_str(), (std::streamsize) req_.body().size());
-#endif
-
 			// "host" is a placeholder that's used so that get_url_path() can parse the URL correctly.
 			const auto path = irods::http::get_url_path(fmt::format("http://host{}", req_.target()));
 			if (!path) {
@@ -122,6 +433,39 @@ namespace irods::http
 			}
 
 			if (const auto iter = req_handlers_->find(*path); iter != std::end(*req_handlers_)) {
+				request_capture::capture(req_, header_received_at_);
+
+				cancelled_ = false;
+				deadline_ = std::chrono::steady_clock::time_point::max();
+
+				if (const auto timeout_iter = req_.find("X-Request-Timeout"); timeout_iter != std::end(req_)) {
+					try {
+						const auto seconds = std::stoi(std::string{timeout_iter->value()});
+						if (seconds <= 0) {
+							throw std::invalid_argument{"Timeout must be greater than zero."};
+						}
+
+						// The client started waiting when it sent the request.
+						deadline_ = header_received_at_ + std::chrono::seconds{seconds};
+					}
+					catch (const std::exception&) {
+						logging::error(*this, "{}: Invalid value for [X-Request-Timeout] header.", __func__);
+						send(irods::http::fail(http::status::bad_request));
+						return;
+					}
+				}
+
+				if (trace_) {
+					trace_->set_attribute("url.path", *path);
+				}
+
+				watch_for_disconnect();
+
+				tracing::scope trace_scope{trace_};
+				tracing::span span{"dispatch"};
+				slow_requests::scope timings_scope{timings_};
+				allocation_accounting::scope allocations_scope{allocations_};
+				client_identity_scope identity_scope{client_identity_ ? &*client_identity_ : nullptr};
 				(iter->second)(shared_from_this(), req_);
 				return;
 			}
@@ -138,6 +482,8 @@ namespace irods::http
 	{
 		boost::ignore_unused(bytes_transferred);
 
+		finish_instrumentation();
+
 		if (ec) {
 			return irods::fail(ec, "write");
 		}
@@ -150,6 +496,8 @@ namespace irods::http
 
 		// We're done with the response so delete it
 		res_ = nullptr;
+		response_reservation_.release();
+		body_reservation_.release();
 
 		// Read another request
 		do_read();
@@ -157,10 +505,118 @@ namespace irods::http
 
 	auto session::do_close() -> void
 	{
+		stop_watching_for_disconnect();
+		timing_wheel_->cancel(timeout_);
+		finish_instrumentation();
+		set_state(session_state::closed);
+
 		// Send a TCP shutdown.
 		boost::beast::error_code ec;
 		stream_.socket().shutdown(boost::asio::ip::tcp::socket::shutdown_send, ec);
 
 		// At this point the connection is closed gracefully.
 	} // do_close
+
+	auto session::on_timeout() -> void
+	{
+		boost::asio::post(stream_.get_executor(), [self = shared_from_this()] {
+			irods::http::log::debug(*self, "Timeout expired or idle limit reached. Closing connection.");
+			self->stream_.close();
+		});
+	} // on_timeout
+
+	auto session::is_cancelled() const -> bool
+	{
+		return cancelled_ || std::chrono::steady_clock::now() >= deadline_.load();
+	} // is_cancelled
+
+	auto session::finish_instrumentation() -> void
+	{
+		const auto now = tracing::now();
+
+		if (trace_) {
+			if (write_started_at_ > 0) {
+				trace_->add_span("write", tracing::new_span_id(), trace_->root_span_id(), write_started_at_, now);
+			}
+
+			trace_->finish();
+			trace_.reset();
+		}
+
+		if (allocations_) {
+			if (timings_) {
+				timings_->set_allocations(allocations_->bytes(), allocations_->allocations());
+			}
+
+			allocations_->finish();
+			allocations_.reset();
+		}
+
+		if (timings_) {
+			if (write_started_at_ > 0) {
+				timings_->add(slow_requests::phase::write, std::chrono::nanoseconds{now - write_started_at_});
+			}
+
+			timings_->finish();
+			timings_.reset();
+		}
+
+		body_read_started_at_ = 0;
+		write_started_at_ = 0;
+	} // finish_instrumentation
+
+	auto session::watch_for_disconnect() -> void
+	{
+		namespace net = boost::asio;
+
+		// The number of bytes of pipelined requests buffered while watching. Past this, the
+		// connection is no longer watched.
+		constexpr std::size_t max_number_of_pipelined_bytes = 64 * 1024;
+
+		watching_for_disconnect_ = true;
+
+		stream_.socket().async_wait(
+			net::ip::tcp::socket::wait_read, [self = shared_from_this()](const boost::beast::error_code& _ec) {
+				namespace logging = irods::http::log;
+
+				// The session is reading the next request.
+				if (_ec == net::error::operation_aborted || !self->watching_for_disconnect_) {
+					return;
+				}
+
+				if (!_ec) {
+					boost::beast::error_code ec;
+
+					// Bytes may belong to the next request. Only a closed connection cancels the
+					// current request. The bytes are moved into the buffer the next request is read
+					// from, otherwise the socket would stay readable and could not be watched again.
+					if (const auto n = self->stream_.socket().available(ec); !ec && n > 0) {
+						if (self->buffer_.size() + n > max_number_of_pipelined_bytes) {
+							logging::debug(
+								*self, "Client pipelined too many bytes. No longer watching for disconnect.");
+							self->watching_for_disconnect_ = false;
+							return;
+						}
+
+						const auto bytes_read = self->stream_.socket().read_some(self->buffer_.prepare(n), ec);
+
+						if (!ec) {
+							self->buffer_.commit(bytes_read);
+							return self->watch_for_disconnect();
+						}
+					}
+				}
+
+				logging::debug(*self, "Client closed the connection. Cancelling request.");
+				self->cancelled_ = true;
+			});
+	} // watch_for_disconnect
+
+	auto session::stop_watching_for_disconnect() -> void
+	{
+		watching_for_disconnect_ = false;
+
+		boost::beast::error_code ec;
+		stream_.socket().cancel(ec);
+	} // stop_watching_for_disconnect
 } // namespace irods::http
@@ -0,0 +1,246 @@
+#include "irods/private/http_api/slow_requests.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <iterator>
+
+namespace
+{
+	using clock_type = std::chrono::steady_clock;
+
+	using irods::http::slow_requests::entry;
+	using irods::http::slow_requests::phase;
+	using irods::http::slow_requests::request_record;
+
+	struct detector_config
+	{
+		clock_type::duration threshold;
+		std::size_t max_number_of_entries;
+		std::chrono::seconds retention;
+	}; // struct detector_config
+
+	// The slowest recent requests, ordered from slowest to fastest.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::vector<entry> g_slowest;
+
+	// A mutex which protects the list of slowest requests from data corruption.
+	std::mutex g_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+
+	// The record of the request being processed by the current thread.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	thread_local std::shared_ptr<request_record> t_record;
+
+	auto config() -> const detector_config&
+	{
+		static const auto cfg = [] {
+			using json_pointer = nlohmann::json::json_pointer;
+
+			const auto& config = irods::http::globals::configuration();
+
+			const auto get = [&config](const char* _name, int _default) {
+				return std::max(config.value(json_pointer{_name}, _default), 0);
+			};
+
+			return detector_config{
+				std::chrono::milliseconds{get("/http_server/slow_requests/threshold_in_milliseconds", 5000)},
+				static_cast<std::size_t>(get("/http_server/slow_requests/max_number_of_entries", 20)),
+				std::chrono::seconds{get("/http_server/slow_requests/retention_in_seconds", 3600)}};
+		}();
+
+		return cfg;
+	} // config
+
+	// Removes entries which are older than the retention period. Requires the caller to hold g_mtx.
+	auto remove_expired_entries() -> void
+	{
+		const auto cutoff = std::chrono::system_clock::now() - config().retention;
+		std::erase_if(g_slowest, [cutoff](const entry& _e) { return _e.finished_at < cutoff; });
+	} // remove_expired_entries
+
+	auto remember(entry&& _entry) -> void
+	{
+		const auto max_entries = config().max_number_of_entries;
+
+		if (0 == max_entries) {
+			return;
+		}
+
+		std::scoped_lock lk{g_mtx};
+
+		remove_expired_entries();
+
+		const auto pos = std::find_if(std::begin(g_slowest), std::end(g_slowest), [&_entry](const entry& _e) {
+			return _e.duration < _entry.duration;
+		});
+
+		if (pos == std::end(g_slowest) && g_slowest.size() >= max_entries) {
+			return;
+		}
+
+		g_slowest.insert(pos, std::move(_entry));
+
+		if (g_slowest.size() > max_entries) {
+			g_slowest.pop_back();
+		}
+	} // remember
+} // anonymous namespace
+
+namespace irods::http::slow_requests
+{
+	request_record::request_record(std::string_view _endpoint)
+		: start_{clock_type::now()}
+		, endpoint_{_endpoint}
+	{
+	} // request_record (constructor)
+
+	auto request_record::set_operation(std::string_view _operation) -> void
+	{
+		std::scoped_lock lk{mtx_};
+		operation_ = _operation;
+	} // set_operation
+
+	auto request_record::set_username(std::string_view _username) -> void
+	{
+		std::scoped_lock lk{mtx_};
+		username_ = _username;
+	} // set_username
+
+	auto request_record::finish() -> void
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::microseconds;
+
+		const auto elapsed = clock_type::now() - start_;
+
+		if (elapsed < config().threshold) {
+			return;
+		}
+
+		const auto get = [this](phase _phase) {
+			const auto d = durations_[static_cast<std::size_t>(_phase)].load(std::memory_order_relaxed);
+			return duration_cast<microseconds>(clock_type::duration{d});
+		};
+
+		entry e{
+			.finished_at = std::chrono::system_clock::now(),
+			.endpoint = endpoint_,
+			.operation = {},
+			.username = {},
+			.bytes_received = bytes_received_.load(std::memory_order_relaxed),
+			.bytes_sent = bytes_sent_.load(std::memory_order_relaxed),
+			.bytes_allocated = bytes_allocated_.load(std::memory_order_relaxed),
+			.number_of_allocations = number_of_allocations_.load(std::memory_order_relaxed),
+			.duration = duration_cast<microseconds>(elapsed),
+			.queue_wait = get(phase::queue_wait),
+			.connection_checkout = get(phase::connection_checkout),
+			.switch_user = get(phase::switch_user),
+			.irods = {},
+			.write = get(phase::write)};
+
+		{
+			std::scoped_lock lk{mtx_};
+			e.operation = operation_;
+			e.username = username_;
+		}
+
+		e.irods = std::max(get(phase::background_task) - e.connection_checkout - e.switch_user, microseconds{});
+
+		irods::http::log::warn(
+			"Slow request: endpoint=[{}] op=[{}] user=[{}] bytes_received=[{}] bytes_sent=[{}] bytes_allocated=[{}] "
+			"allocations=[{}] total=[{}us] queue_wait=[{}us] connection_checkout=[{}us] switch_user=[{}us] "
+			"irods=[{}us] write=[{}us]",
+			e.endpoint,
+			e.operation,
+			e.username,
+			e.bytes_received,
+			e.bytes_sent,
+			e.bytes_allocated,
+			e.number_of_allocations,
+			e.duration.count(),
+			e.queue_wait.count(),
+			e.connection_checkout.count(),
+			e.switch_user.count(),
+			e.irods.count(),
+			e.write.count());
+
+		remember(std::move(e));
+	} // finish
+
+	auto enabled() -> bool
+	{
+		return config().threshold > clock_type::duration::zero();
+	} // enabled
+
+	auto start(std::string_view _endpoint) -> std::shared_ptr<request_record>
+	{
+		if (!enabled()) {
+			return nullptr;
+		}
+
+		return std::make_shared<request_record>(_endpoint);
+	} // start
+
+	auto current() -> request_record*
+	{
+		return t_record.get();
+	} // current
+
+	scope::scope(std::shared_ptr<request_record> _record)
+		: previous_{std::exchange(t_record, std::move(_record))}
+	{
+	} // scope (constructor)
+
+	scope::~scope()
+	{
+		t_record = std::move(previous_);
+	} // scope (destructor)
+
+	timer::timer(phase _phase)
+		: record_{t_record.get()}
+		, phase_{_phase}
+		, start_{record_ ? clock_type::now() : clock_type::time_point{}}
+	{
+	} // timer (constructor)
+
+	timer::~timer()
+	{
+		if (record_) {
+			record_->add(phase_, clock_type::now() - start_);
+		}
+	} // timer (destructor)
+
+	auto wrap(std::function<void()> _task) -> std::function<void()>
+	{
+		if (!t_record) {
+			return _task;
+		}
+
+		return [record = t_record, queued_at = clock_type::now(), task = std::move(_task)] {
+			const auto started_at = clock_type::now();
+			record->add(phase::queue_wait, started_at - queued_at);
+
+			scope s{record};
+
+			try {
+				task();
+			}
+			catch (...) {
+				record->add(phase::background_task, clock_type::now() - started_at);
+				throw;
+			}
+
+			record->add(phase::background_task, clock_type::now() - started_at);
+		};
+	} // wrap
+
+	auto slowest() -> std::vector<entry>
+	{
+		std::scoped_lock lk{g_mtx};
+		remove_expired_entries();
+		return g_slowest;
+	} // slowest
+} // namespace irods::http::slow_requests
@@ -0,0 +1,250 @@
+#include "irods/private/http_api/timing_wheel.hpp"
+
+#include "irods/private/http_api/memory_budget.hpp"
+#include "irods/private/http_api/session.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+	// Returns true if reservations are waiting for the memory budget or if less than a tenth of
+	// it is left. Idle sessions are closed in that case, regardless of their number.
+	auto is_under_memory_pressure() -> bool
+	{
+		namespace memory_budget = irods::http::memory_budget;
+
+		const auto limit = memory_budget::limit();
+		if (limit == 0) {
+			return false;
+		}
+
+		return memory_budget::number_of_waiters() > 0 || memory_budget::usage() >= limit - limit / 10;
+	} // is_under_memory_pressure
+} // anonymous namespace
+
+namespace irods::http
+{
+	timing_wheel::timing_wheel(
+		boost::asio::io_context& _io,
+		std::chrono::milliseconds _tick_interval,
+		std::size_t _number_of_slots,
+		std::size_t _max_number_of_idle)
+		: timer_{_io}
+		, tick_interval_{std::max(_tick_interval, std::chrono::milliseconds{1})}
+		, max_number_of_idle_{_max_number_of_idle}
+		, number_of_slots_{std::max(_number_of_slots, std::size_t{1})}
+	{
+		for (auto& slots : levels_) {
+			slots.assign(number_of_slots_, nullptr);
+		}
+	} // timing_wheel (constructor)
+
+	auto timing_wheel::start() -> void
+	{
+		timer_.expires_after(tick_interval_);
+		timer_.async_wait([self = shared_from_this()](const auto& _ec) {
+			if (_ec) {
+				return;
+			}
+
+			self->tick();
+			self->start();
+		});
+	} // start
+
+	auto timing_wheel::schedule(entry& _entry, std::chrono::steady_clock::duration _timeout) -> void
+	{
+		// Round up and add a tick to account for the portion of the current tick which has
+		// already elapsed. This guarantees the timeout never expires early.
+		const auto interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(tick_interval_).count();
+		const auto timeout = std::max(_timeout.count(), decltype(interval){0});
+		const auto ticks = static_cast<std::uint64_t>((timeout + interval - 1) / interval) + 1;
+
+		std::scoped_lock lk{mtx_};
+
+		if (_entry.scheduled_) {
+			unlink(_entry);
+		}
+
+		_entry.expires_at_ = now_ + ticks;
+		link(_entry);
+	} // schedule
+
+	auto timing_wheel::cancel(entry& _entry) -> void
+	{
+		std::scoped_lock lk{mtx_};
+
+		if (_entry.scheduled_) {
+			unlink(_entry);
+		}
+
+		if (_entry.idle_) {
+			unlink_idle(_entry);
+		}
+	} // cancel
+
+	auto timing_wheel::mark_idle(entry& _entry) -> void
+	{
+		std::shared_ptr<session> evicted;
+
+		// Evaluated before locking the wheel so that the mutex of the budget is never acquired
+		// while holding mtx_.
+		const auto under_memory_pressure = is_under_memory_pressure();
+
+		{
+			std::scoped_lock lk{mtx_};
+
+			if (_entry.idle_) {
+				return;
+			}
+
+			// Append the entry to the list of idle sessions.
+			_entry.idle_prev_ = idle_tail_;
+			_entry.idle_next_ = nullptr;
+			_entry.idle_ = true;
+			(idle_tail_ ? idle_tail_->idle_next_ : idle_head_) = &_entry;
+			idle_tail_ = &_entry;
+			++number_of_idle_;
+
+			const auto over_limit = max_number_of_idle_ > 0 && number_of_idle_ > max_number_of_idle_;
+
+			// Under memory pressure, the session which just became idle is never the one closed.
+			// It is about to read its next request and is likely to be reused.
+			if (!over_limit && (!under_memory_pressure || idle_head_ == &_entry)) {
+				return;
+			}
+
+			// Close the session which has been idle the longest. The session may be in the middle
+			// of being destroyed, in which case it removes itself from the wheel.
+			auto& oldest = *idle_head_;
+			unlink_idle(oldest);
+
+			if (oldest.scheduled_) {
+				unlink(oldest);
+			}
+
+			evicted = oldest.session_->weak_from_this().lock();
+		}
+
+		if (evicted) {
+			evicted->on_timeout();
+		}
+	} // mark_idle
+
+	auto timing_wheel::mark_busy(entry& _entry) -> void
+	{
+		std::scoped_lock lk{mtx_};
+
+		if (_entry.idle_) {
+			unlink_idle(_entry);
+		}
+	} // mark_busy
+
+	auto timing_wheel::link(entry& _entry) -> void
+	{
+		// A timeout which expires within one revolution of the lower level is placed in the slot
+		// of its tick. Otherwise, it is placed in the upper level, in the slot of the revolution
+		// it expires in.
+		if (_entry.expires_at_ - now_ < number_of_slots_) {
+			_entry.level_ = 0;
+			_entry.slot_ = _entry.expires_at_ % number_of_slots_;
+		}
+		else {
+			_entry.level_ = 1;
+			_entry.slot_ = (_entry.expires_at_ / number_of_slots_) % number_of_slots_;
+		}
+
+		_entry.scheduled_ = true;
+
+		// Push the entry onto the front of the slot's list.
+		auto*& head = levels_[_entry.level_][_entry.slot_];
+		_entry.prev_ = nullptr;
+		_entry.next_ = head;
+		if (head) {
+			head->prev_ = &_entry;
+		}
+		head = &_entry;
+	} // link
+
+	auto timing_wheel::unlink(entry& _entry) -> void
+	{
+		if (_entry.prev_) {
+			_entry.prev_->next_ = _entry.next_;
+		}
+		else {
+			levels_[_entry.level_][_entry.slot_] = _entry.next_;
+		}
+
+		if (_entry.next_) {
+			_entry.next_->prev_ = _entry.prev_;
+		}
+
+		_entry.prev_ = nullptr;
+		_entry.next_ = nullptr;
+		_entry.scheduled_ = false;
+	} // unlink
+
+	auto timing_wheel::unlink_idle(entry& _entry) -> void
+	{
+		(_entry.idle_prev_ ? _entry.idle_prev_->idle_next_ : idle_head_) = _entry.idle_next_;
+		(_entry.idle_next_ ? _entry.idle_next_->idle_prev_ : idle_tail_) = _entry.idle_prev_;
+
+		_entry.idle_prev_ = nullptr;
+		_entry.idle_next_ = nullptr;
+		_entry.idle_ = false;
+		--number_of_idle_;
+	} // unlink_idle
+
+	auto timing_wheel::tick() -> void
+	{
+		std::vector<std::shared_ptr<session>> expired;
+
+		{
+			std::scoped_lock lk{mtx_};
+
+			++now_;
+
+			const auto revolution = now_ / number_of_slots_;
+
+			// When the lower level starts a new revolution, move the timeouts which expire during
+			// it down from the upper level. Timeouts which expire in a later revolution of the
+			// upper level stay where they are.
+			if (now_ % number_of_slots_ == 0) {
+				for (auto* e = levels_[1][revolution % number_of_slots_]; e;) {
+					auto* next = e->next_;
+
+					if (e->expires_at_ / number_of_slots_ == revolution) {
+						unlink(*e);
+						link(*e);
+					}
+
+					e = next;
+				}
+			}
+
+			// Every timeout in the current slot of the lower level expires now.
+			for (auto* e = levels_[0][now_ % number_of_slots_]; e;) {
+				auto* next = e->next_;
+
+				unlink(*e);
+
+				if (e->idle_) {
+					unlink_idle(*e);
+				}
+
+				// The session may be in the middle of being destroyed, in which case there is
+				// nothing to close.
+				if (auto sess = e->session_->weak_from_this().lock(); sess) {
+					expired.push_back(std::move(sess));
+				}
+
+				e = next;
+			}
+		}
+
+		for (auto&& sess : expired) {
+			sess->on_timeout();
+		}
+	} // tick
+} // namespace irods::http
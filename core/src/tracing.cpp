@@ -0,0 +1,517 @@
+#include "irods/private/http_api/tracing.hpp"
+
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+
+#include <boost/asio/io_context.hpp>
+#include <boost/asio/ip/udp.hpp>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <optional>
+#include <random>
+#include <stop_token>
+#include <thread>
+
+namespace
+{
+	using irods::http::tracing::attribute;
+	using irods::http::tracing::attribute_value;
+
+	using span_data = irods::http::tracing::trace::span_data;
+
+	// The number of finished traces allowed to wait for the exporter. Traces are dropped when
+	// the exporter cannot keep up, so that tracing never slows down requests.
+	constexpr std::size_t max_number_of_queued_traces = 1024;
+
+	enum class exporter_type
+	{
+		file,
+		udp
+	}; // enum class exporter_type
+
+	struct tracing_config
+	{
+		bool enabled;
+		double sampling_ratio;
+		std::string service_name;
+		exporter_type exporter;
+		std::string path;
+		std::string host;
+		int port;
+	}; // struct tracing_config
+
+	// A finished trace waiting to be exported.
+	struct export_item
+	{
+		std::uint64_t trace_id_high;
+		std::uint64_t trace_id_low;
+		std::vector<span_data> spans;
+	}; // struct export_item
+
+	auto config() -> const tracing_config&
+	{
+		static const auto cfg = [] {
+			using json_pointer = nlohmann::json::json_pointer;
+
+			const auto& config = irods::http::globals::configuration();
+
+			const auto type = config.value(json_pointer{"/http_server/tracing/exporter/type"}, std::string{"file"});
+
+			return tracing_config{
+				config.value(json_pointer{"/http_server/tracing/enabled"}, false),
+				std::clamp(config.value(json_pointer{"/http_server/tracing/sampling_ratio"}, 0.01), 0.0, 1.0),
+				config.value(json_pointer{"/http_server/tracing/service_name"}, std::string{"irods_http_api"}),
+				("udp" == type) ? exporter_type::udp : exporter_type::file,
+				config.value(
+					json_pointer{"/http_server/tracing/exporter/path"},
+					std::string{"/tmp/irods_http_api_traces.jsonl"}),
+				config.value(json_pointer{"/http_server/tracing/exporter/host"}, std::string{"localhost"}),
+				config.value(json_pointer{"/http_server/tracing/exporter/port"}, 4319)};
+		}();
+
+		return cfg;
+	} // config
+
+	auto random_engine() -> std::mt19937_64&
+	{
+		thread_local std::mt19937_64 engine{std::random_device{}()};
+		return engine;
+	} // random_engine
+
+	// Returns a random number which is never 0. W3C Trace Context treats all-zero identifiers
+	// as invalid.
+	auto random_id() -> std::uint64_t
+	{
+		std::uint64_t id{};
+
+		while (0 == id) {
+			id = random_engine()();
+		}
+
+		return id;
+	} // random_id
+
+	auto to_hex(std::uint64_t _value) -> std::string
+	{
+		return fmt::format("{:016x}", _value);
+	} // to_hex
+
+	auto parse_hex(std::string_view _hex, std::uint64_t& _value) -> bool
+	{
+		_value = 0;
+
+		for (auto c : _hex) {
+			_value <<= 4;
+
+			if (c >= '0' && c <= '9') {
+				_value |= static_cast<std::uint64_t>(c - '0');
+			}
+			else if (c >= 'a' && c <= 'f') {
+				_value |= static_cast<std::uint64_t>(c - 'a' + 10);
+			}
+			else {
+				return false;
+			}
+		}
+
+		return true;
+	} // parse_hex
+
+	struct traceparent
+	{
+		std::uint64_t trace_id_high;
+		std::uint64_t trace_id_low;
+		std::uint64_t parent_id;
+		bool sampled;
+	}; // struct traceparent
+
+	// Parses a W3C traceparent header value (e.g. 00-<trace-id>-<parent-id>-<flags>).
+	auto parse_traceparent(std::string_view _value) -> std::optional<traceparent>
+	{
+		// Later versions of the format may append fields, but the prefix is compatible.
+		if (_value.size() < 55 || _value[2] != '-' || _value[35] != '-' || _value[52] != '-') {
+			return std::nullopt;
+		}
+
+		if (_value.substr(0, 2) == "ff" || (_value.size() > 55 && (_value.starts_with("00") || _value[55] != '-'))) {
+			return std::nullopt;
+		}
+
+		traceparent tp{};
+		std::uint64_t version{};
+		std::uint64_t flags{};
+
+		if (!parse_hex(_value.substr(0, 2), version) || !parse_hex(_value.substr(3, 16), tp.trace_id_high) ||
+		    !parse_hex(_value.substr(19, 16), tp.trace_id_low) || !parse_hex(_value.substr(36, 16), tp.parent_id) ||
+		    !parse_hex(_value.substr(53, 2), flags))
+		{
+			return std::nullopt;
+		}
+
+		if ((0 == tp.trace_id_high && 0 == tp.trace_id_low) || 0 == tp.parent_id) {
+			return std::nullopt;
+		}
+
+		tp.sampled = (flags & 0x01) != 0;
+
+		return tp;
+	} // parse_traceparent
+
+	auto to_json(const std::vector<attribute>& _attributes) -> nlohmann::json
+	{
+		auto attrs = nlohmann::json::array();
+
+		for (const auto& [key, value] : _attributes) {
+			if (const auto* s = std::get_if<std::string>(&value); s) {
+				attrs.push_back({{"key", key}, {"value", {{"stringValue", *s}}}});
+			}
+			else {
+				// OTLP/JSON encodes 64-bit integers as strings.
+				const auto i = std::to_string(std::get<std::int64_t>(value));
+				attrs.push_back({{"key", key}, {"value", {{"intValue", i}}}});
+			}
+		}
+
+		return attrs;
+	} // to_json
+
+	// Converts a trace to an OTLP/JSON ExportTraceServiceRequest.
+	auto to_otlp_json(const export_item& _item) -> std::string
+	{
+		// See https://opentelemetry.io/docs/specs/otel/protocol/file-exporter/.
+		constexpr int span_kind_internal = 1;
+		constexpr int span_kind_server = 2;
+
+		const auto trace_id = to_hex(_item.trace_id_high) + to_hex(_item.trace_id_low);
+
+		auto spans = nlohmann::json::array();
+
+		for (const auto& s : _item.spans) {
+			// The root span is the last span of a trace.
+			const auto is_root = (&s == &_item.spans.back());
+
+			spans.push_back({
+				{"traceId", trace_id},
+				{"spanId", to_hex(s.span_id)},
+				{"parentSpanId", (0 == s.parent_span_id) ? std::string{} : to_hex(s.parent_span_id)},
+				{"name", s.name},
+				{"kind", is_root ? span_kind_server : span_kind_internal},
+				{"startTimeUnixNano", std::to_string(s.start)},
+				{"endTimeUnixNano", std::to_string(s.end)},
+				{"attributes", to_json(s.attributes)}
+			});
+		}
+
+		// clang-format off
+		return nlohmann::json{
+			{"resourceSpans", {{
+				{"resource", {
+					{"attributes", to_json({{"service.name", config().service_name}})}
+				}},
+				{"scopeSpans", {{
+					{"scope", {{"name", "irods_http_api"}}},
+					{"spans", std::move(spans)}
+				}}}
+			}}}
+		}.dump();
+		// clang-format on
+	} // to_otlp_json
+
+	// Exports finished traces on a dedicated thread so that requests never wait for I/O.
+	class exporter
+	{
+	  public:
+		exporter()
+			: thread_{[this](std::stop_token _stoken) { run(std::move(_stoken)); }}
+		{
+		} // exporter (constructor)
+
+		exporter(const exporter&) = delete;
+		auto operator=(const exporter&) -> exporter& = delete;
+
+		exporter(exporter&&) = delete;
+		auto operator=(exporter&&) -> exporter& = delete;
+
+		~exporter() = default;
+
+		auto enqueue(export_item&& _item) -> void
+		{
+			{
+				std::scoped_lock lk{mtx_};
+
+				if (queue_.size() >= max_number_of_queued_traces) {
+					++dropped_;
+					return;
+				}
+
+				queue_.push_back(std::move(_item));
+			}
+
+			cv_.notify_one();
+		} // enqueue
+
+	  private:
+		auto run(std::stop_token _stoken) -> void
+		{
+			const auto& cfg = config();
+
+			std::ofstream file;
+			boost::asio::io_context ioc;
+			boost::asio::ip::udp::socket socket{ioc};
+			boost::asio::ip::udp::endpoint endpoint;
+
+			try {
+				if (exporter_type::file == cfg.exporter) {
+					file.open(cfg.path, std::ios::app);
+					if (!file) {
+						irods::http::log::error(
+							"Could not open trace file [{}]. Traces will not be exported.", cfg.path);
+					}
+				}
+				else {
+					boost::asio::ip::udp::resolver resolver{ioc};
+					endpoint = *resolver.resolve(cfg.host, std::to_string(cfg.port)).begin();
+					socket.open(endpoint.protocol());
+				}
+			}
+			catch (const std::exception& e) {
+				irods::http::log::error("Could not initialize trace exporter: {}", e.what());
+			}
+
+			std::deque<export_item> items;
+
+			while (true) {
+				std::size_t dropped{};
+
+				{
+					std::unique_lock lk{mtx_};
+
+					// Returns false if a stop was requested and nothing is left to export.
+					if (!cv_.wait(lk, _stoken, [this] { return !queue_.empty(); })) {
+						return;
+					}
+
+					items.swap(queue_);
+					std::swap(dropped, dropped_);
+				}
+
+				if (dropped > 0) {
+					irods::http::log::warn("Trace exporter dropped [{}] traces.", dropped);
+				}
+
+				for (const auto& item : items) {
+					const auto line = to_otlp_json(item);
+
+					if (exporter_type::file == cfg.exporter) {
+						if (file) {
+							file << line << '\n';
+						}
+
+						continue;
+					}
+
+					if (socket.is_open()) {
+						boost::system::error_code ec;
+						socket.send_to(boost::asio::buffer(line), endpoint, 0, ec);
+					}
+				}
+
+				items.clear();
+				file.flush();
+			}
+		} // run
+
+		std::mutex mtx_;
+		std::condition_variable_any cv_;
+		std::deque<export_item> queue_;
+		std::size_t dropped_{};
+
+		// Declared last so that the thread is stopped before the members it uses are destroyed.
+		std::jthread thread_;
+	}; // class exporter
+
+	auto get_exporter() -> exporter&
+	{
+		static exporter e;
+		return e;
+	} // get_exporter
+
+	// The trace and innermost span of the request being processed by the current thread.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	thread_local std::shared_ptr<irods::http::tracing::trace> t_trace;
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	thread_local std::uint64_t t_span_id{};
+} // anonymous namespace
+
+namespace irods::http::tracing
+{
+	auto now() -> std::int64_t
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+				   std::chrono::system_clock::now().time_since_epoch())
+		    .count();
+	} // now
+
+	auto trace::start(std::string_view _traceparent) -> std::shared_ptr<trace>
+	{
+		const auto& cfg = config();
+
+		if (!cfg.enabled) {
+			return nullptr;
+		}
+
+		// Continue the trace of the client and honor its sampling decision.
+		if (const auto tp = parse_traceparent(_traceparent); tp) {
+			if (!tp->sampled) {
+				return nullptr;
+			}
+
+			return std::make_shared<trace>(private_tag{}, tp->trace_id_high, tp->trace_id_low, tp->parent_id);
+		}
+
+		if (std::uniform_real_distribution<double>{0.0, 1.0}(random_engine()) >= cfg.sampling_ratio) {
+			return nullptr;
+		}
+
+		return std::make_shared<trace>(private_tag{}, random_id(), random_id(), 0);
+	} // start
+
+	trace::trace(
+		private_tag,
+		std::uint64_t _trace_id_high,
+		std::uint64_t _trace_id_low,
+		std::uint64_t _remote_parent_id)
+		: trace_id_high_{_trace_id_high}
+		, trace_id_low_{_trace_id_low}
+		, root_span_id_{random_id()}
+		, remote_parent_id_{_remote_parent_id}
+		, start_{now()}
+	{
+	} // trace (constructor)
+
+	auto trace::add_span(
+		std::string _name,
+		std::uint64_t _span_id,
+		std::uint64_t _parent_span_id,
+		std::int64_t _start,
+		std::int64_t _end,
+		std::vector<attribute> _attributes) -> void
+	{
+		std::scoped_lock lk{mtx_};
+
+		if (!finished_) {
+			spans_.push_back({std::move(_name), _span_id, _parent_span_id, _start, _end, std::move(_attributes)});
+		}
+	} // add_span
+
+	auto trace::set_attribute(std::string _key, attribute_value _value) -> void
+	{
+		std::scoped_lock lk{mtx_};
+		root_attributes_.emplace_back(std::move(_key), std::move(_value));
+	} // set_attribute
+
+	auto trace::finish() -> void
+	{
+		export_item item{trace_id_high_, trace_id_low_, {}};
+
+		{
+			std::scoped_lock lk{mtx_};
+
+			if (finished_) {
+				return;
+			}
+
+			finished_ = true;
+			spans_.push_back({"request", root_span_id_, remote_parent_id_, start_, now(), std::move(root_attributes_)});
+			item.spans = std::move(spans_);
+		}
+
+		get_exporter().enqueue(std::move(item));
+	} // finish
+
+	auto new_span_id() -> std::uint64_t
+	{
+		return random_id();
+	} // new_span_id
+
+	auto current() -> const std::shared_ptr<trace>&
+	{
+		return t_trace;
+	} // current
+
+	auto current_span_id() -> std::uint64_t
+	{
+		return t_span_id;
+	} // current_span_id
+
+	scope::scope(std::shared_ptr<trace> _trace, std::uint64_t _parent_span_id)
+		: previous_trace_{std::exchange(t_trace, std::move(_trace))}
+		, previous_span_id_{t_span_id}
+	{
+		t_span_id = (t_trace && 0 == _parent_span_id) ? t_trace->root_span_id() : _parent_span_id;
+	} // scope (constructor)
+
+	scope::~scope()
+	{
+		t_trace = std::move(previous_trace_);
+		t_span_id = previous_span_id_;
+	} // scope (destructor)
+
+	span::span(std::string_view _name)
+		: trace_{t_trace.get()}
+		, name_{_name}
+	{
+		if (!trace_) {
+			return;
+		}
+
+		span_id_ = random_id();
+		parent_span_id_ = std::exchange(t_span_id, span_id_);
+		start_ = now();
+	} // span (constructor)
+
+	span::~span()
+	{
+		if (!trace_) {
+			return;
+		}
+
+		t_span_id = parent_span_id_;
+
+		try {
+			trace_->add_span(std::string{name_}, span_id_, parent_span_id_, start_, now(), std::move(attributes_));
+		}
+		catch (...) {
+		}
+	} // span (destructor)
+
+	auto span::set_attribute(std::string _key, attribute_value _value) -> void
+	{
+		if (trace_) {
+			attributes_.emplace_back(std::move(_key), std::move(_value));
+		}
+	} // set_attribute
+
+	auto wrap(std::function<void()> _task) -> std::function<void()>
+	{
+		if (!t_trace) {
+			return _task;
+		}
+
+		return [trace = t_trace, parent_span_id = t_span_id, queued_at = now(), task = std::move(_task)] {
+			trace->add_span("background_queue_wait", random_id(), parent_span_id, queued_at, now());
+
+			scope s{trace, parent_span_id};
+			span background_task{"background_task"};
+			task();
+		};
+	} // wrap
+} // namespace irods::http::tracing
@@ -0,0 +1,637 @@
+#include "irods/private/http_api/write_behind.hpp"
+
+#include "irods/private/http_api/checksum_cache.hpp"
+#include "irods/private/http_api/common.hpp"
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+
+#include <irods/dstream.hpp>
+#include <irods/irods_exception.hpp>
+#include <irods/rodsErrorTable.h>
+#include <irods/transport/default_transport.hpp>
+
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
+
+#include <fmt/format.h>
+#include <nlohmann/json.hpp>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <system_error>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+	// clang-format off
+	namespace io      = irods::experimental::io;
+	namespace logging = irods::http::log;
+	namespace stdfs   = std::filesystem;
+	// clang-format on
+
+	using json = nlohmann::json;
+	using clock_type = std::chrono::steady_clock;
+	using upload_state = irods::http::write_behind::upload_state;
+
+	struct spooled_write
+	{
+		std::string handle;
+		std::string username;
+		std::string logical_path;
+		std::string resource;
+		std::uint64_t size{};
+		upload_state state{upload_state::pending};
+		int attempts{};
+		int error_code{};
+		std::string error_message;
+
+		// Set once the bytes and metadata are on disk. Until then, the write must not be
+		// uploaded, but later writes to the same data object must wait for it.
+		bool stored{};
+
+		clock_type::time_point next_attempt{};
+
+		// The time at which the write completed or failed for good.
+		clock_type::time_point finished_at{};
+	}; // struct spooled_write
+
+	// Maps a sequence number to a spooled write. Sequence numbers define the order in which
+	// writes to the same data object are uploaded.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::map<std::uint64_t, spooled_write> g_writes;
+
+	// Maps a handle to a sequence number.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::unordered_map<std::string, std::uint64_t> g_handles;
+
+	std::uint64_t g_next_sequence_number{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// The number of bytes held by writes which may still be uploaded. Failed writes do not count.
+	std::uint64_t g_spool_size{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	std::size_t g_number_of_uploads{}; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables)
+
+	// A mutex which protects the state above from data corruption.
+	std::mutex g_mtx; // NOLINT(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+
+	auto config_value(const char* _pointer, std::int64_t _default) -> std::int64_t
+	{
+		return irods::http::globals::configuration().value(json::json_pointer{_pointer}, _default);
+	} // config_value
+
+	auto spool_directory() -> const stdfs::path&
+	{
+		static const stdfs::path dir = irods::http::globals::configuration().value(
+			json::json_pointer{"/irods_client/write_behind/directory"}, std::string{});
+
+		return dir;
+	} // spool_directory
+
+	auto max_spool_size() -> std::uint64_t
+	{
+		static const auto max = static_cast<std::uint64_t>(
+			std::max(config_value("/irods_client/write_behind/max_size_in_bytes", 1073741824), std::int64_t{0}));
+
+		return max;
+	} // max_spool_size
+
+	auto max_number_of_concurrent_uploads() -> std::size_t
+	{
+		static const auto max = static_cast<std::size_t>(
+			std::max(config_value("/irods_client/write_behind/max_number_of_concurrent_uploads", 4), std::int64_t{1}));
+
+		return max;
+	} // max_number_of_concurrent_uploads
+
+	auto max_number_of_retries() -> int
+	{
+		static const auto max = static_cast<int>(
+			std::max(config_value("/irods_client/write_behind/max_number_of_retries", 5), std::int64_t{0}));
+
+		return max;
+	} // max_number_of_retries
+
+	auto retry_delay(int _attempts) -> std::chrono::seconds
+	{
+		static const auto delay = std::chrono::seconds{
+			std::max(config_value("/irods_client/write_behind/retry_delay_in_seconds", 5), std::int64_t{1})};
+
+		// Back off exponentially so that an unavailable server is not flooded with retries.
+		constexpr int max_exponent = 6;
+		return delay * (1 << std::min(_attempts - 1, max_exponent));
+	} // retry_delay
+
+	auto status_retention() -> std::chrono::seconds
+	{
+		static const auto retention = std::chrono::seconds{std::max(
+			config_value("/irods_client/write_behind/status_retention_in_seconds", 3600), std::int64_t{0})};
+
+		return retention;
+	} // status_retention
+
+	auto data_file(std::uint64_t _sequence_number) -> stdfs::path
+	{
+		return spool_directory() / fmt::format("{:020}.data", _sequence_number);
+	} // data_file
+
+	auto metadata_file(std::uint64_t _sequence_number) -> stdfs::path
+	{
+		return spool_directory() / fmt::format("{:020}.json", _sequence_number);
+	} // metadata_file
+
+	// Writes \p _bytes to \p _path and flushes them to disk.
+	auto write_file(const stdfs::path& _path, std::string_view _bytes) -> void
+	{
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+		const auto fd = ::open(_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+		if (fd < 0) {
+			throw std::system_error{errno, std::generic_category(), fmt::format("open [{}]", _path.c_str())};
+		}
+
+		const auto close_and_throw = [fd, &_path](const char* _op) {
+			const auto error = errno;
+			::close(fd);
+			throw std::system_error{error, std::generic_category(), fmt::format("{} [{}]", _op, _path.c_str())};
+		};
+
+		while (!_bytes.empty()) {
+			const auto n = ::write(fd, _bytes.data(), _bytes.size());
+			if (n < 0) {
+				if (errno == EINTR) {
+					continue;
+				}
+
+				close_and_throw("write");
+			}
+
+			_bytes.remove_prefix(static_cast<std::size_t>(n));
+		}
+
+		if (::fsync(fd) != 0) {
+			close_and_throw("fsync");
+		}
+
+		if (::close(fd) != 0) {
+			throw std::system_error{errno, std::generic_category(), fmt::format("close [{}]", _path.c_str())};
+		}
+	} // write_file
+
+	// Flushes the entries of the spool directory to disk. Required for renames and new files to
+	// survive a crash.
+	auto sync_spool_directory() -> void
+	{
+		// NOLINTNEXTLINE(cppcoreguidelines-pro-type-vararg, hicpp-vararg)
+		const auto fd = ::open(spool_directory().c_str(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+		if (fd < 0) {
+			throw std::system_error{errno, std::generic_category(), "open spool directory"};
+		}
+
+		const auto ec = ::fsync(fd);
+		const auto error = errno;
+		::close(fd);
+
+		if (ec != 0) {
+			throw std::system_error{error, std::generic_category(), "fsync spool directory"};
+		}
+	} // sync_spool_directory
+
+	// Atomically replaces the metadata file of a spooled write.
+	auto save_metadata(std::uint64_t _sequence_number, const spooled_write& _write) -> void
+	{
+		// Uploads which were in progress are restarted following a restart of the server.
+		const auto state = (_write.state == upload_state::uploading) ? upload_state::pending : _write.state;
+
+		// clang-format off
+		const json metadata{
+			{"handle", _write.handle},
+			{"username", _write.username},
+			{"logical_path", _write.logical_path},
+			{"resource", _write.resource},
+			{"size", _write.size},
+			{"state", irods::http::write_behind::to_string(state)},
+			{"attempts", _write.attempts},
+			{"error_code", _write.error_code},
+			{"error_message", _write.error_message}
+		};
+		// clang-format on
+
+		const auto path = metadata_file(_sequence_number);
+		auto tmp_path = path;
+		tmp_path += ".tmp";
+
+		write_file(tmp_path, metadata.dump());
+		stdfs::rename(tmp_path, path);
+		sync_spool_directory();
+	} // save_metadata
+
+	auto remove_files(std::uint64_t _sequence_number) -> void
+	{
+		std::error_code ec;
+
+		// The metadata file is removed first so that an interrupted removal does not cause the
+		// write to be uploaded again.
+		stdfs::remove(metadata_file(_sequence_number), ec);
+		stdfs::remove(data_file(_sequence_number), ec);
+	} // remove_files
+
+	// Records the result of an upload. Requires the caller to hold g_mtx.
+	auto finish_upload(std::uint64_t _sequence_number, int _error_code, const std::string& _error_message) -> void
+	{
+		auto& write = g_writes.at(_sequence_number);
+		--g_number_of_uploads;
+
+		if (_error_code == 0) {
+			logging::info("Uploaded spooled write [{}] to [{}].", write.handle, write.logical_path);
+			write.state = upload_state::completed;
+			write.finished_at = clock_type::now();
+			g_spool_size -= write.size;
+			remove_files(_sequence_number);
+			return;
+		}
+
+		++write.attempts;
+		write.error_code = _error_code;
+		write.error_message = _error_message;
+
+		if (write.attempts > max_number_of_retries()) {
+			logging::error(
+				"Giving up on spooled write [{}] to [{}] after [{}] attempts: {}",
+				write.handle,
+				write.logical_path,
+				write.attempts,
+				_error_message);
+			write.state = upload_state::failed;
+			write.finished_at = clock_type::now();
+
+			// The bytes are kept until the status expires or the write is discarded, but they
+			// must not keep new writes out of the spool.
+			g_spool_size -= write.size;
+		}
+		else {
+			logging::warn(
+				"Spooled write [{}] to [{}] failed. Retrying later: {}",
+				write.handle,
+				write.logical_path,
+				_error_message);
+			write.state = upload_state::pending;
+			write.next_attempt = clock_type::now() + retry_delay(write.attempts);
+		}
+
+		try {
+			save_metadata(_sequence_number, write);
+		}
+		catch (const std::exception& e) {
+			logging::error("Could not update metadata of spooled write [{}]: {}", write.handle, e.what());
+		}
+	} // finish_upload
+
+	auto upload(std::uint64_t _sequence_number, const spooled_write& _write) -> void
+	{
+		static const auto max_number_of_bytes_per_write = static_cast<std::size_t>(std::max(
+			config_value("/irods_client/max_number_of_bytes_per_write_operation", 8388608), std::int64_t{1}));
+
+		int ec = 0;
+		std::string msg;
+
+		try {
+			logging::debug("Uploading spooled write [{}] to [{}].", _write.handle, _write.logical_path);
+
+			irods::http::checksum_cache::invalidate(_write.logical_path);
+
+			auto conn = irods::get_connection(_write.username);
+			io::client::native_transport tp{conn};
+
+			std::unique_ptr<io::odstream> out;
+
+			if (_write.resource.empty()) {
+				out = std::make_unique<io::odstream>(tp, _write.logical_path);
+			}
+			else {
+				out = std::make_unique<io::odstream>(tp, _write.logical_path, io::root_resource_name{_write.resource});
+			}
+
+			if (!*out) {
+				THROW(SYS_INTERNAL_ERR, "Could not open data object for write.");
+			}
+
+			std::ifstream in{data_file(_sequence_number), std::ios::binary};
+			if (!in) {
+				THROW(SYS_INTERNAL_ERR, "Could not open spool file for read.");
+			}
+
+			std::vector<char> buffer(max_number_of_bytes_per_write);
+
+			while (in) {
+				in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+
+				if (in.gcount() > 0 && !out->write(buffer.data(), in.gcount())) {
+					THROW(SYS_INTERNAL_ERR, "Could not write bytes to data object.");
+				}
+			}
+
+			if (!in.eof()) {
+				THROW(SYS_INTERNAL_ERR, "Could not read bytes from spool file.");
+			}
+
+			out->close();
+
+			if (!*out) {
+				THROW(SYS_INTERNAL_ERR, "Could not close data object.");
+			}
+
+			irods::http::checksum_cache::invalidate(_write.logical_path);
+		}
+		catch (const irods::exception& e) {
+			ec = e.code();
+			msg = e.client_display_what();
+		}
+		catch (const std::exception& e) {
+			ec = SYS_INTERNAL_ERR;
+			msg = e.what();
+		}
+
+		{
+			std::scoped_lock lk{g_mtx};
+			finish_upload(_sequence_number, ec, msg);
+		}
+
+		// Writes to the same data object may have been waiting on this one.
+		irods::http::write_behind::process();
+	} // upload
+} // anonymous namespace
+
+namespace irods::http::write_behind
+{
+	auto to_string(upload_state _state) -> std::string_view
+	{
+		switch (_state) {
+			case upload_state::pending:
+				return "pending";
+			case upload_state::uploading:
+				return "uploading";
+			case upload_state::completed:
+				return "completed";
+			case upload_state::failed:
+				return "failed";
+		}
+
+		return "unknown";
+	} // to_string
+
+	auto enabled() -> bool
+	{
+		return !spool_directory().empty();
+	} // enabled
+
+	auto recover() -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		if (stdfs::create_directories(spool_directory())) {
+			stdfs::permissions(spool_directory(), stdfs::perms::owner_all);
+		}
+
+		std::scoped_lock lk{g_mtx};
+
+		std::vector<stdfs::path> data_files;
+
+		for (const auto& entry : stdfs::directory_iterator{spool_directory()}) {
+			const auto& path = entry.path();
+
+			if (path.extension() == ".tmp") {
+				stdfs::remove(path);
+				continue;
+			}
+
+			if (path.extension() == ".data") {
+				data_files.push_back(path);
+				continue;
+			}
+
+			if (path.extension() != ".json") {
+				continue;
+			}
+
+			try {
+				const std::uint64_t sequence_number = std::stoull(path.stem().string());
+				const auto metadata = json::parse(std::ifstream{path});
+
+				spooled_write write;
+				write.handle = metadata.at("handle").get<std::string>();
+				write.username = metadata.at("username").get<std::string>();
+				write.logical_path = metadata.at("logical_path").get<std::string>();
+				write.resource = metadata.at("resource").get<std::string>();
+				write.size = metadata.at("size").get<std::uint64_t>();
+				write.attempts = metadata.at("attempts").get<int>();
+				write.error_code = metadata.at("error_code").get<int>();
+				write.error_message = metadata.at("error_message").get<std::string>();
+				write.stored = true;
+
+				if (stdfs::file_size(data_file(sequence_number)) != write.size) {
+					THROW(SYS_INTERNAL_ERR, "Size of spool file does not match metadata.");
+				}
+
+				// Writes which failed are not attempted again. Their status is retained for the
+				// configured period, starting now.
+				if (metadata.at("state").get<std::string>() == to_string(upload_state::failed)) {
+					write.state = upload_state::failed;
+					write.finished_at = clock_type::now();
+				}
+				else {
+					// Pending writes get a fresh set of attempts.
+					write.attempts = 0;
+					g_spool_size += write.size;
+				}
+
+				g_handles.insert_or_assign(write.handle, sequence_number);
+				g_writes.insert_or_assign(sequence_number, std::move(write));
+				g_next_sequence_number = std::max(g_next_sequence_number, sequence_number + 1);
+			}
+			catch (const std::exception& e) {
+				logging::error("Ignoring spool file [{}]: {}", path.c_str(), e.what());
+			}
+		}
+
+		// Bytes without metadata belong to writes which were never acknowledged.
+		for (const auto& path : data_files) {
+			try {
+				if (!g_writes.contains(std::stoull(path.stem().string()))) {
+					stdfs::remove(path);
+				}
+			}
+			catch (const std::exception& e) {
+				logging::error("Ignoring spool file [{}]: {}", path.c_str(), e.what());
+			}
+		}
+
+		logging::info("Recovered [{}] spooled writes ([{}] bytes).", g_writes.size(), g_spool_size);
+	} // recover
+
+	auto enqueue(
+		std::string_view _username,
+		std::string_view _logical_path,
+		std::string_view _resource,
+		std::string_view _bytes) -> std::optional<std::string>
+	{
+		std::uint64_t sequence_number{};
+		spooled_write write;
+		write.handle = boost::uuids::to_string(boost::uuids::random_generator{}());
+		write.username = _username;
+		write.logical_path = _logical_path;
+		write.resource = _resource;
+		write.size = _bytes.size();
+
+		{
+			std::scoped_lock lk{g_mtx};
+
+			if (write.size > max_spool_size() - std::min(g_spool_size, max_spool_size())) {
+				return std::nullopt;
+			}
+
+			// Reserve the space and position of the write before releasing the lock. This keeps
+			// writes to the same data object in order while the bytes are stored.
+			sequence_number = g_next_sequence_number++;
+			g_spool_size += write.size;
+			g_writes.insert_or_assign(sequence_number, write);
+		}
+
+		try {
+			write_file(data_file(sequence_number), _bytes);
+			save_metadata(sequence_number, write);
+		}
+		catch (...) {
+			remove_files(sequence_number);
+
+			std::scoped_lock lk{g_mtx};
+			g_spool_size -= write.size;
+			g_writes.erase(sequence_number);
+
+			throw;
+		}
+
+		{
+			std::scoped_lock lk{g_mtx};
+			g_writes.at(sequence_number).stored = true;
+			g_handles.insert_or_assign(write.handle, sequence_number);
+		}
+
+		logging::debug("Spooled write [{}] to [{}] ([{}] bytes).", write.handle, write.logical_path, write.size);
+
+		process();
+
+		return write.handle;
+	} // enqueue
+
+	auto status(std::string_view _handle, std::string_view _username) -> std::optional<upload_status>
+	{
+		std::scoped_lock lk{g_mtx};
+
+		const auto iter = g_handles.find(std::string{_handle});
+		if (iter == std::end(g_handles)) {
+			return std::nullopt;
+		}
+
+		const auto& write = g_writes.at(iter->second);
+		if (write.username != _username) {
+			return std::nullopt;
+		}
+
+		return upload_status{
+			write.state, write.logical_path, write.size, write.attempts, write.error_code, write.error_message};
+	} // status
+
+	auto discard(std::string_view _handle, std::string_view _username) -> discard_result
+	{
+		std::scoped_lock lk{g_mtx};
+
+		const auto iter = g_handles.find(std::string{_handle});
+		if (iter == std::end(g_handles)) {
+			return discard_result::not_found;
+		}
+
+		const auto sequence_number = iter->second;
+		const auto& write = g_writes.at(sequence_number);
+
+		if (write.username != _username) {
+			return discard_result::not_found;
+		}
+
+		if (write.state != upload_state::failed) {
+			return discard_result::not_failed;
+		}
+
+		logging::info("Discarding failed write [{}] to [{}].", write.handle, write.logical_path);
+
+		remove_files(sequence_number);
+		g_writes.erase(sequence_number);
+		g_handles.erase(iter);
+
+		return discard_result::discarded;
+	} // discard
+
+	auto process() -> void
+	{
+		if (!enabled()) {
+			return;
+		}
+
+		std::vector<std::pair<std::uint64_t, spooled_write>> ready;
+
+		{
+			std::scoped_lock lk{g_mtx};
+
+			const auto now = clock_type::now();
+
+			// Data objects with an earlier write which has not completed. At most one write per
+			// data object is uploaded at a time.
+			std::set<std::string_view> busy;
+
+			for (auto iter = std::begin(g_writes); iter != std::end(g_writes);) {
+				auto& [sequence_number, write] = *iter;
+
+				if (write.state == upload_state::completed || write.state == upload_state::failed) {
+					if (write.finished_at + status_retention() <= now) {
+						if (write.state == upload_state::failed) {
+							logging::warn("Removing failed write [{}] from the spool.", write.handle);
+							remove_files(sequence_number);
+						}
+
+						g_handles.erase(write.handle);
+						iter = g_writes.erase(iter);
+						continue;
+					}
+				}
+				else if (busy.insert(write.logical_path).second) {
+					if (write.state == upload_state::pending && write.stored && write.next_attempt <= now &&
+					    g_number_of_uploads < max_number_of_concurrent_uploads())
+					{
+						write.state = upload_state::uploading;
+						++g_number_of_uploads;
+						ready.emplace_back(sequence_number, write);
+					}
+				}
+
+				++iter;
+			}
+		}
+
+		for (auto& [sequence_number, write] : ready) {
+			irods::http::globals::background_task(
+				[sequence_number, write = std::move(write)] { upload(sequence_number, write); });
+		}
+	} // process
+} // namespace irods::http::write_behind
@@ -0,0 +1,481 @@
+#include "irods/private/http_api/handlers.hpp"
+
+#include "irods/private/http_api/common.hpp"
+#include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/log.hpp"
+#include "irods/private/http_api/memory_budget.hpp"
+#include "irods/private/http_api/openid.hpp"
+#include "irods/private/http_api/process_stash.hpp"
+#include "irods/private/http_api/profiler.hpp"
+#include "irods/private/http_api/rate_limiter.hpp"
+#include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/slow_requests.hpp"
+#include "irods/private/http_api/version.hpp"
+
+#include <irods/irods_exception.hpp>
+#include <irods/user_administration.hpp>
+
+#include <boost/asio.hpp>
+#include <boost/beast.hpp>
+#include <boost/beast/http.hpp>
+
+#include <nlohmann/json.hpp>
+
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <unordered_map>
+
+// clang-format off
+namespace beast = boost::beast;     // from <boost/beast.hpp>
+namespace http  = beast::http;      // from <boost/beast/http.hpp>
+namespace net   = boost::asio;      // from <boost/asio.hpp>
+
+namespace adm     = irods::experimental::administration;
+namespace logging = irods::http::log;
+
+using json = nlohmann::json;
+// clang-format on
+
+#define IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(name) \
+  auto name(                                              \
+	  irods::http::session_pointer_type _sess_ptr,        \
+	  irods::http::request_type& _req,                    \
+	  irods::http::query_arguments_type& _args)           \
+	  ->void
+
+namespace
+{
+	//
+	// Handler function prototypes
+	//
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_introspect);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_profile);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_rate_limits);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_slow_requests);
+
+	//
+	// Operation to Handler mappings
+	//
+
+	// clang-format off
+	const std::unordered_map<std::string, irods::http::handler_type> handlers_for_get{
+		{"introspect", op_introspect},
+		{"profile", op_profile},
+		{"rate_limits", op_rate_limits},
+		{"slow_requests", op_slow_requests}
+	};
+
+	const std::unordered_map<std::string, irods::http::handler_type> handlers_for_post;
+	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	const irods::http::operation_registration registration{
+		irods::http::handler::administration, handlers_for_get, handlers_for_post};
+} // anonymous namespace
+
+namespace irods::http::handler
+{
+	// NOLINTNEXTLINE(performance-unnecessary-value-param)
+	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(administration)
+	{
+		// Exempt from admission control so that the server can be inspected while it is overloaded.
+		execute_operation(_sess_ptr, _req, handlers_for_get, handlers_for_post, admission_control::disabled);
+	} // administration
+} // namespace irods::http::handler
+
+namespace
+{
+	//
+	// Utility functions
+	//
+
+	// Returns whether the response is ready to be sent. An operation which returns false sends
+	// the response itself.
+	using admin_operation_type =
+		std::function<bool(const irods::http::query_arguments_type&, http::response<http::string_body>&)>;
+
+	// How long the result of a rodsadmin lookup is reused. A change to the type of a user takes
+	// effect once it expires.
+	constexpr auto rodsadmin_verdict_lifetime = std::chrono::seconds{60};
+
+	struct rodsadmin_verdict
+	{
+		bool is_rodsadmin;
+		std::chrono::steady_clock::time_point expires_at;
+	}; // struct rodsadmin_verdict
+
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::mutex g_rodsadmin_verdicts_mtx;
+
+	// Maps a username to the result of its most recent rodsadmin lookup.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
+	std::unordered_map<std::string, rodsadmin_verdict> g_rodsadmin_verdicts;
+
+	// Returns whether \p _username is a rodsadmin, or nothing if it is not known.
+	auto find_rodsadmin_verdict(const std::string& _username) -> std::optional<bool>
+	{
+		std::scoped_lock lk{g_rodsadmin_verdicts_mtx};
+
+		const auto iter = g_rodsadmin_verdicts.find(_username);
+		if (iter == std::end(g_rodsadmin_verdicts) || iter->second.expires_at <= std::chrono::steady_clock::now()) {
+			return std::nullopt;
+		}
+
+		return iter->second.is_rodsadmin;
+	} // find_rodsadmin_verdict
+
+	auto store_rodsadmin_verdict(const std::string& _username, bool _is_rodsadmin) -> void
+	{
+		const auto now = std::chrono::steady_clock::now();
+
+		std::scoped_lock lk{g_rodsadmin_verdicts_mtx};
+
+		// Expired entries are dropped so that the map only holds users seen recently.
+		std::erase_if(g_rodsadmin_verdicts, [now](const auto& _e) { return _e.second.expires_at <= now; });
+		g_rodsadmin_verdicts.insert_or_assign(
+			_username, rodsadmin_verdict{_is_rodsadmin, now + rodsadmin_verdict_lifetime});
+	} // store_rodsadmin_verdict
+
+	// Runs \p _op and sends its response if the client is a rodsadmin. If \p _is_rodsadmin is
+	// empty, the type of the client is looked up in iRODS first.
+	auto run_admin_operation(
+		const irods::http::session_pointer_type& _sess_ptr,
+		const irods::http::request_type& _req,
+		const irods::http::query_arguments_type& _args,
+		const std::string& _username,
+		const char* _fn,
+		std::optional<bool> _is_rodsadmin,
+		const admin_operation_type& _op) -> void
+	{
+		logging::info(*_sess_ptr, "{}: client_info.username = [{}]", _fn, _username);
+
+		http::response<http::string_body> res{http::status::ok, _req.version()};
+		res.set(http::field::server, irods::http::version::server_name);
+		res.set(http::field::content_type, "application/json");
+		res.keep_alive(_req.keep_alive());
+
+		try {
+			if (!_is_rodsadmin) {
+				auto conn = irods::get_connection(_username);
+				const auto type = adm::client::type(conn, adm::user{_username});
+				_is_rodsadmin = type && *type == adm::user_type::rodsadmin;
+				store_rodsadmin_verdict(_username, *_is_rodsadmin);
+			}
+
+			if (!*_is_rodsadmin) {
+				logging::error(*_sess_ptr, "{}: User is not a rodsadmin.", _fn);
+				return _sess_ptr->send(irods::http::fail(res, http::status::forbidden));
+			}
+
+			if (!_op(_args, res)) {
+				return;
+			}
+		}
+		catch (const irods::exception& e) {
+			logging::error(*_sess_ptr, "{}: {}", _fn, e.client_display_what());
+			// clang-format off
+			res.body() = json{
+				{"irods_response", {
+					{"status_code", e.code()},
+					{"status_message", e.client_display_what()}
+				}}
+			}.dump();
+			// clang-format on
+		}
+		catch (const std::exception& e) {
+			logging::error(*_sess_ptr, "{}: {}", _fn, e.what());
+			res.result(http::status::internal_server_error);
+		}
+
+		res.prepare_payload();
+
+		return _sess_ptr->send(std::move(res));
+	} // run_admin_operation
+
+	// Runs \p _op if the client is a rodsadmin. The information exposed by this endpoint
+	// describes the requests of all users, therefore it is restricted.
+	//
+	// The operations only read in-memory state. Once the type of the client is known, they run
+	// on the thread of the session without touching the connection pool or the background
+	// thread pool, so they keep working while either is exhausted.
+	auto execute_admin_operation(
+		irods::http::session_pointer_type _sess_ptr,
+		irods::http::request_type& _req,
+		irods::http::query_arguments_type& _args,
+		const char* _fn,
+		admin_operation_type _op) -> void
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		auto& username = result.client_info.username;
+
+		if (const auto is_rodsadmin = find_rodsadmin_verdict(username); is_rodsadmin) {
+			return run_admin_operation(_sess_ptr, _req, _args, username, _fn, is_rodsadmin, _op);
+		}
+
+		irods::http::globals::background_task([fn = _fn,
+		                                       username = std::move(username),
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args),
+		                                       op = std::move(_op)] {
+			run_admin_operation(_sess_ptr, _req, _args, username, fn, std::nullopt, op);
+		});
+	} // execute_admin_operation
+
+	// Captures a CPU profile and stores it, along with the state of the heap, in \p _res.
+	auto capture_profile(http::response<http::string_body>& _res, int _seconds, int _frequency) -> void
+	{
+		namespace profiler = irods::http::profiler;
+
+		const auto cpu = profiler::profile_cpu(std::chrono::seconds{_seconds}, _frequency);
+		if (!cpu) {
+			_res = irods::http::fail(_res, http::status::conflict, "A profile is already being captured.");
+			return;
+		}
+
+		const auto heap = profiler::heap_stats();
+
+		// clang-format off
+		_res.body() = json{
+			{"irods_response", {{"status_code", 0}}},
+			{"cpu", {
+				{"duration_in_milliseconds", cpu->duration.count()},
+				{"frequency", _frequency},
+				{"samples", cpu->number_of_samples},
+				{"dropped_samples", cpu->number_of_dropped_samples},
+				{"folded_stacks", cpu->folded_stacks}
+			}},
+			{"heap", {
+				{"arena_bytes", heap.arena_bytes},
+				{"mmapped_bytes", heap.mmapped_bytes},
+				{"in_use_bytes", heap.in_use_bytes},
+				{"free_bytes", heap.free_bytes},
+				{"releasable_bytes", heap.releasable_bytes},
+				{"resident_bytes", heap.resident_bytes}
+			}}
+		}.dump();
+		// clang-format on
+	} // capture_profile
+
+	//
+	// Operation handler implementations
+	//
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_introspect)
+	{
+		execute_admin_operation(
+			_sess_ptr, _req, _args, __func__, [](const auto& _op_args, http::response<http::string_body>& _res) {
+				using std::chrono::duration_cast;
+				using std::chrono::milliseconds;
+				using std::chrono::seconds;
+
+				// Listing every session of a busy server would produce a huge response.
+				std::size_t session_limit = 100; // NOLINT(cppcoreguidelines-avoid-magic-numbers)
+
+				if (const auto iter = _op_args.find("session-limit"); iter != std::end(_op_args)) {
+					try {
+						session_limit = std::stoul(iter->second);
+					}
+					catch (const std::exception&) {
+						_res = irods::http::fail(_res, http::status::bad_request, "Invalid value for [session-limit].");
+						return true;
+					}
+				}
+
+				const auto bg_stats = irods::http::globals::background_task_stats();
+				const auto pool_stats = irods::connection_pool_stats();
+				const auto jwks_stats = irods::http::openid::jwks_cache_stats();
+				const auto sessions = irods::http::session::snapshot(session_limit);
+
+				auto sessions_by_state = json::object();
+				for (std::size_t i = 0; i < sessions.number_of_sessions_by_state.size(); ++i) {
+					const auto state = static_cast<irods::http::session_state>(i);
+					sessions_by_state[to_string(state)] = sessions.number_of_sessions_by_state[i];
+				}
+
+				// clang-format off
+				auto session_list = json::array();
+				for (auto&& s : sessions.sessions) {
+					session_list.push_back({
+						{"ip", s.ip},
+						{"state", to_string(s.state)},
+						{"time_in_state_in_milliseconds", duration_cast<milliseconds>(s.time_in_state).count()}
+					});
+				}
+
+				_res.body() = json{
+					{"irods_response", {{"status_code", 0}}},
+					{"background_tasks", {
+						{"threads", bg_stats.number_of_threads},
+						{"queued", bg_stats.number_of_queued_tasks},
+						{"running", bg_stats.number_of_running_tasks}
+					}},
+					{"connection_pool", {
+						{"size", pool_stats.size},
+						{"in_use", pool_stats.number_of_connections_in_use},
+						{"waiters", pool_stats.number_of_waiters}
+					}},
+					{"memory_budget", {
+						{"max_size_in_bytes", irods::http::memory_budget::limit()},
+						{"size_in_bytes", irods::http::memory_budget::usage()},
+						{"number_of_paused_reads", irods::http::memory_budget::number_of_waiters()}
+					}},
+					{"sessions", {
+						{"by_state", sessions_by_state},
+						{"list", session_list}
+					}},
+					{"parallel_write_handles", irods::http::handler::parallel_write_contexts_snapshot()},
+					{"process_stash", irods::http::process_stash::count_by_type()},
+					{"openid", {
+						{"jwks_loaded", jwks_stats.loaded},
+						{"number_of_jwks", jwks_stats.number_of_keys},
+						{"jwks_age_in_seconds", duration_cast<seconds>(jwks_stats.age).count()}
+					}}
+				}.dump();
+				// clang-format on
+
+				return true;
+			});
+	} // op_introspect
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_profile)
+	{
+		execute_admin_operation(
+			_sess_ptr,
+			_req,
+			_args,
+			__func__,
+			[fn = __func__, _sess_ptr](const auto& _op_args, http::response<http::string_body>& _res) {
+				// clang-format off
+				constexpr auto default_seconds   = 10;
+				constexpr auto max_seconds       = 60;
+				constexpr auto default_frequency = 99;
+				constexpr auto max_frequency     = 1000;
+				// clang-format on
+
+				// Returns the value of a query parameter, or nothing if it is out of range.
+				const auto get = [&_op_args](const char* _name, int _default, int _max) -> std::optional<int> {
+					const auto iter = _op_args.find(_name);
+
+					if (iter == std::end(_op_args)) {
+						return _default;
+					}
+
+					try {
+						if (const auto v = std::stoi(iter->second); v > 0 && v <= _max) {
+							return v;
+						}
+					}
+					catch (const std::exception&) {
+					}
+
+					return std::nullopt;
+				};
+
+				const auto seconds = get("seconds", default_seconds, max_seconds);
+				if (!seconds) {
+					_res = irods::http::fail(_res, http::status::bad_request, "Invalid value for [seconds].");
+					return true;
+				}
+
+				const auto frequency = get("frequency", default_frequency, max_frequency);
+				if (!frequency) {
+					_res = irods::http::fail(_res, http::status::bad_request, "Invalid value for [frequency].");
+					return true;
+				}
+
+				// Capturing a profile blocks for its entire duration. It runs on a dedicated thread
+				// so that it does not hold one of the background threads, and the response is posted
+				// to the executor of the session once the profile ends.
+				std::thread{[fn, sess_ptr = _sess_ptr, res = _res, s = *seconds, f = *frequency]() mutable {
+					try {
+						capture_profile(res, s, f);
+					}
+					catch (const std::exception& e) {
+						logging::error(*sess_ptr, "{}: {}", fn, e.what());
+						res.result(http::status::internal_server_error);
+					}
+
+					res.prepare_payload();
+
+					net::post(sess_ptr->stream().get_executor(), [sess_ptr, res = std::move(res)]() mutable {
+						sess_ptr->send(std::move(res));
+					});
+				}}.detach();
+
+				return false;
+			});
+	} // op_profile
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_rate_limits)
+	{
+		execute_admin_operation(
+			_sess_ptr, _req, _args, __func__, [](const auto&, http::response<http::string_body>& _res) {
+				namespace rate_limiter = irods::http::rate_limiter;
+
+				// clang-format off
+				_res.body() = json{
+					{"irods_response", {{"status_code", 0}}},
+					{"enabled", rate_limiter::enabled()},
+					{"number_of_rejected_requests", rate_limiter::number_of_rejected_requests()},
+					{"number_of_rejected_requests_per_user", rate_limiter::number_of_rejected_requests_per_user()}
+				}.dump();
+				// clang-format on
+
+				return true;
+			});
+	} // op_rate_limits
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_slow_requests)
+	{
+		execute_admin_operation(
+			_sess_ptr, _req, _args, __func__, [](const auto&, http::response<http::string_body>& _res) {
+				using std::chrono::duration_cast;
+				using std::chrono::seconds;
+
+				auto requests = json::array();
+
+				// clang-format off
+				for (auto&& e : irods::http::slow_requests::slowest()) {
+					requests.push_back({
+						{"finished_at", duration_cast<seconds>(e.finished_at.time_since_epoch()).count()},
+						{"endpoint", e.endpoint},
+						{"op", e.operation},
+						{"username", e.username},
+						{"bytes_received", e.bytes_received},
+						{"bytes_sent", e.bytes_sent},
+						{"bytes_allocated", e.bytes_allocated},
+						{"number_of_allocations", e.number_of_allocations},
+						{"duration_in_microseconds", e.duration.count()},
+						{"phases_in_microseconds", {
+							{"queue_wait", e.queue_wait.count()},
+							{"connection_checkout", e.connection_checkout.count()},
+							{"switch_user", e.switch_user.count()},
+							{"irods", e.irods.count()},
+							{"write", e.write.count()}
+						}}
+					});
+				}
+
+				_res.body() = json{
+					{"irods_response", {{"status_code", 0}}},
+					{"enabled", irods::http::slow_requests::enabled()},
+					{"requests", requests}
+				}.dump();
+				// clang-format on
+
+				return true;
+			});
+	} // op_slow_requests
+} // anonymous namespace
@@ -1,23 +1,32 @@
 #include "irods/private/http_api/handlers.hpp"
 
+#include "irods/private/http_api/archive.hpp"
+#include "irods/private/http_api/checksum_cache.hpp"
+#include "irods/private/http_api/chunked_response.hpp"
 #include "irods/private/http_api/common.hpp"
+#include "irods/private/http_api/digest.hpp"
 #include "irods/private/http_api/globals.hpp"
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
 #include "irods/private/http_api/shared_api_operations.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/version.hpp"
 
 #include <irods/collCreate.h>
+#include <irods/dataObjChksum.h>
 #include <irods/dataObjInpOut.h>
+#include <irods/dstream.hpp>
 #include <irods/filesystem.hpp>
 #include <irods/filesystem/path_utilities.hpp>
 #include <irods/irods_at_scope_exit.hpp>
 #include <irods/irods_exception.hpp>
+#include <irods/query_builder.hpp>
 #include <irods/rcMisc.h>
 #include <irods/rodsErrorTable.h>
 #include <irods/rodsKeyWdDef.h>
 #include <irods/system_error.hpp> // For make_error_code
 #include <irods/touch.h>
+#include <irods/transport/default_transport.hpp>
 
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
@@ -25,10 +34,25 @@
 
 #include <nlohmann/json.hpp>
 
+#include <fnmatch.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
 #include <cstring>
+#include <deque>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <set>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 // clang-format off
@@ -37,6 +61,7 @@ namespace http  = beast::http;      // from <boost/beast/http.hpp>
 namespace net   = boost::asio;      // from <boost/asio.hpp>
 
 namespace fs      = irods::experimental::filesystem;
+namespace io      = irods::experimental::io;
 namespace logging = irods::http::log;
 
 using json = nlohmann::json;
@@ -64,7 +89,11 @@ namespace
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_set_inheritance);
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_modify_permissions);
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_modify_metadata);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_bulk_modify_metadata);
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_touch);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_upload_archive);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_download_archive);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_verify_checksums);
 
 	//
 	// Operation to Handler mappings
@@ -73,7 +102,9 @@ namespace
 	// clang-format off
 	const std::unordered_map<std::string, irods::http::handler_type> handlers_for_get{
 		{"list", op_list},
-		{"stat", op_stat}
+		{"stat", op_stat},
+		{"download_archive", op_download_archive},
+		{"verify_checksums", op_verify_checksums}
 	};
 
 	const std::unordered_map<std::string, irods::http::handler_type> handlers_for_post{
@@ -85,9 +116,30 @@ namespace
 		{"set_inheritance", op_set_inheritance},
 		{"modify_permissions", op_modify_permissions},
 		{"modify_metadata", op_modify_metadata},
-		{"touch", op_touch}
+		{"bulk_modify_metadata", op_bulk_modify_metadata},
+		{"touch", op_touch},
+		{"upload_archive", op_upload_archive}
 	};
 	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	// Archives are read into memory before they are extracted, so they are given a body limit of
+	// their own.
+	const irods::http::operation_registration registration{
+		irods::http::handler::collections,
+		handlers_for_get,
+		handlers_for_post,
+		[](std::string_view _op) -> std::optional<std::uint64_t> {
+			if ("upload_archive" != _op) {
+				return std::nullopt;
+			}
+
+			static const auto max_archive_size = irods::http::globals::configuration().value(
+				json::json_pointer{"/irods_client/bulk_operations/max_size_of_archive_in_bytes"},
+				std::uint64_t{1073741824});
+
+			return max_archive_size;
+		}};
 } // anonymous namespace
 
 namespace irods::http::handler
@@ -101,6 +153,867 @@ namespace irods::http::handler
 
 namespace
 {
+	//
+	// Utility functions
+	//
+
+	struct archive_upload_state
+	{
+		irods::http::session_pointer_type sess_ptr;
+		irods::http::request_type req;
+		std::string username;
+		fs::path collection;
+		bool verify_checksums{};
+
+		// The entries reference memory owned by the request object.
+		std::vector<irods::http::archive::entry> entries;
+
+		// Holds the index of an entry and the logical path of the data object it maps to.
+		std::vector<std::pair<std::size_t, std::string>> files;
+
+		std::atomic<std::size_t> next_file{};
+		std::atomic<std::size_t> files_written{};
+		std::atomic<std::size_t> active_tasks{};
+
+		std::mutex failures_mtx;
+		json failures = json::array();
+
+		auto add_failure(std::string_view _path, int _ec, std::string_view _msg) -> void
+		{
+			std::scoped_lock lk{failures_mtx};
+			failures.push_back({{"path", _path}, {"irods_response", {{"status_code", _ec}, {"status_message", _msg}}}});
+		} // add_failure
+	}; // struct archive_upload_state
+
+	auto write_archive_entry(
+		RcComm& _comm,
+		const irods::http::archive::entry& _entry,
+		const std::string& _lpath,
+		bool _verify_checksum) -> void
+	{
+		// The number of decompressed bytes held in memory while an entry is written.
+		constexpr std::size_t chunk_size = 1024 * 1024;
+
+		static const auto max_entry_size = irods::http::globals::configuration().value(
+			json::json_pointer{"/irods_client/bulk_operations/max_size_of_decompressed_archive_entry_in_bytes"},
+			std::uint64_t{1073741824});
+
+		// The declared size of compressed entries is supplied by the client. It is checked up front
+		// so that a small archive cannot make the server write an arbitrary amount of data.
+		if (_entry.size > max_entry_size) {
+			const auto msg = fmt::format(
+				"Archive entry exceeds the maximum size of [{}] bytes for decompressed entries.", max_entry_size);
+			THROW(SYS_INVALID_INPUT_PARAM, msg);
+		}
+
+		{
+			io::client::native_transport tp{_comm};
+			io::odstream out{tp, _lpath};
+
+			if (!out) {
+				THROW(SYS_INTERNAL_ERR, "Could not open data object for write.");
+			}
+
+			// Compressed entries are decompressed straight into the data object.
+			irods::http::archive::read_contents(_entry, chunk_size, [&out](std::string_view _data) {
+				if (!out.write(_data.data(), static_cast<std::streamsize>(_data.size()))) {
+					THROW(SYS_INTERNAL_ERR, "Could not write bytes to data object.");
+				}
+			});
+		}
+
+		irods::http::checksum_cache::invalidate(_lpath);
+
+		if (!_verify_checksum) {
+			return;
+		}
+
+		// Have the server compute and register a checksum for the new replica, then compare it
+		// against a checksum computed over the bytes received from the client.
+		DataObjInp input{};
+		irods::at_scope_exit free_memory{[&input] { clearKeyVal(&input.condInput); }};
+		irods::strncpy_null_terminated(input.objPath, _lpath.c_str());
+
+		char* checksum{};
+		irods::at_scope_exit free_checksum{[&checksum] { std::free(checksum); }};
+
+		if (const auto ec = rcDataObjChksum(&_comm, &input, &checksum); ec < 0) {
+			THROW(ec, "Could not calculate checksum of data object.");
+		}
+
+		const auto algorithm = irods::http::algorithm_of_irods_checksum(checksum);
+		if (!algorithm) {
+			const auto msg = fmt::format("Checksum scheme of [{}] is not supported for verification.", checksum);
+			THROW(SYS_NOT_SUPPORTED, msg);
+		}
+
+		// The algorithm is only known once the server has computed its checksum, therefore, the
+		// entry is decompressed a second time rather than being kept in memory.
+		irods::http::digest digest{*algorithm};
+		irods::http::archive::read_contents(_entry, chunk_size, [&digest](std::string_view _data) {
+			digest.update(_data);
+		});
+
+		if (irods::http::to_irods_checksum(*algorithm, digest.finish()) != checksum) {
+			THROW(USER_CHKSUM_MISMATCH, "Checksum of data object does not match the checksum of the archive entry.");
+		}
+	} // write_archive_entry
+
+	auto run_archive_upload_task(std::shared_ptr<archive_upload_state> _state) -> void
+	{
+		std::optional<irods::http::connection_facade> conn;
+
+		for (auto i = _state->next_file++; i < _state->files.size(); i = _state->next_file++) {
+			const auto& [index, lpath] = _state->files[i];
+
+			try {
+				if (!conn) {
+					conn.emplace(irods::get_connection(_state->username));
+				}
+
+				write_archive_entry(*conn, _state->entries[index], lpath, _state->verify_checksums);
+				++_state->files_written;
+			}
+			catch (const irods::exception& e) {
+				logging::error(*_state->sess_ptr, "{}: [{}]: {}", __func__, lpath, e.client_display_what());
+				_state->add_failure(_state->entries[index].path, static_cast<int>(e.code()), e.client_display_what());
+				// The connection may no longer be usable. Acquire a new one for the next entry.
+				conn.reset();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_state->sess_ptr, "{}: [{}]: {}", __func__, lpath, e.what());
+				_state->add_failure(_state->entries[index].path, SYS_INTERNAL_ERR, e.what());
+				conn.reset();
+			}
+		}
+
+		conn.reset();
+
+		if (_state->active_tasks.fetch_sub(1) != 1) {
+			return;
+		}
+
+		// This is the last task. Report the results to the client.
+		http::response<http::string_body> res{http::status::ok, _state->req.version()};
+		res.set(http::field::server, irods::http::version::server_name);
+		res.set(http::field::content_type, "application/json");
+		res.keep_alive(_state->req.keep_alive());
+
+		// clang-format off
+		res.body() = json{
+			{"irods_response", {
+				{"status_code", 0}
+			}},
+			{"number_of_entries", _state->entries.size()},
+			{"number_of_data_objects_written", _state->files_written.load()},
+			{"failed_entries", std::move(_state->failures)}
+		}.dump();
+		// clang-format on
+
+		res.prepare_payload();
+
+		_state->sess_ptr->send(std::move(res));
+	} // run_archive_upload_task
+
+	// Represents a data object or collection which will be added to an archive being downloaded.
+	struct archive_download_item
+	{
+		std::string lpath;
+
+		// The path of the entry within the archive.
+		std::string name;
+
+		irods::http::archive::entry_type type;
+		std::uint64_t size;
+		std::int64_t mtime;
+
+		// Protects the members below. The item is prefetched by exactly one task, the one which
+		// claims it first. The task writing the archive waits for the prefetch to complete.
+		std::mutex mtx;
+		std::condition_variable cv;
+		bool claimed{};
+		bool done{};
+
+		// The leading bytes of the data object.
+		std::string data;
+		std::optional<std::string> error;
+
+		auto claim() -> bool
+		{
+			std::scoped_lock lk{mtx};
+			return !std::exchange(claimed, true);
+		} // claim
+	}; // struct archive_download_item
+
+	auto prefetch_archive_item(RcComm& _comm, archive_download_item& _item, std::size_t _max_bytes) -> void
+	{
+		std::string data;
+		std::optional<std::string> error;
+
+		try {
+			io::client::native_transport tp{_comm};
+			io::idstream in{tp, _item.lpath};
+
+			if (!in) {
+				THROW(SYS_INTERNAL_ERR, "Could not open data object for read.");
+			}
+
+			data.resize(static_cast<std::size_t>(std::min<std::uint64_t>(_item.size, _max_bytes)));
+			in.read(data.data(), static_cast<std::streamsize>(data.size()));
+			data.resize(static_cast<std::size_t>(in.gcount()));
+		}
+		catch (const irods::exception& e) {
+			error = e.client_display_what();
+		}
+		catch (const std::exception& e) {
+			error = e.what();
+		}
+
+		{
+			std::scoped_lock lk{_item.mtx};
+			_item.data = std::move(data);
+			_item.error = std::move(error);
+			_item.done = true;
+		}
+
+		_item.cv.notify_all();
+	} // prefetch_archive_item
+
+	auto write_archive_item(
+		RcComm& _comm,
+		archive_download_item& _item,
+		std::size_t _buffer_size,
+		irods::http::archive::writer& _writer,
+		irods::http::chunked_response& _response) -> bool
+	{
+		const auto is_file = (irods::http::archive::entry_type::file == _item.type);
+
+		if (is_file && _item.size > 0) {
+			// Read the leading bytes of the data object now if no other task has started to.
+			if (_item.claim()) {
+				prefetch_archive_item(_comm, _item, _buffer_size);
+			}
+			else {
+				std::unique_lock lk{_item.mtx};
+				_item.cv.wait(lk, [&_item] { return _item.done; });
+			}
+
+			// Omitting the entry would produce an archive which looks complete, but isn't. The
+			// caller aborts the response so that the client can detect the failure.
+			if (_item.error) {
+				THROW(SYS_INTERNAL_ERR, fmt::format("Could not read [{}]: {}", _item.lpath, *_item.error));
+			}
+		}
+
+		auto chunk = _writer.begin_entry(_item.name, _item.type, _item.size, _item.mtime);
+		_writer.update(_item.data);
+		chunk += _item.data;
+
+		std::uint64_t offset = _item.data.size();
+		std::string().swap(_item.data);
+
+		if (!_response.write(std::move(chunk))) {
+			return false;
+		}
+
+		// Stream the remaining bytes of large data objects, one buffer at a time.
+		if (is_file && offset < _item.size) {
+			io::client::native_transport tp{_comm};
+			io::idstream in{tp, _item.lpath};
+
+			if (!in || !in.seekg(static_cast<std::streamoff>(offset))) {
+				THROW(SYS_INTERNAL_ERR, fmt::format("Could not read remaining bytes of [{}].", _item.lpath));
+			}
+
+			while (offset < _item.size) {
+				const auto count = std::min<std::uint64_t>(_item.size - offset, _buffer_size);
+				std::string buffer(static_cast<std::size_t>(count), '\0');
+				in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+				buffer.resize(static_cast<std::size_t>(in.gcount()));
+
+				// end_entry() would pad the entry with zeros, so a short read must not complete it.
+				if (buffer.empty()) {
+					const auto msg = fmt::format("Read [{}] of [{}] bytes of [{}].", offset, _item.size, _item.lpath);
+					THROW(SYS_INTERNAL_ERR, msg);
+				}
+
+				offset += buffer.size();
+				_writer.update(buffer);
+
+				if (!_response.write(std::move(buffer))) {
+					return false;
+				}
+			}
+		}
+
+		return _response.write(_writer.end_entry());
+	} // write_archive_item
+
+	struct archive_download_options
+	{
+		fs::path root;
+		irods::http::archive::format format = irods::http::archive::format::tar;
+		bool recurse = true;
+
+		// Glob patterns matched against the path of each data object relative to the root.
+		std::optional<std::string> include;
+		std::optional<std::string> exclude;
+	}; // struct archive_download_options
+
+	auto write_collection_archive(
+		RcComm& _comm,
+		const std::string& _username,
+		const archive_download_options& _options,
+		const std::shared_ptr<irods::http::chunked_response>& _response) -> void
+	{
+		static const auto& config = irods::http::globals::configuration();
+		static const auto read_buffer_size = static_cast<std::size_t>(
+			config.at(json::json_pointer{"/irods_client/max_number_of_bytes_per_read_operation"}).get<int>());
+		static const auto max_number_of_prefetched_items = static_cast<std::size_t>(std::max(
+			config.value(json::json_pointer{"/irods_client/bulk_operations/max_number_of_concurrent_tasks"}, 4), 1));
+
+		irods::http::archive::writer writer{_options.format};
+
+		// Entries are placed under a directory named after the collection.
+		const auto root_name = _options.root.object_name().string();
+
+		// Items which have been scheduled for prefetching, but not yet written. The number of
+		// items is bounded, therefore, memory usage does not depend on the number or size of the
+		// data objects in the collection.
+		std::deque<std::shared_ptr<archive_download_item>> pending;
+
+		const auto write_pending_items = [&](std::size_t _max_pending_items) {
+			while (pending.size() > _max_pending_items) {
+				if (!write_archive_item(_comm, *pending.front(), read_buffer_size, writer, *_response)) {
+					return false;
+				}
+
+				pending.pop_front();
+			}
+
+			return true;
+		};
+
+		const auto add_entry = [&](const fs::collection_entry& _entry) {
+			const auto relative_path = _entry.path().lexically_relative(_options.root).string();
+
+			auto item = std::make_shared<archive_download_item>();
+			item->lpath = _entry.path().string();
+			item->name = root_name.empty() ? relative_path : fmt::format("{}/{}", root_name, relative_path);
+			item->mtime = _entry.last_write_time().time_since_epoch().count();
+			item->size = 0;
+
+			if (_entry.is_collection()) {
+				item->type = irods::http::archive::entry_type::directory;
+			}
+			else {
+				// Filters only apply to data objects.
+				if (_options.include && fnmatch(_options.include->c_str(), relative_path.c_str(), 0) != 0) {
+					return true;
+				}
+
+				if (_options.exclude && fnmatch(_options.exclude->c_str(), relative_path.c_str(), 0) == 0) {
+					return true;
+				}
+
+				item->type = irods::http::archive::entry_type::file;
+				item->size = _entry.data_object_size();
+
+				// Read the leading bytes of the data object while earlier items are written to the
+				// client. Each prefetch uses its own connection.
+				if (item->size > 0) {
+					irods::http::globals::background_task([item, _response, _username, fn = __func__] {
+						if (_response->is_closed()) {
+							return;
+						}
+
+						try {
+							auto conn = irods::get_connection(_username);
+
+							if (item->claim()) {
+								prefetch_archive_item(conn, *item, read_buffer_size);
+							}
+						}
+						catch (const std::exception& e) {
+							// The item will be read by the task writing the archive.
+							logging::error("{}: Could not prefetch [{}]: {}", fn, item->lpath, e.what());
+						}
+					});
+				}
+			}
+
+			pending.push_back(std::move(item));
+
+			return write_pending_items(max_number_of_prefetched_items);
+		};
+
+		if (!root_name.empty()) {
+			auto item = std::make_shared<archive_download_item>();
+			item->lpath = _options.root.string();
+			item->name = root_name;
+			item->type = irods::http::archive::entry_type::directory;
+			item->size = 0;
+			item->mtime = fs::client::last_write_time(_comm, _options.root).time_since_epoch().count();
+			pending.push_back(std::move(item));
+		}
+
+		if (_options.recurse) {
+			for (auto&& e : fs::client::recursive_collection_iterator{_comm, _options.root}) {
+				if (!add_entry(e)) {
+					return;
+				}
+			}
+		}
+		else {
+			for (auto&& e : fs::client::collection_iterator{_comm, _options.root}) {
+				if (!add_entry(e)) {
+					return;
+				}
+			}
+		}
+
+		if (write_pending_items(0)) {
+			_response->write(writer.finish());
+		}
+	} // write_collection_archive
+
+	// Limits the rate at which bytes are read by a checksum verification job.
+	//
+	// Each caller is assigned the next available time slot in proportion to the number of bytes
+	// it intends to read, then sleeps until the slot begins.
+	class byte_rate_limiter
+	{
+	  public:
+		explicit byte_rate_limiter(std::uint64_t _bytes_per_second)
+			: bytes_per_second_{_bytes_per_second}
+		{
+		} // constructor
+
+		auto acquire(std::uint64_t _bytes) -> void
+		{
+			if (0 == bytes_per_second_) {
+				return;
+			}
+
+			using namespace std::chrono;
+
+			const auto slot_duration = duration_cast<clock_type::duration>(
+				duration<double>{static_cast<double>(_bytes) / static_cast<double>(bytes_per_second_)});
+
+			clock_type::time_point start;
+
+			{
+				std::scoped_lock lk{mtx_};
+				start = std::max(clock_type::now(), next_);
+				next_ = start + slot_duration;
+			}
+
+			std::this_thread::sleep_until(start);
+		} // acquire
+
+	  private:
+		using clock_type = std::chrono::steady_clock;
+
+		const std::uint64_t bytes_per_second_;
+		std::mutex mtx_;
+		clock_type::time_point next_{};
+	}; // class byte_rate_limiter
+
+	// A replica which will be verified by a checksum verification job.
+	struct fixity_item
+	{
+		std::uint64_t data_id;
+		irods::http::checksum_cache::replica_identity identity;
+
+		// The checksum recorded in the catalog.
+		std::string checksum;
+
+		std::string resource_hierarchy;
+	}; // struct fixity_item
+
+	struct fixity_job_state
+	{
+		fixity_job_state(std::string _username, std::size_t _max_tasks_per_resource, std::uint64_t _bytes_per_second)
+			: username{std::move(_username)}
+			, max_tasks_per_resource{_max_tasks_per_resource}
+			, rate_limiter{_bytes_per_second}
+		{
+		} // constructor
+
+		std::shared_ptr<irods::http::chunked_response> response;
+		std::string username;
+		bool admin{};
+		std::size_t max_tasks_per_resource;
+
+		byte_rate_limiter rate_limiter;
+
+		std::mutex mtx;
+		std::condition_variable cv;
+
+		// The following members are protected by mtx.
+
+		// Replicas waiting to be verified, grouped by root resource. Limiting the number of
+		// verifications per root resource keeps a job from overwhelming a single storage system.
+		std::map<std::string, std::deque<fixity_item>> queues;
+		std::map<std::string, std::size_t> active_tasks_per_resource;
+		std::size_t number_of_queued_items{};
+		std::size_t number_of_active_items{};
+
+		// Tasks which have been handed to the background thread pool. Some of them may still be
+		// waiting for a thread.
+		std::size_t number_of_launched_tasks{};
+
+		// Tasks which have started executing and have not exited yet.
+		std::size_t number_of_running_tasks{};
+
+		// The data ids of the replicas which have been enumerated, but not yet verified. Replicas
+		// are enumerated in order of their data id. Every data id less than the smallest value in
+		// this set has been verified. This is what allows a job to be resumed.
+		std::multiset<std::uint64_t> unfinished_data_ids;
+		std::uint64_t last_enumerated_data_id{};
+
+		std::size_t replicas_verified{};
+		std::size_t replicas_failed{};
+		std::size_t replicas_skipped{};
+
+		// Set when the client disconnects.
+		bool cancelled{};
+
+		// Set once the job no longer accepts tasks. Tasks which start afterwards exit without
+		// touching the response.
+		bool finished{};
+
+		// Returns the queue of the first root resource which can accept another verification.
+		// Requires the caller to hold mtx.
+		auto find_eligible_queue() -> std::map<std::string, std::deque<fixity_item>>::iterator
+		{
+			return std::find_if(std::begin(queues), std::end(queues), [this](const auto& _q) {
+				return !_q.second.empty() && active_tasks_per_resource[_q.first] < max_tasks_per_resource;
+			});
+		} // find_eligible_queue
+
+		auto checkpoint() const -> std::uint64_t
+		{
+			return unfinished_data_ids.empty() ? last_enumerated_data_id : *std::begin(unfinished_data_ids) - 1;
+		} // checkpoint
+
+		auto progress() const -> json
+		{
+			// clang-format off
+			return {
+				{"checkpoint", std::to_string(checkpoint())},
+				{"replicas_verified", replicas_verified},
+				{"replicas_failed", replicas_failed},
+				{"replicas_skipped", replicas_skipped}
+			};
+			// clang-format on
+		} // progress
+	}; // struct fixity_job_state
+
+	// Returns a line describing the problems found with the replica, or an empty string if the
+	// replica matches its checksum.
+	auto verify_fixity_item(RcComm& _comm, const fixity_job_state& _state, const fixity_item& _item) -> std::string
+	{
+		DataObjInp input{};
+		irods::at_scope_exit free_memory{[&input] { clearKeyVal(&input.condInput); }};
+		irods::strncpy_null_terminated(input.objPath, _item.identity.logical_path.c_str());
+
+		const auto replica_number = std::to_string(_item.identity.replica_number);
+		addKeyVal(&input.condInput, VERIFY_CHKSUM_KW, "");
+		addKeyVal(&input.condInput, REPL_NUM_KW, replica_number.c_str());
+
+		if (_state.admin) {
+			addKeyVal(&input.condInput, ADMIN_KW, "");
+		}
+
+		char* results{};
+		irods::at_scope_exit free_results{[&results] { std::free(results); }};
+
+		const auto ec = rcDataObjChksum(&_comm, &input, &results);
+
+		if (ec == 0) {
+			if (!_item.checksum.empty()) {
+				irods::http::checksum_cache::insert(_item.identity, _item.checksum);
+			}
+
+			return {};
+		}
+
+		irods::http::checksum_cache::invalidate(_item.identity.logical_path);
+
+		// clang-format off
+		json line{
+			{"logical_path", _item.identity.logical_path},
+			{"replica_number", _item.identity.replica_number},
+			{"resource_hierarchy", _item.resource_hierarchy},
+			{"irods_response", {{"status_code", ec}}}
+		};
+		// clang-format on
+
+		if (ec == CHECK_VERIFICATION_RESULTS && results) {
+			line["results"] = json::parse(results, nullptr, false);
+		}
+
+		return line.dump() + '\n';
+	} // verify_fixity_item
+
+	// Verifies one replica which is eligible for verification.
+	//
+	// \returns false if no replica is eligible at this time.
+	auto process_fixity_item(RcComm& _comm, fixity_job_state& _state) -> bool
+	{
+		// Verification results are reported in lines. Progress is reported periodically so
+		// that clients know where to resume from if the job is interrupted.
+		constexpr std::size_t progress_interval = 1000;
+
+		fixity_item item;
+		std::string resource;
+
+		{
+			std::scoped_lock lk{_state.mtx};
+
+			// The client disconnected or the deadline of the request passed.
+			if (_state.response->is_closed()) {
+				_state.cancelled = true;
+			}
+
+			if (_state.cancelled) {
+				return false;
+			}
+
+			const auto iter = _state.find_eligible_queue();
+
+			if (iter == std::end(_state.queues)) {
+				return false;
+			}
+
+			resource = iter->first;
+			item = std::move(iter->second.front());
+			iter->second.pop_front();
+
+			++_state.active_tasks_per_resource[resource];
+			++_state.number_of_active_items;
+			--_state.number_of_queued_items;
+		}
+
+		_state.cv.notify_all();
+
+		std::string line;
+		bool skipped = false;
+
+		if (const auto checksum = irods::http::checksum_cache::find(item.identity);
+		    checksum && !item.checksum.empty() && *checksum == item.checksum)
+		{
+			skipped = true;
+		}
+		else {
+			_state.rate_limiter.acquire(static_cast<std::uint64_t>(item.identity.size));
+
+			try {
+				line = verify_fixity_item(_comm, _state, item);
+			}
+			catch (const std::exception& e) {
+				logging::error("{}: [{}]: {}", __func__, item.identity.logical_path, e.what());
+				// clang-format off
+				line = json{
+					{"logical_path", item.identity.logical_path},
+					{"replica_number", item.identity.replica_number},
+					{"resource_hierarchy", item.resource_hierarchy},
+					{"irods_response", {{"status_code", SYS_INTERNAL_ERR}, {"status_message", e.what()}}}
+				}.dump() + '\n';
+				// clang-format on
+			}
+		}
+
+		{
+			std::scoped_lock lk{_state.mtx};
+
+			--_state.active_tasks_per_resource[resource];
+			--_state.number_of_active_items;
+			_state.unfinished_data_ids.erase(_state.unfinished_data_ids.find(item.data_id));
+
+			if (skipped) {
+				++_state.replicas_skipped;
+			}
+			else if (line.empty()) {
+				++_state.replicas_verified;
+			}
+			else {
+				++_state.replicas_failed;
+			}
+
+			const auto completed = _state.replicas_verified + _state.replicas_failed + _state.replicas_skipped;
+			if (completed % progress_interval == 0) {
+				line += _state.progress().dump() + '\n';
+			}
+		}
+
+		_state.cv.notify_all();
+
+		if (!line.empty() && !_state.response->write(std::move(line))) {
+			std::scoped_lock lk{_state.mtx};
+			_state.cancelled = true;
+		}
+
+		return true;
+	} // process_fixity_item
+
+	auto run_fixity_task(std::shared_ptr<fixity_job_state> _state) -> void
+	{
+		{
+			std::scoped_lock lk{_state->mtx};
+
+			// The job finished while this task was waiting for a thread.
+			if (_state->finished) {
+				--_state->number_of_launched_tasks;
+				return;
+			}
+
+			++_state->number_of_running_tasks;
+		}
+
+		try {
+			auto conn = irods::get_connection(_state->username);
+
+			while (process_fixity_item(conn, *_state)) {
+			}
+		}
+		catch (const std::exception& e) {
+			logging::error("{}: {}", __func__, e.what());
+		}
+
+		{
+			std::scoped_lock lk{_state->mtx};
+			--_state->number_of_launched_tasks;
+			--_state->number_of_running_tasks;
+		}
+
+		_state->cv.notify_all();
+	} // run_fixity_task
+
+	// Launches tasks until the number of launched tasks reaches the limit.
+	//
+	// Tasks exit as soon as no replica is eligible for verification. They never wait on other
+	// tasks, so a job cannot exhaust the background thread pool.
+	auto launch_fixity_tasks(const std::shared_ptr<fixity_job_state>& _state, std::size_t _max_tasks) -> void
+	{
+		std::size_t n = 0;
+
+		{
+			std::scoped_lock lk{_state->mtx};
+
+			if (_state->finished) {
+				return;
+			}
+
+			const auto wanted = std::min(_max_tasks, _state->number_of_queued_items);
+			if (_state->number_of_launched_tasks < wanted) {
+				n = wanted - _state->number_of_launched_tasks;
+				_state->number_of_launched_tasks = wanted;
+			}
+		}
+
+		for (std::size_t i = 0; i < n; ++i) {
+			irods::http::globals::background_task([_state] { run_fixity_task(_state); });
+		}
+	} // launch_fixity_tasks
+
+	// Enumerates the replicas under a collection and verifies them. Lines describing replicas
+	// which failed verification are written to the response as they are discovered.
+	auto run_fixity_job(
+		RcComm& _comm,
+		const fs::path& _root,
+		std::uint64_t _resume_after,
+		const std::shared_ptr<fixity_job_state>& _state) -> void
+	{
+		static const auto& config = irods::http::globals::configuration();
+		static const auto max_number_of_tasks = static_cast<std::size_t>(std::max(
+			config.value(json::json_pointer{"/irods_client/bulk_operations/max_number_of_concurrent_tasks"}, 4), 1));
+
+		// Bounds the memory used by a job, regardless of the number of replicas.
+		const auto max_number_of_queued_items = max_number_of_tasks * 64;
+
+		_state->last_enumerated_data_id = _resume_after;
+
+		const auto root = _root.string();
+		const auto pattern = (root == "/") ? std::string{"/%"} : root + "/%";
+		const auto gql = fmt::format(
+			"select order(DATA_ID), DATA_REPL_NUM, COLL_NAME, DATA_NAME, DATA_SIZE, DATA_MODIFY_TIME, "
+			"DATA_CHECKSUM, DATA_RESC_HIER where COLL_NAME = '{}' || like '{}' and DATA_ID > '{}'",
+			root,
+			pattern,
+			_resume_after);
+
+		for (auto&& row : irods::experimental::query_builder{}.build<RcComm>(_comm, gql)) {
+			fixity_item item;
+			item.data_id = std::stoull(row[0]);
+			item.identity = {(fs::path{row[2]} / row[3]).string(), std::stoi(row[1]), std::stoll(row[4]), row[5]};
+			item.checksum = row[6];
+			item.resource_hierarchy = row[7];
+
+			const auto resource = item.resource_hierarchy.substr(0, item.resource_hierarchy.find(';'));
+
+			{
+				std::scoped_lock lk{_state->mtx};
+
+				if (_state->cancelled) {
+					return;
+				}
+
+				_state->unfinished_data_ids.insert(item.data_id);
+				_state->last_enumerated_data_id = item.data_id;
+				_state->queues[resource].push_back(std::move(item));
+				++_state->number_of_queued_items;
+			}
+
+			launch_fixity_tasks(_state, max_number_of_tasks);
+
+			// Help with the backlog instead of waiting for it to shrink. Waiting is only necessary
+			// when every queued replica belongs to a resource which is already busy. In that case,
+			// the replicas being verified are guaranteed to complete.
+			while (true) {
+				{
+					std::unique_lock lk{_state->mtx};
+					if (_state->number_of_queued_items < max_number_of_queued_items || _state->cancelled) {
+						break;
+					}
+				}
+
+				if (!process_fixity_item(_comm, *_state)) {
+					std::unique_lock lk{_state->mtx};
+					_state->cv.wait(lk, [&_state, max_number_of_queued_items] {
+						return _state->cancelled || _state->number_of_queued_items < max_number_of_queued_items ||
+						       _state->find_eligible_queue() != std::end(_state->queues);
+					});
+				}
+			}
+		}
+
+		// Verify the remaining replicas and wait for the other tasks to finish.
+		while (true) {
+			launch_fixity_tasks(_state, max_number_of_tasks);
+
+			if (process_fixity_item(_comm, *_state)) {
+				continue;
+			}
+
+			std::unique_lock lk{_state->mtx};
+
+			const auto done = [&_state] {
+				return _state->cancelled ||
+				       (0 == _state->number_of_queued_items && 0 == _state->number_of_active_items);
+			};
+
+			_state->cv.wait(lk, [&_state, &done] {
+				return done() || _state->find_eligible_queue() != std::end(_state->queues);
+			});
+
+			if (done()) {
+				break;
+			}
+		}
+	} // run_fixity_job
+
 	//
 	// Operation handler implementations
 	//
@@ -157,18 +1070,25 @@ namespace
 
 				json entries;
 
-				const auto recursive_iter = _args.find("recurse");
-				if (recursive_iter != std::end(_args) && recursive_iter->second == "1") {
-					for (auto&& e : fs::client::recursive_collection_iterator{conn, lpath_iter->second}) {
-						entries.push_back(e.path().c_str());
+				{
+					irods::http::tracing::span span{"irods_list_collection"};
+
+					const auto recursive_iter = _args.find("recurse");
+					if (recursive_iter != std::end(_args) && recursive_iter->second == "1") {
+						for (auto&& e : fs::client::recursive_collection_iterator{conn, lpath_iter->second}) {
+							entries.push_back(e.path().c_str());
+						}
 					}
-				}
-				else {
-					for (auto&& e : fs::client::collection_iterator{conn, lpath_iter->second}) {
-						entries.push_back(e.path().c_str());
+					else {
+						for (auto&& e : fs::client::collection_iterator{conn, lpath_iter->second}) {
+							entries.push_back(e.path().c_str());
+						}
 					}
+
+					span.set_attribute("irods.number_of_entries", static_cast<std::int64_t>(entries.size()));
 				}
 
+				irods::http::tracing::span serialize_span{"serialize_response"};
 				res.body() = json{{"irods_response", {{"status_code", 0}}}, {"entries", entries}}.dump();
 			}
 			catch (const fs::filesystem_error& e) {
@@ -741,6 +1661,12 @@ namespace
 		return op_atomic_apply_metadata_operations(_sess_ptr, _req, _args, entity_type::collection);
 	} // op_modify_metadata
 
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_bulk_modify_metadata)
+	{
+		using namespace irods::http::shared_api_operations;
+		return op_atomic_apply_metadata_operations_in_bulk(_sess_ptr, _req, _args, entity_type::collection);
+	} // op_bulk_modify_metadata
+
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_touch)
 	{
 		auto result = irods::http::resolve_client_identity(_req);
@@ -826,4 +1752,401 @@ namespace
 				_sess_ptr->send(std::move(res));
 			});
 	} // op_touch
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_upload_archive)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args)]() mutable {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			http::response<http::string_body> res{http::status::ok, _req.version()};
+			res.set(http::field::server, irods::http::version::server_name);
+			res.set(http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				const auto lpath_iter = _args.find("lpath");
+				if (lpath_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [lpath] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				const auto content_type = _req.base()["content-type"];
+				const auto format = irods::http::archive::to_format({content_type.data(), content_type.size()});
+				if (!format) {
+					logging::error(
+						*_sess_ptr, "{}: Request body must be of type [application/x-tar] or [application/zip].", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				// The connection is returned to the pool before the entries are written. The tasks
+				// writing them acquire connections of their own, so holding it would let concurrent
+				// uploads exhaust the pool while each waits for another connection.
+				std::optional<irods::http::connection_facade> conn;
+				conn.emplace(irods::get_connection(client_info.username));
+
+				if (!fs::client::is_collection(*conn, lpath_iter->second)) {
+					return _sess_ptr->send(irods::http::fail(
+						res,
+						http::status::bad_request,
+						json{{"irods_response", {{"status_code", NOT_A_COLLECTION}}}}.dump()));
+				}
+
+				static const auto& config = irods::http::globals::configuration();
+				static const auto max_number_of_tasks = std::max(
+					config.value(json::json_pointer{"/irods_client/bulk_operations/max_number_of_concurrent_tasks"}, 4),
+					1);
+
+				auto state = std::make_shared<archive_upload_state>();
+				state->sess_ptr = _sess_ptr;
+				state->username = client_info.username;
+				state->collection = lpath_iter->second;
+
+				if (const auto iter = _args.find("verify-checksums"); iter != std::end(_args) && iter->second == "1") {
+					state->verify_checksums = true;
+				}
+
+				// The entries reference the request body, so the request must be owned by the shared
+				// state before the archive is read.
+				state->req = std::move(_req);
+				state->entries = irods::http::archive::read_entries(*format, state->req.body());
+
+				logging::debug(*_sess_ptr, "{}: Archive contains [{}] entries.", fn, state->entries.size());
+
+				// Determine which collections need to exist. The set keeps the paths sorted, which
+				// guarantees parent collections are created before their children.
+				std::set<std::string> collections;
+
+				const auto add_collection_and_ancestors = [&collections](std::string_view _path) {
+					for (auto pos = _path.find('/'); pos != std::string_view::npos; pos = _path.find('/', pos + 1)) {
+						collections.emplace(_path.substr(0, pos));
+					}
+
+					collections.emplace(_path);
+				};
+
+				for (std::size_t i = 0; i < state->entries.size(); ++i) {
+					const auto& entry = state->entries[i];
+
+					const auto relative_path = irods::http::archive::normalize_entry_path(entry.path);
+					if (!relative_path) {
+						state->add_failure(entry.path, SYS_INVALID_INPUT_PARAM, "Invalid entry path.");
+						continue;
+					}
+
+					switch (entry.type) {
+						case irods::http::archive::entry_type::directory:
+							add_collection_and_ancestors(*relative_path);
+							break;
+
+						case irods::http::archive::entry_type::file:
+							if (const auto pos = relative_path->rfind('/'); pos != std::string::npos) {
+								add_collection_and_ancestors(std::string_view{*relative_path}.substr(0, pos));
+							}
+
+							state->files.emplace_back(i, (state->collection / *relative_path).string());
+							break;
+
+						default:
+							state->add_failure(entry.path, SYS_NOT_SUPPORTED, "Entry type not supported.");
+							break;
+					}
+				}
+
+				for (const auto& c : collections) {
+					try {
+						fs::client::create_collection(*conn, state->collection / c);
+					}
+					catch (const fs::filesystem_error& e) {
+						logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+						state->add_failure(c, e.code().value(), e.what());
+					}
+				}
+
+				conn.reset();
+
+				// Data objects are written concurrently. Each task holds a single connection for
+				// its lifetime. The last task to finish sends the response.
+				const auto tasks = std::max<std::size_t>(
+					std::min(static_cast<std::size_t>(max_number_of_tasks), state->files.size()), 1);
+				state->active_tasks = tasks;
+
+				for (std::size_t i = 1; i < tasks; ++i) {
+					irods::http::globals::background_task([state] { run_archive_upload_task(state); });
+				}
+
+				return run_archive_upload_task(std::move(state));
+			}
+			catch (const fs::filesystem_error& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code().value()}, {"status_message", e.what()}}}}.dump();
+			}
+			catch (const irods::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code()}, {"status_message", e.client_display_what()}}}}
+						.dump();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(http::status::internal_server_error);
+			}
+
+			res.prepare_payload();
+
+			_sess_ptr->send(std::move(res));
+		});
+	} // op_upload_archive
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_download_archive)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args)] {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			http::response<http::string_body> res{http::status::ok, _req.version()};
+			res.set(http::field::server, irods::http::version::server_name);
+			res.set(http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				const auto lpath_iter = _args.find("lpath");
+				if (lpath_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [lpath] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				archive_download_options options;
+
+				if (const auto iter = _args.find("format"); iter != std::end(_args)) {
+					if (iter->second == "zip") {
+						options.format = irods::http::archive::format::zip;
+					}
+					else if (iter->second != "tar") {
+						logging::error(*_sess_ptr, "{}: Invalid value for [format] parameter.", fn);
+						return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+					}
+				}
+
+				if (const auto iter = _args.find("recurse"); iter != std::end(_args)) {
+					options.recurse = (iter->second != "0");
+				}
+
+				if (const auto iter = _args.find("include"); iter != std::end(_args)) {
+					options.include = iter->second;
+				}
+
+				if (const auto iter = _args.find("exclude"); iter != std::end(_args)) {
+					options.exclude = iter->second;
+				}
+
+				auto conn = irods::get_connection(client_info.username);
+
+				options.root = fs::path{lpath_iter->second}.lexically_normal();
+
+				if (!fs::client::is_collection(conn, options.root)) {
+					return _sess_ptr->send(irods::http::fail(
+						res,
+						http::status::bad_request,
+						json{{"irods_response", {{"status_code", NOT_A_COLLECTION}}}}.dump()));
+				}
+
+				// Past this point, the response headers have been sent. Errors can only be
+				// reported by closing the connection before the archive is complete.
+				const auto content_type = irods::http::archive::to_content_type(options.format);
+				auto response = std::make_shared<irods::http::chunked_response>(
+					_sess_ptr, _req.version(), _req.keep_alive(), content_type);
+				response->start();
+
+				try {
+					write_collection_archive(conn, client_info.username, options, response);
+					response->finish();
+				}
+				catch (const std::exception& e) {
+					logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+					response->abort();
+				}
+
+				return;
+			}
+			catch (const fs::filesystem_error& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code().value()}, {"status_message", e.what()}}}}.dump();
+			}
+			catch (const irods::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code()}, {"status_message", e.client_display_what()}}}}
+						.dump();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(http::status::internal_server_error);
+			}
+
+			res.prepare_payload();
+
+			_sess_ptr->send(std::move(res));
+		});
+	} // op_download_archive
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_verify_checksums)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args)] {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			http::response<http::string_body> res{http::status::ok, _req.version()};
+			res.set(http::field::server, irods::http::version::server_name);
+			res.set(http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				const auto lpath_iter = _args.find("lpath");
+				if (lpath_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [lpath] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				std::uint64_t resume_after = 0;
+
+				if (const auto iter = _args.find("resume-after"); iter != std::end(_args)) {
+					try {
+						resume_after = std::stoull(iter->second);
+					}
+					catch (const std::exception&) {
+						logging::error(*_sess_ptr, "{}: Invalid value for [resume-after] parameter.", fn);
+						return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+					}
+				}
+
+				static const auto& config = irods::http::globals::configuration();
+				static const auto max_tasks_per_resource = std::max(
+					config.value(
+						json::json_pointer{
+							"/irods_client/checksum_verification/max_number_of_concurrent_tasks_per_resource"},
+						1),
+					1);
+				static const auto max_bytes_per_second = std::max(
+					config.value(
+						json::json_pointer{"/irods_client/checksum_verification/max_number_of_bytes_per_second"},
+						std::int64_t{0}),
+					std::int64_t{0});
+
+				auto state = std::make_shared<fixity_job_state>(
+					client_info.username,
+					static_cast<std::size_t>(max_tasks_per_resource),
+					static_cast<std::uint64_t>(max_bytes_per_second));
+
+				if (const auto iter = _args.find("admin"); iter != std::end(_args) && iter->second == "1") {
+					state->admin = true;
+				}
+
+				auto conn = irods::get_connection(client_info.username);
+
+				const auto root = fs::path{lpath_iter->second}.lexically_normal();
+
+				if (!fs::client::is_collection(conn, root)) {
+					return _sess_ptr->send(irods::http::fail(
+						res,
+						http::status::bad_request,
+						json{{"irods_response", {{"status_code", NOT_A_COLLECTION}}}}.dump()));
+				}
+
+				// Past this point, the response headers have been sent. Errors are reported in
+				// the final line of the response.
+				state->response = std::make_shared<irods::http::chunked_response>(
+					_sess_ptr, _req.version(), _req.keep_alive(), "application/x-ndjson");
+				state->response->start();
+
+				json summary{{"irods_response", {{"status_code", 0}}}};
+
+				try {
+					run_fixity_job(conn, root, resume_after, state);
+				}
+				catch (const irods::exception& e) {
+					logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
+					summary["irods_response"] = {
+						{"status_code", e.code()}, {"status_message", e.client_display_what()}};
+				}
+				catch (const std::exception& e) {
+					logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+					summary["irods_response"] = {{"status_code", SYS_INTERNAL_ERR}, {"status_message", e.what()}};
+				}
+
+				std::unique_lock lk{state->mtx};
+
+				// Tasks which are still running must not touch the response after it is finished.
+				// Only tasks which have started are waited on. Tasks still waiting for a thread of
+				// the pool may be queued behind this one, so they are cancelled instead.
+				state->cancelled = state->cancelled || summary["irods_response"]["status_code"] != 0;
+				state->cv.wait(lk, [&state] { return 0 == state->number_of_running_tasks; });
+				state->finished = true;
+
+				if (state->cancelled && summary["irods_response"]["status_code"] == 0) {
+					return state->response->abort();
+				}
+
+				summary.update(state->progress());
+				lk.unlock();
+
+				if (state->response->write(summary.dump() + '\n')) {
+					state->response->finish();
+				}
+
+				return;
+			}
+			catch (const fs::filesystem_error& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code().value()}, {"status_message", e.what()}}}}.dump();
+			}
+			catch (const irods::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code()}, {"status_message", e.client_display_what()}}}}
+						.dump();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(http::status::internal_server_error);
+			}
+
+			res.prepare_payload();
+
+			_sess_ptr->send(std::move(res));
+		});
+	} // op_verify_checksums
 } // anonymous namespace
@@ -1,11 +1,19 @@
 #include "irods/private/http_api/handlers.hpp"
 
+#include "irods/private/http_api/bulk_operations.hpp"
+#include "irods/private/http_api/checksum_cache.hpp"
+#include "irods/private/http_api/chunked_response.hpp"
 #include "irods/private/http_api/common.hpp"
+#include "irods/private/http_api/delta.hpp"
+#include "irods/private/http_api/digest.hpp"
 #include "irods/private/http_api/globals.hpp"
+#include "irods/private/http_api/lock_instrumentation.hpp"
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
 #include "irods/private/http_api/shared_api_operations.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/version.hpp"
+#include "irods/private/http_api/write_behind.hpp"
 
 #include <irods/client_connection.hpp>
 #include <irods/connection_pool.hpp>
@@ -21,7 +29,9 @@
 #include <irods/key_value_proxy.hpp>
 #include <irods/modDataObjMeta.h>
 #include <irods/phyPathReg.h>
+#include <irods/query_builder.hpp>
 #include <irods/rcMisc.h>
+#include <irods/replica_truncate.h>
 #include <irods/rodsErrorTable.h>
 #include <irods/rodsKeyWdDef.h>
 #include <irods/ticketAdmin.h>
@@ -34,12 +44,21 @@
 #include <boost/asio.hpp>
 #include <boost/beast.hpp>
 #include <boost/beast/http.hpp>
+#include <boost/uuid/uuid.hpp>
+#include <boost/uuid/uuid_generators.hpp>
+#include <boost/uuid/uuid_io.hpp>
 
 #include <nlohmann/json.hpp>
 
+#include <algorithm>
 #include <array>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
 #include <mutex>
+#include <optional>
 #include <span>
 #include <shared_mutex>
 #include <string>
@@ -133,20 +152,94 @@ namespace
 
 		auto in_use(bool _value) noexcept -> void
 		{
+			last_used_at_.store(std::chrono::steady_clock::now());
 			in_use_.store(_value);
 		} // in_use
 
+		// Returns the last time the stream was acquired or released.
+		auto last_used_at() const noexcept -> std::chrono::steady_clock::time_point
+		{
+			return last_used_at_.load();
+		} // last_used_at
+
 	  private:
 		irods::experimental::client_connection conn_{irods::experimental::defer_connection};
 		std::unique_ptr<irods::experimental::io::client::native_transport> tp_;
 		irods::experimental::io::odstream stream_;
 		std::atomic<bool> in_use_{false};
+		std::atomic<std::chrono::steady_clock::time_point> last_used_at_{std::chrono::steady_clock::now()};
 	}; // class parallel_write_stream
 
+	// Tracks the byte ranges of a data object which have been written successfully. Overlapping
+	// and adjacent ranges are merged.
+	class byte_range_set
+	{
+	  public:
+		auto insert(std::uint64_t _begin, std::uint64_t _end) -> void
+		{
+			if (_begin >= _end) {
+				return;
+			}
+
+			auto iter = ranges_.upper_bound(_begin);
+
+			// Merge with the preceding range if it overlaps or touches the new range.
+			if (iter != std::begin(ranges_)) {
+				if (auto prev = std::prev(iter); prev->second >= _begin) {
+					_begin = prev->first;
+					_end = std::max(_end, prev->second);
+					iter = ranges_.erase(prev);
+				}
+			}
+
+			// Merge with the ranges which start inside the new range.
+			while (iter != std::end(ranges_) && iter->first <= _end) {
+				_end = std::max(_end, iter->second);
+				iter = ranges_.erase(iter);
+			}
+
+			ranges_.emplace(_begin, _end);
+		} // insert
+
+		// Returns the number of bytes which have been written starting at offset 0.
+		auto contiguous_size() const noexcept -> std::uint64_t
+		{
+			if (ranges_.empty() || std::begin(ranges_)->first != 0) {
+				return 0;
+			}
+
+			return std::begin(ranges_)->second;
+		} // contiguous_size
+
+		auto to_json() const -> json
+		{
+			auto ranges = json::array();
+
+			for (auto&& [begin, end] : ranges_) {
+				ranges.push_back({begin, end});
+			}
+
+			return ranges;
+		} // to_json
+
+	  private:
+		// Maps the beginning of a range to its end (exclusive).
+		std::map<std::uint64_t, std::uint64_t> ranges_;
+	}; // class byte_range_set
+
 	struct parallel_write_context
 	{
+		std::string lpath;
 		std::vector<std::shared_ptr<parallel_write_stream>> streams;
-		std::unique_ptr<std::mutex> mtx;
+		std::unique_ptr<irods::http::instrumented_mutex<std::mutex>> mtx;
+
+		// The byte ranges acknowledged to the client. Protected by mtx.
+		byte_range_set committed_ranges;
+
+		// The size of the data object once all bytes are written. Provided by the client.
+		std::optional<std::uint64_t> total_size;
+
+		std::chrono::steady_clock::time_point created_at = std::chrono::steady_clock::now();
 
 		auto find_available_parallel_write_stream() -> parallel_write_stream*
 		{
@@ -165,9 +258,73 @@ namespace
 		} // find_available_parallel_write_stream
 	}; // struct parallel_write_context
 
-	std::shared_mutex pwc_mtx;
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	irods::http::instrumented_mutex<std::shared_mutex> pwc_mtx{
+		irods::http::lock_instrumentation::statistics("data_objects.parallel_write_contexts")};
+
 	std::unordered_map<std::string, parallel_write_context> parallel_write_contexts;
 
+	// Shared by the mutexes of all parallel write contexts.
+	// NOLINTNEXTLINE(cert-err58-cpp)
+	auto& parallel_write_context_lock_statistics =
+		irods::http::lock_instrumentation::statistics("data_objects.parallel_write_context");
+
+	auto record_committed_range(const std::string& _parallel_write_handle, std::uint64_t _begin, std::uint64_t _end)
+		-> void
+	{
+		std::shared_lock lk{pwc_mtx};
+
+		// The handle may have been shut down while the write was in progress.
+		const auto iter = parallel_write_contexts.find(_parallel_write_handle);
+		if (iter == std::end(parallel_write_contexts)) {
+			return;
+		}
+
+		std::scoped_lock ctx_lk{*iter->second.mtx};
+		iter->second.committed_ranges.insert(_begin, _end);
+	} // record_committed_range
+
+	// A replica targeted by a checksum verification and the checksum recorded in the catalog.
+	struct replica_for_verification
+	{
+		irods::http::checksum_cache::replica_identity identity;
+		std::string checksum;
+	}; // struct replica_for_verification
+
+	// Returns the replicas of the data object which op_verify_checksum will verify. The
+	// [replica-number] and [resource] parameters are honored the same way the server does.
+	auto find_replicas_for_verification(
+		RcComm& _comm,
+		const std::string& _lpath,
+		const irods::http::query_arguments_type& _args) -> std::vector<replica_for_verification>
+	{
+		const fs::path path = _lpath;
+		const auto gql = fmt::format(
+			"select DATA_REPL_NUM, DATA_SIZE, DATA_MODIFY_TIME, DATA_CHECKSUM, DATA_RESC_HIER "
+			"where COLL_NAME = '{}' and DATA_NAME = '{}'",
+			path.parent_path().c_str(),
+			path.object_name().c_str());
+
+		const auto replica_number_iter = _args.find("replica-number");
+		const auto resource_iter = _args.find("resource");
+
+		std::vector<replica_for_verification> replicas;
+
+		for (auto&& row : irods::experimental::query_builder{}.build<RcComm>(_comm, gql)) {
+			if (replica_number_iter != std::end(_args) && row[0] != replica_number_iter->second) {
+				continue;
+			}
+
+			if (resource_iter != std::end(_args) && row[4].substr(0, row[4].find(';')) != resource_iter->second) {
+				continue;
+			}
+
+			replicas.push_back({{_lpath, std::stoi(row[0]), std::stoll(row[1]), row[2]}, row[3]});
+		}
+
+		return replicas;
+	} // find_replicas_for_verification
+
 	//
 	// Handler function prototypes
 	//
@@ -175,7 +332,13 @@ namespace
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_read);
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_write);
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_parallel_write_init);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_parallel_write_status);
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_parallel_write_shutdown);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_write_behind_status);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_write_behind_discard);
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_block_signatures);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_apply_delta);
 
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_replicate);
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_trim);
@@ -185,6 +348,7 @@ namespace
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_stat);
 
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_register);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_bulk_register);
 
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_rename);
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_copy);
@@ -195,6 +359,7 @@ namespace
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_verify_checksum);
 
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_modify_metadata);
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_bulk_modify_metadata);
 
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_modify_replica);
 
@@ -206,6 +371,9 @@ namespace
 	const std::unordered_map<std::string, irods::http::handler_type> handlers_for_get{
 		{"read", op_read},
 		{"stat", op_stat},
+		{"parallel_write_status", op_parallel_write_status},
+		{"write_behind_status", op_write_behind_status},
+		{"block_signatures", op_block_signatures},
 		{"verify_checksum", op_verify_checksum}
 	};
 
@@ -216,6 +384,8 @@ namespace
 		{"write", op_write},
 		{"parallel_write_init", op_parallel_write_init},
 		{"parallel_write_shutdown", op_parallel_write_shutdown},
+		{"write_behind_discard", op_write_behind_discard},
+		{"apply_delta", op_apply_delta},
 
 		{"rename", op_rename},
 		{"copy", op_copy},
@@ -224,6 +394,7 @@ namespace
 		{"trim", op_trim},
 
 		{"register", op_register},
+		{"bulk_register", op_bulk_register},
 
 		{"set_permission", op_set_permission},
 		{"modify_permissions", op_modify_permissions},
@@ -231,10 +402,15 @@ namespace
 		{"calculate_checksum", op_calculate_checksum},
 
 		{"modify_metadata", op_modify_metadata},
+		{"bulk_modify_metadata", op_bulk_modify_metadata},
 
 		{"modify_replica", op_modify_replica}
 	};
 	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	const irods::http::operation_registration registration{
+		irods::http::handler::data_objects, handlers_for_get, handlers_for_post};
 } // anonymous namespace
 
 namespace irods::http::handler
@@ -244,6 +420,43 @@ namespace irods::http::handler
 	{
 		execute_operation(_sess_ptr, _req, handlers_for_get, handlers_for_post);
 	} // data_objects
+
+	auto parallel_write_contexts_snapshot() -> nlohmann::json
+	{
+		using std::chrono::duration_cast;
+		using std::chrono::seconds;
+
+		const auto now = std::chrono::steady_clock::now();
+
+		auto contexts = json::array();
+
+		std::shared_lock lk{pwc_mtx};
+
+		// clang-format off
+		for (auto&& [handle, ctx] : parallel_write_contexts) {
+			auto streams = json::array();
+
+			std::scoped_lock ctx_lk{*ctx.mtx};
+
+			for (auto&& stream : ctx.streams) {
+				streams.push_back({
+					{"in_use", stream->is_in_use()},
+					{"idle_time_in_seconds", duration_cast<seconds>(now - stream->last_used_at()).count()}
+				});
+			}
+
+			contexts.push_back({
+				{"parallel_write_handle", handle},
+				{"lpath", ctx.lpath},
+				{"age_in_seconds", duration_cast<seconds>(now - ctx.created_at).count()},
+				{"contiguous_bytes_written", ctx.committed_ranges.contiguous_size()},
+				{"streams", streams}
+			});
+		}
+		// clang-format on
+
+		return contexts;
+	} // parallel_write_contexts_snapshot
 } // namespace irods::http::handler
 
 namespace
@@ -305,10 +518,21 @@ namespace
 		auto stream_bytes_to_client() -> void
 		{
 			irods::http::globals::background_task([self = shared_from_this(), fn = __func__]() mutable {
-				self->in_.read(
-					self->buffer_.data(),
-					// NOLINTNEXTLINE(bugprone-narrowing-conversions, cppcoreguidelines-narrowing-conversions)
-					std::min<std::streamsize>(self->buffer_.size(), self->remaining_bytes_));
+				// Closing the connection without the final chunk tells the client the response is
+				// incomplete.
+				if (self->sess_ptr_->is_cancelled()) {
+					logging::warn(*self->sess_ptr_, "{}: Request cancelled. Stopping read.", fn);
+					// The socket must only be used by the executor of the session.
+					return net::post(self->sess_ptr_->stream().get_executor(), [self] { self->sess_ptr_->do_close(); });
+				}
+
+				{
+					irods::http::tracing::span span{"irods_read"};
+					self->in_.read(
+						self->buffer_.data(),
+						// NOLINTNEXTLINE(bugprone-narrowing-conversions, cppcoreguidelines-narrowing-conversions)
+						std::min<std::streamsize>(self->buffer_.size(), self->remaining_bytes_));
+				}
 
 				if (self->in_.fail()) {
 					logging::error(*self->sess_ptr_, "{}: Stream is in a bad state.", fn);
@@ -357,6 +581,18 @@ namespace
 		std::int64_t remaining_bytes_;
 	}; // incremental_read
 
+	// The checksum of the bytes of a write operation. It is computed from the request body before
+	// anything is sent to iRODS.
+	struct write_checksum_state
+	{
+		// The checksum in the format stored in the catalog (e.g. "sha2:<base64>").
+		std::string checksum;
+
+		// The logical path of the data object. Only set if the checksum is to be registered
+		// in the catalog once the data object is closed.
+		std::optional<std::string> lpath_for_registration;
+	}; // struct write_checksum_state
+
 	class incremental_write : public std::enable_shared_from_this<incremental_write>
 	{
 	  public:
@@ -372,7 +608,9 @@ namespace
 			std::string _buffer,
 			std::int64_t _remaining_bytes,
 			std::int64_t _max_bytes_per_write,
-			bool _is_parallel_write)
+			bool _is_parallel_write,
+			std::function<void()> _on_success = {},
+			std::optional<write_checksum_state> _checksum = std::nullopt)
 			: sess_ptr_{_sess_ptr->shared_from_this()}
 			, res_{http::status::ok, _http_version}
 			, conn_{std::move(_conn)}
@@ -385,6 +623,8 @@ namespace
 			, max_bytes_per_write_{_max_bytes_per_write}
 			, read_pos_{buffer_.data()}
 			, is_parallel_write_{_is_parallel_write}
+			, on_success_{std::move(_on_success)}
+			, checksum_{std::move(_checksum)}
 		{
 			res_.set(http::field::server, irods::http::version::server_name);
 			res_.set(http::field::content_type, "application/json");
@@ -419,20 +659,45 @@ namespace
 							fn,
 							self->remaining_bytes_,
 							to_send);
-						self->out_ptr_->write(self->read_pos_, to_send);
+
+						{
+							irods::http::tracing::span span{"irods_write"};
+							self->out_ptr_->write(self->read_pos_, to_send);
+						}
+
 						self->read_pos_ += to_send; // NOLINT(cppcoreguidelines-pro-bounds-pointer-arithmetic)
 						self->remaining_bytes_ -= to_send;
 
 						return self->stream_bytes_to_irods();
 					}
 
+					// The replica number must be captured before the stream is closed. It identifies the
+					// replica whose checksum is registered.
+					const auto replica_number = self->out_ptr_->replica_number().value;
+
 					// If we're performing a normal write, close the stream before returning a response.
 					// This is required so that the iRODS server triggers appropriate policy before handing
 					// back control to the client. For example, replication resources and synchronous replication.
 					if (!self->is_parallel_write_) {
+						irods::http::tracing::span span{"irods_close"};
 						self->out_ptr_->close();
 					}
 
+					// The final write may have failed. The bytes must not be acknowledged in that case.
+					if (!*self->out_ptr_) {
+						logging::error(*self->sess_ptr_, "{}: Could not write all bytes to data object.", fn);
+						return self->sess_ptr_->send(
+							irods::http::fail(self->res_, http::status::internal_server_error));
+					}
+
+					if (self->on_success_) {
+						self->on_success_();
+					}
+
+					if (self->checksum_) {
+						return self->finish_checksum(replica_number);
+					}
+
 					self->res_.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
 					self->res_.prepare_payload();
 					self->sess_ptr_->send(std::move(self->res_));
@@ -448,6 +713,40 @@ namespace
 			});
 		} // stream_bytes_to_irods
 
+		// Registers the checksum if requested. Because the checksum is computed from the bytes of
+		// the request, the iRODS server never has to read the replica back to produce one.
+		auto finish_checksum(int _replica_number) -> void
+		{
+			const auto& state = *checksum_;
+			const auto& checksum = state.checksum;
+
+			int ec = 0;
+
+			if (state.lpath_for_registration) {
+				DataObjInfo info{};
+				irods::strncpy_null_terminated(info.objPath, state.lpath_for_registration->c_str());
+				info.replNum = _replica_number;
+
+				KeyValPair reg_params{};
+				irods::experimental::key_value_proxy kvp{reg_params};
+				irods::at_scope_exit clear_kvp{[&kvp] { kvp.clear(); }};
+				kvp[CHKSUM_KW] = checksum;
+
+				ModDataObjMetaInp input{};
+				input.dataObjInfo = &info;
+				input.regParam = &reg_params;
+
+				ec = rcModDataObjMeta(static_cast<RcComm*>(conn_), &input);
+				if (ec < 0) {
+					logging::error(*sess_ptr_, "{}: Could not register checksum. [error_code={}]", __func__, ec);
+				}
+			}
+
+			res_.body() = json{{"irods_response", {{"status_code", ec}}}, {"checksum", checksum}}.dump();
+			res_.prepare_payload();
+			sess_ptr_->send(std::move(res_));
+		} // finish_checksum
+
 		// The following member variables represent state initialized by op_write.
 		// Instances of this class require the state to last until after the final write
 		// operation completes or an error occurs, whichever happens first.
@@ -473,12 +772,191 @@ namespace
 
 		// Indicates whether the client is performing a parallel write.
 		const bool is_parallel_write_;
+
+		// Invoked once all bytes have been written successfully.
+		std::function<void()> on_success_;
+
+		// Only set if the client supplied a digest or requested that the checksum be registered.
+		std::optional<write_checksum_state> checksum_;
 	}; // incremental_write
 
+	auto register_ndjson_entry(
+		RcComm& _comm,
+		const irods::http::ndjson_entry& _entry,
+		bool _as_additional_replica,
+		bool _force) -> std::string
+	{
+		const auto entry = json::parse(_entry.text, nullptr, false);
+		if (entry.is_discarded() || !entry.is_object()) {
+			return irods::http::make_bulk_error_result(_entry.line_number, SYS_INVALID_INPUT_PARAM, "Invalid JSON.");
+		}
+
+		const auto get_string = [&entry](const char* _key) -> const std::string* {
+			const auto iter = entry.find(_key);
+			return (iter != std::end(entry) && iter->is_string()) ? iter->get_ptr<const std::string*>() : nullptr;
+		};
+
+		const auto* lpath = get_string("lpath");
+		if (!lpath || lpath->empty() || lpath->size() >= sizeof(DataObjInp::objPath)) {
+			return irods::http::make_bulk_error_result(
+				_entry.line_number, SYS_INVALID_INPUT_PARAM, "Missing or invalid [lpath] member.");
+		}
+
+		const auto* ppath = get_string("ppath");
+		if (!ppath || ppath->empty()) {
+			return irods::http::make_bulk_error_result(
+				_entry.line_number, SYS_INVALID_INPUT_PARAM, "Missing or invalid [ppath] member.");
+		}
+
+		const auto* resource = get_string("resource");
+		if (!resource || resource->empty()) {
+			return irods::http::make_bulk_error_result(
+				_entry.line_number, SYS_INVALID_INPUT_PARAM, "Missing or invalid [resource] member.");
+		}
+
+		DataObjInp input{};
+		irods::at_scope_exit free_memory{[&input] { clearKeyVal(&input.condInput); }};
+
+		irods::strncpy_null_terminated(input.objPath, lpath->c_str());
+		addKeyVal(&input.condInput, FILE_PATH_KW, ppath->c_str());
+		addKeyVal(&input.condInput, DEST_RESC_NAME_KW, resource->c_str());
+
+		if (const auto iter = entry.find("size"); iter != std::end(entry)) {
+			if (!iter->is_number_unsigned()) {
+				return irods::http::make_bulk_error_result(
+					_entry.line_number, SYS_INVALID_INPUT_PARAM, "Invalid [size] member.");
+			}
+
+			addKeyVal(&input.condInput, DATA_SIZE_KW, std::to_string(iter->get<std::uint64_t>()).c_str());
+		}
+
+		if (const auto iter = entry.find("checksum"); iter != std::end(entry)) {
+			if (!iter->is_string()) {
+				return irods::http::make_bulk_error_result(
+					_entry.line_number, SYS_INVALID_INPUT_PARAM, "Invalid [checksum] member.");
+			}
+
+			addKeyVal(&input.condInput, REG_CHKSUM_KW, iter->get_ref<const std::string&>().c_str());
+		}
+
+		if (_as_additional_replica) {
+			addKeyVal(&input.condInput, REG_REPL_KW, "");
+		}
+
+		if (_force) {
+			addKeyVal(&input.condInput, FORCE_FLAG_KW, "");
+		}
+
+		const auto ec = rcPhyPathReg(&_comm, &input);
+
+		// clang-format off
+		auto result = json{
+			{"line", _entry.line_number},
+			{"lpath", *lpath},
+			{"irods_response", {
+				{"status_code", (ec < 0) ? ec : 0}
+			}}
+		}.dump();
+		// clang-format on
+
+		result += '\n';
+
+		return result;
+	} // register_ndjson_entry
+
 	//
 	// Operation handler implementations
 	//
 
+	// Returns the digest supplied via the Content-Digest or Digest header of \p _req.
+	auto find_expected_digest(const irods::http::request_type& _req) -> std::optional<irods::http::expected_digest>
+	{
+		if (const auto hdr = _req.find("Content-Digest"); hdr != std::end(_req)) {
+			const auto value = hdr->value();
+			return irods::http::parse_content_digest_header({value.data(), value.size()});
+		}
+
+		if (const auto hdr = _req.find("Digest"); hdr != std::end(_req)) {
+			const auto value = hdr->value();
+			return irods::http::parse_digest_header({value.data(), value.size()});
+		}
+
+		return std::nullopt;
+	} // find_expected_digest
+
+	// Stores the bytes of a write in the write-behind spool. The data object is written in the
+	// background.
+	auto spool_write(
+		irods::http::session_pointer_type _sess_ptr,
+		const irods::http::request_type& _req,
+		const irods::http::query_arguments_type& _args,
+		const std::string& _username,
+		http::response<http::string_body>& _res) -> void
+	{
+		const auto is_set = [&_args](const char* _name, std::string_view _value) {
+			const auto iter = _args.find(_name);
+			return iter != std::end(_args) && iter->second == _value;
+		};
+
+		if (!irods::http::write_behind::enabled()) {
+			logging::error(*_sess_ptr, "{}: Write-behind is not enabled.", __func__);
+			return _sess_ptr->send(irods::http::fail(_res, http::status::bad_request));
+		}
+
+		// Spooled writes replace the entire data object. Anything which depends on the current
+		// state of the data object cannot be deferred.
+		if (_args.contains("parallel-write-handle") || _args.contains("offset") || _args.contains("ticket") ||
+		    is_set("truncate", "0") || is_set("append", "1") || is_set("register-checksum", "1"))
+		{
+			logging::error(*_sess_ptr, "{}: Parameters are not compatible with [write-behind].", __func__);
+			return _sess_ptr->send(irods::http::fail(_res, http::status::bad_request));
+		}
+
+		const auto lpath_iter = _args.find("lpath");
+		if (lpath_iter == std::end(_args)) {
+			logging::error(*_sess_ptr, "{}: Missing [lpath] parameter.", __func__);
+			return _sess_ptr->send(irods::http::fail(_res, http::status::bad_request));
+		}
+
+		const auto bytes_iter = _args.find("bytes");
+		if (bytes_iter == std::end(_args)) {
+			logging::error(*_sess_ptr, "{}: Missing [bytes] parameter.", __func__);
+			return _sess_ptr->send(irods::http::fail(_res, http::status::bad_request));
+		}
+
+		// The client is not around when the upload happens, so the digest is verified before
+		// the write is acknowledged.
+		if (const auto expected = find_expected_digest(_req); expected) {
+			irods::http::digest digest{expected->algorithm};
+			digest.update(bytes_iter->second);
+
+			if (!irods::http::matches(*expected, digest.finish())) {
+				return _sess_ptr->send(irods::http::fail(
+					_res,
+					http::status::bad_request,
+					json{{"irods_response", {{"status_code", USER_CHKSUM_MISMATCH}}}}.dump()));
+			}
+		}
+
+		const auto resource_iter = _args.find("resource");
+		const auto handle = irods::http::write_behind::enqueue(
+			_username,
+			lpath_iter->second,
+			(resource_iter != std::end(_args)) ? resource_iter->second : std::string{},
+			bytes_iter->second);
+
+		if (!handle) {
+			logging::error(*_sess_ptr, "{}: Write-behind spool is full.", __func__);
+			return _sess_ptr->send(irods::http::fail(_res, http::status::service_unavailable));
+		}
+
+		_res.result(http::status::accepted);
+		_res.body() = json{{"irods_response", {{"status_code", 0}}}, {"write_behind_handle", *handle}}.dump();
+		_res.prepare_payload();
+
+		_sess_ptr->send(std::move(_res));
+	} // spool_write
+
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_read)
 	{
 		auto result = irods::http::resolve_client_identity(_req);
@@ -730,7 +1208,12 @@ namespace
 
 				std::vector<char> buffer(count);
 
-				if (!in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()))) {
+				{
+					irods::http::tracing::span span{"irods_read"};
+					in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+				}
+
+				if (!in) {
 					logging::error(
 						*_sess_ptr, "{}: Could not read bytes from data object [{}].", fn, lpath_iter->second);
 					res.result(http::status::internal_server_error);
@@ -781,6 +1264,72 @@ namespace
 			res.keep_alive(_req.keep_alive());
 
 			try {
+				if (const auto iter = _args.find("write-behind"); iter != std::end(_args) && iter->second == "1") {
+					return spool_write(_sess_ptr, _req, _args, client_info.username, res);
+				}
+
+				// The bytes of the request are in memory before anything is sent to iRODS. They are
+				// verified before the data object is opened so that a mismatch never reaches the
+				// replica, not even by truncating it.
+				std::optional<write_checksum_state> checksum;
+
+				auto expected_digest = find_expected_digest(_req);
+
+				const auto register_iter = _args.find("register-checksum");
+				const bool register_checksum = register_iter != std::end(_args) && register_iter->second == "1";
+
+				if (register_checksum) {
+					// The checksum describes the bytes of this request. It can only be registered
+					// when those bytes make up the entire data object.
+					const auto is_set = [&_args](const char* _name, std::string_view _value) {
+						const auto iter = _args.find(_name);
+						return iter != std::end(_args) && iter->second == _value;
+					};
+
+					if (_args.contains("parallel-write-handle") || _args.contains("offset") ||
+					    is_set("truncate", "0") || is_set("append", "1"))
+					{
+						logging::error(
+							*_sess_ptr,
+							"{}: [register-checksum] requires a write which replaces the entire data object.",
+							fn);
+						return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+					}
+				}
+
+				if (const auto bytes_iter = _args.find("bytes");
+				    bytes_iter != std::end(_args) && (expected_digest || register_checksum))
+				{
+					const auto algorithm =
+						expected_digest ? expected_digest->algorithm : irods::http::digest_algorithm::sha256;
+
+					irods::http::digest digest{algorithm};
+					digest.update(bytes_iter->second);
+					const auto raw_digest = digest.finish();
+
+					checksum = write_checksum_state{irods::http::to_irods_checksum(algorithm, raw_digest), {}};
+
+					if (expected_digest && !irods::http::matches(*expected_digest, raw_digest)) {
+						logging::error(*_sess_ptr, "{}: Digest supplied by client does not match bytes received.", fn);
+						res.result(http::status::bad_request);
+						// clang-format off
+						res.body() = json{
+							{"irods_response", {
+								{"status_code", USER_CHKSUM_MISMATCH},
+								{"status_message", "Digest supplied by client does not match bytes received."}
+							}},
+							{"checksum", checksum->checksum}
+						}.dump();
+						// clang-format on
+						res.prepare_payload();
+						return _sess_ptr->send(std::move(res));
+					}
+
+					if (register_checksum) {
+						checksum->lpath_for_registration = _args.find("lpath")->second;
+					}
+				}
+
 				// Used to determine whether the data object should be closed following the write
 				// operation or by the parallel_write_shutdown HTTP API operation.
 				bool is_parallel_write = false;
@@ -915,11 +1464,14 @@ namespace
 					return _sess_ptr->send(std::move(res));
 				}
 
+				std::optional<std::int64_t> offset;
+
 				auto iter = _args.find("offset");
 				if (iter != std::end(_args)) {
 					logging::trace(*_sess_ptr, "{}: Setting offset for write.", fn);
 					try {
-						out_ptr->seekp(std::stoll(iter->second));
+						offset = std::stoll(iter->second);
+						out_ptr->seekp(*offset);
 					}
 					catch (const std::exception& e) {
 						logging::error(
@@ -949,6 +1501,29 @@ namespace
 						.at(json::json_pointer{"/irods_client/max_number_of_bytes_per_write_operation"})
 						.get<std::int64_t>();
 
+				// Parallel writes record the byte range written so that clients can resume an
+				// interrupted transfer by only sending the ranges which are missing.
+				std::function<void()> on_success;
+
+				if (is_parallel_write) {
+					const std::int64_t position = offset ? *offset : static_cast<std::int64_t>(out_ptr->tellp());
+					if (position < 0) {
+						logging::error(*_sess_ptr, "{}: Could not determine position in data object.", fn);
+						return _sess_ptr->send(irods::http::fail(res, http::status::internal_server_error));
+					}
+
+					const auto begin = static_cast<std::uint64_t>(position);
+					on_success = [handle = parallel_write_handle_iter->second, begin, end = begin + remaining_bytes] {
+						record_committed_range(handle, begin, end);
+					};
+				}
+				else {
+					// Cached verification results must not outlive the bytes they describe.
+					const auto& lpath = _args.find("lpath")->second;
+					irods::http::checksum_cache::invalidate(lpath);
+					on_success = [lpath] { irods::http::checksum_cache::invalidate(lpath); };
+				}
+
 				// clang-format off
 				std::make_shared<incremental_write>(
 					_sess_ptr,
@@ -962,7 +1537,9 @@ namespace
 					std::move(iter->second),
 					remaining_bytes,
 					max_number_of_bytes_per_write,
-					is_parallel_write)->start();
+					is_parallel_write,
+					std::move(on_success),
+					std::move(checksum))->start();
 				// clang-format on
 			}
 			catch (const fs::filesystem_error& e) {
@@ -994,13 +1571,492 @@ namespace
 			catch (const std::exception& e) {
 				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
 				res.result(http::status::internal_server_error);
-				res.prepare_payload();
-				_sess_ptr->send(std::move(res));
+				res.prepare_payload();
+				_sess_ptr->send(std::move(res));
+			}
+		});
+	} // op_write
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_parallel_write_init)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args)] {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			http::response<http::string_body> res{http::status::ok, _req.version()};
+			res.set(http::field::server, irods::http::version::server_name);
+			res.set(http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				const auto lpath_iter = _args.find("lpath");
+				if (lpath_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [lpath] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				const auto stream_count_iter = _args.find("stream-count");
+				if (stream_count_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [stream-count] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				const auto stream_count = std::stoi(stream_count_iter->second);
+				if (stream_count > irods::http::globals::configuration()
+				                       .at(json::json_pointer{"/irods_client/max_number_of_parallel_write_streams"})
+				                       .get<int>())
+				{
+					logging::error(
+						*_sess_ptr,
+						"{}: Argument for [stream-count] parameter exceeds maximum number of streams allowed.",
+						fn,
+						stream_count_iter->second);
+					res.result(http::status::bad_request);
+					res.prepare_payload();
+					return _sess_ptr->send(std::move(res));
+				}
+
+				std::optional<std::uint64_t> total_size;
+
+				if (const auto iter = _args.find("total-size"); iter != std::end(_args)) {
+					try {
+						total_size = std::stoull(iter->second);
+					}
+					catch (const std::exception& e) {
+						logging::error(
+							*_sess_ptr,
+							"{}: Invalid value for [total-size] parameter. Received [{}].",
+							fn,
+							iter->second);
+						return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+					}
+				}
+
+				namespace io = irods::experimental::io;
+
+				logging::trace(*_sess_ptr, "{}: Opening initial output stream to [{}].", fn, lpath_iter->second);
+
+				std::vector<std::shared_ptr<parallel_write_stream>> pw_streams;
+				pw_streams.reserve(stream_count);
+
+				try {
+					auto openmode = std::ios_base::out;
+
+					if (const auto iter = _args.find("truncate"); iter != std::end(_args) && iter->second == "0") {
+						openmode |= std::ios_base::in;
+					}
+
+					if (const auto iter = _args.find("append"); iter != std::end(_args) && iter->second == "1") {
+						openmode |= std::ios_base::app;
+					}
+
+					std::optional<std::string> ticket;
+					if (const auto iter = _args.find("ticket"); iter != std::end(_args)) {
+						ticket = iter->second;
+					}
+
+					// Open the first stream.
+					pw_streams.emplace_back(std::make_shared<parallel_write_stream>(
+						client_info.username, lpath_iter->second, openmode, ticket));
+
+					auto& first_stream = pw_streams.front()->stream();
+					logging::debug(
+						*_sess_ptr,
+						"{}: replica token=[{}], replica number=[{}], leaf resource name=[{}]",
+						fn,
+						first_stream.replica_token().value,
+						first_stream.replica_number().value,
+						first_stream.leaf_resource_name().value);
+
+					// Open secondary streams using the first stream as a base.
+					for (int i = 0; i < stream_count; ++i) {
+						pw_streams.emplace_back(std::make_shared<parallel_write_stream>(
+							client_info.username, lpath_iter->second, openmode, ticket, &pw_streams.front()->stream()));
+					}
+				}
+				catch (const irods::exception& e) {
+					logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
+					logging::error(
+						*_sess_ptr, "{}: Could not open one or more output streams to [{}].", fn, lpath_iter->second);
+					res.result(http::status::internal_server_error);
+					res.prepare_payload();
+					return _sess_ptr->send(std::move(res));
+				}
+
+				std::string transfer_handle;
+
+				{
+					std::scoped_lock lk{pwc_mtx};
+
+					transfer_handle = irods::generate_uuid(parallel_write_contexts);
+					logging::debug(*_sess_ptr, "{}: (init) Parallel Write Handle = [{}].", fn, transfer_handle);
+
+					auto [iter, insertion_result] =
+						parallel_write_contexts.emplace(transfer_handle, parallel_write_context{});
+					if (!insertion_result) {
+						logging::error(
+							*_sess_ptr,
+							"{}: Could not initialize parallel write context for [{}].",
+							fn,
+							lpath_iter->second);
+						res.result(http::status::internal_server_error);
+						res.prepare_payload();
+						return _sess_ptr->send(std::move(res));
+					}
+
+					// The context is initialized while the lock is held because other threads may
+					// inspect it as soon as it is visible in the map.
+					auto& pw_context = iter->second;
+					pw_context.lpath = lpath_iter->second;
+					pw_context.streams = std::move(pw_streams);
+					pw_context.mtx = std::make_unique<irods::http::instrumented_mutex<std::mutex>>(
+						parallel_write_context_lock_statistics);
+					pw_context.total_size = total_size;
+				}
+
+				irods::http::checksum_cache::invalidate(lpath_iter->second);
+
+				res.body() =
+					json{
+						{"irods_response",
+				         {
+							 {"status_code", 0},
+						 }},
+						{"parallel_write_handle", transfer_handle}}
+						.dump();
+			}
+			catch (const fs::filesystem_error& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code().value()}, {"status_message", e.what()}}}}.dump();
+			}
+			catch (const irods::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code()}, {"status_message", e.client_display_what()}}}}
+						.dump();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(http::status::internal_server_error);
+			}
+
+			res.prepare_payload();
+
+			_sess_ptr->send(std::move(res));
+		});
+	} // op_parallel_write_init
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_parallel_write_status)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args)] {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			http::response<http::string_body> res{http::status::ok, _req.version()};
+			res.set(http::field::server, irods::http::version::server_name);
+			res.set(http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				const auto parallel_write_handle_iter = _args.find("parallel-write-handle");
+				if (parallel_write_handle_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [parallel-write-handle] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				std::shared_lock lk{pwc_mtx};
+
+				const auto pw_iter = parallel_write_contexts.find(parallel_write_handle_iter->second);
+				if (pw_iter == std::end(parallel_write_contexts)) {
+					logging::error(*_sess_ptr, "{}: Invalid handle for parallel write.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::not_found));
+				}
+
+				std::scoped_lock ctx_lk{*pw_iter->second.mtx};
+
+				const auto& committed_ranges = pw_iter->second.committed_ranges;
+
+				// clang-format off
+				json body{
+					{"irods_response", {
+						{"status_code", 0}
+					}},
+					{"committed_offset", committed_ranges.contiguous_size()},
+					{"committed_ranges", committed_ranges.to_json()}
+				};
+				// clang-format on
+
+				if (pw_iter->second.total_size) {
+					body["total_size"] = *pw_iter->second.total_size;
+				}
+
+				res.body() = body.dump();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(http::status::internal_server_error);
+			}
+
+			res.prepare_payload();
+
+			_sess_ptr->send(std::move(res));
+		});
+	} // op_parallel_write_status
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_parallel_write_shutdown)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args)] {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			http::response<http::string_body> res{http::status::ok, _req.version()};
+			res.set(http::field::server, irods::http::version::server_name);
+			res.set(http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				// 1. Verify transfer handle and lookup PTC.
+				// 2. Close all streams in reverse order.
+				// 3. Disassociate the transfer handle and PTC.
+				// 4. Free resources.
+
+				const auto parallel_write_handle_iter = _args.find("parallel-write-handle");
+				if (parallel_write_handle_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [parallel-write-handle] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(http::status::bad_request));
+				}
+
+				logging::debug(
+					*_sess_ptr, "{}: (shutdown) Parallel Write Handle = [{}].", fn, parallel_write_handle_iter->second);
+
+				{
+					std::scoped_lock lk{pwc_mtx};
+
+					const auto pw_iter = parallel_write_contexts.find(parallel_write_handle_iter->second);
+					if (pw_iter != std::end(parallel_write_contexts)) {
+						// If the client announced the size of the data object, the data object is only
+						// finalized once every byte has been written. Otherwise, the handle remains open
+						// so that the client can write the missing byte ranges.
+						if (const auto& total_size = pw_iter->second.total_size; total_size) {
+							std::scoped_lock ctx_lk{*pw_iter->second.mtx};
+
+							const auto& committed_ranges = pw_iter->second.committed_ranges;
+							if (committed_ranges.contiguous_size() < *total_size) {
+								logging::error(
+									*_sess_ptr,
+									"{}: Cannot finalize data object. Only [{}] of [{}] bytes have been written.",
+									fn,
+									committed_ranges.contiguous_size(),
+									*total_size);
+								// clang-format off
+								return _sess_ptr->send(irods::http::fail(res, http::status::bad_request, json{
+									{"irods_response", {
+										{"status_code", SYS_INVALID_INPUT_PARAM},
+										{"status_message", "Data object is incomplete."}
+									}},
+									{"committed_ranges", committed_ranges.to_json()}
+								}.dump()));
+								// clang-format on
+							}
+						}
+
+						// Ignore the first stream. It must be closed last so that replication resources
+						// are triggered correctly.
+						auto end = std::prev(std::rend(pw_iter->second.streams));
+
+						io::on_close_success close_input{};
+						close_input.update_size = false;
+						close_input.update_status = false;
+						close_input.compute_checksum = false;
+						close_input.send_notifications = false;
+						close_input.preserve_replica_state_table = false;
+
+						for (auto iter = std::rbegin(pw_iter->second.streams); iter != end; ++iter) {
+							(*iter)->stream().close(&close_input);
+						}
+
+						// Allow the first stream to update the catalog.
+						pw_iter->second.streams.front()->stream().close();
+
+						irods::http::checksum_cache::invalidate(pw_iter->second.lpath);
+
+						parallel_write_contexts.erase(pw_iter);
+					}
+				}
+
+				res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
+			}
+			catch (const fs::filesystem_error& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code().value()}, {"status_message", e.what()}}}}.dump();
+			}
+			catch (const irods::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
+				res.body() =
+					json{{"irods_response", {{"status_code", e.code()}, {"status_message", e.client_display_what()}}}}
+						.dump();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(http::status::internal_server_error);
+			}
+
+			res.prepare_payload();
+
+			_sess_ptr->send(std::move(res));
+		});
+	} // op_parallel_write_shutdown
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_write_behind_status)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args)] {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			http::response<http::string_body> res{http::status::ok, _req.version()};
+			res.set(http::field::server, irods::http::version::server_name);
+			res.set(http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				const auto handle_iter = _args.find("write-behind-handle");
+				if (handle_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [write-behind-handle] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				const auto status = irods::http::write_behind::status(handle_iter->second, client_info.username);
+				if (!status) {
+					logging::error(*_sess_ptr, "{}: Invalid handle for write-behind.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::not_found));
+				}
+
+				// clang-format off
+				json body{
+					{"irods_response", {
+						{"status_code", 0}
+					}},
+					{"state", irods::http::write_behind::to_string(status->state)},
+					{"logical_path", status->logical_path},
+					{"size", status->size},
+					{"attempts", status->attempts}
+				};
+				// clang-format on
+
+				if (status->error_code != 0) {
+					body["error"] = {{"status_code", status->error_code}, {"status_message", status->error_message}};
+				}
+
+				res.body() = body.dump();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(http::status::internal_server_error);
+			}
+
+			res.prepare_payload();
+
+			_sess_ptr->send(std::move(res));
+		});
+	} // op_write_behind_status
+
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_write_behind_discard)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _args = std::move(_args)] {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			http::response<http::string_body> res{http::status::ok, _req.version()};
+			res.set(http::field::server, irods::http::version::server_name);
+			res.set(http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				const auto handle_iter = _args.find("write-behind-handle");
+				if (handle_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [write-behind-handle] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				switch (irods::http::write_behind::discard(handle_iter->second, client_info.username)) {
+					case irods::http::write_behind::discard_result::not_found:
+						logging::error(*_sess_ptr, "{}: Invalid handle for write-behind.", fn);
+						return _sess_ptr->send(irods::http::fail(res, http::status::not_found));
+
+					case irods::http::write_behind::discard_result::not_failed:
+						logging::error(*_sess_ptr, "{}: Only failed writes can be discarded.", fn);
+						return _sess_ptr->send(irods::http::fail(res, http::status::conflict));
+
+					case irods::http::write_behind::discard_result::discarded:
+						break;
+				}
+
+				res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(http::status::internal_server_error);
 			}
+
+			res.prepare_payload();
+
+			_sess_ptr->send(std::move(res));
 		});
-	} // op_write
+	} // op_write_behind_discard
 
-	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_parallel_write_init)
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_block_signatures)
 	{
 		auto result = irods::http::resolve_client_identity(_req);
 		if (result.response) {
@@ -1028,115 +2084,116 @@ namespace
 					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
 				}
 
-				const auto stream_count_iter = _args.find("stream-count");
-				if (stream_count_iter == std::end(_args)) {
-					logging::error(*_sess_ptr, "{}: Missing [stream-count] parameter.", fn);
-					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				auto conn = irods::get_connection(client_info.username);
+
+				if (!fs::client::is_data_object(conn, lpath_iter->second)) {
+					logging::error(*_sess_ptr, "{}: Logical path [{}] is not a data object.", fn, lpath_iter->second);
+					return _sess_ptr->send(irods::http::fail(res, http::status::not_found));
 				}
 
-				const auto stream_count = std::stoi(stream_count_iter->second);
-				if (stream_count > irods::http::globals::configuration()
-				                       .at(json::json_pointer{"/irods_client/max_number_of_parallel_write_streams"})
-				                       .get<int>())
-				{
-					logging::error(
-						*_sess_ptr,
-						"{}: Argument for [stream-count] parameter exceeds maximum number of streams allowed.",
-						fn,
-						stream_count_iter->second);
-					res.result(http::status::bad_request);
-					res.prepare_payload();
-					return _sess_ptr->send(std::move(res));
+				// Each block is read into memory in its entirety, so the block size is bounded by
+				// the size of a single read.
+				static const auto max_block_size =
+					irods::http::globals::configuration()
+						.at(json::json_pointer{"/irods_client/max_number_of_bytes_per_read_operation"})
+						.get<std::uint64_t>();
+
+				const auto data_object_size =
+					static_cast<std::uint64_t>(fs::client::data_object_size(conn, lpath_iter->second));
+				auto block_size = irods::http::delta::default_block_size(data_object_size, max_block_size);
+
+				if (const auto iter = _args.find("block-size"); iter != std::end(_args)) {
+					try {
+						block_size = std::stoull(iter->second);
+					}
+					catch (const std::exception& e) {
+						block_size = 0;
+					}
+
+					if (block_size < irods::http::delta::min_block_size || block_size > max_block_size) {
+						logging::error(
+							*_sess_ptr,
+							"{}: Invalid value for [block-size] parameter. Received [{}].",
+							fn,
+							iter->second);
+						return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+					}
 				}
 
-				namespace io = irods::experimental::io;
+				io::client::native_transport tp{conn};
+				io::idstream in{tp, lpath_iter->second};
 
-				logging::trace(*_sess_ptr, "{}: Opening initial output stream to [{}].", fn, lpath_iter->second);
+				if (!in) {
+					logging::error(*_sess_ptr, "{}: Could not open data object [{}].", fn, lpath_iter->second);
+					return _sess_ptr->send(irods::http::fail(res, http::status::internal_server_error));
+				}
 
-				std::vector<std::shared_ptr<parallel_write_stream>> pw_streams;
-				pw_streams.reserve(stream_count);
+				// Past this point, the response headers have been sent. Errors are reported in
+				// the final line of the response.
+				auto response = std::make_shared<irods::http::chunked_response>(
+					_sess_ptr, _req.version(), _req.keep_alive(), "application/x-ndjson");
+				response->start();
+
+				// Lines are sent in batches so that large data objects do not produce millions of
+				// tiny chunks. write() blocks while too many bytes are queued, therefore, memory
+				// usage does not depend on the number of blocks.
+				constexpr std::size_t max_batch_size = 64 * 1024;
+
+				std::string batch = json{{"size", data_object_size}, {"block_size", block_size}}.dump() + '\n';
+				json summary{{"irods_response", {{"status_code", 0}}}};
 
 				try {
-					auto openmode = std::ios_base::out;
+					std::string buffer(block_size, '\0');
 
-					if (const auto iter = _args.find("truncate"); iter != std::end(_args) && iter->second == "0") {
-						openmode |= std::ios_base::in;
-					}
+					for (auto remaining = data_object_size; remaining > 0;) {
+						if (_sess_ptr->is_cancelled()) {
+							logging::info(*_sess_ptr, "{}: Request was cancelled.", fn);
+							return response->abort();
+						}
 
-					if (const auto iter = _args.find("append"); iter != std::end(_args) && iter->second == "1") {
-						openmode |= std::ios_base::app;
-					}
+						const auto count = std::min(remaining, block_size);
 
-					std::optional<std::string> ticket;
-					if (const auto iter = _args.find("ticket"); iter != std::end(_args)) {
-						ticket = iter->second;
-					}
+						in.read(buffer.data(), static_cast<std::streamsize>(count));
+						if (std::cmp_not_equal(in.gcount(), count)) {
+							const auto msg = fmt::format("Could not read data object [{}].", lpath_iter->second);
+							THROW(SYS_INTERNAL_ERR, msg);
+						}
 
-					// Open the first stream.
-					pw_streams.emplace_back(std::make_shared<parallel_write_stream>(
-						client_info.username, lpath_iter->second, openmode, ticket));
+						const std::string_view block{buffer.data(), count};
 
-					auto& first_stream = pw_streams.front()->stream();
-					logging::debug(
-						*_sess_ptr,
-						"{}: replica token=[{}], replica number=[{}], leaf resource name=[{}]",
-						fn,
-						first_stream.replica_token().value,
-						first_stream.replica_number().value,
-						first_stream.leaf_resource_name().value);
+						irods::http::digest strong{irods::http::digest_algorithm::sha256};
+						strong.update(block);
 
-					// Open secondary streams using the first stream as a base.
-					for (int i = 0; i < stream_count; ++i) {
-						pw_streams.emplace_back(std::make_shared<parallel_write_stream>(
-							client_info.username, lpath_iter->second, openmode, ticket, &pw_streams.front()->stream()));
+						batch += json::array({irods::http::delta::weak_checksum(block),
+						                      irods::http::safe_base64_encode(strong.finish())})
+						             .dump();
+						batch += '\n';
+
+						if (batch.size() >= max_batch_size && !response->write(std::exchange(batch, {}))) {
+							return;
+						}
+
+						remaining -= count;
 					}
 				}
 				catch (const irods::exception& e) {
 					logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
-					logging::error(
-						*_sess_ptr, "{}: Could not open one or more output streams to [{}].", fn, lpath_iter->second);
-					res.result(http::status::internal_server_error);
-					res.prepare_payload();
-					return _sess_ptr->send(std::move(res));
+					summary["irods_response"] = {
+						{"status_code", e.code()}, {"status_message", e.client_display_what()}};
+				}
+				catch (const std::exception& e) {
+					logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+					summary["irods_response"] = {{"status_code", SYS_INTERNAL_ERR}, {"status_message", e.what()}};
 				}
 
-				std::string transfer_handle;
-				decltype(parallel_write_contexts)::iterator pwc_iter;
-
-				{
-					std::scoped_lock lk{pwc_mtx};
-
-					transfer_handle = irods::generate_uuid(parallel_write_contexts);
-					logging::debug(*_sess_ptr, "{}: (init) Parallel Write Handle = [{}].", fn, transfer_handle);
-
-					auto [iter, insertion_result] =
-						parallel_write_contexts.emplace(transfer_handle, parallel_write_context{});
-					if (!insertion_result) {
-						logging::error(
-							*_sess_ptr,
-							"{}: Could not initialize parallel write context for [{}].",
-							fn,
-							lpath_iter->second);
-						res.result(http::status::internal_server_error);
-						res.prepare_payload();
-						return _sess_ptr->send(std::move(res));
-					}
+				batch += summary.dump();
+				batch += '\n';
 
-					pwc_iter = iter;
+				if (response->write(std::move(batch))) {
+					response->finish();
 				}
 
-				auto& pw_context = pwc_iter->second;
-				pw_context.streams = std::move(pw_streams);
-				pw_context.mtx = std::make_unique<std::mutex>();
-
-				res.body() =
-					json{
-						{"irods_response",
-				         {
-							 {"status_code", 0},
-						 }},
-						{"parallel_write_handle", transfer_handle}}
-						.dump();
+				return;
 			}
 			catch (const fs::filesystem_error& e) {
 				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
@@ -1158,9 +2215,9 @@ namespace
 
 			_sess_ptr->send(std::move(res));
 		});
-	} // op_parallel_write_init
+	} // op_block_signatures
 
-	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_parallel_write_shutdown)
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_apply_delta)
 	{
 		auto result = irods::http::resolve_client_identity(_req);
 		if (result.response) {
@@ -1182,48 +2239,153 @@ namespace
 			res.keep_alive(_req.keep_alive());
 
 			try {
-				// 1. Verify transfer handle and lookup PTC.
-				// 2. Close all streams in reverse order.
-				// 3. Disassociate the transfer handle and PTC.
-				// 4. Free resources.
+				const auto lpath_iter = _args.find("lpath");
+				if (lpath_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [lpath] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
 
-				const auto parallel_write_handle_iter = _args.find("parallel-write-handle");
-				if (parallel_write_handle_iter == std::end(_args)) {
-					logging::error(*_sess_ptr, "{}: Missing [parallel-write-handle] parameter.", fn);
-					return _sess_ptr->send(irods::http::fail(http::status::bad_request));
+				const auto block_size_iter = _args.find("block-size");
+				if (block_size_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [block-size] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
 				}
 
-				logging::debug(
-					*_sess_ptr, "{}: (shutdown) Parallel Write Handle = [{}].", fn, parallel_write_handle_iter->second);
+				const auto instructions_iter = _args.find("instructions");
+				if (instructions_iter == std::end(_args)) {
+					logging::error(*_sess_ptr, "{}: Missing [instructions] parameter.", fn);
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
 
-				{
-					std::scoped_lock lk{pwc_mtx};
+				std::string_view literals;
+				if (const auto iter = _args.find("bytes"); iter != std::end(_args)) {
+					literals = iter->second;
+				}
 
-					const auto pw_iter = parallel_write_contexts.find(parallel_write_handle_iter->second);
-					if (pw_iter != std::end(parallel_write_contexts)) {
-						// Ignore the first stream. It must be closed last so that replication resources
-						// are triggered correctly.
-						auto end = std::prev(std::rend(pw_iter->second.streams));
+				auto conn = irods::get_connection(client_info.username);
 
-						io::on_close_success close_input{};
-						close_input.update_size = false;
-						close_input.update_status = false;
-						close_input.compute_checksum = false;
-						close_input.send_notifications = false;
-						close_input.preserve_replica_state_table = false;
+				const auto data_object_size =
+					static_cast<std::uint64_t>(fs::client::data_object_size(conn, lpath_iter->second));
 
-						for (auto iter = std::rbegin(pw_iter->second.streams); iter != end; ++iter) {
-							(*iter)->stream().close(&close_input);
+				std::vector<irods::http::delta::instruction> instructions;
+
+				try {
+					instructions = irods::http::delta::parse_instructions(
+						instructions_iter->second, std::stoull(block_size_iter->second), data_object_size, literals);
+				}
+				catch (const irods::exception& e) {
+					logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
+					res.result(http::status::bad_request);
+					res.body() = json{{"irods_response",
+					                   {{"status_code", e.code()}, {"status_message", e.client_display_what()}}}}
+					                 .dump();
+					res.prepare_payload();
+					return _sess_ptr->send(std::move(res));
+				}
+				catch (const std::exception& e) {
+					logging::error(*_sess_ptr, "{}: Invalid delta: {}", fn, e.what());
+					return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+				}
+
+				static const auto max_number_of_bytes_per_write =
+					irods::http::globals::configuration()
+						.at(json::json_pointer{"/irods_client/max_number_of_bytes_per_write_operation"})
+						.get<std::uint64_t>();
+
+				// The delta is applied to a temporary data object in the same collection. The data
+				// object is only modified once the new contents are complete, so a delta which
+				// cannot be applied leaves it untouched, and copies may read any block.
+				const fs::path lpath = lpath_iter->second;
+				const auto uuid = boost::uuids::to_string(boost::uuids::random_generator{}());
+				const auto tmp_lpath =
+					lpath.parent_path() / fmt::format(".{}.delta.{}", lpath.object_name().c_str(), uuid);
+
+				irods::at_scope_exit remove_tmp{[&conn, &tmp_lpath, fn] {
+					try {
+						if (fs::client::exists(conn, tmp_lpath)) {
+							fs::client::remove(conn, tmp_lpath, fs::remove_options::no_trash);
 						}
+					}
+					catch (const std::exception& e) {
+						logging::error("{}: Could not remove [{}]: {}", fn, tmp_lpath.c_str(), e.what());
+					}
+				}};
 
-						// Allow the first stream to update the catalog.
-						pw_iter->second.streams.front()->stream().close();
+				std::uint64_t new_size = 0;
 
-						parallel_write_contexts.erase(pw_iter);
+				{
+					io::client::native_transport src_tp{conn};
+					io::idstream src{src_tp, lpath};
+
+					io::client::native_transport dst_tp{conn};
+					io::odstream dst{dst_tp, tmp_lpath};
+
+					if (!src || !dst) {
+						logging::error(*_sess_ptr, "{}: Could not open data objects for delta.", fn);
+						return _sess_ptr->send(irods::http::fail(res, http::status::internal_server_error));
+					}
+
+					std::string buffer;
+
+					using instruction_kind = irods::http::delta::instruction::kind;
+
+					for (auto&& in : instructions) {
+						for (std::uint64_t done = 0; done < in.length && src && dst;) {
+							const auto count = std::min(in.length - done, max_number_of_bytes_per_write);
+							std::string_view data;
+
+							if (instruction_kind::copy == in.type) {
+								buffer.resize(count);
+								src.seekg(static_cast<std::streamoff>(in.source_offset + done));
+								src.read(buffer.data(), static_cast<std::streamsize>(count));
+								if (std::cmp_not_equal(src.gcount(), count)) {
+									src.setstate(std::ios_base::failbit);
+									break;
+								}
+								data = buffer;
+							}
+							else {
+								data = literals.substr(in.source_offset + done, count);
+							}
+
+							dst.write(data.data(), static_cast<std::streamsize>(count));
+							done += count;
+						}
+
+						if (!src || !dst) {
+							logging::error(*_sess_ptr, "{}: Could not apply delta to [{}].", fn, lpath.c_str());
+							return _sess_ptr->send(irods::http::fail(res, http::status::internal_server_error));
+						}
+
+						new_size += in.length;
+					}
+
+					dst.close();
+
+					if (!dst) {
+						logging::error(*_sess_ptr, "{}: Could not close [{}].", fn, tmp_lpath.c_str());
+						return _sess_ptr->send(irods::http::fail(res, http::status::internal_server_error));
 					}
 				}
 
-				res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
+				// iRODS cannot rename a data object over another one. Overwriting the data object
+				// with a server-side copy replaces its contents in a single operation and keeps its
+				// identity, permissions and metadata.
+				dataObjCopyInp_t input{};
+				irods::at_scope_exit free_memory{[&input] {
+					clearKeyVal(&input.srcDataObjInp.condInput);
+					clearKeyVal(&input.destDataObjInp.condInput);
+				}};
+
+				irods::strncpy_null_terminated(input.srcDataObjInp.objPath, tmp_lpath.c_str());
+				irods::strncpy_null_terminated(input.destDataObjInp.objPath, lpath.c_str());
+				addKeyVal(&input.destDataObjInp.condInput, FORCE_FLAG_KW, "");
+
+				const auto ec = rcDataObjCopy(static_cast<RcComm*>(conn), &input);
+
+				irods::http::checksum_cache::invalidate(lpath.string());
+
+				res.body() = json{{"irods_response", {{"status_code", ec}}}, {"size", new_size}}.dump();
 			}
 			catch (const fs::filesystem_error& e) {
 				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
@@ -1245,7 +2407,7 @@ namespace
 
 			_sess_ptr->send(std::move(res));
 		});
-	} // op_parallel_write_shutdown
+	} // op_apply_delta
 
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_replicate)
 	{
@@ -1295,6 +2457,7 @@ namespace
 
 					auto conn = irods::get_connection(client_info.username);
 					const auto ec = rcDataObjRepl(static_cast<RcComm*>(conn), &input);
+					irods::http::checksum_cache::invalidate(input.objPath);
 
 					// clang-format off
 					res.body() = json{
@@ -1376,6 +2539,7 @@ namespace
 
 					auto conn = irods::get_connection(client_info.username);
 					const auto ec = rcDataObjTrim(static_cast<RcComm*>(conn), &input);
+					irods::http::checksum_cache::invalidate(input.objPath);
 
 					res.body() = json{{"irods_response", {{"status_code", ec < 0 ? ec : 0}}}}.dump();
 				}
@@ -1691,6 +2855,59 @@ namespace
 			});
 	} // op_register
 
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_bulk_register)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task(
+			[fn = __func__, client_info, _sess_ptr, _req = std::move(_req), _args = std::move(_args)]() mutable {
+				logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+				http::response<http::string_body> res{http::status::ok, _req.version()};
+				res.set(http::field::server, irods::http::version::server_name);
+				res.set(http::field::content_type, "application/json");
+				res.keep_alive(_req.keep_alive());
+
+				try {
+					if (!irods::http::is_ndjson_request(_req)) {
+						logging::error(*_sess_ptr, "{}: Request body must be of type [application/x-ndjson].", fn);
+						return _sess_ptr->send(irods::http::fail(res, http::status::bad_request));
+					}
+
+					const auto as_additional_replica_iter = _args.find("as-additional-replica");
+					const auto as_additional_replica =
+						(as_additional_replica_iter != std::end(_args) && as_additional_replica_iter->second == "1");
+
+					const auto force_iter = _args.find("force");
+					const auto force = (force_iter != std::end(_args) && force_iter->second == "1");
+
+					// Each background task reuses a single connection for all of the entries it
+					// processes. This avoids paying for authentication, connection checkout, and
+					// proxying for every file.
+					return irods::http::process_ndjson_entries(
+						_sess_ptr,
+						std::move(_req),
+						client_info.username,
+						[as_additional_replica, force](RcComm& _comm, const irods::http::ndjson_entry& _entry) {
+							return register_ndjson_entry(_comm, _entry, as_additional_replica, force);
+						});
+				}
+				catch (const std::exception& e) {
+					logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+					res.result(http::status::internal_server_error);
+				}
+
+				res.prepare_payload();
+
+				_sess_ptr->send(std::move(res));
+			});
+	} // op_bulk_register
+
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_remove)
 	{
 		auto result = irods::http::resolve_client_identity(_req);
@@ -1749,6 +2966,7 @@ namespace
 
 				auto conn = irods::get_connection(client_info.username);
 				const auto ec = rcDataObjUnlink(static_cast<RcComm*>(conn), &input);
+				irods::http::checksum_cache::invalidate(input.objPath);
 
 				res.body() = json{{"irods_response", {{"status_code", ec}}}}.dump();
 			}
@@ -1818,6 +3036,8 @@ namespace
 				}
 
 				fs::client::rename(conn, old_lpath_iter->second, new_lpath_iter->second);
+				irods::http::checksum_cache::invalidate(old_lpath_iter->second);
+				irods::http::checksum_cache::invalidate(new_lpath_iter->second);
 
 				res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
 			}
@@ -2183,21 +3403,63 @@ namespace
 						addKeyVal(&input.condInput, REPL_NUM_KW, iter->second.c_str());
 					}
 
+					// Only the results of verifications which read the replicas are cached.
+					bool use_cache = irods::http::checksum_cache::enabled();
+
 					if (const auto iter = _args.find("compute-checksums");
 				        iter != std::end(_args) && iter->second == "0") {
 						addKeyVal(&input.condInput, NO_COMPUTE_KW, "");
+						use_cache = false;
 					}
 
 					if (const auto iter = _args.find("admin"); iter != std::end(_args) && iter->second == "1") {
 						addKeyVal(&input.condInput, ADMIN_KW, "");
 					}
 
+					auto conn = irods::get_connection(client_info.username);
+
+					// Replicas which were verified recently and have not changed since do not need to be
+					// read again. The catalog is queried as the client, so cached results are only
+					// returned to users who can see the replicas.
+					std::vector<replica_for_verification> replicas;
+
+					if (use_cache) {
+						replicas = find_replicas_for_verification(conn, input.objPath, _args);
+
+						const auto is_verified = [](const replica_for_verification& _r) {
+							const auto checksum = irods::http::checksum_cache::find(_r.identity);
+							return checksum && !_r.checksum.empty() && *checksum == _r.checksum;
+						};
+
+						if (!replicas.empty() && std::all_of(std::begin(replicas), std::end(replicas), is_verified)) {
+							logging::debug(
+								*_sess_ptr, "{}: Using cached verification results for [{}].", fn, input.objPath);
+							res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
+							res.prepare_payload();
+							return _sess_ptr->send(std::move(res));
+						}
+					}
+
 					char* results{};
 					irods::at_scope_exit free_results{[&results] { std::free(results); }};
 
-					auto conn = irods::get_connection(client_info.username);
 					const auto ec = rcDataObjChksum(static_cast<RcComm*>(conn), &input, &results);
 
+					if (use_cache) {
+						const auto* rerr_info = static_cast<RcComm*>(conn)->rError;
+
+						if (ec == 0 && (!rerr_info || rerr_info->len == 0)) {
+							for (auto&& r : replicas) {
+								if (!r.checksum.empty()) {
+									irods::http::checksum_cache::insert(r.identity, r.checksum);
+								}
+							}
+						}
+						else {
+							irods::http::checksum_cache::invalidate(input.objPath);
+						}
+					}
+
 					json response{{"irods_response", {{"status_code", ec}}}};
 
 					if (ec < 0) {
@@ -2249,6 +3511,12 @@ namespace
 		return op_atomic_apply_metadata_operations(_sess_ptr, _req, _args, entity_type::data_object);
 	} // op_modify_metadata
 
+	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_bulk_modify_metadata)
+	{
+		using namespace irods::http::shared_api_operations;
+		return op_atomic_apply_metadata_operations_in_bulk(_sess_ptr, _req, _args, entity_type::data_object);
+	} // op_bulk_modify_metadata
+
 	IRODS_HTTP_API_ENDPOINT_OPERATION_SIGNATURE(op_modify_replica)
 	{
 		auto result = irods::http::resolve_client_identity(_req);
@@ -2337,6 +3605,7 @@ namespace
 
 				auto conn = irods::get_connection(client_info.username);
 				const auto ec = rcModDataObjMeta(static_cast<RcComm*>(conn), &input);
+				irods::http::checksum_cache::invalidate(info.objPath);
 
 				json response{{"irods_response", {{"status_code", ec}}}};
 
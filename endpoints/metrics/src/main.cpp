@@ -0,0 +1,97 @@
+#include "irods/private/http_api/handlers.hpp"
+
+#include "irods/private/http_api/allocation_accounting.hpp"
+#include "irods/private/http_api/circuit_breaker.hpp"
+#include "irods/private/http_api/common.hpp"
+#include "irods/private/http_api/concurrency_limiter.hpp"
+#include "irods/private/http_api/lock_instrumentation.hpp"
+#include "irods/private/http_api/log.hpp"
+#include "irods/private/http_api/memory_budget.hpp"
+#include "irods/private/http_api/rate_limiter.hpp"
+#include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/version.hpp"
+
+#include <boost/beast.hpp>
+#include <nlohmann/json.hpp>
+
+namespace irods::http::handler
+{
+	// NOLINTNEXTLINE(performance-unnecessary-value-param)
+	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(metrics)
+	{
+		namespace logging = irods::http::log;
+
+		try {
+			if (_req.method() != boost::beast::http::verb::get) {
+				logging::error("{}: HTTP method not supported.", __func__);
+				return _sess_ptr->send(fail(status_type::method_not_allowed));
+			}
+
+			using json = nlohmann::json;
+
+			const auto breaker = circuit_breaker::stats();
+			const auto limiter = concurrency_limiter::stats();
+
+			auto allocations_by_endpoint = json::object();
+			for (auto&& [endpoint, ops] : allocation_accounting::totals_by_endpoint()) {
+				for (auto&& [op, t] : ops) {
+					allocations_by_endpoint[endpoint][op] = {
+						{"number_of_requests", t.number_of_requests},
+						{"bytes", t.bytes},
+						{"allocations", t.allocations},
+						{"max_bytes_per_request", t.max_bytes_per_request}};
+				}
+			}
+
+			response_type res{status_type::ok, _req.version()};
+			res.set(field_type::server, irods::http::version::server_name);
+			res.set(field_type::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			// clang-format off
+			res.body() = json{
+				{"allocations", {
+					{"enabled", allocation_accounting::enabled()},
+					{"endpoints", allocations_by_endpoint}
+				}},
+				{"circuit_breaker", {
+					{"enabled", circuit_breaker::enabled()},
+					{"state", circuit_breaker::to_string(breaker.state)},
+					{"number_of_calls", breaker.number_of_calls},
+					{"number_of_failed_calls", breaker.number_of_failed_calls}
+				}},
+				{"concurrency_limiter", {
+					{"enabled", concurrency_limiter::enabled()},
+					{"limit", limiter.limit},
+					{"number_of_tasks_in_flight", limiter.number_of_tasks_in_flight},
+					{"number_of_queued_tasks", limiter.number_of_queued_tasks},
+					{"min_latency_in_microseconds", limiter.min_latency.count()},
+					{"latency_in_microseconds", limiter.latency.count()}
+				}},
+				{"locks", {
+					{"enabled", lock_instrumentation::enabled()},
+					{"histogram_bucket_bounds_in_microseconds", lock_statistics::bucket_bounds_in_microseconds},
+					{"statistics", lock_instrumentation::to_json()}
+				}},
+				{"memory_budget", {
+					{"max_size_in_bytes", memory_budget::limit()},
+					{"size_in_bytes", memory_budget::usage()},
+					{"number_of_paused_reads", memory_budget::number_of_waiters()}
+				}},
+				{"rate_limits", {
+					{"enabled", rate_limiter::enabled()},
+					{"number_of_rejected_requests", rate_limiter::number_of_rejected_requests()}
+				}}
+			}.dump();
+			// clang-format on
+
+			res.prepare_payload();
+
+			return _sess_ptr->send(std::move(res));
+		}
+		catch (const std::exception& e) {
+			logging::error(*_sess_ptr, "{}: {}", __func__, e.what());
+			return _sess_ptr->send(irods::http::fail(boost::beast::http::status::internal_server_error));
+		}
+	} // metrics
+} //namespace irods::http::handler
@@ -4,6 +4,7 @@
 #include "irods/private/http_api/globals.hpp"
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/version.hpp"
 
 #include <irods/generalAdmin.h>
@@ -76,6 +77,10 @@ namespace
 		{"remove_specific_query", op_remove_specific_query}
 	};
 	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	const irods::http::operation_registration registration{
+		irods::http::handler::query, handlers_for_get, handlers_for_post};
 } // anonymous namespace
 
 namespace irods::http::handler
@@ -237,15 +242,29 @@ namespace
 							qb.zone_hint(iter->second);
 						}
 
-						for (auto&& r : qb.build<RcComm>(conn, query_iter->second)) {
-							for (auto&& c : r) {
-								row.push_back(c);
+						{
+							irods::http::tracing::span span{"irods_genquery"};
+
+							for (auto&& r : qb.build<RcComm>(conn, query_iter->second)) {
+								// Rows are fetched from the catalog one page at a time. Stop before
+								// fetching pages nobody is waiting for.
+								if (_sess_ptr->is_cancelled()) {
+									logging::warn(*_sess_ptr, "{}: Request cancelled. Abandoning query.", fn);
+									return _sess_ptr->send(irods::http::fail(res, http::status::gateway_timeout));
+								}
+
+								for (auto&& c : r) {
+									row.push_back(c);
+								}
+
+								rows.push_back(row);
+								row.clear();
 							}
 
-							rows.push_back(row);
-							row.clear();
+							span.set_attribute("irods.number_of_rows", static_cast<std::int64_t>(rows.size()));
 						}
 
+						irods::http::tracing::span serialize_span{"serialize_response"};
 						res.body() = json{{"irods_response", {{"status_code", 0}}}, {"rows", rows}}.dump();
 					}
 				}
@@ -362,6 +381,11 @@ namespace
 					auto conn = irods::get_connection(client_info.username);
 
 					for (auto&& r : qb.build<RcComm>(conn, name)) {
+						if (_sess_ptr->is_cancelled()) {
+							logging::warn(*_sess_ptr, "{}: Request cancelled. Abandoning query.", fn);
+							return _sess_ptr->send(irods::http::fail(res, http::status::gateway_timeout));
+						}
+
 						if (offset_counter < offset) {
 							++offset_counter;
 							continue;
@@ -5,6 +5,7 @@
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
 #include "irods/private/http_api/shared_api_operations.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/version.hpp"
 
 #include <irods/generalAdmin.h>
@@ -76,6 +77,10 @@ namespace
 		{"modify_metadata", op_modify_metadata}
 	};
 	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	const irods::http::operation_registration registration{
+		irods::http::handler::resources, handlers_for_get, handlers_for_post};
 } // anonymous namespace
 
 namespace irods::http::handler
@@ -144,7 +149,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::add_resource(conn, resc_info);
+
+					{
+						irods::http::tracing::span span{"irods_add_resource"};
+						adm::client::add_resource(conn, resc_info);
+					}
 
 					res.body() = json{
 						{"irods_response",
@@ -195,7 +204,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::remove_resource(conn, name_iter->second);
+
+					{
+						irods::http::tracing::span span{"irods_remove_resource"};
+						adm::client::remove_resource(conn, name_iter->second);
+					}
 
 					res.body() = json{
 						{"irods_response",
@@ -262,6 +275,8 @@ namespace
 
 				auto conn = irods::get_connection(client_info.username);
 
+				irods::http::tracing::span span{"irods_modify_resource"};
+
 				if (property_iter->second == "name") {
 					// TODO(#284): Remove this once the resource administration library grows support
 					// for renaming resources.
@@ -388,13 +403,17 @@ namespace
 
 					auto conn = irods::get_connection(client_info.username);
 
-					const auto ctx_iter = _args.find("context");
-					if (ctx_iter != std::end(_args)) {
-						adm::client::add_child_resource(
-							conn, parent_name_iter->second, child_name_iter->second, ctx_iter->second);
-					}
-					else {
-						adm::client::add_child_resource(conn, parent_name_iter->second, child_name_iter->second);
+					{
+						irods::http::tracing::span span{"irods_add_child_resource"};
+
+						const auto ctx_iter = _args.find("context");
+						if (ctx_iter != std::end(_args)) {
+							adm::client::add_child_resource(
+								conn, parent_name_iter->second, child_name_iter->second, ctx_iter->second);
+						}
+						else {
+							adm::client::add_child_resource(conn, parent_name_iter->second, child_name_iter->second);
+						}
 					}
 
 					res.body() = json{
@@ -452,7 +471,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::remove_child_resource(conn, parent_name_iter->second, child_name_iter->second);
+
+					{
+						irods::http::tracing::span span{"irods_remove_child_resource"};
+						adm::client::remove_child_resource(conn, parent_name_iter->second, child_name_iter->second);
+					}
 
 					res.body() = json{
 						{"irods_response",
@@ -503,7 +526,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::rebalance_resource(conn, name_iter->second);
+
+					{
+						irods::http::tracing::span span{"irods_rebalance_resource"};
+						adm::client::rebalance_resource(conn, name_iter->second);
+					}
 
 					res.body() = json{
 						{"irods_response",
@@ -563,80 +590,85 @@ namespace
 
 				const auto& config = irods::http::globals::configuration();
 
-				if (config.at(json::json_pointer{"/irods_client/enable_4_2_compatibility"}).get<bool>()) {
-					const auto gql = fmt::format(
-						"select RESC_ID, RESC_TYPE_NAME, RESC_ZONE_NAME, "
-						"RESC_LOC, RESC_VAULT_PATH, RESC_STATUS, "
-						"RESC_CONTEXT, RESC_COMMENT, RESC_INFO, "
-						"RESC_FREE_SPACE, RESC_FREE_SPACE_TIME, "
-						"RESC_PARENT, RESC_CREATE_TIME, RESC_MODIFY_TIME "
-						"where RESC_NAME = '{}'",
-						name_iter->second);
-
-					for (auto&& row : irods::experimental::query_builder{}.build<RcComm>(conn, gql)) {
+				{
+					irods::http::tracing::span span{"irods_stat_resource"};
+
+					if (config.at(json::json_pointer{"/irods_client/enable_4_2_compatibility"}).get<bool>()) {
+						const auto gql = fmt::format(
+							"select RESC_ID, RESC_TYPE_NAME, RESC_ZONE_NAME, "
+							"RESC_LOC, RESC_VAULT_PATH, RESC_STATUS, "
+							"RESC_CONTEXT, RESC_COMMENT, RESC_INFO, "
+							"RESC_FREE_SPACE, RESC_FREE_SPACE_TIME, "
+							"RESC_PARENT, RESC_CREATE_TIME, RESC_MODIFY_TIME "
+							"where RESC_NAME = '{}'",
+							name_iter->second);
+
+						for (auto&& row : irods::experimental::query_builder{}.build<RcComm>(conn, gql)) {
+							exists = true;
+
+							// clang-format off
+							info = {
+								{"id", row[0]},
+								{"name", name_iter->second},
+								{"type", row[1]},
+								{"zone", row[2]},
+								{"host", row[3]},
+								{"vault_path", row[4]},
+								{"status", row[5]},
+								{"context", row[6]},
+								{"comments", row[7]},
+								{"information", row[8]},
+								{"free_space", row[9]},
+								{"free_space_last_modified", 0},
+								{"parent_id", row[11]},
+								{"created", std::stoull(row[12])},
+								{"last_modified", std::stoull(row[13])},
+								{"last_modified_millis", 0}
+							};
+							// clang-format on
+
+							if (!row[10].empty()) {
+								info["free_space_last_modified"] = std::stoull(row[10]);
+							}
+						}
+					}
+					else if (const auto resc = adm::client::resource_info(conn, name_iter->second); resc) {
 						exists = true;
 
+						// The resource administration library interprets the resource status. That behavior has
+						// been deemed undesirable due to the fact that some admins may have established conventions
+						// for the resource status. Therefore, the HTTP API uses GenQuery to retrieve the status
+						// value set by the admin.
+						std::string status;
+						const auto gql = fmt::format("select RESC_STATUS where RESC_NAME = '{}'", name_iter->second);
+						for (auto&& row : irods::experimental::query_builder{}.build<RcComm>(conn, gql)) {
+							status = std::move(row[0]);
+						}
+
 						// clang-format off
 						info = {
-							{"id", row[0]},
-							{"name", name_iter->second},
-							{"type", row[1]},
-							{"zone", row[2]},
-							{"host", row[3]},
-							{"vault_path", row[4]},
-							{"status", row[5]},
-							{"context", row[6]},
-							{"comments", row[7]},
-							{"information", row[8]},
-							{"free_space", row[9]},
-							{"free_space_last_modified", 0},
-							{"parent_id", row[11]},
-							{"created", std::stoull(row[12])},
-							{"last_modified", std::stoull(row[13])},
-							{"last_modified_millis", 0}
+							{"id", resc->id()},
+							{"name", resc->name()},
+							{"type", resc->type()},
+							{"zone", resc->zone_name()},
+							{"host", resc->host_name()},
+							{"vault_path", resc->vault_path()},
+							{"status", status},
+							{"context", resc->context_string()},
+							{"comments", resc->comments()},
+							{"information", resc->information()},
+							{"free_space", resc->free_space()},
+							{"free_space_last_modified", resc->free_space_last_modified().time_since_epoch().count()},
+							{"parent_id", resc->parent_id()},
+							{"created", resc->created().time_since_epoch().count()},
+							{"last_modified", resc->last_modified().time_since_epoch().count()},
+							{"last_modified_millis", resc->last_modified_millis().count()}
 						};
 						// clang-format on
-
-						if (!row[10].empty()) {
-							info["free_space_last_modified"] = std::stoull(row[10]);
-						}
 					}
 				}
-				else if (const auto resc = adm::client::resource_info(conn, name_iter->second); resc) {
-					exists = true;
-
-					// The resource administration library interprets the resource status. That behavior has
-					// been deemed undesirable due to the fact that some admins may have established conventions
-					// for the resource status. Therefore, the HTTP API uses GenQuery to retrieve the status
-					// value set by the admin.
-					std::string status;
-					const auto gql = fmt::format("select RESC_STATUS where RESC_NAME = '{}'", name_iter->second);
-					for (auto&& row : irods::experimental::query_builder{}.build<RcComm>(conn, gql)) {
-						status = std::move(row[0]);
-					}
-
-					// clang-format off
-					info = {
-						{"id", resc->id()},
-						{"name", resc->name()},
-						{"type", resc->type()},
-						{"zone", resc->zone_name()},
-						{"host", resc->host_name()},
-						{"vault_path", resc->vault_path()},
-						{"status", status},
-						{"context", resc->context_string()},
-						{"comments", resc->comments()},
-						{"information", resc->information()},
-						{"free_space", resc->free_space()},
-						{"free_space_last_modified", resc->free_space_last_modified().time_since_epoch().count()},
-						{"parent_id", resc->parent_id()},
-						{"created", resc->created().time_since_epoch().count()},
-						{"last_modified", resc->last_modified().time_since_epoch().count()},
-						{"last_modified_millis", resc->last_modified_millis().count()}
-					};
-					// clang-format on
-				}
 
+				irods::http::tracing::span serialize_span{"serialize_response"};
 				res.body() = json{{"irods_response", {{"status_code", 0}}}, {"exists", exists}, {"info", info}}.dump();
 			}
 			catch (const irods::exception& e) {
@@ -73,6 +73,10 @@ namespace
 		{"remove_delay_rule", op_remove_delay_rule}
 	};
 	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	const irods::http::operation_registration registration{
+		irods::http::handler::rules, handlers_for_get, handlers_for_post};
 } // anonymous namespace
 
 namespace irods::http::handler
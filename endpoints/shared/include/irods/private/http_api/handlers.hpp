@@ -3,6 +3,8 @@
 
 #include "irods/private/http_api/common.hpp"
 
+#include <nlohmann/json.hpp>
+
 #ifndef IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE
 // Enables all endpoint function signatures for declarations and definitions to be
 // updated from one location.
@@ -12,6 +14,8 @@
 
 namespace irods::http::handler
 {
+	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(administration);
+
 	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(authentication);
 
 	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(collections);
@@ -22,6 +26,8 @@ namespace irods::http::handler
 
 	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(information);
 
+	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(metrics);
+
 	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(query);
 
 	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(resources);
@@ -33,6 +39,12 @@ namespace irods::http::handler
 	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(users_groups);
 
 	IRODS_HTTP_API_ENDPOINT_ENTRY_FUNCTION_SIGNATURE(zones);
+
+	// Returns the open parallel write handles and the state of their streams. Defined by the
+	// data_objects endpoint.
+	//
+	// This function is thread-safe.
+	auto parallel_write_contexts_snapshot() -> nlohmann::json;
 } // namespace irods::http::handler
 
 #endif // IRODS_HTTP_API_HANDLERS_HPP
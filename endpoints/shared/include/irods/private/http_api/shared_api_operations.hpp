@@ -28,6 +28,11 @@ namespace irods::http::shared_api_operations
 	IRODS_HTTP_API_SHARED_API_OPERATION_FUNCTION_SIGNATURE(op_atomic_apply_acl_operations);
 
 	IRODS_HTTP_API_SHARED_API_OPERATION_FUNCTION_SIGNATURE(op_atomic_apply_metadata_operations);
+
+	// Applies metadata operations to many entities. The request body must be NDJSON. Each line
+	// must be a JSON object containing an "lpath" and "operations" member. Results are streamed
+	// back to the client as NDJSON, one line per entry, as they become available.
+	IRODS_HTTP_API_SHARED_API_OPERATION_FUNCTION_SIGNATURE(op_atomic_apply_metadata_operations_in_bulk);
 } // namespace irods::http::shared_api_operations
 
 #endif // IRODS_HTTP_API_SHARED_API_OPERATIONS_HPP
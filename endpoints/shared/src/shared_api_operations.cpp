@@ -1,8 +1,10 @@
 #include "irods/private/http_api/shared_api_operations.hpp"
 
+#include "irods/private/http_api/bulk_operations.hpp"
 #include "irods/private/http_api/globals.hpp"
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/version.hpp"
 
 #include <irods/atomic_apply_acl_operations.h>
@@ -18,7 +20,12 @@
 
 #include <nlohmann/json.hpp>
 
+#include <fmt/format.h>
+
+#include <optional>
+#include <string>
 #include <string_view>
+#include <utility>
 
 // clang-format off
 namespace beast = boost::beast;     // from <boost/beast.hpp>
@@ -31,6 +38,27 @@ namespace logging = irods::http::log;
 using json = nlohmann::json;
 // clang-format on
 
+namespace
+{
+	//
+	// Function prototypes
+	//
+
+	auto skip_whitespace(std::string_view _s, std::size_t _pos) -> std::size_t;
+
+	auto skip_string(std::string_view _s, std::size_t _pos) -> std::size_t;
+
+	auto skip_value(std::string_view _s, std::size_t _pos) -> std::size_t;
+
+	auto find_top_level_member(std::string_view _object, std::string_view _key) -> std::optional<std::string_view>;
+
+	auto apply_metadata_operations_for_entry(
+		RcComm& _comm,
+		const irods::http::ndjson_entry& _entry,
+		std::string_view _entity_type,
+		bool _admin_mode) -> std::string;
+} // anonymous namespace
+
 namespace irods::http::shared_api_operations
 {
 	IRODS_HTTP_API_SHARED_API_OPERATION_FUNCTION_SIGNATURE(op_atomic_apply_acl_operations)
@@ -104,8 +132,10 @@ namespace irods::http::shared_api_operations
 					// NOLINTNEXTLINE(cppcoreguidelines-owning-memory, cppcoreguidelines-no-malloc)
 					irods::at_scope_exit_unsafe free_output{[&output] { std::free(output); }};
 
-					const auto ec =
-						rc_atomic_apply_acl_operations(static_cast<RcComm*>(conn), json_input.c_str(), &output);
+					const auto ec = [&conn, &json_input, &output] {
+						irods::http::tracing::span span{"irods_atomic_apply_acl_operations"};
+						return rc_atomic_apply_acl_operations(static_cast<RcComm*>(conn), json_input.c_str(), &output);
+					}();
 
 					if (ec != 0) {
 						res.result(::http::status::bad_request);
@@ -117,6 +147,7 @@ namespace irods::http::shared_api_operations
 						response.at("irods_response")["failed_operation"] = json::parse(output);
 					}
 
+					irods::http::tracing::span serialize_span{"serialize_response"};
 					res.body() = response.dump();
 				}
 				catch (const irods::exception& e) {
@@ -202,24 +233,34 @@ namespace irods::http::shared_api_operations
 						return _sess_ptr->send(irods::http::fail(res, ::http::status::bad_request));
 					}
 
+					// The operations are forwarded to the iRODS server as is. Only verify that they
+					// represent valid JSON. There's no need to build a DOM for them.
+					const auto& operations = operations_iter->second;
+					if (!json::accept(operations)) {
+						logging::error(*_sess_ptr, "{}: Invalid JSON in [operations] parameter.", fn);
+						return _sess_ptr->send(irods::http::fail(res, ::http::status::bad_request));
+					}
+
 					const auto admin_mode_iter = _args.find("admin");
+					const auto admin_mode = (admin_mode_iter != std::end(_args) && admin_mode_iter->second == "1");
 
-					// clang-format off
-					const auto json_input = json{
-						{"admin_mode", (admin_mode_iter != std::end(_args) && admin_mode_iter->second == "1")},
-						{"entity_name", entity_name_iter->second},
-						{"entity_type", etype},
-						{"operations", json::parse(operations_iter->second)}
-					}.dump();
-					// clang-format on
+					const auto json_input = fmt::format(
+						R"_({{"admin_mode":{},"entity_name":{},"entity_type":"{}","operations":{}}})_",
+						admin_mode,
+						json(entity_name_iter->second).dump(),
+						etype,
+						operations);
 
 					char* output{};
 					// NOLINTNEXTLINE(cppcoreguidelines-owning-memory, cppcoreguidelines-no-malloc)
 					irods::at_scope_exit_unsafe free_output{[&output] { std::free(output); }};
 
 					auto conn = irods::get_connection(client_info.username);
-					const auto ec =
-						rc_atomic_apply_metadata_operations(static_cast<RcComm*>(conn), json_input.c_str(), &output);
+					const auto ec = [&conn, &json_input, &output] {
+						irods::http::tracing::span span{"irods_atomic_apply_metadata_operations"};
+						return rc_atomic_apply_metadata_operations(
+							static_cast<RcComm*>(conn), json_input.c_str(), &output);
+					}();
 
 					if (ec != 0) {
 						res.result(::http::status::bad_request);
@@ -231,6 +272,7 @@ namespace irods::http::shared_api_operations
 						response.at("irods_response")["failed_operation"] = json::parse(output);
 					}
 
+					irods::http::tracing::span serialize_span{"serialize_response"};
 					res.body() = response.dump();
 				}
 				catch (const irods::exception& e) {
@@ -254,4 +296,241 @@ namespace irods::http::shared_api_operations
 				return _sess_ptr->send(std::move(res));
 			});
 	} // op_atomic_apply_metadata_operations
+
+	IRODS_HTTP_API_SHARED_API_OPERATION_FUNCTION_SIGNATURE(op_atomic_apply_metadata_operations_in_bulk)
+	{
+		auto result = irods::http::resolve_client_identity(_req);
+		if (result.response) {
+			return _sess_ptr->send(std::move(*result.response));
+		}
+
+		const auto client_info = result.client_info;
+
+		irods::http::globals::background_task([fn = __func__,
+		                                       client_info,
+		                                       _sess_ptr,
+		                                       _req = std::move(_req),
+		                                       _entity_type,
+		                                       _args = std::move(_args)]() mutable {
+			logging::info(*_sess_ptr, "{}: client_info.username = [{}]", fn, client_info.username);
+
+			::http::response<::http::string_body> res{::http::status::ok, _req.version()};
+			res.set(::http::field::server, irods::http::version::server_name);
+			res.set(::http::field::content_type, "application/json");
+			res.keep_alive(_req.keep_alive());
+
+			try {
+				std::string_view etype;
+
+				switch (_entity_type) {
+					case entity_type::data_object:
+						etype = "data_object";
+						break;
+
+					case entity_type::collection:
+						etype = "collection";
+						break;
+
+					default:
+						logging::error(*_sess_ptr, "{}: Invalid entity type for bulk atomic metadata operations.", fn);
+						return _sess_ptr->send(irods::http::fail(res, ::http::status::bad_request));
+				}
+
+				if (!irods::http::is_ndjson_request(_req)) {
+					logging::error(*_sess_ptr, "{}: Request body must be of type [application/x-ndjson].", fn);
+					return _sess_ptr->send(irods::http::fail(res, ::http::status::bad_request));
+				}
+
+				const auto admin_mode_iter = _args.find("admin");
+				const auto admin_mode = (admin_mode_iter != std::end(_args) && admin_mode_iter->second == "1");
+
+				return irods::http::process_ndjson_entries(
+					_sess_ptr,
+					std::move(_req),
+					client_info.username,
+					[etype, admin_mode](RcComm& _comm, const irods::http::ndjson_entry& _entry) {
+						return apply_metadata_operations_for_entry(_comm, _entry, etype, admin_mode);
+					});
+			}
+			catch (const std::exception& e) {
+				logging::error(*_sess_ptr, "{}: {}", fn, e.what());
+				res.result(::http::status::internal_server_error);
+			}
+
+			res.prepare_payload();
+
+			return _sess_ptr->send(std::move(res));
+		});
+	} // op_atomic_apply_metadata_operations_in_bulk
 } // namespace irods::http::shared_api_operations
+
+namespace
+{
+	auto skip_whitespace(std::string_view _s, std::size_t _pos) -> std::size_t
+	{
+		while (_pos < _s.size() &&
+		       (_s[_pos] == ' ' || _s[_pos] == '\t' || _s[_pos] == '\n' || _s[_pos] == '\r'))
+		{
+			++_pos;
+		}
+
+		return _pos;
+	} // skip_whitespace
+
+	auto skip_string(std::string_view _s, std::size_t _pos) -> std::size_t
+	{
+		// Skip the opening quote.
+		++_pos;
+
+		while (_pos < _s.size()) {
+			if (_s[_pos] == '\\') {
+				_pos += 2;
+				continue;
+			}
+
+			if (_s[_pos] == '"') {
+				return _pos + 1;
+			}
+
+			++_pos;
+		}
+
+		return _pos;
+	} // skip_string
+
+	auto skip_value(std::string_view _s, std::size_t _pos) -> std::size_t
+	{
+		if (_pos >= _s.size()) {
+			return _pos;
+		}
+
+		if (_s[_pos] == '"') {
+			return skip_string(_s, _pos);
+		}
+
+		if (_s[_pos] == '{' || _s[_pos] == '[') {
+			int depth = 0;
+
+			while (_pos < _s.size()) {
+				switch (_s[_pos]) {
+					case '"':
+						_pos = skip_string(_s, _pos);
+						continue;
+
+					case '{':
+					case '[':
+						++depth;
+						break;
+
+					case '}':
+					case ']':
+						if (--depth == 0) {
+							return _pos + 1;
+						}
+						break;
+
+					default:
+						break;
+				}
+
+				++_pos;
+			}
+
+			return _pos;
+		}
+
+		// Numbers, booleans, and null.
+		return _s.find_first_of(",}] \t\r\n", _pos);
+	} // skip_value
+
+	auto find_top_level_member(std::string_view _object, std::string_view _key) -> std::optional<std::string_view>
+	{
+		// This function assumes _object contains valid JSON. It only walks the top-level members of
+		// the object, which allows callers to extract values without building a DOM.
+
+		auto pos = skip_whitespace(_object, 0);
+		if (pos >= _object.size() || _object[pos] != '{') {
+			return std::nullopt;
+		}
+
+		pos = skip_whitespace(_object, pos + 1);
+
+		while (pos < _object.size() && _object[pos] == '"') {
+			const auto key_end = skip_string(_object, pos);
+			const auto key = _object.substr(pos + 1, key_end - pos - 2);
+
+			// Skip the colon separating the key and value.
+			pos = skip_whitespace(_object, skip_whitespace(_object, key_end) + 1);
+
+			const auto value_end = skip_value(_object, pos);
+			if (value_end == std::string_view::npos || value_end > _object.size()) {
+				return std::nullopt;
+			}
+
+			if (key == _key) {
+				return _object.substr(pos, value_end - pos);
+			}
+
+			// Skip the comma separating the members.
+			pos = skip_whitespace(_object, value_end);
+			if (pos < _object.size() && _object[pos] == ',') {
+				pos = skip_whitespace(_object, pos + 1);
+			}
+		}
+
+		return std::nullopt;
+	} // find_top_level_member
+
+	auto apply_metadata_operations_for_entry(
+		RcComm& _comm,
+		const irods::http::ndjson_entry& _entry,
+		std::string_view _entity_type,
+		bool _admin_mode) -> std::string
+	{
+		// Validation is done using a SAX parser. Values are forwarded to the iRODS server as raw
+		// JSON text, avoiding the cost of building and serializing a DOM for every entry.
+		if (!json::accept(_entry.text)) {
+			return irods::http::make_bulk_error_result(_entry.line_number, SYS_INVALID_INPUT_PARAM, "Invalid JSON.");
+		}
+
+		const auto lpath = find_top_level_member(_entry.text, "lpath");
+		if (!lpath || !lpath->starts_with('"')) {
+			return irods::http::make_bulk_error_result(
+				_entry.line_number, SYS_INVALID_INPUT_PARAM, "Missing or invalid [lpath] member.");
+		}
+
+		const auto operations = find_top_level_member(_entry.text, "operations");
+		if (!operations || !operations->starts_with('[')) {
+			return irods::http::make_bulk_error_result(
+				_entry.line_number, SYS_INVALID_INPUT_PARAM, "Missing or invalid [operations] member.");
+		}
+
+		const auto json_input = fmt::format(
+			R"_({{"admin_mode":{},"entity_name":{},"entity_type":"{}","operations":{}}})_",
+			_admin_mode,
+			*lpath,
+			_entity_type,
+			*operations);
+
+		char* output{};
+		// NOLINTNEXTLINE(cppcoreguidelines-owning-memory, cppcoreguidelines-no-malloc)
+		irods::at_scope_exit_unsafe free_output{[&output] { std::free(output); }};
+
+		const auto ec = rc_atomic_apply_metadata_operations(&_comm, json_input.c_str(), &output);
+
+		if (output && json::accept(output)) {
+			return fmt::format(
+				R"_({{"line":{},"lpath":{},"irods_response":{{"status_code":{},"failed_operation":{}}}}})_" "\n",
+				_entry.line_number,
+				*lpath,
+				ec,
+				output);
+		}
+
+		return fmt::format(
+			R"_({{"line":{},"lpath":{},"irods_response":{{"status_code":{}}}}})_" "\n",
+			_entry.line_number,
+			*lpath,
+			ec);
+	} // apply_metadata_operations_for_entry
+} // anonymous namespace
@@ -4,6 +4,7 @@
 #include "irods/private/http_api/globals.hpp"
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/version.hpp"
 
 #include <irods/irods_exception.hpp>
@@ -68,6 +69,10 @@ namespace
 		{"remove", op_remove}
 	};
 	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	const irods::http::operation_registration registration{
+		irods::http::handler::tickets, handlers_for_get, handlers_for_post};
 } // anonymous namespace
 
 namespace irods::http::handler
@@ -220,6 +225,10 @@ namespace
 				}
 
 				auto conn = irods::get_connection(client_info.username);
+
+				// Covers the creation of the ticket and each of its constraints.
+				irods::http::tracing::span span{"irods_create_ticket"};
+
 				auto ticket = adm::ticket::client::create_ticket(conn, ticket_type, lpath_iter->second);
 
 				auto constraint_iter = _args.find("use-count");
@@ -364,7 +373,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::ticket::client::delete_ticket(conn, name_iter->second);
+
+					{
+						irods::http::tracing::span span{"irods_delete_ticket"};
+						adm::ticket::client::delete_ticket(conn, name_iter->second);
+					}
 
 					res.body() = json{
 						{"irods_response",
@@ -5,6 +5,7 @@
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
 #include "irods/private/http_api/shared_api_operations.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/version.hpp"
 
 #include <irods/irods_exception.hpp>
@@ -94,6 +95,10 @@ namespace
 		{"modify_metadata", op_modify_metadata}
 	};
 	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	const irods::http::operation_registration registration{
+		irods::http::handler::users_groups, handlers_for_get, handlers_for_post};
 } // anonymous namespace
 
 namespace irods::http::handler
@@ -164,7 +169,12 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::add_user(conn, adm::user{name_iter->second, zone_iter->second}, user_type, zone_type);
+
+					{
+						irods::http::tracing::span span{"irods_add_user"};
+						adm::client::add_user(
+							conn, adm::user{name_iter->second, zone_iter->second}, user_type, zone_type);
+					}
 
 					// clang-format off
 					res.body() = json{
@@ -228,7 +238,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::remove_user(conn, adm::user{name_iter->second, zone_iter->second});
+
+					{
+						irods::http::tracing::span span{"irods_remove_user"};
+						adm::client::remove_user(conn, adm::user{name_iter->second, zone_iter->second});
+					}
 
 					// clang-format off
 					res.body() = json{
@@ -304,7 +318,11 @@ namespace
 					const adm::user_password_property prop{new_password_iter->second, proxy_user_password};
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::modify_user(conn, adm::user{name_iter->second, zone_iter->second}, prop);
+
+					{
+						irods::http::tracing::span span{"irods_modify_user"};
+						adm::client::modify_user(conn, adm::user{name_iter->second, zone_iter->second}, prop);
+					}
 
 					res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
 				}
@@ -370,7 +388,11 @@ namespace
 					const adm::user_type_property prop{adm::to_user_type(new_user_type_iter->second)};
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::modify_user(conn, adm::user{name_iter->second, zone_iter->second}, prop);
+
+					{
+						irods::http::tracing::span span{"irods_modify_user"};
+						adm::client::modify_user(conn, adm::user{name_iter->second, zone_iter->second}, prop);
+					}
 
 					// clang-format off
 					res.body() = json{
@@ -522,7 +544,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::add_group(conn, adm::group{name_iter->second});
+
+					{
+						irods::http::tracing::span span{"irods_add_group"};
+						adm::client::add_group(conn, adm::group{name_iter->second});
+					}
 
 					// clang-format off
 					res.body() = json{
@@ -580,7 +606,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::remove_group(conn, adm::group{name_iter->second});
+
+					{
+						irods::http::tracing::span span{"irods_remove_group"};
+						adm::client::remove_group(conn, adm::group{name_iter->second});
+					}
 
 					// clang-format off
 					res.body() = json{
@@ -650,8 +680,12 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::add_user_to_group(
-						conn, adm::group{group_iter->second}, adm::user{user_iter->second, zone_iter->second});
+
+					{
+						irods::http::tracing::span span{"irods_add_user_to_group"};
+						adm::client::add_user_to_group(
+							conn, adm::group{group_iter->second}, adm::user{user_iter->second, zone_iter->second});
+					}
 
 					res.body() = json{
 						{"irods_response",
@@ -714,8 +748,12 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::remove_user_from_group(
-						conn, adm::group{group_iter->second}, adm::user{user_iter->second, zone_iter->second});
+
+					{
+						irods::http::tracing::span span{"irods_remove_user_from_group"};
+						adm::client::remove_user_from_group(
+							conn, adm::group{group_iter->second}, adm::user{user_iter->second, zone_iter->second});
+					}
 
 					res.body() = json{
 						{"irods_response",
@@ -760,7 +798,13 @@ namespace
 
 				try {
 					auto conn = irods::get_connection(client_info.username);
-					const auto users = adm::client::users(conn);
+
+					const auto users = [&conn] {
+						irods::http::tracing::span span{"irods_users"};
+						return adm::client::users(conn);
+					}();
+
+					irods::http::tracing::span serialize_span{"serialize_response"};
 
 					std::vector<json> v;
 					v.reserve(users.size());
@@ -808,7 +852,13 @@ namespace
 
 				try {
 					auto conn = irods::get_connection(client_info.username);
-					auto groups = adm::client::groups(conn);
+
+					auto groups = [&conn] {
+						irods::http::tracing::span span{"irods_groups"};
+						return adm::client::groups(conn);
+					}();
+
+					irods::http::tracing::span serialize_span{"serialize_response"};
 
 					std::vector<std::string> v;
 					v.reserve(groups.size());
@@ -925,11 +975,12 @@ namespace
 					const adm::group group{adm::group{group_iter->second}};
 					const adm::user user{adm::user{user_iter->second, zone_iter->second}};
 
-					res.body() =
-						json{
-							{"irods_response", {{"status_code", 0}}},
-							{"is_member", adm::client::user_is_member_of_group(conn, group, user)}}
-							.dump();
+					const auto is_member = [&] {
+						irods::http::tracing::span span{"irods_user_is_member_of_group"};
+						return adm::client::user_is_member_of_group(conn, group, user);
+					}();
+
+					res.body() = json{{"irods_response", {{"status_code", 0}}}, {"is_member", is_member}}.dump();
 				}
 				catch (const irods::exception& e) {
 					logging::error(*_sess_ptr, "{}: {}", fn, e.client_display_what());
@@ -975,6 +1026,10 @@ namespace
 
 					auto conn = irods::get_connection(client_info.username);
 
+					// The lookups are interleaved with building the response, which is cheap in
+					// comparison. One span covers both.
+					irods::http::tracing::span span{"irods_stat"};
+
 					json info{
 						{"irods_response",
 				         {
@@ -4,6 +4,7 @@
 #include "irods/private/http_api/globals.hpp"
 #include "irods/private/http_api/log.hpp"
 #include "irods/private/http_api/session.hpp"
+#include "irods/private/http_api/tracing.hpp"
 #include "irods/private/http_api/version.hpp"
 
 #include <irods/irods_at_scope_exit.hpp>
@@ -70,6 +71,10 @@ namespace
 		//{"set_zone_collection_permission", op_set_zone_collection_permission}
 	};
 	// clang-format on
+
+	// Allows requests for unknown operations to be rejected before their body is read.
+	const irods::http::operation_registration registration{
+		irods::http::handler::zones, handlers_for_get, handlers_for_post};
 } // anonymous namespace
 
 namespace irods::http::handler
@@ -125,7 +130,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::add_zone(conn, name_iter->second, opts);
+
+					{
+						irods::http::tracing::span span{"irods_add_zone"};
+						adm::client::add_zone(conn, name_iter->second, opts);
+					}
 
 					res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
 				}
@@ -177,7 +186,11 @@ namespace
 					}
 
 					auto conn = irods::get_connection(client_info.username);
-					adm::client::remove_zone(conn, name_iter->second);
+
+					{
+						irods::http::tracing::span span{"irods_remove_zone"};
+						adm::client::remove_zone(conn, name_iter->second);
+					}
 
 					res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
 				}
@@ -242,6 +255,8 @@ namespace
 
 					auto conn = irods::get_connection(client_info.username);
 
+					irods::http::tracing::span span{"irods_modify_zone"};
+
 					if (property_iter->second == "name") {
 						adm::client::modify_zone(conn, name_iter->second, adm::zone_name_property{value_iter->second});
 					}
@@ -336,8 +351,11 @@ namespace
 
 					auto conn = irods::get_connection(client_info.username);
 
-					adm::client::modify_zone(
-						conn, name_iter->second, adm::zone_collection_acl_property{acl, user_iter->second});
+					{
+						irods::http::tracing::span span{"irods_modify_zone"};
+						adm::client::modify_zone(
+							conn, name_iter->second, adm::zone_collection_acl_property{acl, user_iter->second});
+					}
 
 					res.body() = json{{"irods_response", {{"status_code", 0}}}}.dump();
 				}
@@ -389,6 +407,8 @@ namespace
 					{
 						auto conn = irods::get_connection(client_info.username);
 
+						irods::http::tracing::span span{"irods_zone_report"};
+
 						if (const auto ec = rcZoneReport(static_cast<RcComm*>(conn), &bbuf); ec != 0) {
 							logging::error(*_sess_ptr, "{}: rcZoneReport error: [{}]", fn, ec);
 							// clang-format off
@@ -404,6 +424,7 @@ namespace
 						}
 					}
 
+					irods::http::tracing::span serialize_span{"serialize_response"};
 					res.body() = fmt::format(
 						R"_irods_({{"irods_response":{{"status_code":0}},"zone_report":{}}})_irods_",
 						std::string_view(static_cast<char*>(bbuf->buf), bbuf->len));
@@ -462,6 +483,7 @@ namespace
 
 				{
 					auto conn = irods::get_connection(client_info.username);
+					irods::http::tracing::span span{"irods_stat_zone"};
 					zone = adm::client::zone_info(conn, name_iter->second);
 				}
 
@@ -482,6 +504,7 @@ namespace
 					// clang-format on
 				}
 
+				irods::http::tracing::span serialize_span{"serialize_response"};
 				// clang-format off
 				res.body() = json{
 					{"irods_response", {{"status_code", 0}}},
@@ -43,6 +43,21 @@ int user_mapper_match(const char* _param, char** _match);
 /// \retval  non-zero if closing of the plugin was not successful.
 int user_mapper_close();
 
+/// Returns the statistics of the locks used by the user mapping plugin.
+///
+/// This function is optional. The server only calls it if the plugin provides it.
+///
+/// \param[out] _stats A pointer to a C-string. Gives a JSON object mapping the name of each
+///                    lock to its statistics (see irods::http::lock_statistics::to_json).
+///                    Must be freed via user_mapper_free.
+///
+/// \pre \p _stats must be a non-null pointer to a C-string.
+///
+/// \returns A code representing the result of the operation.
+/// \retval  zero if the statistics were returned.
+/// \retval  non-zero if an error occurred.
+int user_mapper_lock_statistics(char** _stats);
+
 /// Frees a C-string generated from the user mapping plugin.
 ///
 /// \param[in] _data A C-string originating from the user mapping plugin.
@@ -1,5 +1,7 @@
 #include "irods/http_api/plugins/user_mapping/interface.h"
 
+#include "irods/private/http_api/instrumented_mutex.hpp"
+
 #include <cstdlib>
 #include <cstring>
 #include <exception>
@@ -28,11 +30,21 @@ namespace
 	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
 	std::vector<user_profile> profile_list; // Represents the mappings of irods users to attributes.
 
+	// The locks are only taken while matching OpenID users, which costs far more than the
+	// instrumentation. Therefore, their statistics are always collected.
 	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
-	std::shared_mutex list_mutex; // Ensures a write cannot happen while reads happen to profile_list and vice versa.
+	irods::http::lock_statistics list_mutex_stats{"user_mapping.local_file.list_mutex", true};
 
-	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables)
-	std::mutex update_mutex; // Allows for only one thread to run 'update()' at a time.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	irods::http::lock_statistics update_mutex_stats{"user_mapping.local_file.update_mutex", true};
+
+	// Ensures a write cannot happen while reads happen to profile_list and vice versa.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	irods::http::instrumented_mutex<std::shared_mutex> list_mutex{list_mutex_stats};
+
+	// Allows for only one thread to run 'update()' at a time.
+	// NOLINTNEXTLINE(cppcoreguidelines-avoid-non-const-global-variables, cert-err58-cpp)
+	irods::http::instrumented_mutex<std::mutex> update_mutex{update_mutex_stats};
 
 	auto update() -> void;
 
@@ -181,6 +193,27 @@ auto user_mapper_close() -> int
 	return 0;
 } // user_mapper_close
 
+auto user_mapper_lock_statistics(char** _stats) -> int
+{
+	if (nullptr == _stats) {
+		return 1;
+	}
+
+	try {
+		const auto stats = nlohmann::json{
+			{list_mutex_stats.name(), list_mutex_stats.to_json()},
+			{update_mutex_stats.name(), update_mutex_stats.to_json()}};
+
+		*_stats = strdup(stats.dump().c_str());
+		return 0;
+	}
+	catch (const std::exception& e) {
+		spdlog::error("{}: {}", __func__, e.what());
+		*_stats = nullptr;
+		return 1;
+	}
+} // user_mapper_lock_statistics
+
 auto user_mapper_free(char* _data) -> void
 {
 	// NOLINTNEXTLINE(cppcoreguidelines-no-malloc, cppcoreguidelines-owning-memory)
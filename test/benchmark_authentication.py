@@ -0,0 +1,289 @@
+'''Benchmarks the authentication paths of the iRODS HTTP API server.
+
+For each mode, the benchmark measures how many operations per second the server completes and
+how much latency authentication adds on top of a request which is not authenticated (GET
+/info). The modes are:
+
+    basic               Validates a bearer token issued by the server after Basic
+                        authentication (i.e. a lookup in the server's token store).
+    jwt                 Validates a JWT access token issued by the OpenID Provider. The server
+                        must run as a protected resource.
+    introspection       Validates an opaque access token via the introspection endpoint of the
+                        OpenID Provider. The server must run as a protected resource.
+    password_grant      Issues a bearer token via the Resource Owner Password Credentials Grant.
+                        The server must run as an OpenID client.
+    authorization_code  Issues a bearer token via the Authorization Code Grant. The server must
+                        run as an OpenID client and the provider must approve requests without
+                        user interaction (e.g. mock_oidc_provider.py).
+
+Tokens are validated by sending a POST request with an operation which does not exist. The
+server authenticates the request before reading its body, so a valid token results in an HTTP
+status code of 400 (unknown operation) without contacting iRODS, and an invalid one in 401.
+
+The OpenID modes are meant to be run against mock_oidc_provider.py, which also reports the
+number of calls made to each of its endpoints. Modes which cannot run against the server's
+configuration are reported as failed and skipped.
+
+Results can be written as JSON via --output and compared with a previous run via --compare.
+The exit code is 1 if the throughput of any mode dropped by more than --max-regression
+percent.
+
+Example:
+
+    python3 mock_oidc_provider.py --port 8080 --introspection-latency-ms 2 &
+    python3 benchmark_authentication.py --url http://localhost:9000/irods-http-api/0.5.0 \\
+        --provider-url http://localhost:8080/realms/irods --username alice --password apass \\
+        --modes basic,jwt,introspection --duration 10 --concurrency 8
+'''
+
+import argparse
+import base64
+import json
+import sys
+import threading
+import time
+import urllib.parse
+
+import requests
+
+all_modes = ['basic', 'jwt', 'introspection', 'password_grant', 'authorization_code']
+
+# An operation which no endpoint implements.
+probe_operation = '__benchmark_authentication__'
+
+class benchmark_error(Exception):
+    pass
+
+def percentile(values, p):
+    if not values:
+        return 0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p))]
+
+def provider_stats(args):
+    '''Returns the number of calls made to each endpoint of the mock provider, or None.'''
+    if not args.provider_url:
+        return None
+
+    try:
+        url = urllib.parse.urlsplit(args.provider_url)
+        r = requests.get(f'{url.scheme}://{url.netloc}/stats', timeout=5)
+        return r.json() if r.status_code == 200 else None
+    except (requests.RequestException, ValueError):
+        return None
+
+def provider_token(args, token_format):
+    '''Obtains an access token from the OpenID Provider via the password grant.'''
+    if not args.provider_url:
+        raise benchmark_error('--provider-url is required.')
+
+    r = requests.post(f'{args.provider_url}/protocol/openid-connect/token', data={
+        'grant_type': 'password',
+        'client_id': args.client_id,
+        'username': args.username,
+        'password': args.password,
+        'scope': 'openid',
+        'token_format': token_format
+    }, timeout=args.timeout)
+
+    if r.status_code != 200:
+        raise benchmark_error(f'The provider returned HTTP status code {r.status_code}.')
+
+    return r.json()['access_token']
+
+def credentials(args):
+    return base64.b64encode(f'{args.username}:{args.password}'.encode()).decode()
+
+def make_operation(args, mode):
+    '''Returns a function which performs one operation of the mode using a session, and returns
+    whether it succeeded.'''
+    url = args.url.rstrip('/')
+
+    if mode in ['basic', 'jwt', 'introspection']:
+        if mode == 'basic':
+            r = requests.post(f'{url}/authenticate', auth=(args.username, args.password), timeout=args.timeout)
+            if r.status_code != 200:
+                raise benchmark_error(f'Basic authentication returned HTTP status code {r.status_code}.')
+            token = r.text
+        else:
+            token = provider_token(args, 'jwt' if mode == 'jwt' else 'opaque')
+
+        headers = {'Authorization': f'Bearer {token}'}
+        data = {'op': probe_operation}
+
+        def validate(session):
+            r = session.post(f'{url}/collections', headers=headers, data=data, timeout=args.timeout)
+            return r.status_code == 400
+
+        return validate
+
+    if mode == 'password_grant':
+        headers = {'Authorization': f'iRODS {credentials(args)}'}
+
+        def password_grant(session):
+            r = session.post(f'{url}/authenticate', headers=headers, timeout=args.timeout)
+            return r.status_code == 200 and len(r.text) > 0
+
+        return password_grant
+
+    if mode == 'authorization_code':
+        def authorization_code(session):
+            # Follows the redirects to the provider and back to the server.
+            r = session.get(f'{url}/authenticate', timeout=args.timeout)
+            return r.status_code == 200 and len(r.text) > 0
+
+        return authorization_code
+
+    raise benchmark_error(f'Unknown mode [{mode}].')
+
+def run(args, operation):
+    '''Runs the operation on several threads and returns the latencies of the successful
+    operations measured after the warmup, the number of failures and the elapsed time.'''
+    lock = threading.Lock()
+    latencies = []
+    failures = [0]
+
+    start = time.monotonic()
+    measure_from = start + args.warmup
+    stop_at = measure_from + args.duration
+
+    def worker():
+        session = requests.Session()
+        local_latencies = []
+        local_failures = 0
+
+        while True:
+            t0 = time.monotonic()
+            if t0 >= stop_at:
+                break
+
+            try:
+                ok = operation(session)
+            except requests.RequestException:
+                ok = False
+
+            t1 = time.monotonic()
+
+            if t0 >= measure_from:
+                if ok:
+                    local_latencies.append(t1 - t0)
+                else:
+                    local_failures += 1
+
+        with lock:
+            latencies.extend(local_latencies)
+            failures[0] += local_failures
+
+    threads = [threading.Thread(target=worker) for _ in range(args.concurrency)]
+    for t in threads:
+        t.start()
+    for t in threads:
+        t.join()
+
+    return latencies, failures[0], args.duration
+
+def summarize(latencies, failures, elapsed):
+    return {
+        'operations_per_second': len(latencies) / elapsed,
+        'operations': len(latencies),
+        'failures': failures,
+        'latency_in_milliseconds': {
+            'p50': percentile(latencies, 0.5) * 1000,
+            'p90': percentile(latencies, 0.9) * 1000,
+            'p99': percentile(latencies, 0.99) * 1000,
+            'max': percentile(latencies, 1.0) * 1000
+        }
+    }
+
+def main():
+    parser = argparse.ArgumentParser(description='Benchmarks the authentication paths of the iRODS HTTP API server.')
+    parser.add_argument('--url', default='http://localhost:9000/irods-http-api/0.5.0',
+                        help='The base URL of the server, including the version.')
+    parser.add_argument('--provider-url', help='The URL of the OpenID Provider (e.g. http://localhost:8080/realms/irods).')
+    parser.add_argument('--client-id', default='irods_http_api')
+    parser.add_argument('--username', default='alice')
+    parser.add_argument('--password', default='apass')
+    parser.add_argument('--modes', default=','.join(all_modes), help='A comma-separated list of modes to run.')
+    parser.add_argument('--duration', type=float, default=10, help='The number of seconds to measure each mode for.')
+    parser.add_argument('--warmup', type=float, default=2, help='The number of seconds to run before measuring.')
+    parser.add_argument('--concurrency', type=int, default=8, help='The number of concurrent clients.')
+    parser.add_argument('--timeout', type=float, default=30, help='The timeout of each request in seconds.')
+    parser.add_argument('--output', help='Writes the results to this file as JSON.')
+    parser.add_argument('--compare', help='A file written via --output by a previous run.')
+    parser.add_argument('--max-regression', type=float, default=10,
+                        help='The drop in throughput, in percent, which is reported as a regression.')
+    args = parser.parse_args()
+
+    modes = [m.strip() for m in args.modes.split(',') if m.strip()]
+    for m in modes:
+        if m not in all_modes:
+            parser.error(f'Unknown mode [{m}]. Choose from: {", ".join(all_modes)}.')
+
+    results = {'concurrency': args.concurrency, 'modes': {}}
+
+    url = args.url.rstrip('/')
+    latencies, failures, elapsed = run(args, lambda s: s.get(f'{url}/info', timeout=args.timeout).status_code == 200)
+    results['baseline'] = summarize(latencies, failures, elapsed)
+    baseline_p50 = results['baseline']['latency_in_milliseconds']['p50']
+
+    print(f'baseline (GET /info): {results["baseline"]["operations_per_second"]:.1f} ops/s, p50 {baseline_p50:.2f} ms')
+
+    for mode in modes:
+        try:
+            operation = make_operation(args, mode)
+
+            # Make sure the mode works before measuring it.
+            if not operation(requests.Session()):
+                raise benchmark_error('The server rejected the operation. Check the server configuration.')
+        except (benchmark_error, requests.RequestException) as e:
+            print(f'{mode}: skipped: {e}')
+            results['modes'][mode] = {'error': str(e)}
+            continue
+
+        stats_before = provider_stats(args)
+        latencies, failures, elapsed = run(args, operation)
+        stats_after = provider_stats(args)
+
+        r = summarize(latencies, failures, elapsed)
+        r['added_latency_in_milliseconds'] = r['latency_in_milliseconds']['p50'] - baseline_p50
+
+        if stats_before is not None and stats_after is not None:
+            # Includes the calls made during the warmup.
+            r['provider_calls'] = {k: stats_after[k] - stats_before.get(k, 0) for k in stats_after}
+
+        results['modes'][mode] = r
+
+        lat = r['latency_in_milliseconds']
+        print(f'{mode}: {r["operations_per_second"]:.1f} ops/s, p50 {lat["p50"]:.2f} ms, p99 {lat["p99"]:.2f} ms, '
+              f'added {r["added_latency_in_milliseconds"]:.2f} ms, failures {r["failures"]}')
+
+        if 'provider_calls' in r:
+            calls = ', '.join(f'{k}={v}' for k, v in r['provider_calls'].items() if v > 0)
+            print(f'    provider calls: {calls or "none"}')
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump(results, f, indent=4)
+
+    exit_code = 0
+
+    if args.compare:
+        with open(args.compare, 'r') as f:
+            previous = json.load(f)
+
+        for mode, r in results['modes'].items():
+            before = previous.get('modes', {}).get(mode, {}).get('operations_per_second')
+            if before is None or 'operations_per_second' not in r or before == 0:
+                continue
+
+            change = (r['operations_per_second'] - before) / before * 100
+            print(f'{mode}: {change:+.1f}% operations per second compared to [{args.compare}].')
+
+            if change < -args.max_regression:
+                print(f'{mode}: regression exceeds {args.max_regression}%.')
+                exit_code = 1
+
+    return exit_code
+
+if __name__ == '__main__':
+    sys.exit(main())
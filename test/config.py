@@ -25,7 +25,28 @@ test_config = {
     'irods_zone': 'tempZone',
     'irods_server_hostname': 'localhost',
 
-    'run_genquery2_tests': True
+    'run_genquery2_tests': True,
+
+    # The optional features enabled in the configuration of the server under test. The tests of
+    # each feature verify the server reports it in the same state and exercise it if enabled.
+    'server_features': {
+        'allocation_accounting': False,
+        'circuit_breaker': False,
+        'concurrency_limiter': False,
+        'lock_instrumentation': False,
+
+        # Requires low limits (e.g. 10 requests per second per user). Requests made by other
+        # tests may be rejected while the limits are in effect, so run test_metrics_endpoint on
+        # its own when this is enabled.
+        'rate_limits': False,
+
+        # Requires the "file" exporter. The tests read the traces from trace_file_path, so the
+        # server must run on the same host as the tests.
+        'tracing': False
+    },
+
+    # The file the server exports traces to (i.e. http_server.tracing.exporter.path).
+    'trace_file_path': '/tmp/irods_http_api_traces.jsonl'
 }
 
 schema = {
@@ -65,6 +86,40 @@ schema = {
         },
         'run_genquery2_tests': {
             'type': 'boolean'
+        },
+        'server_features': {
+            'type': 'object',
+            'properties': {
+                'allocation_accounting': {
+                    'type': 'boolean'
+                },
+                'circuit_breaker': {
+                    'type': 'boolean'
+                },
+                'concurrency_limiter': {
+                    'type': 'boolean'
+                },
+                'lock_instrumentation': {
+                    'type': 'boolean'
+                },
+                'rate_limits': {
+                    'type': 'boolean'
+                },
+                'tracing': {
+                    'type': 'boolean'
+                }
+            },
+            'required': [
+                'allocation_accounting',
+                'circuit_breaker',
+                'concurrency_limiter',
+                'lock_instrumentation',
+                'rate_limits',
+                'tracing'
+            ]
+        },
+        'trace_file_path': {
+            'type': 'string'
         }
     },
     'required': [
@@ -76,7 +131,9 @@ schema = {
         'rodsuser',
         'irods_zone',
         'irods_server_hostname',
-        'run_genquery2_tests'
+        'run_genquery2_tests',
+        'server_features',
+        'trace_file_path'
     ],
     'definitions': {
         'login': {
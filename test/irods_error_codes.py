@@ -10,5 +10,7 @@ NOT_A_DATA_OBJECT               = -171000
 OBJ_PATH_DOES_NOT_EXIST         = -358000
 OVERWRITE_WITHOUT_FORCE_FLAG    = -312000
 SYS_INVALID_INPUT_PARAM         = -130000
+SYS_NOT_SUPPORTED               = -169000
 SYS_NO_API_PRIV                 = -13000
 SYS_RESC_DOES_NOT_EXIST         = -78000
+USER_CHKSUM_MISMATCH            = -314000
@@ -0,0 +1,377 @@
+'''A local OpenID Provider for benchmarking and load testing the authentication paths of the
+iRODS HTTP API server without a real identity provider.
+
+The provider implements the endpoints used by the server:
+
+    <realm>/.well-known/openid-configuration    Discovery
+    <realm>/protocol/openid-connect/certs        JWKS
+    <realm>/protocol/openid-connect/auth         Authorization (approves every request)
+    <realm>/protocol/openid-connect/token        Token (password, authorization_code and
+                                                 client_credentials grants)
+    <realm>/protocol/openid-connect/token/introspect
+                                                 Token introspection
+
+Tokens are signed with RS256 by default, like most OpenID Providers. An RSA key is generated
+at startup and its public part is served from the JWKS endpoint, so the server exercises
+fetching the JWKS and verifying signatures with a public key. Passing --signing-algorithm
+HS256 signs tokens with the client secret instead, which is what the server uses to validate
+symmetric tokens when access_token_secret and nonstandard_id_token_secret are not configured.
+The JWKS is empty in that case.
+
+RS256 requires the cryptography package (see requirements.txt).
+
+Access tokens are JWTs by default. The token endpoint accepts a non-standard "token_format"
+parameter. Passing "opaque" returns an access token which is not a JWT, forcing the server to
+validate it via the introspection endpoint.
+
+Each endpoint can be slowed down to simulate a remote provider (see --latency-ms and the
+per-endpoint options). The number of calls to each endpoint is available from /stats, and
+can be reset via a POST to the same path.
+
+Tokens carry an "irods_username" claim (see --irods-user-claim) so that the server can be
+configured with the user_claim mapping plugin. Example server configuration:
+
+    "openid_connect": {
+        "provider_url": "http://localhost:8080/realms/irods",
+        "client_id": "irods_http_api",
+        "client_secret": "mock-secret",
+        "mode": "protected_resource",
+        ...
+        "user_mapping": {
+            "plugin_path": "/usr/lib/irods_http_api/user_mapping/libirods_http_api_plugin-user_claim.so",
+            "configuration": {"irods_user_claim": "irods_username"}
+        }
+    }
+
+Example:
+
+    python3 mock_oidc_provider.py --port 8080 --user alice:apass --latency-ms 5
+'''
+
+import argparse
+import base64
+import hashlib
+import hmac
+import http.server
+import json
+import random
+import secrets
+import sys
+import threading
+import time
+import urllib.parse
+
+from cryptography.exceptions import InvalidSignature
+from cryptography.hazmat.primitives import hashes
+from cryptography.hazmat.primitives.asymmetric import padding, rsa
+
+def base64url(data):
+    return base64.urlsafe_b64encode(data).rstrip(b'=').decode()
+
+def base64url_decode(data):
+    return base64.urlsafe_b64decode(data + '=' * (-len(data) % 4))
+
+def base64url_uint(value):
+    return base64url(value.to_bytes((value.bit_length() + 7) // 8, 'big'))
+
+class hs256_signer:
+    '''Signs tokens with the client secret.'''
+
+    alg = 'HS256'
+    kid = None
+
+    def __init__(self, secret):
+        self.key = secret.encode()
+
+    def sign(self, data):
+        return hmac.new(self.key, data, hashlib.sha256).digest()
+
+    def verify(self, data, signature):
+        return hmac.compare_digest(self.sign(data), signature)
+
+    def jwks(self):
+        return []
+
+class rs256_signer:
+    '''Signs tokens with an RSA key generated at startup.'''
+
+    alg = 'RS256'
+
+    def __init__(self, key_size):
+        self.private_key = rsa.generate_private_key(public_exponent=65537, key_size=key_size)
+        self.public_key = self.private_key.public_key()
+        self.kid = secrets.token_hex(8)
+
+    def sign(self, data):
+        return self.private_key.sign(data, padding.PKCS1v15(), hashes.SHA256())
+
+    def verify(self, data, signature):
+        try:
+            self.public_key.verify(signature, data, padding.PKCS1v15(), hashes.SHA256())
+            return True
+        except InvalidSignature:
+            return False
+
+    def jwks(self):
+        numbers = self.public_key.public_numbers()
+        return [{
+            'kty': 'RSA',
+            'use': 'sig',
+            'alg': self.alg,
+            'kid': self.kid,
+            'n': base64url_uint(numbers.n),
+            'e': base64url_uint(numbers.e)
+        }]
+
+def encode_jwt(claims, signer, typ):
+    header = {'alg': signer.alg, 'typ': typ}
+    if signer.kid is not None:
+        header['kid'] = signer.kid
+    signing_input = base64url(json.dumps(header).encode()) + '.' + base64url(json.dumps(claims).encode())
+    return signing_input + '.' + base64url(signer.sign(signing_input.encode()))
+
+class provider:
+    '''The state shared by all request handlers.'''
+
+    def __init__(self, args):
+        self.issuer = f'http://{args.public_host or args.host}:{args.port}{args.realm}'
+        self.realm = args.realm
+        self.client_id = args.client_id
+        self.client_secret = args.client_secret
+        self.token_lifetime = args.token_lifetime
+        self.irods_user_claim = args.irods_user_claim
+        self.jitter = args.jitter_ms / 1000
+
+        if args.signing_algorithm == 'RS256':
+            self.signer = rs256_signer(args.rsa_key_size)
+        else:
+            self.signer = hs256_signer(args.client_secret)
+
+        self.users = {}
+        for user in args.user or ['alice:apass']:
+            name, password, *irods_user = user.split(':')
+            self.users[name] = {'password': password, 'irods_user': irods_user[0] if irods_user else name}
+
+        def latency(value):
+            return (args.latency_ms if value is None else value) / 1000
+
+        self.latencies = {
+            'discovery': latency(args.discovery_latency_ms),
+            'jwks': latency(args.jwks_latency_ms),
+            'auth': latency(args.auth_latency_ms),
+            'token': latency(args.token_latency_ms),
+            'introspection': latency(args.introspection_latency_ms)
+        }
+
+        self.mtx = threading.Lock()
+        self.calls = {name: 0 for name in self.latencies}
+        self.codes = {}
+        self.opaque_tokens = {}
+
+    def delay(self, endpoint):
+        with self.mtx:
+            self.calls[endpoint] += 1
+
+        d = self.latencies[endpoint] + random.uniform(0, self.jitter)
+        if d > 0:
+            time.sleep(d)
+
+    def claims_for(self, username):
+        now = int(time.time())
+        return {
+            'iss': self.issuer,
+            'aud': self.client_id,
+            'azp': self.client_id,
+            'sub': f'sub-{username}',
+            'preferred_username': username,
+            'email': f'{username}@example.org',
+            self.irods_user_claim: self.users[username]['irods_user'],
+            'iat': now,
+            'nbf': now,
+            'exp': now + self.token_lifetime
+        }
+
+    def issue_tokens(self, username, token_format):
+        claims = self.claims_for(username)
+
+        if token_format == 'opaque':
+            access_token = secrets.token_urlsafe(32)
+            with self.mtx:
+                self.opaque_tokens[access_token] = claims
+        else:
+            access_token = encode_jwt(dict(claims, jti=secrets.token_hex(8), scope='openid'), self.signer, 'at+jwt')
+
+        return {
+            'access_token': access_token,
+            'id_token': encode_jwt(claims, self.signer, 'JWT'),
+            'token_type': 'Bearer',
+            'expires_in': self.token_lifetime,
+            'scope': 'openid'
+        }
+
+    def introspect(self, token):
+        with self.mtx:
+            claims = self.opaque_tokens.get(token)
+
+        if claims is None:
+            # Accept the JWTs issued by this provider as well.
+            try:
+                signing_input, signature = token.rsplit('.', 1)
+                if not self.signer.verify(signing_input.encode(), base64url_decode(signature)):
+                    return {'active': False}
+                claims = json.loads(base64url_decode(signing_input.split('.', 1)[1]))
+            except (ValueError, json.JSONDecodeError):
+                return {'active': False}
+
+        if claims['exp'] <= time.time():
+            return {'active': False}
+
+        return dict(claims, active=True, client_id=self.client_id, token_type='Bearer')
+
+class request_handler(http.server.BaseHTTPRequestHandler):
+    protocol_version = 'HTTP/1.1'
+
+    def log_message(self, format, *args):
+        if self.server.verbose:
+            super().log_message(format, *args)
+
+    def send_json(self, body, status=200):
+        data = json.dumps(body).encode()
+        self.send_response(status)
+        self.send_header('Content-Type', 'application/json')
+        self.send_header('Content-Length', str(len(data)))
+        self.end_headers()
+        self.wfile.write(data)
+
+    def read_form(self):
+        length = int(self.headers.get('Content-Length', 0))
+        body = self.rfile.read(length).decode()
+        return {k: v[0] for k, v in urllib.parse.parse_qs(body).items()}
+
+    def do_GET(self):
+        p = self.server.provider
+        url = urllib.parse.urlsplit(self.path)
+
+        if url.path == f'{p.realm}/.well-known/openid-configuration':
+            p.delay('discovery')
+            return self.send_json({
+                'issuer': p.issuer,
+                'authorization_endpoint': f'{p.issuer}/protocol/openid-connect/auth',
+                'token_endpoint': f'{p.issuer}/protocol/openid-connect/token',
+                'introspection_endpoint': f'{p.issuer}/protocol/openid-connect/token/introspect',
+                'jwks_uri': f'{p.issuer}/protocol/openid-connect/certs',
+                'grant_types_supported': ['authorization_code', 'password', 'client_credentials'],
+                'response_types_supported': ['code'],
+                'id_token_signing_alg_values_supported': [p.signer.alg]
+            })
+
+        if url.path == f'{p.realm}/protocol/openid-connect/certs':
+            p.delay('jwks')
+            return self.send_json({'keys': p.signer.jwks()})
+
+        if url.path == f'{p.realm}/protocol/openid-connect/auth':
+            p.delay('auth')
+            query = {k: v[0] for k, v in urllib.parse.parse_qs(url.query).items()}
+
+            # Every request is approved. The user can be chosen via login_hint.
+            username = query.get('login_hint', next(iter(p.users)))
+            if username not in p.users or 'redirect_uri' not in query:
+                return self.send_json({'error': 'invalid_request'}, 400)
+
+            code = secrets.token_urlsafe(16)
+            with p.mtx:
+                p.codes[code] = username
+
+            params = urllib.parse.urlencode({'code': code, 'state': query.get('state', '')})
+            self.send_response(302)
+            self.send_header('Location', f'{query["redirect_uri"]}?{params}')
+            self.send_header('Content-Length', '0')
+            self.end_headers()
+            return
+
+        if url.path == '/stats':
+            with p.mtx:
+                return self.send_json(dict(p.calls))
+
+        self.send_json({'error': 'not_found'}, 404)
+
+    def do_POST(self):
+        p = self.server.provider
+        path = urllib.parse.urlsplit(self.path).path
+        form = self.read_form()
+
+        if path == f'{p.realm}/protocol/openid-connect/token':
+            p.delay('token')
+            grant_type = form.get('grant_type')
+
+            if grant_type == 'password':
+                username = form.get('username')
+                user = p.users.get(username)
+                if user is None or user['password'] != form.get('password'):
+                    return self.send_json({'error': 'invalid_grant', 'error_description': 'Invalid credentials'}, 401)
+            elif grant_type == 'authorization_code':
+                with p.mtx:
+                    username = p.codes.pop(form.get('code'), None)
+                if username is None:
+                    return self.send_json({'error': 'invalid_grant', 'error_description': 'Invalid code'}, 400)
+            elif grant_type == 'client_credentials':
+                username = form.get('username', next(iter(p.users)))
+                if username not in p.users:
+                    return self.send_json({'error': 'invalid_request'}, 400)
+            else:
+                return self.send_json({'error': 'unsupported_grant_type'}, 400)
+
+            return self.send_json(p.issue_tokens(username, form.get('token_format', 'jwt')))
+
+        if path == f'{p.realm}/protocol/openid-connect/token/introspect':
+            p.delay('introspection')
+            return self.send_json(p.introspect(form.get('token', '')))
+
+        if path == '/stats':
+            with p.mtx:
+                p.calls = {name: 0 for name in p.calls}
+            return self.send_json({})
+
+        self.send_json({'error': 'not_found'}, 404)
+
+def main():
+    parser = argparse.ArgumentParser(description='A local OpenID Provider for benchmarking the iRODS HTTP API.')
+    parser.add_argument('--host', default='localhost', help='The address to listen on.')
+    parser.add_argument('--port', type=int, default=8080, help='The port to listen on.')
+    parser.add_argument('--public-host', help='The host used in the issuer and endpoint URLs. Defaults to --host.')
+    parser.add_argument('--realm', default='/realms/irods', help='The path of the provider.')
+    parser.add_argument('--client-id', default='irods_http_api')
+    parser.add_argument('--client-secret', default='mock-secret',
+                        help='Also the key used to sign tokens when --signing-algorithm is HS256.')
+    parser.add_argument('--signing-algorithm', choices=['RS256', 'HS256'], default='RS256',
+                        help='The algorithm used to sign tokens.')
+    parser.add_argument('--rsa-key-size', type=int, default=2048, help='The size of the RSA key in bits.')
+    parser.add_argument('--user', action='append',
+                        help='A user in the form name:password[:irods_user]. Can be repeated. Defaults to alice:apass.')
+    parser.add_argument('--irods-user-claim', default='irods_username',
+                        help='The claim which holds the name of the iRODS user.')
+    parser.add_argument('--token-lifetime', type=int, default=3600, help='The lifetime of tokens in seconds.')
+    parser.add_argument('--latency-ms', type=float, default=0, help='The latency added to every endpoint.')
+    parser.add_argument('--jitter-ms', type=float, default=0, help='A random latency of up to this much is added.')
+    for endpoint in ['discovery', 'jwks', 'auth', 'token', 'introspection']:
+        parser.add_argument(f'--{endpoint}-latency-ms', type=float,
+                            help=f'The latency added to the {endpoint} endpoint. Defaults to --latency-ms.')
+    parser.add_argument('--verbose', action='store_true', help='Log every request.')
+    args = parser.parse_args()
+
+    server = http.server.ThreadingHTTPServer((args.host, args.port), request_handler)
+    server.daemon_threads = True
+    server.provider = provider(args)
+    server.verbose = args.verbose
+
+    print(f'Mock OpenID Provider listening on {args.host}:{args.port} with issuer {server.provider.issuer}', flush=True)
+
+    try:
+        server.serve_forever()
+    except KeyboardInterrupt:
+        pass
+
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
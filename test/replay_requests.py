@@ -0,0 +1,223 @@
+'''Replays requests captured by the iRODS HTTP API server against a server.
+
+Requests are captured when http_server.request_capture.enabled is true. Each line of the
+capture file is a JSON object. Lines holding a "capture" property start a new segment (i.e. a
+run of the server) and the times of the requests which follow are relative to the start of
+that segment. Segments are replayed one after the other.
+
+Requests are issued at the times recorded in the capture, divided by the speed. A speed of 2
+replays the capture twice as fast and a speed of 0 issues requests as fast as the workers
+allow. Requests are always started in the order they were captured.
+
+Credentials are never captured. Bearer tokens are replaced with the token passed via
+--bearer-token, or with one obtained by authenticating as --username. Basic credentials (i.e.
+requests to /authenticate) are replaced with --username and --password. Values which were
+replaced by their size in the capture are sent as the same number of filler bytes.
+
+Example:
+
+    python3 replay_requests.py /tmp/irods_http_api_requests.jsonl \\
+        --url http://localhost:9000 --username alice --password apass --speed 2
+'''
+
+import argparse
+import base64
+import concurrent.futures
+import json
+import sys
+import threading
+import time
+
+import requests
+
+def load_capture(path):
+    '''Returns the captured requests, ordered by the time they are to be issued.
+
+    The times of each segment are offset so that it starts once the previous segment ends.
+    '''
+    records = []
+    offset = 0
+    end_of_segment = 0
+
+    with open(path, 'r') as f:
+        for line in f:
+            line = line.strip()
+            if not line:
+                continue
+
+            record = json.loads(line)
+
+            if 'capture' in record:
+                offset = end_of_segment
+                continue
+
+            record['t'] += offset
+            end_of_segment = max(end_of_segment, record['t'])
+            records.append(record)
+
+    records.sort(key=lambda r: r['t'])
+    return records
+
+def to_value(value):
+    '''Returns the value of a body, form field or query parameter.'''
+    if isinstance(value, dict):
+        return b'x' * value['size']
+    return value
+
+class replayer:
+    def __init__(self, args):
+        self.url = args.url.rstrip('/')
+        self.timeout = args.timeout
+        self.bearer_token = args.bearer_token
+        self.credentials = None
+        self.local = threading.local()
+
+        if args.username is not None:
+            self.credentials = base64.b64encode(f'{args.username}:{args.password}'.encode()).decode()
+
+    def session(self):
+        if not hasattr(self.local, 'session'):
+            self.local.session = requests.Session()
+        return self.local.session
+
+    def authenticate(self, records):
+        '''Obtains a bearer token using the basic credentials, if necessary.'''
+        if self.bearer_token is not None or self.credentials is None:
+            return
+
+        # Use the path of a captured request to /authenticate so that the base URL matches.
+        paths = [r['path'] for r in records if r['path'].endswith('/authenticate')]
+        if not paths:
+            base = records[0]['path'].rsplit('/', 1)[0]
+            paths = [f'{base}/authenticate']
+
+        r = requests.post(self.url + paths[0], headers={'Authorization': f'Basic {self.credentials}'})
+        r.raise_for_status()
+        self.bearer_token = r.text
+
+    def headers_for(self, record):
+        headers = {}
+
+        for name, value in record['headers'].items():
+            if name.lower() == 'content-type' and 'form' in record:
+                # Set by requests along with the multipart boundary.
+                continue
+
+            if name.lower() == 'authorization':
+                scheme = value.split(' ', 1)[0]
+
+                if scheme.lower() == 'bearer':
+                    if self.bearer_token is None:
+                        continue
+                    value = f'Bearer {self.bearer_token}'
+                elif self.credentials is not None:
+                    value = f'{scheme} {self.credentials}'
+                else:
+                    continue
+
+            headers[name] = value
+
+        return headers
+
+    def send(self, record):
+        '''Issues a request and returns its HTTP status code and latency in seconds.'''
+        kwargs = {
+            'headers': self.headers_for(record),
+            'params': {k: to_value(v) for k, v in record['query'].items()},
+            'timeout': self.timeout
+        }
+
+        if 'form' in record:
+            form = {k: to_value(v) for k, v in record['form'].items()}
+
+            content_type = next((v for k, v in record['headers'].items() if k.lower() == 'content-type'), '')
+
+            if content_type.startswith('multipart/form-data'):
+                kwargs['files'] = {k: (None, v) for k, v in form.items()}
+            else:
+                kwargs['data'] = form
+        elif 'body' in record:
+            body = to_value(record['body'])
+            kwargs['data'] = body.encode() if isinstance(body, str) else body
+
+        start = time.monotonic()
+
+        try:
+            r = self.session().request(record['method'], self.url + record['path'], **kwargs)
+            status = r.status_code
+        except requests.RequestException as e:
+            status = type(e).__name__
+
+        return status, time.monotonic() - start
+
+def percentile(values, p):
+    if not values:
+        return 0
+    values = sorted(values)
+    return values[min(len(values) - 1, int(len(values) * p))]
+
+def main():
+    parser = argparse.ArgumentParser(description='Replays requests captured by the iRODS HTTP API server.')
+    parser.add_argument('capture_file', help='The file written by http_server.request_capture.')
+    parser.add_argument('--url', default='http://localhost:9000', help='The scheme, host and port of the server.')
+    parser.add_argument('--speed', type=float, default=1.0,
+                        help='The multiple of the original speed to replay at. 0 replays as fast as possible.')
+    parser.add_argument('--bearer-token', help='The bearer token sent in place of the captured tokens.')
+    parser.add_argument('--username', help='The user to authenticate as, if --bearer-token is not given.')
+    parser.add_argument('--password', default='', help='The password of --username.')
+    parser.add_argument('--max-workers', type=int, default=64, help='The maximum number of concurrent requests.')
+    parser.add_argument('--timeout', type=float, default=60, help='The timeout of each request in seconds.')
+    args = parser.parse_args()
+
+    if args.speed < 0:
+        parser.error('--speed must not be negative.')
+
+    records = load_capture(args.capture_file)
+    if not records:
+        print('The capture file holds no requests.')
+        return 0
+
+    r = replayer(args)
+    r.authenticate(records)
+
+    results = []
+    lags = []
+
+    with concurrent.futures.ThreadPoolExecutor(max_workers=args.max_workers) as executor:
+        started_at = time.monotonic()
+
+        for record in records:
+            if args.speed > 0:
+                due = started_at + record['t'] / 1e6 / args.speed
+                delay = due - time.monotonic()
+
+                if delay > 0:
+                    time.sleep(delay)
+                else:
+                    lags.append(-delay)
+
+            results.append(executor.submit(r.send, record))
+
+        results = [f.result() for f in results]
+        elapsed = time.monotonic() - started_at
+
+    status_counts = {}
+    for status, _ in results:
+        status_counts[status] = status_counts.get(status, 0) + 1
+
+    latencies = [latency for _, latency in results]
+
+    print(f'Replayed {len(results)} requests in {elapsed:.3f} seconds ({len(results) / elapsed:.1f} requests/second).')
+    print('Status codes:')
+    for status, count in sorted(status_counts.items(), key=lambda i: str(i[0])):
+        print(f'    {status}: {count}')
+    print('Latency (milliseconds):')
+    for label, p in [('p50', 0.5), ('p90', 0.9), ('p99', 0.99), ('max', 1.0)]:
+        print(f'    {label}: {percentile(latencies, p) * 1000:.1f}')
+    if lags:
+        print(f'Requests started late: {len(lags)} (max lag: {max(lags) * 1000:.1f} milliseconds)')
+
+    return 0
+
+if __name__ == '__main__':
+    sys.exit(main())
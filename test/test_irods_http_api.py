@@ -5,14 +5,18 @@ import base64
 import concurrent.futures
 import hashlib
 import http.client
+import io
 import json
 import logging
 import os
 import requests
 import socket
 import sys
+import tarfile
 import time
 import unittest
+import urllib.parse
+import zipfile
 
 def setup_class(cls, opts):
     '''Initializes shared state needed by all test cases.
@@ -159,6 +163,128 @@ def do_test_server_reports_error_when_op_is_not_supported(cls, test_http_post_me
         logging.debug(r.content)
         cls.assertEqual(r.status_code, 400)
 
+class test_admin_endpoint(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        setup_class(cls, {'endpoint_name': 'admin'})
+
+    @classmethod
+    def tearDownClass(cls):
+        tear_down_class(cls)
+
+    def setUp(self):
+        self.assertFalse(self._class_init_error, 'Class initialization failed. Cannot continue.')
+
+    def test_cpu_profile_is_captured_for_rodsadmins_only(self):
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsuser_bearer_token}, params={'op': 'profile', 'seconds': 1})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 403)
+
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}, params={'op': 'profile', 'seconds': 1, 'frequency': 500})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+
+        result = r.json()
+        self.assertEqual(result['irods_response']['status_code'], 0)
+        self.assertGreaterEqual(result['cpu']['duration_in_milliseconds'], 1000)
+        self.assertEqual(result['cpu']['frequency'], 500)
+
+        # Each line of the folded stacks ends with the number of samples for that stack.
+        total = 0
+        for line in result['cpu']['folded_stacks'].splitlines():
+            total += int(line.rsplit(' ', 1)[1])
+        self.assertLessEqual(total, result['cpu']['samples'])
+
+        self.assertGreater(result['heap']['resident_bytes'], 0)
+
+        # Out of range values are rejected.
+        for params in [{'seconds': 0}, {'seconds': 61}, {'frequency': 1001}, {'frequency': 'abc'}]:
+            with self.subTest(params=params):
+                r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}, params={'op': 'profile', **params})
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 400)
+
+    def test_slow_requests_are_reported_to_rodsadmins_only(self):
+        # Only rodsadmins are allowed to see the requests of other users.
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsuser_bearer_token}, params={'op': 'slow_requests'})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 403)
+
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}, params={'op': 'slow_requests'})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+
+        result = r.json()
+        self.assertEqual(result['irods_response']['status_code'], 0)
+        self.assertIn('enabled', result)
+
+        # Requests are ordered from slowest to fastest and carry a breakdown of their phases.
+        durations = [e['duration_in_microseconds'] for e in result['requests']]
+        self.assertEqual(durations, sorted(durations, reverse=True))
+
+        for e in result['requests']:
+            self.assertIn('endpoint', e)
+            self.assertIn('op', e)
+            self.assertIn('username', e)
+            for phase in ['queue_wait', 'connection_checkout', 'switch_user', 'irods', 'write']:
+                self.assertIn(phase, e['phases_in_microseconds'])
+
+    def test_rate_limit_rejections_are_reported_to_rodsadmins_only(self):
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsuser_bearer_token}, params={'op': 'rate_limits'})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 403)
+
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}, params={'op': 'rate_limits'})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+
+        result = r.json()
+        self.assertEqual(result['irods_response']['status_code'], 0)
+        self.assertIn('enabled', result)
+        self.assertEqual(result['number_of_rejected_requests'], sum(result['number_of_rejected_requests_per_user'].values()))
+
+    def test_runtime_state_is_reported_to_rodsadmins_only(self):
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsuser_bearer_token}, params={'op': 'introspect'})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 403)
+
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}, params={'op': 'introspect', 'session-limit': 1})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+
+        result = r.json()
+        self.assertEqual(result['irods_response']['status_code'], 0)
+
+        # Once the client is known to be a rodsadmin, requests are served without the background
+        # thread pool. Therefore, this request may or may not be counted.
+        self.assertGreaterEqual(result['background_tasks']['threads'], 1)
+        for key in ['queued', 'running']:
+            self.assertIn(key, result['background_tasks'])
+
+        for key in ['size', 'in_use', 'waiters']:
+            self.assertIn(key, result['connection_pool'])
+
+        # The memory budget is reported using the same names as the /metrics endpoint.
+        for key in ['max_size_in_bytes', 'size_in_bytes', 'number_of_paused_reads']:
+            self.assertIn(key, result['memory_budget'])
+
+        # The session serving this request is processing it.
+        self.assertGreaterEqual(result['sessions']['by_state']['processing'], 1)
+        self.assertLessEqual(len(result['sessions']['list']), 1)
+
+        self.assertIsInstance(result['parallel_write_handles'], list)
+        self.assertIsInstance(result['process_stash'], dict)
+        self.assertIn('jwks_loaded', result['openid'])
+
+        # Invalid session limits are rejected.
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}, params={'op': 'introspect', 'session-limit': 'abc'})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 400)
+
+    def test_server_reports_error_when_http_method_is_not_supported(self):
+        do_test_server_reports_error_when_http_method_is_not_supported(self)
+
 class test_authenticate_endpoint(unittest.TestCase):
 
     @classmethod
@@ -716,6 +842,296 @@ class test_collections_endpoint(unittest.TestCase):
         self.assertEqual(result['irods_response']['status_code'], 0)
         self.assertEqual(result['inheritance_enabled'], False)
 
+    def test_uploading_a_tar_archive_into_a_collection(self):
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        collection = f'/{self.zone_name}/home/{self.rodsuser_username}/test_uploading_a_tar_archive'
+
+        # Create the collection the archive will be extracted into.
+        r = requests.post(self.url_endpoint, headers=headers, data={'op': 'create', 'lpath': collection})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+        try:
+            # Build a tar archive containing nested directories and files.
+            files = {
+                'a.txt': b'contents of a',
+                'dir/b.txt': b'contents of b',
+                'dir/nested/c.txt': b'contents of c' * 1000
+            }
+
+            buffer = io.BytesIO()
+            with tarfile.open(fileobj=buffer, mode='w') as tar:
+                info = tarfile.TarInfo('dir/empty')
+                info.type = tarfile.DIRTYPE
+                tar.addfile(info)
+
+                info = tarfile.TarInfo('link')
+                info.type = tarfile.SYMTYPE
+                info.linkname = 'a.txt'
+                tar.addfile(info)
+
+                for name, contents in files.items():
+                    info = tarfile.TarInfo(name)
+                    info.size = len(contents)
+                    tar.addfile(info, io.BytesIO(contents))
+
+            # Upload the archive.
+            r = requests.post(self.url_endpoint,
+                              headers={**headers, 'Content-Type': 'application/x-tar'},
+                              params={'op': 'upload_archive', 'lpath': collection, 'verify-checksums': 1},
+                              data=buffer.getvalue())
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            result = r.json()
+            self.assertEqual(result['irods_response']['status_code'], 0)
+            self.assertEqual(result['number_of_entries'], 5)
+            self.assertEqual(result['number_of_data_objects_written'], len(files))
+
+            # Show the symbolic link was reported as a failure.
+            self.assertEqual(len(result['failed_entries']), 1)
+            self.assertEqual(result['failed_entries'][0]['path'], 'link')
+            self.assertEqual(result['failed_entries'][0]['irods_response']['status_code'], irods_error_codes.SYS_NOT_SUPPORTED)
+
+            # Show the empty directory was created as a collection.
+            r = requests.get(self.url_endpoint, headers=headers, params={'op': 'stat', 'lpath': f'{collection}/dir/empty'})
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            # Show the data objects contain the bytes from the archive.
+            for name, contents in files.items():
+                r = requests.get(f'{self.url_base}/data-objects', headers=headers, params={
+                    'op': 'read',
+                    'lpath': f'{collection}/{name}'
+                })
+                self.assertEqual(r.status_code, 200)
+                self.assertEqual(r.content, contents)
+
+        finally:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': collection,
+                'recurse': 1,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+    def test_uploading_a_zip_archive_with_compressed_entries(self):
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        collection = f'/{self.zone_name}/home/{self.rodsuser_username}/test_uploading_a_zip_archive'
+
+        r = requests.post(self.url_endpoint, headers=headers, data={'op': 'create', 'lpath': collection})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+        try:
+            # Larger than the chunks the server decompresses entries in.
+            large = b'0123456789abcdef' * (256 * 1024)
+
+            buffer = io.BytesIO()
+            with zipfile.ZipFile(buffer, 'w', zipfile.ZIP_DEFLATED) as z:
+                z.writestr('large.txt', large)
+                z.writestr('bomb.txt', b'x' * 1024)
+            archive = bytearray(buffer.getvalue())
+
+            # Declare a decompressed size for bomb.txt which exceeds the default limit of 1 GiB. The
+            # entry must be rejected without being decompressed.
+            offset = archive.find(b'PK\x01\x02')
+            while offset >= 0:
+                name_length = int.from_bytes(archive[offset + 28:offset + 30], 'little')
+                if archive[offset + 46:offset + 46 + name_length] == b'bomb.txt':
+                    archive[offset + 24:offset + 28] = (0xfffffff0).to_bytes(4, 'little')
+                offset = archive.find(b'PK\x01\x02', offset + 4)
+
+            r = requests.post(self.url_endpoint,
+                              headers={**headers, 'Content-Type': 'application/zip'},
+                              params={'op': 'upload_archive', 'lpath': collection, 'verify-checksums': 1},
+                              data=bytes(archive))
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            result = r.json()
+            self.assertEqual(result['irods_response']['status_code'], 0)
+            self.assertEqual(result['number_of_data_objects_written'], 1)
+            self.assertEqual(len(result['failed_entries']), 1)
+            self.assertEqual(result['failed_entries'][0]['path'], 'bomb.txt')
+            self.assertEqual(result['failed_entries'][0]['irods_response']['status_code'], irods_error_codes.SYS_INVALID_INPUT_PARAM)
+
+            r = requests.get(f'{self.url_base}/data-objects', headers=headers, params={
+                'op': 'read',
+                'lpath': f'{collection}/large.txt',
+                'count': len(large)
+            })
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.content, large)
+
+        finally:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': collection,
+                'recurse': 1,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+    def test_downloading_a_collection_as_an_archive(self):
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        collection_name = 'test_downloading_a_collection_as_an_archive'
+        collection = f'/{self.zone_name}/home/{self.rodsuser_username}/{collection_name}'
+
+        files = {
+            'a.txt': b'contents of a',
+            'b.bin': b'contents of b',
+            'sub/c.txt': b'contents of c' * 1000
+        }
+
+        # Create a collection containing data objects and a subcollection.
+        for name in [collection, f'{collection}/sub']:
+            r = requests.post(self.url_endpoint, headers=headers, data={'op': 'create', 'lpath': name})
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+        try:
+            for name, contents in files.items():
+                r = requests.post(f'{self.url_base}/data-objects', headers=headers, data={
+                    'op': 'write',
+                    'lpath': f'{collection}/{name}',
+                    'bytes': contents
+                })
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 200)
+                self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            # Download the collection as a tar archive and show it contains every data object.
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'download_archive',
+                'lpath': collection
+            })
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.headers['Content-Type'], 'application/x-tar')
+
+            with tarfile.open(fileobj=io.BytesIO(r.content)) as tar:
+                self.assertTrue(tar.getmember(collection_name).isdir())
+                self.assertTrue(tar.getmember(f'{collection_name}/sub').isdir())
+
+                for name, contents in files.items():
+                    self.assertEqual(tar.extractfile(f'{collection_name}/{name}').read(), contents)
+
+            # Download the collection as a zip archive, excluding some of the data objects.
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'download_archive',
+                'lpath': collection,
+                'format': 'zip',
+                'include': '*.txt'
+            })
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.headers['Content-Type'], 'application/zip')
+
+            with zipfile.ZipFile(io.BytesIO(r.content)) as archive:
+                self.assertIsNone(archive.testzip())
+                self.assertNotIn(f'{collection_name}/b.bin', archive.namelist())
+                self.assertEqual(archive.read(f'{collection_name}/a.txt'), files['a.txt'])
+                self.assertEqual(archive.read(f'{collection_name}/sub/c.txt'), files['sub/c.txt'])
+
+        finally:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': collection,
+                'recurse': 1,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+    def test_verifying_the_checksums_of_every_replica_in_a_collection(self):
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        collection = f'/{self.zone_name}/home/{self.rodsuser_username}/test_verifying_the_checksums_of_a_collection'
+
+        r = requests.post(self.url_endpoint, headers=headers, data={
+            'op': 'create',
+            'lpath': f'{collection}/sub',
+            'create-intermediates': 1
+        })
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+        try:
+            # Create data objects. Only the first two have checksums.
+            data_objects = [f'{collection}/a.txt', f'{collection}/sub/b.txt', f'{collection}/sub/c.txt']
+
+            for i, data_object in enumerate(data_objects):
+                r = requests.post(f'{self.url_base}/data-objects', headers=headers, data={
+                    'op': 'write',
+                    'lpath': data_object,
+                    'bytes': f'contents of {data_object}'
+                })
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 200)
+                self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+                if i < 2:
+                    r = requests.post(f'{self.url_base}/data-objects', headers=headers, data={
+                        'op': 'calculate_checksum',
+                        'lpath': data_object
+                    })
+                    self.logger.debug(r.content)
+                    self.assertEqual(r.status_code, 200)
+                    self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            # Verify the collection and show only the data object without a checksum is reported.
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'verify_checksums',
+                'lpath': collection
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.headers['Content-Type'], 'application/x-ndjson')
+
+            lines = [json.loads(line) for line in r.text.splitlines()]
+            summary = lines[-1]
+            self.assertEqual(summary['irods_response']['status_code'], 0)
+            self.assertEqual(summary['replicas_verified'] + summary['replicas_skipped'], 2)
+            self.assertEqual(summary['replicas_failed'], 1)
+
+            failures = [line for line in lines if 'logical_path' in line]
+            self.assertEqual(len(failures), 1)
+            self.assertEqual(failures[0]['logical_path'], data_objects[2])
+            self.assertEqual(
+                failures[0]['irods_response']['status_code'], irods_error_codes.CHECK_VERIFICATION_RESULTS)
+
+            # Resuming from the final checkpoint verifies nothing.
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'verify_checksums',
+                'lpath': collection,
+                'resume-after': summary['checkpoint']
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+
+            summary = json.loads(r.text.splitlines()[-1])
+            self.assertEqual(summary['irods_response']['status_code'], 0)
+            self.assertEqual(summary['replicas_verified'] + summary['replicas_skipped'], 0)
+            self.assertEqual(summary['replicas_failed'], 0)
+
+        finally:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': collection,
+                'recurse': 1,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
     def test_server_reports_error_when_http_method_is_not_supported(self):
         do_test_server_reports_error_when_http_method_is_not_supported(self)
 
@@ -1246,65 +1662,214 @@ class test_data_objects_endpoint(unittest.TestCase):
             })
             self.logger.debug(r.content)
 
-    def test_calculate_checksum_operation_handles_non_existent_data_objects_gracefully(self):
-        r = requests.post(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsuser_bearer_token}, data={
-            'op': 'calculate_checksum',
-            'lpath': '/tempZone/does/not/exist.txt'
-        })
-        self.logger.debug(r.content)
-        self.assertEqual(r.status_code, 200)
-        self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.CAT_NO_ROWS_FOUND)
-
-    def test_verify_checksum_operation_handles_non_existent_data_objects_gracefully(self):
-        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsuser_bearer_token}, params={
-            'op': 'verify_checksum',
-            'lpath': '/tempZone/does/not/exist.txt'
-        })
-        self.logger.debug(r.content)
-        self.assertEqual(r.status_code, 200)
-        self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.CAT_NO_ROWS_FOUND)
+    def test_writes_can_be_acknowledged_before_reaching_irods(self):
+        # This test assumes the HTTP API is configured with a write-behind spool directory.
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        data_object = os.path.join('/', self.zone_name, 'home', self.rodsuser_username, 'write_behind.txt')
 
-    def test_registering_a_new_data_object(self):
-        rodsadmin_headers = {'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}
+        try:
+            # Spool two writes to the same data object. The second write must win.
+            for contents in ['first contents', 'second contents']:
+                r = requests.post(self.url_endpoint, headers=headers, data={
+                    'op': 'write',
+                    'lpath': data_object,
+                    'bytes': contents,
+                    'write-behind': 1
+                })
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 202)
+                self.assertEqual(r.json()['irods_response']['status_code'], 0)
+                handle = r.json()['write_behind_handle']
 
-        # The name of the physical file to create and register.
-        filename = 'newly_registered_file.txt'
-        physical_path = f'/tmp/{filename}'
+            # Wait for the last write to reach iRODS.
+            for _ in range(30):
+                r = requests.get(self.url_endpoint, headers=headers, params={
+                    'op': 'write_behind_status',
+                    'write-behind-handle': handle
+                })
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 200)
+                result = r.json()
+                self.assertEqual(result['logical_path'], data_object)
+                self.assertNotEqual(result['state'], 'failed')
 
-        # The logical path of the data object.
-        data_object = f'/{self.zone_name}/home/{self.rodsadmin_username}/{filename}'
+                if result['state'] == 'completed':
+                    break
 
-        # The name of the resource to register the replica under.
-        resource = 'demoResc'
+                time.sleep(1)
 
-        try:
-            # Create a non-empty local file.
-            content = 'data'
-            with open(physical_path, 'w') as f:
-                f.write(content)
+            self.assertEqual(result['state'], 'completed')
 
-            # Show the data object we want to create via registration does not exist.
-            r = requests.get(self.url_endpoint, headers=rodsadmin_headers, params={
-                'op': 'stat',
-                'lpath': data_object
-            })
+            r = requests.get(self.url_endpoint, headers=headers, params={'op': 'read', 'lpath': data_object})
             self.logger.debug(r.content)
             self.assertEqual(r.status_code, 200)
-            self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.NOT_A_DATA_OBJECT)
+            self.assertEqual(r.text, 'second contents')
 
-            # Register the local file into the catalog as a new data object.
-            # We know we're registering a new data object because the "as-additional-replica"
-            # parameter isn't set to 1.
-            r = requests.post(self.url_endpoint, headers=rodsadmin_headers, data={
-                'op': 'register',
+            # Show write-behind is rejected when the write depends on the current contents.
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'write',
                 'lpath': data_object,
-                'ppath': physical_path,
-                'resource': resource,
-                'data-size': len(content)
+                'bytes': 'more contents',
+                'append': 1,
+                'write-behind': 1
             })
             self.logger.debug(r.content)
-            self.assertEqual(r.status_code, 200)
-            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+            self.assertEqual(r.status_code, 400)
+
+            # Show handles cannot be used by other users.
+            r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}, params={
+                'op': 'write_behind_status',
+                'write-behind-handle': handle
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 404)
+
+            r = requests.post(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}, data={
+                'op': 'write_behind_discard',
+                'write-behind-handle': handle
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 404)
+
+            # Show only failed writes can be discarded.
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'write_behind_discard',
+                'write-behind-handle': handle
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 409)
+
+        finally:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': data_object,
+                'catalog-only': 0,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+
+    def test_verifying_checksums_after_the_data_object_is_overwritten(self):
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        data_object = os.path.join('/', self.zone_name, 'home', self.rodsuser_username, 'reverified.txt')
+
+        try:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'write',
+                'lpath': data_object,
+                'bytes': 'original contents'
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'calculate_checksum',
+                'lpath': data_object
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            # Verifying an unchanged data object repeatedly produces the same result. If the checksum
+            # cache is enabled, only the first request reads the replica.
+            for _ in range(2):
+                r = requests.get(self.url_endpoint, headers=headers, params={
+                    'op': 'verify_checksum',
+                    'lpath': data_object
+                })
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 200)
+                self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            # Overwrite the data object with bytes of the same size. This clears the checksum
+            # in the catalog, so the previous result must not be reused.
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'write',
+                'lpath': data_object,
+                'bytes': 'modified contents'
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'verify_checksum',
+                'lpath': data_object
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            result = r.json()
+            self.assertEqual(result['irods_response']['status_code'], irods_error_codes.CHECK_VERIFICATION_RESULTS)
+            self.assertEqual(result['results'][0]['error_code'], irods_error_codes.CAT_NO_CHECKSUM_FOR_REPLICA)
+
+        finally:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': data_object,
+                'catalog-only': 0,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+
+    def test_calculate_checksum_operation_handles_non_existent_data_objects_gracefully(self):
+        r = requests.post(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsuser_bearer_token}, data={
+            'op': 'calculate_checksum',
+            'lpath': '/tempZone/does/not/exist.txt'
+        })
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.CAT_NO_ROWS_FOUND)
+
+    def test_verify_checksum_operation_handles_non_existent_data_objects_gracefully(self):
+        r = requests.get(self.url_endpoint, headers={'Authorization': 'Bearer ' + self.rodsuser_bearer_token}, params={
+            'op': 'verify_checksum',
+            'lpath': '/tempZone/does/not/exist.txt'
+        })
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.CAT_NO_ROWS_FOUND)
+
+    def test_registering_a_new_data_object(self):
+        rodsadmin_headers = {'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}
+
+        # The name of the physical file to create and register.
+        filename = 'newly_registered_file.txt'
+        physical_path = f'/tmp/{filename}'
+
+        # The logical path of the data object.
+        data_object = f'/{self.zone_name}/home/{self.rodsadmin_username}/{filename}'
+
+        # The name of the resource to register the replica under.
+        resource = 'demoResc'
+
+        try:
+            # Create a non-empty local file.
+            content = 'data'
+            with open(physical_path, 'w') as f:
+                f.write(content)
+
+            # Show the data object we want to create via registration does not exist.
+            r = requests.get(self.url_endpoint, headers=rodsadmin_headers, params={
+                'op': 'stat',
+                'lpath': data_object
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.NOT_A_DATA_OBJECT)
+
+            # Register the local file into the catalog as a new data object.
+            # We know we're registering a new data object because the "as-additional-replica"
+            # parameter isn't set to 1.
+            r = requests.post(self.url_endpoint, headers=rodsadmin_headers, data={
+                'op': 'register',
+                'lpath': data_object,
+                'ppath': physical_path,
+                'resource': resource,
+                'data-size': len(content)
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
 
             # Show a new data object exists with the expected replica information.
             r = requests.get(f'{self.url_base}/query', headers=rodsadmin_headers, params={
@@ -1330,6 +1895,81 @@ class test_data_objects_endpoint(unittest.TestCase):
             })
             self.logger.debug(r.content)
 
+    def test_registering_many_data_objects_in_bulk(self):
+        rodsadmin_headers = {'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}
+
+        # The name of the resource to register the replicas under.
+        resource = 'demoResc'
+
+        # Maps the physical path of each file to the logical path of its data object.
+        filenames = [f'bulk_registered_file.{i}.txt' for i in range(10)]
+        paths = {f'/tmp/{f}': f'/{self.zone_name}/home/{self.rodsadmin_username}/{f}' for f in filenames}
+
+        try:
+            # Create non-empty local files and build the NDJSON request body.
+            content = 'data'
+            lines = []
+            for physical_path, data_object in paths.items():
+                with open(physical_path, 'w') as f:
+                    f.write(content)
+
+                lines.append(json.dumps({
+                    'lpath': data_object,
+                    'ppath': physical_path,
+                    'resource': resource,
+                    'size': len(content)
+                }))
+
+            # Include an entry which is missing required information.
+            lines.append(json.dumps({'lpath': f'/{self.zone_name}/home/{self.rodsadmin_username}/missing_ppath'}))
+
+            # Register the local files into the catalog as new data objects.
+            r = requests.post(self.url_endpoint,
+                              headers=rodsadmin_headers | {'Content-Type': 'application/x-ndjson'},
+                              params={'op': 'bulk_register'},
+                              data='\n'.join(lines).encode('utf-8'))
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+
+            # Results are not guaranteed to be returned in order.
+            results = {}
+            for line in r.text.splitlines():
+                result = json.loads(line)
+                results[result['line']] = result
+
+            self.assertEqual(len(results), len(lines))
+
+            for i, data_object in enumerate(paths.values()):
+                self.assertEqual(results[i + 1]['lpath'], data_object)
+                self.assertEqual(results[i + 1]['irods_response']['status_code'], 0)
+
+            self.assertEqual(results[len(lines)]['irods_response']['status_code'], irods_error_codes.SYS_INVALID_INPUT_PARAM)
+
+            # Show the new data objects exist with the expected replica information.
+            for physical_path, data_object in paths.items():
+                r = requests.get(f'{self.url_base}/query', headers=rodsadmin_headers, params={
+                    'op': 'execute_genquery',
+                    'query': f"select DATA_PATH, RESC_NAME, DATA_SIZE where COLL_NAME = '{os.path.dirname(data_object)}' and DATA_NAME = '{os.path.basename(data_object)}'"
+                })
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 200)
+                result = r.json()
+                self.assertEqual(result['irods_response']['status_code'], 0)
+                self.assertEqual(len(result['rows']), 1)
+                self.assertEqual(result['rows'][0][0], physical_path)
+                self.assertEqual(result['rows'][0][1], resource)
+                self.assertEqual(result['rows'][0][2], str(len(content)))
+
+        finally:
+            # Unregister the data objects.
+            for data_object in paths.values():
+                r = requests.post(self.url_endpoint, headers=rodsadmin_headers, data={
+                    'op': 'remove',
+                    'lpath': data_object,
+                    'catalog-only': 1
+                })
+                self.logger.debug(r.content)
+
     def test_registering_an_additional_replica_for_an_existing_data_object(self):
         rodsadmin_headers = {'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}
 
@@ -1583,6 +2223,53 @@ class test_data_objects_endpoint(unittest.TestCase):
 
         return result
 
+    def test_requests_are_authenticated_before_the_body_is_sent(self):
+        body = 'op=write&lpath=/tempZone/home/rods/foo.txt&bytes=' + 'x' * 1024
+        url = config.test_config['url_base'] + '/data-objects'
+
+        for token, expected_status in [('invalid_token', 401), (self.rodsuser_bearer_token, 100)]:
+            conn = http.client.HTTPConnection(config.test_config['host'], config.test_config['port'])
+
+            try:
+                # Send the headers only. The server must respond without waiting for the body.
+                conn.putrequest('POST', url)
+                conn.putheader('Authorization', f'Bearer {token}')
+                conn.putheader('Content-Type', 'application/x-www-form-urlencoded')
+                conn.putheader('Content-Length', str(len(body)))
+                conn.putheader('Expect', '100-continue')
+                conn.endheaders()
+
+                conn.sock.settimeout(10)
+                status_line = conn.sock.makefile('rb').readline().decode('utf-8')
+                self.logger.debug(status_line)
+                self.assertEqual(int(status_line.split()[1]), expected_status)
+
+            finally:
+                conn.close()
+
+    def test_requests_for_unknown_operations_are_rejected_before_the_body_is_sent(self):
+        body = '{"lpath": "/tempZone/home/rods/foo.txt"}\n' * 64
+        url = config.test_config['url_base'] + '/data-objects?op=not_an_operation'
+
+        conn = http.client.HTTPConnection(config.test_config['host'], config.test_config['port'])
+
+        try:
+            # The operation is passed via the query string, so it can be checked before the body is read.
+            conn.putrequest('POST', url)
+            conn.putheader('Authorization', f'Bearer {self.rodsuser_bearer_token}')
+            conn.putheader('Content-Type', 'application/x-ndjson')
+            conn.putheader('Content-Length', str(len(body)))
+            conn.putheader('Expect', '100-continue')
+            conn.endheaders()
+
+            conn.sock.settimeout(10)
+            status_line = conn.sock.makefile('rb').readline().decode('utf-8')
+            self.logger.debug(status_line)
+            self.assertEqual(int(status_line.split()[1]), 400)
+
+        finally:
+            conn.close()
+
     def test_parallel_writes(self):
         headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
 
@@ -1650,6 +2337,227 @@ class test_data_objects_endpoint(unittest.TestCase):
         self.assertEqual(r.status_code, 200)
         self.assertEqual(r.json()['irods_response']['status_code'], 0)
 
+    def test_updating_a_data_object_using_block_signatures_and_a_delta(self):
+        headers = {'Authorization': f'Bearer {self.rodsuser_bearer_token}'}
+        data_object = f'/{self.zone_name}/home/{self.rodsuser_username}/delta_target.bin'
+        block_size = 1024
+
+        def weak_checksum(block):
+            a = sum(block) % 65536
+            b = sum((len(block) - i) * x for i, x in enumerate(block)) % 65536
+            return a + (b << 16)
+
+        def strong_checksum(block):
+            return base64.b64encode(hashlib.sha256(block).digest()).decode('utf-8')
+
+        data = os.urandom(4 * block_size)
+
+        try:
+            r = requests.post(self.url_endpoint, headers=headers, files={
+                'op': 'write',
+                'lpath': data_object,
+                'bytes': data
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            # Show the signatures match the contents of the data object.
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'block_signatures',
+                'lpath': data_object,
+                'block-size': block_size
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.headers['Content-Type'], 'application/x-ndjson')
+            lines = [json.loads(line) for line in r.text.splitlines()]
+            self.assertEqual(lines[0]['size'], len(data))
+            self.assertEqual(lines[0]['block_size'], block_size)
+            self.assertEqual(lines[-1]['irods_response']['status_code'], 0)
+            blocks = lines[1:-1]
+            self.assertEqual(len(blocks), 4)
+
+            for i, (weak, strong) in enumerate(blocks):
+                block = data[i * block_size:(i + 1) * block_size]
+                self.assertEqual(weak, weak_checksum(block))
+                self.assertEqual(strong, strong_checksum(block))
+
+            # Replace the second block with fewer bytes and drop the third one. The remaining
+            # blocks are copied from the data object.
+            literal = b'the second block changed'
+            expected = data[:block_size] + literal + data[3 * block_size:]
+
+            r = requests.post(self.url_endpoint, headers=headers, files={
+                'op': 'apply_delta',
+                'lpath': data_object,
+                'block-size': str(block_size),
+                'instructions': json.dumps([
+                    {'op': 'copy', 'block': 0, 'count': 1},
+                    {'op': 'literal', 'offset': 0, 'length': len(literal)},
+                    {'op': 'copy', 'block': 3, 'count': 1}
+                ]),
+                'bytes': literal
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+            self.assertEqual(r.json()['size'], len(expected))
+
+            r = requests.get(self.url_endpoint, headers=headers, params={'op': 'read', 'lpath': data_object})
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.content, expected)
+
+            # Show blocks can be copied in any order.
+            r = requests.post(self.url_endpoint, headers=headers, files={
+                'op': 'apply_delta',
+                'lpath': data_object,
+                'block-size': str(block_size),
+                'instructions': json.dumps([
+                    {'op': 'copy', 'block': 1, 'count': 1},
+                    {'op': 'copy', 'block': 0, 'count': 1}
+                ])
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            expected = expected[block_size:2 * block_size] + expected[:block_size]
+
+            r = requests.get(self.url_endpoint, headers=headers, params={'op': 'read', 'lpath': data_object})
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.content, expected)
+
+            # Show copies of missing blocks are rejected and leave the data object untouched.
+            r = requests.post(self.url_endpoint, headers=headers, files={
+                'op': 'apply_delta',
+                'lpath': data_object,
+                'block-size': str(block_size),
+                'instructions': json.dumps([
+                    {'op': 'copy', 'block': 0, 'count': 1},
+                    {'op': 'copy', 'block': 5, 'count': 1}
+                ])
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 400)
+            self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.SYS_INVALID_INPUT_PARAM)
+
+            r = requests.get(self.url_endpoint, headers=headers, params={'op': 'read', 'lpath': data_object})
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.content, expected)
+
+        finally:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': data_object,
+                'catalog-only': 0,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+
+    def test_resuming_an_interrupted_parallel_write(self):
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        data_object = os.path.join('/', self.zone_name, 'home', self.rodsuser_username, 'resumed_parallel_write.txt')
+
+        # Tell the server how many bytes the data object will contain.
+        r = requests.post(self.url_endpoint, headers=headers, data={
+            'op': 'parallel_write_init',
+            'lpath': data_object,
+            'stream-count': 2,
+            'total-size': 30
+        })
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        result = r.json()
+        self.assertEqual(result['irods_response']['status_code'], 0)
+        parallel_write_handle = result['parallel_write_handle']
+
+        try:
+            # Write the last two chunks only. This simulates a client which was interrupted.
+            for index, content in [(2, 'C'), (1, 'B')]:
+                result = self.multipart_form_data_upload(**{
+                    'bearer_token': self.rodsuser_bearer_token,
+                    'fields': {
+                        'op': 'write',
+                        'parallel-write-handle': parallel_write_handle,
+                        'offset': index * 10,
+                        'stream-index': index - 1
+                    },
+                    'bytes': content * 10
+                })
+                self.assertEqual(result['irods_response']['status_code'], 0)
+
+            # Show the server reports which byte ranges have been written.
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'parallel_write_status',
+                'parallel-write-handle': parallel_write_handle
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            result = r.json()
+            self.assertEqual(result['irods_response']['status_code'], 0)
+            self.assertEqual(result['committed_offset'], 0)
+            self.assertEqual(result['committed_ranges'], [[10, 30]])
+            self.assertEqual(result['total_size'], 30)
+
+            # Show the data object cannot be finalized while bytes are missing.
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'parallel_write_shutdown',
+                'parallel-write-handle': parallel_write_handle
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 400)
+            self.assertEqual(r.json()['committed_ranges'], [[10, 30]])
+
+            # Write the missing bytes.
+            result = self.multipart_form_data_upload(**{
+                'bearer_token': self.rodsuser_bearer_token,
+                'fields': {
+                    'op': 'write',
+                    'parallel-write-handle': parallel_write_handle,
+                    'offset': 0,
+                    'stream-index': 0
+                },
+                'bytes': 'A' * 10
+            })
+            self.assertEqual(result['irods_response']['status_code'], 0)
+
+            # End the parallel write.
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'parallel_write_shutdown',
+                'parallel-write-handle': parallel_write_handle
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+            # Show the handle is no longer valid.
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'parallel_write_status',
+                'parallel-write-handle': parallel_write_handle
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 404)
+
+            # Show the data object contains exactly what we expect.
+            r = requests.get(self.url_endpoint, headers=headers, params={
+                'op': 'read',
+                'lpath': data_object,
+                'count': 30
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.content.decode('utf-8'), 'A' * 10 + 'B' * 10 + 'C' * 10)
+
+        finally:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': data_object,
+                'catalog-only': 0,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+
     def test_parallel_writes_with_data_exceeding_internal_write_threshold(self):
         # This test assumes the HTTP API is configured to use a value smaller than
         # 96kb for "/irods_client/max_number_of_bytes_per_write_operation". This is
@@ -1825,6 +2733,71 @@ class test_data_objects_endpoint(unittest.TestCase):
             })
             self.logger.debug(r.content)
 
+    def test_writes_are_verified_against_the_digest_supplied_by_the_client(self):
+        headers = {'Authorization': f'Bearer {self.rodsuser_bearer_token}'}
+        data_object = f'/{self.zone_name}/home/{self.rodsuser_username}/digest_verified_write.txt'
+
+        data = os.urandom(64 * 1024)
+        checksum = base64.b64encode(hashlib.sha256(data).digest()).decode('utf-8')
+
+        try:
+            # Show a digest which does not match the bytes is rejected.
+            bad_checksum = base64.b64encode(hashlib.sha256(b'not the data').digest()).decode('utf-8')
+            r = requests.post(self.url_endpoint, headers={**headers, 'Content-Digest': f'sha-256=:{bad_checksum}:'}, files={
+                'op': 'write',
+                'lpath': data_object,
+                'bytes': data
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 400)
+            self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.USER_CHKSUM_MISMATCH)
+            self.assertEqual(r.json()['checksum'], f'sha2:{checksum}')
+
+            # Show the rejected bytes never reached iRODS.
+            r = requests.get(self.url_endpoint, headers=headers, params={'op': 'stat', 'lpath': data_object})
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], irods_error_codes.NOT_A_DATA_OBJECT)
+
+            # Show a matching digest is accepted and the checksum can be registered without
+            # asking the server to compute it.
+            r = requests.post(self.url_endpoint, headers={**headers, 'Digest': f'SHA-256={checksum}'}, files={
+                'op': 'write',
+                'lpath': data_object,
+                'bytes': data,
+                'register-checksum': '1'
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+            self.assertEqual(r.json()['checksum'], f'sha2:{checksum}')
+
+            r = requests.get(self.url_endpoint, headers=headers, params={'op': 'stat', 'lpath': data_object})
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['checksum'], f'sha2:{checksum}')
+
+            # Show the checksum cannot be registered for a partial write.
+            r = requests.post(self.url_endpoint, headers=headers, files={
+                'op': 'write',
+                'lpath': data_object,
+                'bytes': data,
+                'offset': '1',
+                'register-checksum': '1'
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 400)
+
+        finally:
+            # Remove the data object.
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'remove',
+                'lpath': data_object,
+                'catalog-only': 0,
+                'no-trash': 1
+            })
+            self.logger.debug(r.content)
+
     def test_modifying_metadata_atomically(self):
         headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
 
@@ -1908,6 +2881,78 @@ class test_data_objects_endpoint(unittest.TestCase):
         self.assertEqual(r.status_code, 200)
         self.assertEqual(r.json()['irods_response']['status_code'], 0)
 
+    def test_modifying_metadata_in_bulk(self):
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+
+        # Create several data objects.
+        home_collection = os.path.join('/', self.zone_name, 'home', self.rodsuser_username)
+        data_objects = [os.path.join(home_collection, f'for_bulk_metadata.{i}.txt') for i in range(10)]
+
+        for data_object in data_objects:
+            r = requests.post(self.url_endpoint, headers=headers, data={
+                'op': 'touch',
+                'lpath': data_object
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+            self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+        try:
+            # Build the NDJSON request body. Include a blank line, an invalid line, and
+            # a line targeting a data object that does not exist.
+            lines = [json.dumps({'lpath': lpath, 'operations': [{'operation': 'add', 'attribute': 'bulk_a1', 'value': 'bulk_v1'}]}) for lpath in data_objects]
+            lines.append('')
+            lines.append('{"lpath": "missing operations"}')
+            lines.append(json.dumps({'lpath': data_objects[0] + '.does_not_exist', 'operations': [{'operation': 'add', 'attribute': 'a', 'value': 'v'}]}))
+
+            r = requests.post(self.url_endpoint,
+                              headers=headers | {'Content-Type': 'application/x-ndjson'},
+                              params={'op': 'bulk_modify_metadata'},
+                              data='\n'.join(lines).encode('utf-8'))
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+
+            # Results are not guaranteed to be returned in order.
+            results = {}
+            for line in r.text.splitlines():
+                result = json.loads(line)
+                results[result['line']] = result
+
+            self.assertEqual(len(results), len(data_objects) + 2)
+
+            for i, lpath in enumerate(data_objects):
+                self.assertEqual(results[i + 1]['lpath'], lpath)
+                self.assertEqual(results[i + 1]['irods_response']['status_code'], 0)
+
+            self.assertEqual(results[len(data_objects) + 2]['irods_response']['status_code'], irods_error_codes.SYS_INVALID_INPUT_PARAM)
+            self.assertNotEqual(results[len(data_objects) + 3]['irods_response']['status_code'], 0)
+
+            # Show the metadata exists on all data objects.
+            r = requests.get(f'{self.url_base}/query', headers=headers, params={
+                'op': 'execute_genquery',
+                'query': "select DATA_NAME where META_DATA_ATTR_NAME = 'bulk_a1' and META_DATA_ATTR_VALUE = 'bulk_v1'",
+                'count': len(data_objects)
+            })
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+
+            result = r.json()
+            self.assertEqual(result['irods_response']['status_code'], 0)
+            self.assertEqual(len(result['rows']), len(data_objects))
+
+        finally:
+            # Remove the data objects.
+            for data_object in data_objects:
+                r = requests.post(self.url_endpoint, headers=headers, data={
+                    'op': 'remove',
+                    'lpath': data_object,
+                    'catalog-only': 0,
+                    'no-trash': 1
+                })
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 200)
+                self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
     def test_modifying_permissions_atomically(self):
         headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
 
@@ -2362,6 +3407,241 @@ class test_information_endpoint(unittest.TestCase):
         self.assertIn('max_size_of_request_body_in_bytes', info)
         self.assertIn('openid_connect_enabled', info)
 
+    def test_idle_connections_are_closed_once_the_header_timeout_expires(self):
+        conn = http.client.HTTPConnection(config.test_config['host'], config.test_config['port'])
+
+        try:
+            # A keep-alive connection serves multiple requests.
+            for _ in range(3):
+                conn.request('GET', self.url_endpoint)
+                r = conn.getresponse()
+                r.read()
+                self.assertEqual(r.status, 200)
+
+            # Send part of a header and wait. The server closes the connection once the
+            # header timeout expires.
+            conn.sock.sendall(b'GET ')
+            conn.sock.settimeout(120)
+            self.assertEqual(conn.sock.recv(1), b'')
+
+        finally:
+            conn.close()
+
+    def test_requests_carrying_a_traceparent_header_are_accepted(self):
+        traceparents = [
+            # Sampled and not sampled.
+            '00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-01',
+            '00-4bf92f3577b34da6a3ce929d0e0e4736-00f067aa0ba902b7-00',
+
+            # Malformed values are ignored.
+            '00-00000000000000000000000000000000-00f067aa0ba902b7-01',
+            'not a traceparent'
+        ]
+
+        for traceparent in traceparents:
+            with self.subTest(traceparent=traceparent):
+                r = requests.get(self.url_endpoint, headers={'traceparent': traceparent})
+                self.logger.debug(r.content)
+                self.assertEqual(r.status_code, 200)
+
+    def test_spans_of_sampled_requests_are_exported_with_the_trace_id_of_the_client(self):
+        if not config.test_config['server_features']['tracing']:
+            self.skipTest('Tracing is disabled. Check [server_features] in test configuration file.')
+
+        trace_file_path = config.test_config['trace_file_path']
+        offset = os.path.getsize(trace_file_path) if os.path.exists(trace_file_path) else 0
+
+        parent_id = '00f067aa0ba902b7'
+        unsampled_trace_id = os.urandom(16).hex()
+        sampled_trace_id = os.urandom(16).hex()
+
+        # The server honors the sampling decision of the client.
+        for trace_id, flags in [(unsampled_trace_id, '00'), (sampled_trace_id, '01')]:
+            r = requests.get(self.url_endpoint, headers={'traceparent': f'00-{trace_id}-{parent_id}-{flags}'})
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+
+        # Traces are exported in the background. Wait for the trace of the sampled request.
+        spans = []
+        for _ in range(100):
+            spans = []
+            with open(trace_file_path, 'r') as f:
+                f.seek(offset)
+                for line in f:
+                    # The exporter may be in the middle of writing the last line.
+                    if not line.endswith('\n'):
+                        break
+
+                    for resource_spans in json.loads(line)['resourceSpans']:
+                        for scope_spans in resource_spans['scopeSpans']:
+                            spans.extend(scope_spans['spans'])
+
+            if any(s['traceId'] == sampled_trace_id for s in spans):
+                break
+
+            time.sleep(0.1)
+
+        sampled_spans = [s for s in spans if s['traceId'] == sampled_trace_id]
+        self.assertGreater(len(sampled_spans), 0)
+
+        # The root span of the request is a child of the client's span.
+        root_spans = [s for s in sampled_spans if s['name'] == 'request']
+        self.assertEqual(len(root_spans), 1)
+        self.assertEqual(root_spans[0]['parentSpanId'], parent_id)
+
+        # The unsampled request was served first, therefore it would have been exported by now.
+        self.assertFalse(any(s['traceId'] == unsampled_trace_id for s in spans))
+
+    def test_server_reports_error_when_http_method_is_not_supported(self):
+        do_test_server_reports_error_when_http_method_is_not_supported(self)
+
+class test_metrics_endpoint(unittest.TestCase):
+
+    @classmethod
+    def setUpClass(cls):
+        setup_class(cls, {'endpoint_name': 'metrics'})
+
+    @classmethod
+    def tearDownClass(cls):
+        tear_down_class(cls)
+
+    def setUp(self):
+        self.assertFalse(self._class_init_error, 'Class initialization failed. Cannot continue.')
+
+    def test_memory_budget_is_reported_and_released_after_requests_complete(self):
+        # Upload a body which occupies the memory budget while it is being processed.
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        data_object = os.path.join('/', self.zone_name, 'home', self.rodsuser_username, 'memory_budget.txt')
+        url = config.test_config['url_base'] + '/data-objects'
+
+        try:
+            r = requests.post(url, headers=headers, data={'op': 'write', 'lpath': data_object, 'bytes': 'x' * 65536})
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+
+            r = requests.get(self.url_endpoint)
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 200)
+
+            memory_budget = r.json()['memory_budget']
+            self.assertIn('max_size_in_bytes', memory_budget)
+            self.assertEqual(memory_budget['number_of_paused_reads'], 0)
+
+            # The memory held by the upload is released once its response is sent.
+            self.assertLess(memory_budget['size_in_bytes'], 65536)
+
+        finally:
+            requests.post(url, headers=headers, data={'op': 'remove', 'lpath': data_object, 'catalog-only': 0, 'no-trash': 1})
+
+    def stat_home_collection_and_get_metrics(self):
+        '''Performs an operation which checks out an iRODS connection and returns the metrics.'''
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        r = requests.get(self.url_base + '/collections', headers=headers, params={
+            'op': 'stat',
+            'lpath': os.path.join('/', self.zone_name, 'home', self.rodsuser_username)
+        })
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+
+        r = requests.get(self.url_endpoint)
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+
+        return r.json()
+
+    def test_lock_statistics_are_reported(self):
+        locks = self.stat_home_collection_and_get_metrics()['locks']
+        self.assertEqual(locks['enabled'], config.test_config['server_features']['lock_instrumentation'])
+
+        bounds = locks['histogram_bucket_bounds_in_microseconds']
+        self.assertEqual(bounds, sorted(bounds))
+
+        # The locks of the server are registered whether or not the statistics are enabled.
+        for name in ['data_objects.parallel_write_contexts', 'process_stash']:
+            self.assertIn(name, locks['statistics'])
+
+        for name, stats in locks['statistics'].items():
+            with self.subTest(lock=name):
+                self.assertLessEqual(stats['contended_acquisitions'], stats['acquisitions'])
+                for distribution in ['wait_time', 'hold_time']:
+                    self.assertEqual(len(stats[distribution]['histogram']), len(bounds) + 1)
+
+    def test_allocations_are_reported_per_endpoint_and_operation(self):
+        allocations = self.stat_home_collection_and_get_metrics()['allocations']
+        self.assertEqual(allocations['enabled'], config.test_config['server_features']['allocation_accounting'])
+
+        if not allocations['enabled']:
+            self.assertEqual(allocations['endpoints'], {})
+            return
+
+        totals = allocations['endpoints'][config.test_config['url_base'] + '/collections']['stat']
+        self.assertGreaterEqual(totals['number_of_requests'], 1)
+        self.assertGreater(totals['allocations'], 0)
+        self.assertGreaterEqual(totals['bytes'], totals['max_bytes_per_request'])
+
+    def test_circuit_breaker_is_closed_while_irods_is_healthy(self):
+        breaker = self.stat_home_collection_and_get_metrics()['circuit_breaker']
+        self.assertEqual(breaker['enabled'], config.test_config['server_features']['circuit_breaker'])
+        self.assertEqual(breaker['state'], 'closed')
+        self.assertLessEqual(breaker['number_of_failed_calls'], breaker['number_of_calls'])
+
+        # The connection checked out by the stat operation is observed by the breaker.
+        if breaker['enabled']:
+            self.assertGreaterEqual(breaker['number_of_calls'], 1)
+
+    def test_concurrency_limiter_state_is_reported(self):
+        limiter = self.stat_home_collection_and_get_metrics()['concurrency_limiter']
+        self.assertEqual(limiter['enabled'], config.test_config['server_features']['concurrency_limiter'])
+
+        if not limiter['enabled']:
+            return
+
+        self.assertGreaterEqual(limiter['limit'], 1)
+        self.assertEqual(limiter['number_of_queued_tasks'], 0)
+        self.assertIn('min_latency_in_microseconds', limiter)
+        self.assertIn('latency_in_microseconds', limiter)
+
+    def test_requests_exceeding_the_rate_limits_are_rejected(self):
+        r = requests.get(self.url_endpoint)
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+
+        rate_limits = r.json()['rate_limits']
+        self.assertIn('number_of_rejected_requests', rate_limits)
+
+        # The users which were rejected are only reported to rodsadmins.
+        self.assertNotIn('number_of_rejected_requests_per_user', rate_limits)
+
+        self.assertEqual(rate_limits['enabled'], config.test_config['server_features']['rate_limits'])
+
+        if not rate_limits['enabled']:
+            return
+
+        # Send requests until one is rejected. The burst allowed by the limits is finite.
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        url = config.test_config['url_base'] + '/collections'
+        params = {'op': 'stat', 'lpath': os.path.join('/', self.zone_name, 'home', self.rodsuser_username)}
+
+        for _ in range(1000):
+            r = requests.get(url, headers=headers, params=params)
+            if r.status_code == 429:
+                break
+            self.assertEqual(r.status_code, 200)
+
+        self.assertEqual(r.status_code, 429)
+        self.assertGreaterEqual(int(r.headers['Retry-After']), 1)
+
+        r = requests.get(self.url_endpoint)
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        self.assertGreaterEqual(r.json()['rate_limits']['number_of_rejected_requests'], 1)
+
+        headers = {'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}
+        r = requests.get(self.url_base + '/admin', headers=headers, params={'op': 'rate_limits'})
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        self.assertGreaterEqual(r.json()['number_of_rejected_requests_per_user'][self.rodsuser_username], 1)
+
     def test_server_reports_error_when_http_method_is_not_supported(self):
         do_test_server_reports_error_when_http_method_is_not_supported(self)
 
@@ -2389,6 +3669,48 @@ class test_query_endpoint(unittest.TestCase):
         self.assertEqual(result['irods_response']['status_code'], 0)
         self.assertGreater(len(result['rows']), 0)
 
+    def test_requests_honor_the_timeout_supplied_by_the_client(self):
+        headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}
+        params = {'op': 'execute_genquery', 'parser': 'genquery1', 'query': 'select COLL_NAME'}
+
+        # A generous timeout does not affect the request.
+        r = requests.get(self.url_endpoint, headers=headers | {'X-Request-Timeout': '60'}, params=params)
+        self.logger.debug(r.content)
+        self.assertEqual(r.status_code, 200)
+        self.assertEqual(r.json()['irods_response']['status_code'], 0)
+
+        # Invalid timeouts are rejected.
+        for timeout in ['0', '-1', 'abc']:
+            r = requests.get(self.url_endpoint, headers=headers | {'X-Request-Timeout': timeout}, params=params)
+            self.logger.debug(r.content)
+            self.assertEqual(r.status_code, 400)
+
+    def test_queries_which_outlive_the_timeout_supplied_by_the_client_respond_with_504(self):
+        params = urllib.parse.urlencode({'op': 'execute_genquery', 'parser': 'genquery1', 'query': 'select COLL_NAME'})
+        url = f"{config.test_config['url_base']}/query?{params}"
+
+        conn = http.client.HTTPConnection(config.test_config['host'], config.test_config['port'])
+
+        try:
+            # The timeout is measured from the arrival of the request header. Delaying the body keeps
+            # the request in flight past its deadline without depending on the size of the catalog.
+            conn.putrequest('GET', url)
+            conn.putheader('Authorization', f'Bearer {self.rodsuser_bearer_token}')
+            conn.putheader('X-Request-Timeout', '1')
+            conn.putheader('Content-Type', 'text/plain')
+            conn.putheader('Content-Length', '1')
+            conn.endheaders()
+
+            time.sleep(2)
+            conn.send(b'x')
+
+            r = conn.getresponse()
+            self.logger.debug(r.read())
+            self.assertEqual(r.status, 504)
+
+        finally:
+            conn.close()
+
     def test_genquery1_no_distinct_option(self):
         rodsadmin_headers = {'Authorization': 'Bearer ' + self.rodsadmin_bearer_token}
         rodsuser_headers = {'Authorization': 'Bearer ' + self.rodsuser_bearer_token}